@@ -25,6 +25,10 @@ namespace mlir
         template <typename ConcreteType>
         class isAbcTarget : public mlir::OpTrait::TraitBase<ConcreteType, isAbcTarget>
         {};
+
+        template <typename ConcreteType>
+        class isAbcSsaExpression : public mlir::OpTrait::TraitBase<ConcreteType, isAbcSsaExpression>
+        {};
     } // namespace OpTrait
 } // namespace mlir
 
@@ -36,6 +40,8 @@ bool containsExactlyOneTargetNode(mlir::Region &region);
 
 bool containsExactlyOneStatementNode(mlir::Region &region);
 
+bool endsWithSsaExpressionValue(mlir::Region &region);
+
 #define GET_OP_CLASSES
 #include "transpiration/IR/ast/AST.h.inc"
 
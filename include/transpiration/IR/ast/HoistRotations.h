@@ -0,0 +1,27 @@
+#ifndef IR_AST_HOIST_ROTATIONS_H
+#define IR_AST_HOIST_ROTATIONS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include "transpiration/IR/ast/ASTDialect.h"
+
+/// Groups the `ast.ssa.call @rotate(%x, %k)` ops with literal offsets that rotate the same value within a block into a
+/// single `ast.ssa.multi_rotate`, which is placed before the first of these rotations.
+/// Two reads of the same variable (`ast.ssa.variable`) count as the same value unless the variable may have been
+/// written in between, i.e., by an assignment or declaration of the variable or by any op with regions.
+/// The location of the multi_rotate fuses the locations of the calls it replaces, in program order.
+std::unique_ptr<mlir::Pass> createHoistRotationsPass();
+
+/// The rotations that the pass grouped, i.e., for every ast.ssa.multi_rotate in the module the names of the (NameLoc)
+/// locations of the calls it replaces. For a module lowered by the AbcAstToSsaVisitor, these are the unique node IDs of
+/// the rotate() Calls in the AST, which is how the SealEmitterVisitor learns which rotations to compute together.
+std::vector<std::vector<std::string>> collectHoistedRotations(mlir::ModuleOp module);
+
+/// Registers the pass as "hoist-rotations"
+void registerHoistRotationsPass();
+
+#endif // IR_AST_HOIST_ROTATIONS_H
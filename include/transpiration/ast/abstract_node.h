@@ -2,6 +2,7 @@
 #define AST_ABSTRACT_NODE_H_
 
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <string>
@@ -11,10 +12,41 @@
 // forward declaration of Visitor interface from transpiration/visitor/IVisitor.h
 class IVisitor;
 
+// forward declaration of the arena that nodes can be allocated in, see transpiration/ast/utils/node_arena.h
+class NodeArena;
+
 // Forward Iterator that redirects all calls to a (polymorphic) BaseIteratorImpl iterator
 template <typename T>
 class NodeIterator;
 
+/// The concrete class of a node, which allows to dispatch on a node without a virtual call per handler, see
+/// transpiration/ast/utils/static_visitor.h
+enum class NodeKind
+{
+    Assignment,
+    BinaryExpression,
+    Block,
+    Call,
+    ExpressionList,
+    For,
+    Function,
+    FunctionParameter,
+    If,
+    IndexAccess,
+    LiteralBool,
+    LiteralChar,
+    LiteralInt,
+    LiteralFloat,
+    LiteralDouble,
+    LiteralString,
+    OperatorExpression,
+    Return,
+    TernaryOperator,
+    UnaryExpression,
+    Variable,
+    VariableDeclaration
+};
+
 // AbstractNode defines the common interface for all nodes.
 //
 // DIRECTED GRAPH:
@@ -38,7 +70,7 @@ class NodeIterator;
 // Changing Ownership of a Node (e.g. when moving a node around in a tree)
 // should proceed by first taking ownership to the local scope via takeNode()
 // Then, adding the node to its new parent via a derived class's setter method
-// Internally, the setter should first add the child and then use setParent()
+// Internally, the setter should first add the child and then use adoptChild(), which calls setParent()
 
 class AbstractNode {
 private:
@@ -57,6 +89,19 @@ public:
     // Virtual Destructor, force class to be abstract
     virtual ~AbstractNode() = 0;
 
+    /// Allocates a node, which the CompilerStatistics count (see nodes_allocated and peak_node_bytes)
+    static void *operator new(size_t size);
+
+    /// Allocates a node in an arena, e.g., new (arena) Variable("x"), see NodeArena::make()
+    static void *operator new(size_t size, NodeArena &arena);
+
+    /// Sized, such that the bytes of the most derived node are released (the destructor is virtual). Nodes that were
+    /// allocated in a NodeArena are returned to it.
+    static void operator delete(void *pointer, size_t size);
+
+    /// Only called if the constructor of a node allocated in the arena throws
+    static void operator delete(void *pointer, NodeArena &arena);
+
     // Clones a node recursively, i.e., by including all of its children.
     // Because return-type covariance does not work with smart pointers,
     // derived classes are expected to introduce a std::unique_ptr<DerivedNode> clone() method that hides this (for use
@@ -81,6 +126,11 @@ public:
     /// \param v Visitor that offers a visit() method
     virtual void accept(IVisitor &v) = 0;
 
+    /// Returns the concrete class of the node. Unlike getNodeType(), this does not allocate and is meant for
+    /// dispatching on the node (see static_visitor.h).
+    /// \return The kind of the node, e.g., NodeKind::Variable for a Variable
+    [[nodiscard]] virtual NodeKind getNodeKind() const = 0;
+
     /** @defgroup DAG Methods for handling parent/child relationship
      *  @{
      */
@@ -203,6 +253,65 @@ protected:
     /// Default Constructor, defines some default behavior for subclasses related to IDs
     AbstractNode();
 
+    /// Deletes a child, which derived classes must do for each of their children in their destructor. The children of
+    /// the child are not deleted by the destructor of the child, but afterwards by the outermost destroyChild() of the
+    /// thread, one after the other, since an AST might be too deep to be deleted recursively.
+    /// \param child The child to delete, which is null afterwards
+    template <typename T>
+    static void destroyChild(std::unique_ptr<T> &child)
+    {
+        if (child)
+            destroyNode(std::unique_ptr<AbstractNode>(child.release()));
+    }
+
+    /// Clones a child into one of the members of this node, which derived classes must do for each of their children
+    /// in their copy constructor and copy assignment. Like destroyChild(), the children of the child are not cloned by
+    /// the copy constructor of the child, but afterwards by the outermost cloneChild() of the thread, one after the
+    /// other, i.e., the member might only hold the clone once the outermost clone() returned. Hence, the member must
+    /// not move in the meantime (e.g. the vector of children must not grow once its elements are cloned into).
+    /// \param child The member to hold the clone (made a child of this node), whose previous node is deleted
+    /// \param original The child to clone, or null to clear the member
+    template <typename T>
+    void cloneChild(std::unique_ptr<T> &child, const std::unique_ptr<T> &original)
+    {
+        destroyChild(child);
+        if (original)
+            cloneNode(*original, *this, &child, [](void *member, AbstractNode *clone) {
+                static_cast<std::unique_ptr<T> *>(member)->reset(static_cast<T *>(clone));
+            });
+    }
+
+    /// Makes this node the parent of a child, which derived classes must do in every constructor and setter that
+    /// takes a child (other than by cloning it), such that the parents are set as soon as a node is built, e.g., by
+    /// the Parser
+    /// \param child The new child, which may be null
+    template <typename T>
+    void adoptChild(const std::unique_ptr<T> &child)
+    {
+        if (child)
+            child->setParent(*this);
+    }
+
+    /// Makes this node the parent of all (non-null) children, see adoptChild()
+    /// \param children The new children
+    template <typename T>
+    void adoptChildren(const std::vector<std::unique_ptr<T>> &children)
+    {
+        for (auto &child : children)
+            adoptChild(child);
+    }
+
+private:
+    /// Deletes a node or, if called from the destructor of a node that is deleted by destroyNode(), defers it
+    static void destroyNode(std::unique_ptr<AbstractNode> node);
+
+    /// Stores a clone in the member of its parent that it was cloned for, see cloneChild()
+    typedef void (*CloneSetter)(void *member, AbstractNode *clone);
+
+    /// Clones a node into a member of its parent or, if called from the copy constructor of a node that is cloned by
+    /// cloneNode(), defers it
+    static void cloneNode(const AbstractNode &original, AbstractNode &parent, void *member, CloneSetter setter);
+
 public:
     /// Returns a node's unique ID, or generates it by calling generateUniqueNodeId() if the name was not defined yet.
     /// \return The node's name consisting of the node type and an ongoing number (e.g., Function_1).
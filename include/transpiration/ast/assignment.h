@@ -110,6 +110,7 @@ public:
     ////////// AbstractNode Interface /////////////
     ///////////////////////////////////////////////
     void accept(IVisitor &v) override;
+    NodeKind getNodeKind() const override;
     iterator begin() override;
     const_iterator begin() const override;
     iterator end() override;
@@ -67,6 +67,10 @@ public:
     /// \return Vector of (references to) all non-null arguments
     std::vector<std::reference_wrapper<AbstractExpression>> getArguments();
 
+    /// Get (a vector of ptrs to) all arguments
+    /// \return vec of (pointers to) all arguments
+    std::vector<std::unique_ptr<AbstractExpression>> &getArgumentPtrs();
+
     /// Create a Call node from a nlohmann::json representation of this node.
     /// \return unique_ptr to a new Call node
     static std::unique_ptr<Call> fromJson(nlohmann::json j);
@@ -75,6 +79,7 @@ public:
     ////////// AbstractNode Interface /////////////
     ///////////////////////////////////////////////
     void accept(IVisitor &v) override;
+    NodeKind getNodeKind() const override;
     iterator begin() override;
     const_iterator begin() const override;
     iterator end() override;
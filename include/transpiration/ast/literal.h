@@ -153,6 +153,9 @@ public:
         v.visit(*this);
     }
 
+    /// Only defined for the common types below, which the IVisitor has a visit() for
+    NodeKind getNodeKind() const override;
+
     iterator begin() override
     {
         return iterator(std::make_unique<EmptyIteratorImpl<AbstractNode>>(*this));
@@ -251,4 +254,40 @@ inline std::string Literal<std::string>::getNodeType() const
     return "LiteralString";
 };
 
+template <>
+inline NodeKind Literal<bool>::getNodeKind() const
+{
+    return NodeKind::LiteralBool;
+};
+
+template <>
+inline NodeKind Literal<char>::getNodeKind() const
+{
+    return NodeKind::LiteralChar;
+};
+
+template <>
+inline NodeKind Literal<int>::getNodeKind() const
+{
+    return NodeKind::LiteralInt;
+};
+
+template <>
+inline NodeKind Literal<float>::getNodeKind() const
+{
+    return NodeKind::LiteralFloat;
+};
+
+template <>
+inline NodeKind Literal<double>::getNodeKind() const
+{
+    return NodeKind::LiteralDouble;
+};
+
+template <>
+inline NodeKind Literal<std::string>::getNodeKind() const
+{
+    return NodeKind::LiteralString;
+};
+
 #endif // AST_LITERAL_H_
@@ -80,6 +80,10 @@ public:
     /// \return Vector of (const references to) all non-null operands
     std::vector<std::reference_wrapper<const AbstractExpression>> getOperands() const;
 
+    /// Get (a vector of ptrs to) all operands
+    /// \return vec of (pointers to) all operands
+    std::vector<std::unique_ptr<AbstractExpression>> &getOperandPtrs();
+
     /// Set the operator to newOperator
     /// \param newOperator new operator to set
     void setOperator(Operator newOperator);
@@ -99,6 +103,7 @@ public:
     ////////// AbstractNode Interface /////////////
     ///////////////////////////////////////////////
     void accept(IVisitor &v) override;
+    NodeKind getNodeKind() const override;
     iterator begin() override;
     const_iterator begin() const override;
     iterator end() override;
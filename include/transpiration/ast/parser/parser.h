@@ -1,6 +1,7 @@
 #ifndef AST_PARSER_PARSER_H_
 #define AST_PARSER_PARSER_H_
 
+#include <deque>
 #include <memory>
 
 #include "transpiration/ast/abstract_node.h"
@@ -78,6 +79,9 @@ private:
 
     static AbstractExpression *parseLiteral(tokens_iterator &it, bool isNegative);
 
+    /// Parses statements until the end of the input and wraps them into a Block
+    static std::unique_ptr<AbstractNode> parseProgram(tokens_iterator &it);
+
 public:
     /// Parses a given input program, returns (a unique ptr) to the created root node of the AST.
     /// \param s The program to parse given as string in a C++-like syntax.
@@ -91,6 +95,17 @@ public:
     static std::unique_ptr<AbstractNode> parse(
         std::string s, std::vector<std::reference_wrapper<AbstractNode>> &createdNodesList);
 
+    /// Splits a given input program into its tokens, which parse(std::deque<token> &) accepts. Only needed to
+    /// measure tokenizing and parsing separately, parse(std::string) tokenizes lazily while parsing.
+    /// \param s The program given as string in a C++-like syntax.
+    /// \return The tokens of the program, without the final end-of-file token.
+    static std::deque<token> tokenize(std::string s);
+
+    /// Parses a program that has already been tokenized, see parse(std::string).
+    /// \param tokens The tokens of the program, which are consumed.
+    /// \return (A unique pointer) to the root node of the AST.
+    static std::unique_ptr<AbstractNode> parse(std::deque<token> &tokens);
+
     /// Parses the JSON string representation of an AST and returns (a unique ptr) to the created root node of the AST.
     /// \param s The JSON string to parse
     /// \return (A unique pointer) to the root node of the AST.
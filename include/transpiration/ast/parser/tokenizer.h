@@ -11,18 +11,18 @@
 
 using get_character = std::function<char()>;
 
+/// Reads the characters of inputString one after the other, without modifying it (erasing each character from the
+/// front of the string would make tokenizing quadratic in the length of the program)
 inline get_character getCharacterFunc(std::string &inputString)
 {
-    return [&inputString]() {
-        if (inputString.empty())
+    return [&inputString, position = size_t(0)]() mutable {
+        if (position == inputString.size())
         {
             return (char)EOF;
         }
         else
         {
-            char c = inputString.at(0);
-            inputString.erase(0, 1);
-            return c;
+            return inputString[position++];
         }
     };
 }
@@ -1,6 +1,9 @@
 #ifndef AST_UTILS_ABC_AST_TO_MLIR_VISITOR_H_
 #define AST_UTILS_ABC_AST_TO_MLIR_VISITOR_H_
 
+#include <utility>
+#include <vector>
+
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/MLIRContext.h>
 
@@ -20,11 +23,27 @@ private:
     mlir::OpBuilder builder;
     mlir::Block *block;
 
+    /// Nodes whose translation has been deferred, with the blocks they are translated into, the next one on top
+    std::vector<std::pair<AbstractNode *, mlir::Block *>> pending;
+
+    /// Number of recursive_visit() calls that are translating the pending nodes
+    size_t translating = 0;
+
     void add_op(mlir::Operation *op);
     void add_recursive_result_to_region(AbstractNode &node, mlir::Region &region);
+    void add_deferred_result_to_region(AbstractNode &node, mlir::Region &region);
     mlir::Type translate_type(Datatype abc_type);
+
+    /// Translates the node into childBlock, which is complete once this returns
     void recursive_visit(AbstractNode &node, mlir::Block *childBlock);
 
+    /// Translates the node into childBlock, possibly after the caller returned, i.e., for visit()s that do not inspect
+    /// the translation of their children. This keeps deep expressions from recursing for every level.
+    void deferred_visit(AbstractNode &node, mlir::Block *childBlock);
+
+    /// Calls the visit() for the node's class
+    void translate(AbstractNode &node);
+
 public:
     explicit SpecialAbcAstToMlirVisitor(mlir::MLIRContext &ctx);
 
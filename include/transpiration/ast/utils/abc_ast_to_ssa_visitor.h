@@ -0,0 +1,118 @@
+#ifndef AST_UTILS_ABC_AST_TO_SSA_VISITOR_H_
+#define AST_UTILS_ABC_AST_TO_SSA_VISITOR_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/MLIRContext.h>
+
+#include "transpiration/IR/ast/ASTDialect.h"
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the AbcAstToSsaVisitor's logic
+class SpecialAbcAstToSsaVisitor;
+
+/// AbcAstToSsaVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialAbcAstToSsaVisitor, PlainVisitor> AbcAstToSsaVisitor;
+
+/// Lowers the AST into the SSA-valued ops of the ast dialect (ast.ssa.*).
+/// In contrast to the AbcAstToMlirVisitor, which nests every operand of an expression in a region with a fresh
+/// mlir::Block, expressions are emitted as a flat sequence of ops into the block of the enclosing statement and are
+/// connected through their result values. New blocks are only created for statements that open a scope
+/// (Block, Function, For, If), i.e., roughly one block per scope instead of several blocks per expression.
+class SpecialAbcAstToSsaVisitor : public PlainVisitor
+{
+private:
+    mlir::OpBuilder builder;
+
+    /// Block that statements are currently appended to
+    mlir::Block *block;
+
+    /// Result of the most recently lowered expression
+    mlir::Value value;
+
+    /// Results of the lowered operands of the expressions that are being lowered, the last operand on top. Since
+    /// unrolled programs nest expressions too deep to lower them recursively, lower_expression() lowers every
+    /// subexpression after its operands and the handlers of expressions take the values of their operands from here.
+    std::vector<mlir::Value> values;
+
+    /// Types of the declared variables and function parameters, one map per open scope (innermost last), used to type
+    /// ast.ssa.variable reads
+    std::vector<std::unordered_map<std::string, mlir::Type>> declaredTypes;
+
+    mlir::Type translate_type(Datatype abc_type);
+
+    /// Lowers an expression at the current insertion point and returns its result value
+    mlir::Value lower_expression(AbstractExpression &expr);
+
+    /// Takes the value of the last lowered operand
+    /// \throws runtime_error if there is none, e.g., for a BinaryExpression without a right operand
+    mlir::Value pop_value();
+
+    /// Takes the values of the last count lowered operands, in the order in which they were lowered
+    std::vector<mlir::Value> pop_values(size_t count);
+
+    /// Lowers a statement (or a Block's statements) into a new block appended to the given region
+    void lower_statements_into(AbstractStatement &stmt, mlir::Region &region);
+
+    /// Returns the type that the given variable was declared with, or NoneType if the declaration is unknown
+    mlir::Type lookup_type(const std::string &identifier);
+
+public:
+    explicit SpecialAbcAstToSsaVisitor(mlir::MLIRContext &ctx);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    mlir::Block *getBlockPtr();
+
+    void visit(Assignment &elem);
+
+    void visit(BinaryExpression &elem);
+
+    void visit(Block &elem);
+
+    void visit(Call &elem);
+
+    void visit(ExpressionList &elem);
+
+    void visit(For &elem);
+
+    void visit(Function &elem);
+
+    void visit(FunctionParameter &elem);
+
+    void visit(If &elem);
+
+    void visit(IndexAccess &elem);
+
+    void visit(LiteralBool &elem);
+
+    void visit(LiteralChar &elem);
+
+    void visit(LiteralInt &elem);
+
+    void visit(LiteralFloat &elem);
+
+    void visit(LiteralDouble &elem);
+
+    void visit(LiteralString &elem);
+
+    void visit(OperatorExpression &elem);
+
+    void visit(Return &elem);
+
+    void visit(TernaryOperator &elem);
+
+    void visit(UnaryExpression &elem);
+
+    void visit(VariableDeclaration &elem);
+
+    void visit(Variable &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+};
+
+#endif // AST_UTILS_ABC_AST_TO_SSA_VISITOR_H_
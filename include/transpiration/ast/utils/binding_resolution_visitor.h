@@ -0,0 +1,40 @@
+#ifndef AST_UTILS_BINDING_RESOLUTION_VISITOR_H_
+#define AST_UTILS_BINDING_RESOLUTION_VISITOR_H_
+
+#include "transpiration/ast/utils/scoped_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the BindingResolutionVisitor's logic
+class SpecialBindingResolutionVisitor;
+
+/// BindingResolutionVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialBindingResolutionVisitor> BindingResolutionVisitor;
+
+/// Resolves every Variable once and stamps it with the ScopedIdentifier of its declaration (see Variable::setBinding).
+/// ScopedVisitors that continue with the same scopes then find the declaration of a Variable without any lookup by
+/// name (see ScopedVisitor::findIdentifier):
+///   BindingResolutionVisitor resolution;
+///   ast->accept(resolution);
+///   SecretTaintVisitor taint;
+///   taint.setRootScope(resolution.takeRootScope());
+///   ast->accept(taint);
+/// Visitors with scopes of their own ignore the bindings, and so does everyone once the scopes are destroyed.
+/// Variables that are not declared in any enclosing scope stay unbound.
+class SpecialBindingResolutionVisitor : public ScopedVisitor
+{
+private:
+    /// Number of Variables stamped with a binding
+    size_t numBindings = 0;
+
+public:
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Variable &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+
+    /// Get the number of Variables that have been stamped with a binding
+    [[nodiscard]] size_t getNumBindings() const;
+};
+
+#endif // AST_UTILS_BINDING_RESOLUTION_VISITOR_H_
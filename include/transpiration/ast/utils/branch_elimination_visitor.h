@@ -0,0 +1,103 @@
+#ifndef AST_UTILS_BRANCH_ELIMINATION_VISITOR_H_
+#define AST_UTILS_BRANCH_ELIMINATION_VISITOR_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the BranchEliminationVisitor's logic
+class SpecialBranchEliminationVisitor;
+
+/// BranchEliminationVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialBranchEliminationVisitor, PlainVisitor> BranchEliminationVisitor;
+
+/// Replaces If statements and TernaryOperators whose condition depends on secret data by oblivious multiplexers.
+/// Which conditions are secret is decided by a prior run of the SecretTaintVisitor (see getTaintedNodes()).
+///
+/// A secret `cond ? a : b` becomes `b +++ (cond *** (a --- b))`, i.e., a select with a single multiplication.
+/// Unless b is a Variable, it is bound to a temporary `T __else_N = b;` right before the enclosing statement, so that
+/// it is evaluated only once.
+/// A secret `if (cond) {...} else {...}` is flattened into straight-line code in the enclosing Block:
+///   secret T' __cond_N = cond;
+///   T v__then_N = v;  <then branch, writing to v__then_N>
+///   T v__else_N = v;  <else branch, writing to v__else_N>
+///   v = v__else_N +++ (__cond_N *** (v__then_N --- v__else_N));
+/// for every variable v declared outside the If and written in either branch, where T' is the type of the condition
+/// (e.g. double for a comparison lowered by the ComparisonLoweringVisitor). The condition is evaluated only once
+/// and every variable costs one multiplication, independent of how often it is assigned in the branches.
+/// Variables declared inside a branch are renamed, so that both branches can be flattened into the same Block.
+/// Nested secret Ifs are flattened inside-out. Ifs with a plaintext condition are kept as real control flow.
+/// Return statements inside a secret branch cannot be made oblivious and result in a runtime_error.
+class SpecialBranchEliminationVisitor : public PlainVisitor
+{
+private:
+    /// Unique node IDs of the expressions that (may) evaluate to a secret value
+    std::unordered_set<std::string> secretNodes;
+
+    /// Declared types of the variables, one map per scope (innermost scope last)
+    std::vector<std::unordered_map<std::string, Datatype>> declaredTypes;
+
+    /// Set by visit(If), the enclosing Block must replace the visited statement by these statements
+    std::vector<std::unique_ptr<AbstractStatement>> replacementStatements;
+
+    /// Set by eliminate(TernaryOperator), the enclosing Block inserts these statements before the current statement
+    std::vector<std::unique_ptr<AbstractStatement>> pendingStatements;
+
+    /// Number of multiplexers created so far, used to create fresh identifiers
+    int muxCounter = 0;
+
+    /// Eliminates the secret TernaryOperators in the expression bottom-up and, if the expression itself was one, hands
+    /// its multiplexer to replace
+    void visitExpression(
+        AbstractExpression &expr, const std::function<void(std::unique_ptr<AbstractExpression> &&)> &replace);
+
+    /// Visits the statements of the block without opening a new scope, inserts the pending temporaries and splices in
+    /// flattened Ifs
+    void visitStatements(Block &block);
+
+    /// Returns the declared type of the variable
+    /// \throws runtime_error if the variable has not been declared
+    Datatype lookupType(const std::string &identifier);
+
+    /// Returns the type that the expression evaluates to, which is secret iff the expression is a secret node
+    /// \throws runtime_error if the expression reads a variable that has not been declared
+    Datatype inferType(const AbstractExpression &expr);
+
+    /// Replaces the expression if it is a TernaryOperator with a secret condition, called bottom-up by
+    /// rewriteBottomUp()
+    /// \return The multiplexer replacing the expression, or nullptr to keep it
+    std::unique_ptr<AbstractExpression> eliminate(AbstractExpression &expr);
+    std::unique_ptr<AbstractExpression> eliminate(TernaryOperator &elem);
+
+    /// Creates the straight-line replacement for an If with a secret condition
+    std::vector<std::unique_ptr<AbstractStatement>> flatten(If &elem);
+
+public:
+    explicit SpecialBranchEliminationVisitor(std::unordered_set<std::string> secretNodes);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Assignment &elem);
+
+    void visit(Block &elem);
+
+    void visit(For &elem);
+
+    void visit(Function &elem);
+
+    void visit(If &elem);
+
+    void visit(Return &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+};
+
+#endif // AST_UTILS_BRANCH_ELIMINATION_VISITOR_H_
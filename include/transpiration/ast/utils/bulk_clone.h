@@ -0,0 +1,35 @@
+#ifndef AST_UTILS_BULK_CLONE_H_
+#define AST_UTILS_BULK_CLONE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "transpiration/ast/abstract_expression.h"
+#include "transpiration/ast/abstract_node.h"
+#include "transpiration/ast/utils/node_arena.h"
+
+/// Expressions that bulkClone() substitutes for the Variables with the given identifiers
+typedef std::unordered_map<std::string, const AbstractExpression *> Substitutions;
+
+/// Clones a subtree in a single iterative pass, e.g., the body of a loop for every iteration that is unrolled.
+/// Unlike clone(), which calls the virtual clone_impl() of every node recursively, this builds the clone bottom-up
+/// with the constructors of the concrete classes, which become the parents of their children (see adoptChild()), and
+/// copes with arbitrarily deep subtrees. Like clone(), the Variables of the clone are not bound (see setBinding()).
+///
+/// Every Variable whose identifier has a substitute is replaced by a clone of the substitute (which itself is cloned
+/// without substitutions), e.g., the induction variable of an unrolled loop by the LiteralInt of the iteration, or by
+/// another Variable to rename it, so that the clone does not need to be rewritten in a second pass.
+///
+/// Null children (e.g. removed statements of a Block) are not cloned, i.e., the clone has no null children.
+/// \param node Root of the subtree
+/// \param arena Arena to allocate the clone in (which must outlive it), or nullptr to allocate it on the heap
+/// \param substitutions Substitutes by the identifier of the Variables they replace
+/// \return The clone, which has no parent
+/// \throws std::runtime_error if a Variable that is the target of a VariableDeclaration would be substituted by an
+/// expression that is not a Variable, or the target of an Assignment or IndexAccess by one that is not an
+/// AbstractTarget
+std::unique_ptr<AbstractNode> bulkClone(
+    const AbstractNode &node, NodeArena *arena = nullptr, const Substitutions &substitutions = {});
+
+#endif // AST_UTILS_BULK_CLONE_H_
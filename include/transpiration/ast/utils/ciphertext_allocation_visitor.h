@@ -0,0 +1,118 @@
+#ifndef AST_UTILS_CIPHERTEXT_ALLOCATION_VISITOR_H_
+#define AST_UTILS_CIPHERTEXT_ALLOCATION_VISITOR_H_
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/utils/scoped_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the CiphertextAllocationVisitor's logic
+class SpecialCiphertextAllocationVisitor;
+
+/// CiphertextAllocationVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialCiphertextAllocationVisitor> CiphertextAllocationVisitor;
+
+/// Positions (in program order) of the first and the last statement during which a value must be kept
+struct LiveInterval
+{
+    size_t start;
+    size_t end;
+};
+
+/// Assigns the ciphertext variables of a Function to as few ciphertext buffers as possible, like a register allocator:
+///  - A liveness analysis numbers the statements in program order and computes the interval from the first to the
+///    last occurrence of each variable. A variable that is declared outside of a loop but occurs inside of it lives
+///    during the whole loop, since a later iteration might still read it.
+///  - A linear scan over the intervals then reuses the buffer of a variable as soon as its interval has ended.
+///    A variable whose interval starts where another one ends takes over that buffer, preferably the one of the
+///    left-most operand it is computed from, such that its first operation can be performed in place.
+/// The number of buffers is the maximum number of simultaneously live ciphertexts, independently of the number of
+/// variable declarations. Secret parameters keep their own identifiers as buffers.
+/// Variables are told apart by their declaration (ScopedIdentifier), not by their identifier, since all buffers live in
+/// the scope of the Function: a variable that shadows another one gets a buffer of its own while the other one is live.
+class SpecialCiphertextAllocationVisitor : public ScopedVisitor
+{
+private:
+    /// Identifiers of the variables that hold ciphertexts
+    std::unordered_set<std::string> cipherVariables;
+
+    /// The secret parameters
+    std::vector<ScopedIdentifier> parameters;
+
+    /// Position of the current statement
+    size_t position = 0;
+
+    /// Indices (into loopIntervals) of the loops enclosing the current statement, outermost first
+    std::vector<size_t> openLoops;
+
+    /// Positions spanned by each loop
+    std::vector<LiveInterval> loopIntervals;
+
+    /// Loop nesting depth at which each variable is declared
+    std::unordered_map<ScopedIdentifier, size_t> declarationDepths;
+
+    /// Variables that must live during a whole loop (index into loopIntervals)
+    std::vector<std::pair<ScopedIdentifier, size_t>> loopCarried;
+
+    std::unordered_map<ScopedIdentifier, LiveInterval> intervals;
+
+    /// Variable written by the current statement, or nullptr
+    const ScopedIdentifier *currentTarget = nullptr;
+
+    /// The first variable read by the statement at each position, i.e., its left-most operand
+    std::unordered_map<size_t, ScopedIdentifier> firstReads;
+
+    /// Every occurrence of a ciphertext variable in the visited Function, with the declaration it refers to
+    std::vector<std::pair<Variable *, ScopedIdentifier>> occurrences;
+
+    /// Buffer of each variable, computed by allocate()
+    std::unordered_map<ScopedIdentifier, std::string> buffers;
+
+    size_t bufferCount = 0;
+
+    /// Records an occurrence of the variable at the current position
+    void occurs(const ScopedIdentifier &scopedIdentifier);
+
+    [[nodiscard]] bool isParameter(const ScopedIdentifier &scopedIdentifier) const;
+
+public:
+    /// \param cipherVariables Identifiers of the variables that hold ciphertexts
+    explicit SpecialCiphertextAllocationVisitor(std::unordered_set<std::string> cipherVariables);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Assignment &elem);
+
+    void visit(Block &elem);
+
+    void visit(For &elem);
+
+    void visit(FunctionParameter &elem);
+
+    void visit(Variable &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+
+    /// Live intervals of all ciphertext variables, including the extensions over loops
+    /// \return The intervals by declaration
+    const std::unordered_map<ScopedIdentifier, LiveInterval> &getIntervals();
+
+    /// Runs the linear scan over the intervals of the visited Function
+    /// \return The buffer of each ciphertext variable, either a secret parameter's identifier or __ct_<k>
+    const std::unordered_map<ScopedIdentifier, std::string> &allocate();
+
+    /// Renames every occurrence of a ciphertext variable in the visited Function to the buffer that allocate() assigned
+    /// to its declaration
+    void assignBuffers();
+
+    /// Number of buffers used by allocate(), including the secret parameters
+    [[nodiscard]] size_t getBufferCount() const;
+};
+
+#endif // AST_UTILS_CIPHERTEXT_ALLOCATION_VISITOR_H_
@@ -0,0 +1,102 @@
+#ifndef AST_UTILS_COMPARISON_LOWERING_VISITOR_H_
+#define AST_UTILS_COMPARISON_LOWERING_VISITOR_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/polynomial_approximation.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the ComparisonLoweringVisitor's logic
+class SpecialComparisonLoweringVisitor;
+
+/// ComparisonLoweringVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialComparisonLoweringVisitor, PlainVisitor> ComparisonLoweringVisitor;
+
+/// Replaces relational BinaryExpressions (<, <=, >, >=, ==, !=) on secret reals (float/double) by polynomial
+/// approximations that can be evaluated on CKKS ciphertexts. With s ~ sign(x) being a SignApproximation:
+///   a < b, a <= b  ->  0.5 + 0.5 * s((b - a) / bound)
+///   a > b, a >= b  ->  0.5 + 0.5 * s((a - b) / bound)
+///   a == b         ->  1 - s((a - b) / bound)^2
+///   a != b         ->  s((a - b) / bound)^2
+/// i.e., the result is (approximately) 0 or 1 and can be used directly by the BranchEliminationVisitor.
+/// The scaled difference and all intermediate powers are declared as temporaries right before the statement that
+/// contains the comparison. Conditions of For loops are left untouched, since they are evaluated once per iteration.
+/// Which operands are secret is decided by a prior run of the SecretTaintVisitor (see getTaintedNodes()).
+class SpecialComparisonLoweringVisitor : public PlainVisitor
+{
+private:
+    /// Unique node IDs of the expressions that (may) evaluate to a secret value
+    std::unordered_set<std::string> secretNodes;
+
+    /// Configuration used for comparisons without a call-site specific configuration
+    ApproximationConfig defaultConfig;
+
+    /// Call-site specific configurations, indexed by the unique node ID of the BinaryExpression
+    std::unordered_map<std::string, ApproximationConfig> callSiteConfigs;
+
+    /// Declared types of the variables, one map per scope (innermost scope last)
+    std::vector<std::unordered_map<std::string, Datatype>> declaredTypes;
+
+    /// Expressions of the current statement that involve a float or double value, see markReal()
+    std::unordered_set<const AbstractNode *> realNodes;
+
+    /// Set when lowering a comparison, the enclosing Block inserts these statements before the current statement
+    std::vector<std::unique_ptr<AbstractStatement>> pendingStatements;
+
+    /// Number of comparisons lowered so far, used to create fresh identifiers
+    int comparisonCounter = 0;
+
+    /// Lowers the comparisons in the expression bottom-up and, if the expression itself was a lowered comparison, hands
+    /// its replacement to replace
+    void visitExpression(
+        AbstractExpression &expr, const std::function<void(std::unique_ptr<AbstractExpression> &&)> &replace);
+
+    /// Visits the statements of the block without opening a new scope and inserts the pending temporaries
+    void visitStatements(Block &block);
+
+    /// Records in realNodes whether the expression involves a float or double value, which must already be recorded for
+    /// its children. Unrolled programs nest expressions too deep to recurse into them for every comparison.
+    void markReal(const AbstractNode &node);
+
+    /// Lowers the expression if it is a comparison on secret reals, called bottom-up by rewriteBottomUp()
+    /// \return The polynomial approximation replacing the expression, or nullptr to keep it
+    std::unique_ptr<AbstractExpression> lowerComparison(AbstractExpression &expr);
+    std::unique_ptr<AbstractExpression> lowerComparison(BinaryExpression &elem);
+
+    /// Creates the polynomial approximation of the comparison
+    std::unique_ptr<AbstractExpression> lower(BinaryExpression &elem);
+
+public:
+    /// \param secretNodes Unique node IDs of the secret expressions, see SecretTaintVisitor::getTaintedNodes()
+    /// \param defaultConfig Precision/depth trade-off for all comparisons without a call-site specific configuration
+    /// \param callSiteConfigs Precision/depth trade-off per comparison, indexed by unique node ID
+    explicit SpecialComparisonLoweringVisitor(
+        std::unordered_set<std::string> secretNodes, ApproximationConfig defaultConfig = ApproximationConfig(),
+        std::unordered_map<std::string, ApproximationConfig> callSiteConfigs = {});
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Assignment &elem);
+
+    void visit(Block &elem);
+
+    void visit(For &elem);
+
+    void visit(Function &elem);
+
+    void visit(If &elem);
+
+    void visit(Return &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+};
+
+#endif // AST_UTILS_COMPARISON_LOWERING_VISITOR_H_
@@ -0,0 +1,171 @@
+#ifndef AST_UTILS_COMPILER_PIPELINE_H_
+#define AST_UTILS_COMPILER_PIPELINE_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "transpiration/ast/utils/function_cache.h"
+#include "transpiration/ast/utils/program_cache.h"
+#include "transpiration/ast/utils/seal_emitter_visitor.h"
+#include "transpiration/runtime/cost_table.h"
+
+namespace mlir
+{
+class MLIRContext;
+} // namespace mlir
+
+/// Wall time and memory of one phase of the CompilerPipeline, summed over all Functions it ran for
+struct PhaseReport
+{
+    std::string name;
+
+    double milliseconds = 0;
+
+    /// Peak resident set size of the process at the end of the phase, i.e., the maximum over this and all earlier
+    /// phases (and anything the process did before)
+    size_t peakResidentBytes = 0;
+};
+
+/// What compiling a single program cost, see CompilerPipeline::compile()
+struct CompilationReport
+{
+    /// In the order they ran
+    std::vector<PhaseReport> phases;
+
+    size_t sourceBytes = 0;
+    size_t tokens = 0;
+
+    /// Number of nodes of the AST right after parsing and after the AST passes
+    size_t parsedNodes = 0;
+    size_t loweredNodes = 0;
+
+    /// Number of Variables stamped with their declaration during scoping
+    size_t resolvedIdentifiers = 0;
+
+    /// Number of operations of the MLIR module (excluding the module itself) after lowering and after the passes
+    size_t mlirOperations = 0;
+    size_t optimizedMlirOperations = 0;
+
+    size_t emittedBytes = 0;
+
+    /// How much each counter of the CompilerStatistics increased while compiling, e.g., nodes_allocated or
+    /// functions_reused
+    std::map<std::string, size_t> counters;
+
+    [[nodiscard]] double totalMilliseconds() const;
+
+    /// The report as JSON, e.g. for benchmark dashboards:
+    ///   { "phases": [ { "name": "tokenize", "ms": 1.5, "peak_rss_bytes": 12582912 }, ... ], "total_ms": 42.0,
+    ///     "counts": { "source_bytes": 1024, "tokens": 300, "parsed_nodes": 120, ... },
+    ///     "counters": { "nodes_allocated": 2400, "scopes_created": 12, ... } }
+    [[nodiscard]] nlohmann::json toJson() const;
+};
+
+/// Runs the complete compiler on a program given as source code, one phase after the other:
+///  - tokenize: splits the source into tokens (Parser::tokenize),
+///  - parse: builds the AST from the tokens, whose nodes become the parents of their children as they are built,
+///  - scoping: builds the Scopes of the AST and stamps every Variable with its declaration (BindingResolutionVisitor),
+///    so that the first SecretTaintVisitor, which continues with these Scopes, does not resolve any Variable by name,
+///  - ast-passes: runs the lowering passes on the AST, i.e., SecretTaintVisitor, ComparisonLoweringVisitor,
+///    BranchEliminationVisitor, LayoutPlanningVisitor and RotationSchedulingVisitor,
+///  - ast-to-mlir: lowers the lowered AST into the SSA-valued ops of the ast dialect (AbcAstToSsaVisitor) in a
+///    ModuleOp,
+///  - mlir-passes: runs the MLIR pass pipeline (hoist-rotations) on the module,
+///  - emit: translates the lowered AST into SEAL code (SealEmitterVisitor), computing the rotations that the
+///    hoist-rotations pass grouped together (see collectHoistedRotations()).
+/// Every phase is timed separately, which is what the compile-time benchmarks in test/bench are built on. If timing is
+/// enabled in the CompilerStatistics, the phases are also recorded there, with the phases of the Parser, the visitors
+/// and every MLIR pass nested into them.
+///
+/// A program that consists of Functions only is compiled one Function at a time, i.e., all phases after parsing run
+/// for every Function on its own. Before, the phase program-taint runs a SecretTaintVisitor on the whole program, which
+/// marks the parameters that receive secret arguments as secret and finds the functions that return a secret value,
+/// which are declared to the SecretTaintVisitors of every Function (which is all a Function depends on, see
+/// CompiledFunction). With a FunctionCache, a Function is only compiled if the cache has no Function with the same
+/// structural hash (see structural_hash.h, including its secret parameters), the same options and callees with the
+/// same secret signatures, e.g., recompiling a program after editing one of its Functions only compiles that one (and
+/// the Functions whose secret parameters or secret callees changed with it). Looking up the Functions is the phase
+/// cache-lookup.
+/// With a ProgramCache, a program that has been compiled before with the same options and VERSION is not compiled at
+/// all, i.e., compile() only runs the phase program-cache-lookup.
+///
+/// The compiler is single-threaded: the CompilerStatistics (and thus the counters of every Parser, visitor and Scope)
+/// are process-wide and not synchronized, so are the caches. What compile() leaves behind in the process is bounded,
+/// though: the identifiers of the program are interned in a SymbolTable of its own (see SymbolTable::Context), which
+/// is released when compile() returns, and only the IDs of Scopes (a 64-bit counter) keep growing.
+class CompilerPipeline
+{
+private:
+    ParameterSpec spec;
+
+    bool parallel;
+
+    bool passTimingReport = false;
+
+    /// Latencies that the LayoutPlanningVisitor weighs rotations and multiplications with, if any
+    std::optional<CostTable> costTable;
+
+    FunctionCache *cache = nullptr;
+
+    ProgramCache *programCache = nullptr;
+
+    /// Runs the phases after parsing on a Function in a Block of its own, or on a whole program
+    /// \param ast The Block or program, which is lowered in place
+    /// \param secretFunctions The functions of the program that return a secret value
+    /// \param prologue Whether the emitted code starts with the prologue of the translation unit
+    /// \param context The context of the ast dialect
+    /// \param report Report whose phases are extended
+    /// \return The emitted code and counts of the AST
+    CompiledFunction compileUnit(
+        AbstractNode &ast, const std::unordered_set<std::string> &secretFunctions, bool prologue,
+        mlir::MLIRContext &context, CompilationReport &report) const;
+
+    /// Hash of everything but the program (or Function) that the emitted code depends on, i.e., the VERSION and the
+    /// options (including the cost table)
+    [[nodiscard]] uint64_t optionsHash() const;
+
+public:
+    /// Version of the emitted code, which is part of the key of every cached Function and program, i.e., cached
+    /// Functions and programs of earlier versions are not reused. Must change with every change of the emitted code.
+    static const char *const VERSION;
+
+    /// \param spec Encryption parameters that the emitted code is written for
+    /// \param parallel Whether the emitted code runs independent operations concurrently (see SealEmitterVisitor)
+    explicit CompilerPipeline(ParameterSpec spec = ParameterSpec(), bool parallel = false);
+
+    /// Prints MLIR's pass timing report (with the analyses and the nesting of the pass pipeline) to stderr, once the
+    /// MLIR passes have run
+    void enablePassTimingReport(bool enabled = true);
+
+    /// Chooses the layouts of secret arrays by the latencies of rotations and multiplications measured for the target
+    /// machine (see LayoutPlanningVisitor::useCostTable), instead of weighing them equally
+    /// \param costs The cost table, e.g. CostTable::load() of a table written by the benchmarks in test/bench
+    void setCostTable(CostTable costs);
+
+    /// Reuses the Functions of earlier compilations that are in the cache and adds the others to it
+    /// \param functionCache The cache, which must outlive the pipeline, or nullptr to compile every Function
+    void setFunctionCache(FunctionCache *functionCache);
+
+    /// Reuses the programs of earlier compilations that are in the cache and adds the others to it
+    /// \param cache The cache, which must outlive the pipeline, or nullptr to compile every program
+    void setProgramCache(ProgramCache *cache);
+
+    /// Compiles a program and writes the emitted SEAL code to output
+    /// \param source The program given as string in a C++-like syntax
+    /// \param output Stream the emitted translation unit is written to
+    /// \return The time, memory and sizes of all phases
+    /// \throws runtime_error if the program cannot be parsed, lowered or emitted
+    CompilationReport compile(std::string source, std::ostream &output) const;
+
+    /// Number of nodes of an AST, including the root
+    static size_t countNodes(AbstractNode &root);
+};
+
+#endif // AST_UTILS_COMPILER_PIPELINE_H_
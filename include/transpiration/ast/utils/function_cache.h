@@ -0,0 +1,89 @@
+#ifndef AST_UTILS_FUNCTION_CACHE_H_
+#define AST_UTILS_FUNCTION_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+/// What the CompilerPipeline produced for a single Function, which only depends on the Function itself (with the
+/// parameters that the whole program makes secret), the options of the pipeline and the secret signatures of the
+/// functions it calls, i.e., whether they return a secret value and which of their parameters are secret
+struct CompiledFunction
+{
+    /// The emitted SEAL code of the Function, without the prologue of the translation unit (see SealEmitterVisitor)
+    std::string code;
+
+    /// Does the Function (may) return a secret value? Calls to it are secret if so.
+    bool returnsSecret = false;
+
+    /// The counts of the CompilationReport for this Function
+    size_t resolvedIdentifiers = 0;
+    size_t mlirOperations = 0;
+    size_t optimizedMlirOperations = 0;
+    size_t loweredNodes = 0;
+
+    [[nodiscard]] nlohmann::json toJson() const;
+
+    /// \throws nlohmann::json::exception if the JSON is not a CompiledFunction
+    static CompiledFunction fromJson(const nlohmann::json &j);
+};
+
+/// Compiled Functions by a key derived from their structural hash (see structural_hash.h), such that the
+/// CompilerPipeline only compiles the Functions of a program that changed since it was last compiled. The cache lives
+/// in memory, e.g. of a compiler that runs as a service, and optionally in a directory with one file per Function,
+/// e.g. to share it between runs of transpiration-compile. Entries are never evicted. The compiler is single-threaded
+/// (see CompilerPipeline), so is this class, but several processes can share the same directory.
+class FunctionCache
+{
+private:
+    std::unordered_map<uint64_t, CompiledFunction> functions;
+
+    /// Directory the Functions are persisted in, or empty if they only live in memory
+    std::string directory;
+
+    size_t hits = 0;
+
+    size_t misses = 0;
+
+    [[nodiscard]] std::string pathOf(uint64_t key) const;
+
+public:
+    /// A cache that only lives in memory
+    FunctionCache() = default;
+
+    /// A cache that is also persisted in (and loaded on demand from) a directory
+    /// \param directory The directory, which is created if it does not exist
+    /// \throws std::runtime_error if the directory cannot be created
+    explicit FunctionCache(std::string directory);
+
+    /// Looks up a Function in memory and then in the directory, a file that cannot be read counts as a miss
+    /// \param key Key of the Function
+    /// \return The compiled Function, which stays valid as long as the cache, or nullptr if there is none
+    const CompiledFunction *find(uint64_t key);
+
+    /// Adds a compiled Function (replacing one with the same key) and writes it to the directory, if any. The
+    /// Function is only kept in memory if it cannot be written, i.e., the next run will compile it again.
+    /// \param key Key of the Function
+    /// \param function The compiled Function
+    void insert(uint64_t key, CompiledFunction function);
+
+    /// \return The number of Functions in memory
+    [[nodiscard]] size_t size() const;
+
+    /// \return The number of calls of find() that found a Function
+    [[nodiscard]] size_t getHits() const;
+
+    /// \return The number of calls of find() that did not
+    [[nodiscard]] size_t getMisses() const;
+};
+
+/// Writes a file such that readers, including other processes, either see its previous or its complete new contents:
+/// the contents are written to a temporary file in the same directory, which then replaces the file.
+/// \param path The file
+/// \param contents The new contents
+/// \return false if the file could not be written, in which case it is unchanged
+bool writeFileAtomically(const std::string &path, const std::string &contents);
+
+#endif // AST_UTILS_FUNCTION_CACHE_H_
@@ -0,0 +1,265 @@
+#ifndef AST_UTILS_LAYOUT_PLANNER_H_
+#define AST_UTILS_LAYOUT_PLANNER_H_
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+#include "transpiration/runtime/cost_table.h"
+
+/// How the elements of a secret array are mapped onto the slots of a ciphertext.
+/// For an n x m matrix M and a vector v of length m:
+enum class Layout
+{
+    /// M[i][j] in slot i*m + j, v[j] in slot j
+    ROW_MAJOR,
+    /// M[i][j] in slot j*n + i, v[j] in slots j*n ... j*n + n-1 (each element repeated n times)
+    COLUMN_MAJOR,
+    /// Halevi-Shoup: M[i][(i + k) % m] in slot i of the k-th ciphertext (matrices only). For the baby-step giant-step
+    /// evaluation, with k = g*b + j and b = babyStepCount(m), the client pre-rotates the k-th ciphertext by g*b slots
+    DIAGONAL,
+    /// v[j] in slots j, m + j, 2m + j, ... (the vector repeated n times, vectors only)
+    REPLICATED
+};
+
+/// String representation of enums
+std::string enumToString(const Layout layout);
+
+/// Cost of (a part of) a computation on ciphertexts, the planner minimizes rotations + multiplications
+struct LayoutCost
+{
+    size_t rotations = 0;
+    size_t multiplications = 0;
+
+    /// Cost of something that cannot be done at all
+    static LayoutCost infeasible();
+
+    [[nodiscard]] bool isInfeasible() const;
+
+    [[nodiscard]] size_t total() const;
+
+    /// Estimated latency, given the latencies of a rotation and of a (plaintext) multiplication
+    [[nodiscard]] double weighted(double rotationLatency, double multiplicationLatency) const;
+
+    LayoutCost operator+(const LayoutCost &other) const;
+};
+
+/// A secret array that is accessed via IndexAccess
+struct ArrayInfo
+{
+    std::string identifier;
+
+    /// 1 for vectors, 2 for matrices
+    size_t dimensions = 1;
+
+    /// Number of rows (matrices), or the number of copies in REPLICATED and COLUMN_MAJOR layout (vectors)
+    size_t rows = 1;
+
+    /// Number of columns (matrices) or elements (vectors)
+    size_t columns = 1;
+
+    /// Function parameters can be encoded in any layout by the client, for free
+    bool isInput = false;
+
+    /// Declared type of the array elements
+    Datatype datatype = Datatype(Type::INT, true);
+
+    /// The layouts that make sense for an array of this dimension
+    [[nodiscard]] std::vector<Layout> candidates() const;
+};
+
+/// An operation whose cost depends on the layouts of the arrays involved
+struct LayoutSite
+{
+    enum Kind
+    {
+        /// y[i] += M[i][j] * v[j] (or M[j][i] * v[j] if transposed), operands = { M, v }
+        MATRIX_VECTOR,
+        /// x[i] op y[i], operands = { x, y }
+        ELEMENTWISE
+    };
+
+    Kind kind;
+
+    /// Identifiers of the arrays involved
+    std::vector<std::string> operands;
+
+    /// Is the matrix accessed as M[j][i]?
+    bool transposed = false;
+
+    /// Is the operation a multiplication (only relevant for ELEMENTWISE)?
+    bool multiplication = false;
+
+    /// The operation itself, the operands are renamed to their converted copies within it
+    BinaryExpression *expression = nullptr;
+
+    /// Block and statement before which conversions for this site are inserted
+    Block *block = nullptr;
+    AbstractStatement *statement = nullptr;
+};
+
+/// A layout conversion that has to be inserted before a site
+struct LayoutConversion
+{
+    std::string identifier;
+    Layout from;
+    Layout to;
+    size_t site;
+    LayoutCost cost;
+};
+
+/// The result of the planning
+struct LayoutPlan
+{
+    /// Layout of every secret array
+    std::map<std::string, Layout> layouts;
+
+    /// Layout that each site needs its operands in (in the same order as LayoutSite::operands)
+    std::vector<std::vector<Layout>> siteLayouts;
+
+    /// Conversions between the layouts of the arrays and the layouts needed by the sites
+    std::vector<LayoutConversion> conversions;
+
+    /// Total cost of all sites and conversions
+    LayoutCost cost;
+};
+
+/// Forward declaration of the class that will actually implement the LayoutPlanningVisitor's logic
+class SpecialLayoutPlanningVisitor;
+
+/// LayoutPlanningVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialLayoutPlanningVisitor, PlainVisitor> LayoutPlanningVisitor;
+
+/// Decides how secret arrays (ExpressionLists accessed via IndexAccess) are packed into ciphertext slots.
+/// The visitor collects all secret arrays and recognizes matrix-vector products and elementwise operations in loop
+/// nests, whose extents are taken from loops of the form `for (int i = 0; i < N; ...)`. plan() then chooses a layout
+/// per array minimizing the total number of rotations plus multiplications over all sites (weighted by their measured
+/// latencies if a CostTable is given, see test/bench), where a site whose operands
+/// are not in a suitable layout pays for converting them. insertConversions() materializes these conversions as
+/// masks (multiplications with 0/1 ExpressionLists) and rotate() Calls right before the loop nest of the site, and
+/// renames the array within the loop nest to the converted copy.
+class SpecialLayoutPlanningVisitor : public PlainVisitor
+{
+private:
+    /// Unique node IDs of the expressions that (may) evaluate to a secret value
+    std::unordered_set<std::string> secretNodes;
+
+    /// Number of slots of a ciphertext
+    size_t slots;
+
+    /// Weights of rotations and multiplications in the cost of a plan
+    double rotationLatency = 1;
+    double multiplicationLatency = 1;
+
+    /// Is cost a cheaper than cost b?
+    [[nodiscard]] bool isCheaper(const LayoutCost &a, const LayoutCost &b) const;
+
+    /// Extent of loops whose bounds are not literals
+    size_t defaultExtent;
+
+    /// All secret arrays, by identifier
+    std::map<std::string, ArrayInfo> arrays;
+
+    /// All recognized sites
+    std::vector<LayoutSite> sites;
+
+    /// Declared types of all variables (by identifier)
+    std::unordered_map<std::string, Datatype> declaredTypes;
+
+    /// Identifiers of the function parameters
+    std::unordered_set<std::string> parameters;
+
+    /// Enclosing loops: loop variable, extent, block and For statement
+    struct LoopFrame
+    {
+        std::string variable;
+        size_t extent;
+        Block *block;
+        AbstractStatement *statement;
+    };
+    std::vector<LoopFrame> loops;
+
+    /// The Block and statement that are currently visited
+    Block *currentBlock = nullptr;
+    AbstractStatement *currentStatement = nullptr;
+
+    /// The plan, once it has been computed
+    std::unique_ptr<LayoutPlan> plan_;
+
+    /// Extent of the given loop variable
+    size_t extentOf(const std::string &loopVariable);
+
+    /// Registers (or updates) a secret array
+    ArrayInfo &registerArray(const std::string &identifier, size_t dimensions, size_t rows, size_t columns);
+
+    /// Adds a site, with conversions inserted before the outermost loop over one of the given loop variables
+    void addSite(LayoutSite site, const std::vector<std::string> &loopVariables);
+
+    /// Registers the secret array accessed by x[i] or x[i][j], called with every IndexAccess
+    void registerAccess(IndexAccess &elem);
+
+    /// Adds the site of x[i] op y[i] or M[i][j] * v[j], called with every BinaryExpression after its operands
+    void planSite(BinaryExpression &elem);
+
+    /// Cheapest cost of the site given the layouts of all arrays, with the layouts the operands are needed in
+    LayoutCost siteCost(const LayoutSite &site, const std::map<std::string, Layout> &layouts,
+                        std::vector<Layout> *operandLayouts = nullptr);
+
+public:
+    /// \param secretNodes Unique node IDs of the secret expressions, see SecretTaintVisitor::getTaintedNodes()
+    /// \param slots Number of slots of a ciphertext
+    /// \param defaultExtent Assumed extent of loops whose bounds are not known at compile time
+    explicit SpecialLayoutPlanningVisitor(
+        std::unordered_set<std::string> secretNodes, size_t slots = 4096, size_t defaultExtent = 16);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    /// Registers the arrays and plans the sites of the expression and its subexpressions in a single walk() (see
+    /// static_visitor.h), since unrolled programs nest expressions too deep to visit them recursively
+    void visit(AbstractExpression &elem);
+
+    void visit(Block &elem);
+
+    void visit(For &elem);
+
+    void visit(FunctionParameter &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+
+    /// Number of baby steps b = ceil(sqrt(m)) of the diagonal matrix-vector product, there are ceil(m / b) giant steps
+    static size_t babyStepCount(size_t m);
+
+    /// Cost of a matrix-vector product of an n x m matrix with the operands in the given layouts
+    static LayoutCost matrixVectorCost(Layout matrix, Layout vector, size_t n, size_t m);
+
+    /// Cost of converting the array from one layout into another
+    static LayoutCost conversionCost(Layout from, Layout to, const ArrayInfo &array);
+
+    /// Weighs rotations and multiplications by their latencies for the parameters of the table, instead of equally
+    void useCostTable(const CostTable &costs);
+
+    /// Get the secret arrays found while visiting
+    [[nodiscard]] const std::map<std::string, ArrayInfo> &getArrays() const;
+
+    /// Get the sites found while visiting
+    [[nodiscard]] const std::vector<LayoutSite> &getSites() const;
+
+    /// Chooses the layouts of all secret arrays (exhaustively for up to 8 arrays, by coordinate descent otherwise)
+    /// \return The plan with minimal (weighted) rotations + multiplications
+    /// \throws runtime_error if a secret array does not fit into a ciphertext
+    const LayoutPlan &plan();
+
+    /// Inserts the conversions of the plan into the visited AST
+    /// \throws runtime_error if the plan requires a conversion that cannot be expressed
+    void insertConversions();
+};
+
+#endif // AST_UTILS_LAYOUT_PLANNER_H_
@@ -0,0 +1,81 @@
+#ifndef AST_UTILS_NODE_ARENA_H_
+#define AST_UTILS_NODE_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// Region that AST nodes can be allocated in, e.g., by bulkClone() (see bulk_clone.h): allocating a node only bumps a
+/// pointer into the current chunk of the arena instead of calling into the heap.
+///
+/// The nodes of an arena are owned like any other node, i.e., by their parent or by a std::unique_ptr, and deleted
+/// the usual way. Deleting a node does not release its memory though, the chunks are released all at once when the
+/// arena is destroyed, which therefore must outlive all of its nodes. AbstractNode::operator delete recognizes the
+/// nodes of an arena by the chunk they are in, since the chunks are aligned to their size.
+/// The compiler is single-threaded, so is this class.
+class NodeArena
+{
+private:
+    /// Chunks of CHUNK_SIZE bytes each, the current one last
+    std::vector<void *> chunks;
+
+    /// Next free byte in the current chunk
+    char *next = nullptr;
+
+    /// End of the current chunk
+    char *end = nullptr;
+
+    /// Bytes of the nodes that were allocated and not deleted yet
+    size_t liveBytes = 0;
+
+public:
+    /// Size and alignment of the chunks, which limits the size of a node
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    NodeArena() = default;
+
+    /// Releases the memory of all nodes, which must have been deleted already
+    ~NodeArena();
+
+    NodeArena(const NodeArena &other) = delete;
+
+    NodeArena &operator=(const NodeArena &other) = delete;
+
+    /// Allocates memory for a node (see AbstractNode::operator new), suitably aligned for any node
+    /// \param size Bytes of the node
+    /// \return The memory
+    /// \throws std::invalid_argument if size exceeds CHUNK_SIZE
+    void *allocate(size_t size);
+
+    /// Called by AbstractNode::operator delete for the nodes of this arena. The memory is only reused once the arena is
+    /// destroyed.
+    /// \param size Bytes of the node
+    void deallocate(size_t size);
+
+    /// Finds the arena that a node was allocated in
+    /// \param pointer Any node
+    /// \return The arena of the node, or nullptr if it was allocated on the heap
+    static NodeArena *find(const void *pointer);
+
+    /// \return The bytes of the nodes of this arena that have not been deleted yet
+    [[nodiscard]] size_t getLiveBytes() const;
+
+    /// \return The bytes of the chunks of this arena
+    [[nodiscard]] size_t getReservedBytes() const;
+
+    /// Creates a node in an arena, or on the heap
+    /// \tparam T Concrete class of the node
+    /// \param arena Arena to allocate the node in, or nullptr to allocate it on the heap
+    /// \param args Arguments of a constructor of T
+    /// \return The new node
+    template <typename T, typename... Args>
+    static std::unique_ptr<T> make(NodeArena *arena, Args &&...args)
+    {
+        if (arena)
+            return std::unique_ptr<T>(new (*arena) T(std::forward<Args>(args)...));
+        return std::make_unique<T>(std::forward<Args>(args)...);
+    }
+};
+
+#endif // AST_UTILS_NODE_ARENA_H_
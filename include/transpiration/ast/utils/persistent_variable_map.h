@@ -0,0 +1,454 @@
+#ifndef AST_UTILS_PERSISTENT_VARIABLE_MAP_H_
+#define AST_UTILS_PERSISTENT_VARIABLE_MAP_H_
+
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/utils/scope.h"
+
+/// A VariableMap with structural sharing, for analyses that fork their state at every If/For and merge it afterwards.
+/// The entries are stored in a hash array mapped trie (HAMT) whose nodes are shared between copies: an update copies
+/// only the shared nodes on the path from the root to the entry (at most 13 nodes of up to 32 children) and modifies
+/// nodes that are not shared in place, so copying the map (and fork()) is O(1) and two maps forked from each other
+/// share all entries that neither of them changed.
+/// merge() only looks at the entries changed since the fork, i.e., it costs as much as the diff, not the map. Merging a
+/// fork back into the map it was forked from (without changes since) only looks at the entries changed in the fork:
+///   auto branch = variables.fork();
+///   ... (analyse the branch on its fork)
+///   variables.merge(branch, join);
+///   auto thenBranch = variables.fork(), elseBranch = variables.fork();
+///   ... (analyse the branches on their own forks)
+///   thenBranch.merge(elseBranch, [](const T &a, const T &b) { return join(a, b); });
+///   variables = std::move(thenBranch);
+template <typename T>
+class PersistentVariableMap
+{
+public:
+    typedef std::pair<ScopedIdentifier, T> Entry;
+
+private:
+    /// Bits of the hash consumed per level, i.e., an inner node has up to 2^BITS children
+    static constexpr unsigned BITS = 5;
+
+    /// Depth of the leaves that are never split, i.e., that hold all entries whose hashes agree in the first
+    /// BITS * MAX_DEPTH bits
+    static constexpr unsigned MAX_DEPTH = 64 / BITS;
+
+    /// Either an inner node (bitmap != 0) or a leaf (bitmap == 0). Nodes are never modified while they are shared.
+    struct Node
+    {
+        /// Which of the 2^BITS children of an inner node exist
+        uint32_t bitmap = 0;
+
+        /// The existing children of an inner node, in the order of their bits
+        std::vector<std::shared_ptr<const Node>> children;
+
+        /// Hash of the entries of a leaf (of all but the leaves at MAX_DEPTH, whose entries only share a prefix)
+        uint64_t hash = 0;
+
+        /// The entries of a leaf, more than one only if their hashes collide
+        std::vector<Entry> entries;
+    };
+
+    std::shared_ptr<const Node> root;
+
+    size_t numEntries = 0;
+
+    /// The entries that have been updated since the last resetChangeFlags() or fork()
+    std::unordered_set<ScopedIdentifier> changed;
+
+    /// The root of the map this map was forked from, at the time of the fork. Since it stays shared, a map whose root
+    /// is still this node has not changed since.
+    std::shared_ptr<const Node> forkedFrom;
+
+    /// std::hash<ScopedIdentifier> with the bits mixed (splitmix64's finalizer), since the trie consumes them in order
+    static uint64_t hashOf(const ScopedIdentifier &s)
+    {
+        uint64_t h = std::hash<ScopedIdentifier>{}(s);
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    static uint32_t bitOf(uint64_t hash, unsigned depth)
+    {
+        return uint32_t(1) << ((hash >> (BITS * depth)) & ((1u << BITS) - 1));
+    }
+
+    /// Index of the child for bit in the children of a node with the given bitmap
+    static size_t positionOf(uint32_t bitmap, uint32_t bit)
+    {
+        return std::bitset<32>(bitmap & (bit - 1)).count();
+    }
+
+    /// The node itself if no other map (or node) shares it, a copy otherwise. Like the rest of the compiler, this is
+    /// not thread-safe, i.e., forks must not be modified concurrently.
+    static std::shared_ptr<Node> edit(const std::shared_ptr<const Node> &node)
+    {
+        if (node.use_count() == 1)
+            return std::const_pointer_cast<Node>(node);
+        return std::make_shared<Node>(*node);
+    }
+
+    [[nodiscard]] const T *find(const ScopedIdentifier &s) const
+    {
+        auto hash = hashOf(s);
+        const Node *node = root.get();
+        for (unsigned depth = 0; node != nullptr; ++depth)
+        {
+            if (node->bitmap == 0)
+            {
+                for (auto &entry : node->entries)
+                {
+                    if (std::equal_to<ScopedIdentifier>{}(entry.first, s))
+                        return &entry.second;
+                }
+                return nullptr;
+            }
+            auto bit = bitOf(hash, depth);
+            if (!(node->bitmap & bit))
+                return nullptr;
+            node = node->children[positionOf(node->bitmap, bit)].get();
+        }
+        return nullptr;
+    }
+
+    /// \return node (or its copy, if shared) at the given depth with the entry inserted, or assigned if assign is true
+    static std::shared_ptr<const Node> insert(
+        const std::shared_ptr<const Node> &node, uint64_t hash, unsigned depth, Entry &&entry, bool assign, bool &added)
+    {
+        if (!node)
+        {
+            auto leaf = std::make_shared<Node>();
+            leaf->hash = hash;
+            leaf->entries.push_back(std::move(entry));
+            added = true;
+            return leaf;
+        }
+
+        if (node->bitmap == 0)
+        {
+            if (node->hash == hash || depth == MAX_DEPTH)
+            {
+                for (size_t i = 0; i < node->entries.size(); ++i)
+                {
+                    if (std::equal_to<ScopedIdentifier>{}(node->entries[i].first, entry.first))
+                    {
+                        if (!assign)
+                            return node;
+                        auto leaf = edit(node);
+                        leaf->entries[i].second = std::move(entry.second);
+                        return leaf;
+                    }
+                }
+                auto leaf = edit(node);
+                leaf->entries.push_back(std::move(entry));
+                added = true;
+                return leaf;
+            }
+
+            // the hashes differ in a later level: push the leaf one level down, below a new inner node
+            auto inner = std::make_shared<Node>();
+            inner->bitmap = bitOf(node->hash, depth);
+            inner->children.push_back(node);
+            return insert(inner, hash, depth, std::move(entry), assign, added);
+        }
+
+        auto bit = bitOf(hash, depth);
+        auto position = positionOf(node->bitmap, bit);
+        auto copy = edit(node);
+        if (copy->bitmap & bit)
+        {
+            copy->children[position] =
+                insert(copy->children[position], hash, depth + 1, std::move(entry), assign, added);
+        }
+        else
+        {
+            copy->bitmap |= bit;
+            copy->children.insert(copy->children.begin() + position,
+                                  insert(nullptr, hash, depth + 1, std::move(entry), assign, added));
+        }
+        return copy;
+    }
+
+    /// \return node (or its copy, if shared) at the given depth without the entry for s, which must exist in node,
+    /// or nullptr if nothing remains
+    static std::shared_ptr<const Node> remove(
+        const std::shared_ptr<const Node> &node, uint64_t hash, unsigned depth, const ScopedIdentifier &s)
+    {
+        if (node->bitmap == 0)
+        {
+            if (node->entries.size() == 1)
+                return nullptr;
+            auto leaf = edit(node);
+            for (auto it = leaf->entries.begin(); it != leaf->entries.end(); ++it)
+            {
+                if (std::equal_to<ScopedIdentifier>{}(it->first, s))
+                {
+                    leaf->entries.erase(it);
+                    break;
+                }
+            }
+            return leaf;
+        }
+
+        // the node is copied before its child, whose copy (if shared) it then holds
+        auto bit = bitOf(hash, depth);
+        auto position = positionOf(node->bitmap, bit);
+        auto copy = edit(node);
+        auto child = remove(copy->children[position], hash, depth + 1, s);
+        if (child)
+        {
+            copy->children[position] = std::move(child);
+        }
+        else
+        {
+            copy->bitmap &= ~bit;
+            copy->children.erase(copy->children.begin() + position);
+            if (copy->bitmap == 0)
+                return nullptr;
+        }
+        return copy;
+    }
+
+    void put(const ScopedIdentifier &s, T &&v, bool assign)
+    {
+        // an existing entry would not change, but its path would still be copied
+        if (!assign && has(s))
+        {
+            changed.insert(s);
+            return;
+        }
+        bool added = false;
+        root = insert(root, hashOf(s), 0, Entry(s, std::move(v)), assign, added);
+        if (added)
+            ++numEntries;
+        changed.insert(s);
+    }
+
+public:
+    /// Iterates over the entries in the (arbitrary) order of their hashes
+    class const_iterator
+    {
+    private:
+        /// The path from the root to the current leaf, with the index of the child (or the entry in the leaf) taken
+        std::vector<std::pair<const Node *, size_t>> path;
+
+        /// Moves to the first entry at or after the current position, or to the end
+        void settle()
+        {
+            while (!path.empty())
+            {
+                auto node = path.back().first;
+                auto index = path.back().second;
+                if (node->bitmap == 0 && index < node->entries.size())
+                    return;
+                if (node->bitmap != 0 && index < node->children.size())
+                {
+                    path.emplace_back(node->children[index].get(), 0);
+                    continue;
+                }
+                path.pop_back();
+                if (!path.empty())
+                    ++path.back().second;
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Entry value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Entry *pointer;
+        typedef const Entry &reference;
+
+        const_iterator() = default;
+
+        explicit const_iterator(const Node *root)
+        {
+            if (root)
+            {
+                path.emplace_back(root, 0);
+                settle();
+            }
+        }
+
+        reference operator*() const
+        {
+            return path.back().first->entries[path.back().second];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator &operator++()
+        {
+            ++path.back().second;
+            settle();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return path.empty() ? other.path.empty() : !other.path.empty() && path.back() == other.path.back();
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    ~PersistentVariableMap() = default;
+
+    PersistentVariableMap() = default;
+
+    PersistentVariableMap(const PersistentVariableMap &other) = default;
+
+    PersistentVariableMap(PersistentVariableMap &&other) noexcept = default;
+
+    PersistentVariableMap &operator=(const PersistentVariableMap &other) = default;
+
+    PersistentVariableMap &operator=(PersistentVariableMap &&other) noexcept = default;
+
+    /// A copy of this map without change flags, in O(1)
+    [[nodiscard]] PersistentVariableMap fork() const
+    {
+        PersistentVariableMap fork;
+        fork.root = root;
+        fork.numEntries = numEntries;
+        fork.forkedFrom = root;
+        return fork;
+    }
+
+    /// \throws std::out_of_range if there is no entry for s
+    [[nodiscard]] const T &get(const ScopedIdentifier &s) const
+    {
+        auto value = find(s);
+        if (!value)
+            throw std::out_of_range("No entry exists for " + s.getId());
+        return *value;
+    }
+
+    /// \throws std::out_of_range if there is no entry for s
+    [[nodiscard]] const T &at(const ScopedIdentifier &s) const
+    {
+        return get(s);
+    }
+
+    [[nodiscard]] bool has(const ScopedIdentifier &s) const
+    {
+        return find(s) != nullptr;
+    }
+
+    [[nodiscard]] size_t count(const ScopedIdentifier &s) const
+    {
+        return has(s) ? 1 : 0;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return numEntries;
+    }
+
+    void erase(const ScopedIdentifier &s)
+    {
+        if (has(s))
+        {
+            root = remove(root, hashOf(s), 0, s);
+            --numEntries;
+        }
+        changed.erase(s);
+    }
+
+    /// Adds the entry unless there already is one for s
+    void add(const ScopedIdentifier &s, T v)
+    {
+        put(s, std::move(v), false);
+    }
+
+    void insert_or_assign(const ScopedIdentifier &s, T &&v)
+    {
+        put(s, std::move(v), true);
+    }
+
+    void update(const ScopedIdentifier &s, T v)
+    {
+        if (!has(s))
+            throw std::invalid_argument("Cannot update value because no entry exists");
+        put(s, std::move(v), true);
+    }
+
+    /// Merges a map that was forked from the same map as this one (or from this one, without changes since). Only the
+    /// entries changed in either map since the fork are looked at: an entry that exists in both becomes
+    /// combine(this value, other value) and one that only exists in other (e.g., a variable declared in a branch) is
+    /// taken over. Entries that were erased from either map are not merged back. The merged entries are marked as
+    /// changed in this map, such that merging this map into the one it was forked from includes them.
+    /// If other was forked from this map and this map has not changed since, only the entries changed in other are
+    /// looked at, since all others are the same in both maps, i.e., the cost does not grow with the changes of this map
+    /// (e.g., of a map that is never reset and merges one fork after the other).
+    /// \param other A fork of the same map as this one, or of this one
+    /// \param combine Joins two values of the same variable, e.g., a logical or for secret-ness, such that
+    /// combine(v, v) == v
+    template <typename F>
+    void merge(const PersistentVariableMap &other, F &&combine)
+    {
+        auto mergeEntry = [&](const ScopedIdentifier &s) {
+            auto theirs = other.find(s);
+            if (!theirs)
+                return;
+            auto ours = find(s);
+            insert_or_assign(s, ours ? T(combine(*ours, *theirs)) : T(*theirs));
+        };
+
+        if (other.forkedFrom && other.forkedFrom == root)
+        {
+            for (auto &s : other.changed)
+                mergeEntry(s);
+            return;
+        }
+
+        auto keys = changed;
+        keys.insert(other.changed.begin(), other.changed.end());
+        for (auto &s : keys)
+            mergeEntry(s);
+    }
+
+    void resetChangeFlags()
+    {
+        // clear() would keep (and clear) all buckets of the largest set of changes so far, e.g., of the initial fill
+        if (!changed.empty())
+            changed = std::unordered_set<ScopedIdentifier>();
+    }
+
+    [[nodiscard]] const std::unordered_set<ScopedIdentifier> &changedEntries() const
+    {
+        return changed;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(root.get());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+};
+
+#endif // AST_UTILS_PERSISTENT_VARIABLE_MAP_H_
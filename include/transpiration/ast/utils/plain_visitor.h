@@ -3,11 +3,16 @@
 
 #include "transpiration/ast/utils/ivisitor.h"
 #include "transpiration/ast/utils/scope.h"
+#include "transpiration/ast/utils/traversal_stack.h"
 
 /// This class implements the "default" behaviour of a visitor
 /// simply visiting a node's children
+/// The default visit() visits the children through a TraversalStack, i.e., does not recurse for every level of the AST.
 class PlainVisitor : public IVisitor
 {
+private:
+    TraversalStack traversal;
+
 public:
     ~PlainVisitor() override = default;
 
@@ -55,6 +60,7 @@ public:
 
     void visit(Variable &elem) override;
 
+    /// Visits the children of elem, which have all been visited when this returns
     void visitChildren(AbstractNode &elem);
 };
 
@@ -0,0 +1,292 @@
+#ifndef AST_UTILS_PLAINTEXT_INTERPRETER_H_
+#define AST_UTILS_PLAINTEXT_INTERPRETER_H_
+
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/utils/scoped_visitor.h"
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+#include "transpiration/ast/utils/variable_map.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the PlaintextInterpreter's logic
+class SpecialPlaintextInterpreter;
+
+/// PlaintextInterpreter uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialPlaintextInterpreter> PlaintextInterpreter;
+
+/// Value of a variable or an expression during interpretation: either a scalar or an array, i.e., the slots of a
+/// (ciphertext) vector
+struct PlainValue
+{
+    double scalar = 0;
+
+    /// Elements of an array, empty for scalars
+    std::vector<double> elements;
+
+    bool isArray = false;
+
+    PlainValue() = default;
+
+    PlainValue(double scalar) : scalar(scalar){};
+
+    PlainValue(std::vector<double> elements) : elements(std::move(elements)), isArray(true){};
+
+    /// Element i, where a scalar is broadcast to all elements and arrays are padded with zeros
+    [[nodiscard]] double at(size_t i) const
+    {
+        return isArray ? (i < elements.size() ? elements[i] : 0) : scalar;
+    }
+
+    /// The value as a condition, where the condition of an array lives in its first slot
+    [[nodiscard]] bool isTrue() const
+    {
+        return isArray ? !elements.empty() && elements[0] != 0 : scalar != 0;
+    }
+};
+
+/// Executes Functions on plaintext values, treating secret values as if they were in the clear. This gives a
+/// reference result for every transformation (the result of a transformed Function must not change) and a cheap
+/// estimate of the cost of a program before compiling it to FHE.
+/// Visiting a Function (or a Block of Functions) does not run it, but compiles it into a flat bytecode for a small
+/// stack machine: every identifier is resolved once, via the scopes of the ScopedVisitor, to the index of a slot in a
+/// flat array of variables, and control flow becomes jumps. run() then only executes a loop over the instructions,
+/// without any lookup by name or any recursion over the AST.
+/// Values are doubles, where operations on integers (int, bool, char) truncate like in C++. Integers are exact as long
+/// as their magnitude stays below 2^53: an integer argument, an integer +, - or * or a conversion to an integer whose
+/// result is beyond throws a runtime_error instead of rounding it, since the reference result must not be off.
+/// Arrays are vectors of slots: arithmetic operates element-wise (broadcasting scalars, padding the shorter array with
+/// zeros), nested ExpressionLists are flattened in row-major order and rotate(x, k) rotates x to the left by k slots,
+/// either cyclically over its own length or, if the slot count is given, over that many slots padded with zeros.
+/// &&, || and ?: only evaluate the operands that C++ would evaluate (an array counts as its first slot there).
+/// Only rotate can be called, strings are not supported and IndexAccesses must index a Variable.
+class SpecialPlaintextInterpreter : public ScopedVisitor
+{
+public:
+    enum class Opcode : unsigned char
+    {
+        /// push constants[operand]
+        CONSTANT,
+        /// push variables[operand]
+        LOAD,
+        /// pop a value into variables[operand]
+        STORE,
+        /// pop an index, push element index of variables[operand]
+        LOAD_INDEX,
+        /// pop a value and an index, store the value as element index of variables[operand]
+        STORE_INDEX,
+        /// pop operand values, push the array of their (concatenated) elements
+        LIST,
+        /// truncate the top of the stack to an integer
+        TRUNCATE,
+        /// pop an offset, rotate the top of the stack to the left by offset slots
+        ROTATE,
+        /// continue at instruction operand
+        JUMP,
+        /// pop a condition, continue at instruction operand if it is false
+        JUMP_IF_FALSE,
+        /// return the top of the stack if operand is 1, nothing otherwise
+        RETURN,
+        /// pop the right operand, replace the left operand by the result; for ADD, SUBTRACT and MULTIPLY, operand is 1
+        /// if both operands are integers, whose result must be exact
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        DIVIDE_INTEGER,
+        MODULO,
+        LOGICAL_AND,
+        LOGICAL_OR,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        EQUAL,
+        NOT_EQUAL,
+        BITWISE_AND,
+        BITWISE_XOR,
+        BITWISE_OR,
+        /// replace the top of the stack by the result
+        LOGICAL_NOT,
+        BITWISE_NOT
+    };
+
+    struct Instruction
+    {
+        Opcode opcode;
+        int operand;
+
+        /// How the operands of an arithmetic instruction or a rotation will be represented after compiling to FHE
+        OpSpecialization specialization;
+    };
+
+private:
+    /// A compiled Function
+    struct Program
+    {
+        std::vector<Instruction> code;
+
+        std::vector<PlainValue> constants;
+
+        /// Slots of the parameters, in order
+        std::vector<size_t> parameters;
+
+        /// Number of variable slots
+        size_t variableCount = 0;
+
+        /// Does each slot hold an integer?
+        std::vector<bool> integerVariables;
+
+        /// Does each slot hold a secret value?
+        std::vector<bool> secretVariables;
+
+        /// How often each instruction has been executed during the last run
+        std::vector<size_t> executions;
+    };
+
+    std::unordered_map<std::string, Program> programs;
+
+    /// Function that is currently compiled
+    Program *program = nullptr;
+
+    /// Slot of every variable that has been declared so far
+    VariableMap<size_t> slots;
+
+    /// A step of compiling an expression: compiling a subexpression, or else continuing with the subexpressions
+    /// compiled so far, like the code after a recursive call would
+    struct Step
+    {
+        AbstractExpression *expression;
+
+        std::function<void()> continuation;
+    };
+
+    /// Steps that remain to compile the current expression, the next one on top, since unrolled programs nest
+    /// expressions too deep to compile them recursively
+    std::vector<Step> steps;
+
+    /// Does the expression that has been compiled last evaluate to an integer?
+    bool integerResult = false;
+
+    /// Does the expression that has been compiled last evaluate to a secret value?
+    bool secretResult = false;
+
+    /// Number of slots that rotations operate on, 0 to rotate arrays over their own length
+    size_t slotCount;
+
+    /// Appends an instruction to the current program
+    /// \return Index of the instruction
+    size_t emit(Opcode opcode, int operand = 0, OpSpecialization specialization = OpSpecialization::PLAIN_PLAIN);
+
+    /// Appends an instruction that pushes a constant
+    void emitConstant(PlainValue value, bool integer);
+
+    /// Declares a new variable in the current scope
+    /// \return Its slot
+    size_t declare(const std::string &identifier, const Datatype &datatype);
+
+    /// Slot of a variable that is visible in the current scope
+    /// \throws runtime_error if the variable has not been declared
+    size_t resolve(const std::string &identifier);
+
+    /// Appends the instructions that compute an expression, which the visit() of the expression nodes only schedule
+    void compile(AbstractExpression &expression);
+
+    /// Schedules the steps that compile an expression and then run the continuation
+    void compileThen(AbstractExpression &expression, std::function<void()> continuation);
+
+    /// Schedules the elements of an ExpressionList from next on and the instruction that creates the list from them
+    /// \param integer Are all elements before next integers?
+    /// \param secret Is any element before next secret?
+    void compileList(
+        std::vector<std::reference_wrapper<AbstractExpression>> expressions, size_t next, bool integer, bool secret);
+
+    /// Schedules the operands of an OperatorExpression from next on, each folded into the value of the ones before it
+    /// \param secret Is any operand before next secret?
+    void compileFold(
+        OperatorExpression &elem, std::vector<std::reference_wrapper<AbstractExpression>> operands, size_t next,
+        bool secret);
+
+    /// Appends the instructions that compute `left op right`, where left and right are on the stack
+    void emitOperator(const Operator &op, bool integer, OpSpecialization specialization);
+
+    /// Appends the instructions that store the value on top of the stack into the variable
+    void emitStore(size_t slot);
+
+    /// Executes the instructions of a program
+    PlainValue execute(Program &p, std::vector<PlainValue> &variables);
+
+public:
+    /// \param slotCount Number of slots that rotations operate on, 0 to rotate arrays over their own length
+    explicit SpecialPlaintextInterpreter(size_t slotCount = 0);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Assignment &elem);
+
+    void visit(BinaryExpression &elem);
+
+    void visit(Block &elem);
+
+    void visit(Call &elem);
+
+    void visit(ExpressionList &elem);
+
+    void visit(For &elem);
+
+    void visit(Function &elem);
+
+    void visit(FunctionParameter &elem);
+
+    void visit(If &elem);
+
+    void visit(IndexAccess &elem);
+
+    void visit(LiteralBool &elem);
+
+    void visit(LiteralChar &elem);
+
+    void visit(LiteralInt &elem);
+
+    void visit(LiteralFloat &elem);
+
+    void visit(LiteralDouble &elem);
+
+    void visit(LiteralString &elem);
+
+    void visit(OperatorExpression &elem);
+
+    void visit(Return &elem);
+
+    void visit(TernaryOperator &elem);
+
+    void visit(UnaryExpression &elem);
+
+    void visit(Variable &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+
+    /// Runs a Function that has been visited before
+    /// \param function Identifier of the Function
+    /// \param arguments Values of its parameters, in order
+    /// \return The returned value, or an empty PlainValue if the Function returns nothing
+    /// \throws runtime_error if the Function is unknown, the number of arguments does not match or it fails
+    PlainValue run(const std::string &function, std::vector<PlainValue> arguments);
+
+    /// The bytecode of a Function that has been visited before
+    [[nodiscard]] const std::vector<Instruction> &getCode(const std::string &function) const;
+
+    /// Number of operations of each kind (e.g. "*" or "rotate") that the last run of a Function executed, by how their
+    /// operands will be represented after compiling to FHE. Without loads, stores and jumps, this is an estimate of
+    /// the cost of the Function that accounts for the actual number of loop iterations.
+    [[nodiscard]] std::map<std::pair<std::string, OpSpecialization>, size_t> getProfile(
+        const std::string &function) const;
+};
+
+#endif // AST_UTILS_PLAINTEXT_INTERPRETER_H_
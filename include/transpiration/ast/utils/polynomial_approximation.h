@@ -0,0 +1,148 @@
+#ifndef AST_UTILS_POLYNOMIAL_APPROXIMATION_H_
+#define AST_UTILS_POLYNOMIAL_APPROXIMATION_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/abstract_expression.h"
+#include "transpiration/ast/abstract_statement.h"
+
+/// A polynomial over the reals in the power basis
+class Polynomial
+{
+private:
+    /// coefficients[i] is the coefficient of x^i, without trailing zeros
+    std::vector<double> coefficients;
+
+public:
+    /// Create a polynomial from its coefficients
+    /// \param coefficients coefficients[i] is the coefficient of x^i
+    explicit Polynomial(std::vector<double> coefficients);
+
+    /// Degree of the polynomial (0 for constants, including the zero polynomial)
+    [[nodiscard]] size_t degree() const;
+
+    /// Does the polynomial have no non-zero coefficient?
+    [[nodiscard]] bool isZero() const;
+
+    /// Get (a const reference to) the coefficients
+    /// \return coefficients, where the i-th entry is the coefficient of x^i
+    [[nodiscard]] const std::vector<double> &getCoefficients() const;
+
+    /// Evaluates the polynomial (in plaintext) using Horner's method
+    double operator()(double x) const;
+
+    /// Splits this polynomial into this = quotient * x^k + remainder with deg(remainder) < k
+    /// \param k the power to divide by
+    /// \return (quotient, remainder)
+    [[nodiscard]] std::pair<Polynomial, Polynomial> divideByPower(size_t k) const;
+
+    /// Multiplicative depth of the Paterson-Stockmeyer evaluation, i.e., ceil(log2(degree + 1))
+    [[nodiscard]] size_t depth() const;
+
+    /// Number of ciphertext-ciphertext multiplications of the Paterson-Stockmeyer evaluation
+    [[nodiscard]] size_t countNonScalarMultiplications() const;
+
+    /// f_n(x) = sum_{i=0}^{n} 1/4^i * binom(2i, i) * x * (1 - x^2)^i of degree 2n+1, which converges to sign(x) on
+    /// [-1, 1] when composed with itself (Cheon et al., "Efficient Homomorphic Comparison Methods with Optimal
+    /// Complexity", 2020)
+    /// \param n 1 <= n <= 4
+    static Polynomial signF(unsigned n);
+
+    /// g_n(x) of degree 2n+1 from the same paper, which quickly moves small inputs away from zero but does not
+    /// converge to sign(x) itself
+    /// \param n 1 <= n <= 4
+    static Polynomial signG(unsigned n);
+};
+
+/// Precision/depth trade-off of a comparison, can be chosen per call site
+struct ApproximationConfig
+{
+    /// Inputs are expected to satisfy |a - b| <= inputBound
+    double inputBound = 1.0;
+
+    /// Differences smaller than inputGap * inputBound are not guaranteed to be resolved correctly
+    double inputGap = 1.0 / 256;
+
+    /// The result of the sign approximation is within 2^-precisionBits of +/-1 (outside of the gap)
+    unsigned precisionBits = 12;
+
+    /// Which f_n/g_n (1 <= n <= 4) to compose, or 0 to pick the one with the smallest depth
+    unsigned degree = 0;
+};
+
+/// Composition of polynomials that approximates sign(x) on [-1, 1] for |x| >= inputGap
+class SignApproximation
+{
+private:
+    /// The polynomials, in order of application
+    std::vector<Polynomial> stages;
+
+public:
+    explicit SignApproximation(std::vector<Polynomial> stages);
+
+    /// Chooses the number of g_n and f_n iterations (and n, unless fixed by the config) that reaches the requested
+    /// precision with minimal depth, ties are broken by the number of non-scalar multiplications.
+    /// The worst-case error is determined by evaluating the composition on a grid over [inputGap, 1].
+    /// \throws runtime_error if the precision cannot be reached with a reasonable number of iterations
+    static SignApproximation fromConfig(const ApproximationConfig &config);
+
+    [[nodiscard]] const std::vector<Polynomial> &getStages() const;
+
+    /// Multiplicative depth of the whole composition
+    [[nodiscard]] size_t depth() const;
+
+    /// Number of ciphertext-ciphertext multiplications of the whole composition
+    [[nodiscard]] size_t countNonScalarMultiplications() const;
+
+    /// Evaluates the composition (in plaintext)
+    double operator()(double x) const;
+};
+
+/// Emits the Paterson-Stockmeyer evaluation of a polynomial in a (secret double) variable as AST nodes.
+/// The baby-step powers x^1 ... x^k and the giant-step powers x^(k*2^j) are declared as temporaries (appended to the
+/// statements passed to the constructor), since they are used many times; the polynomial itself is returned as an
+/// expression over these temporaries. Splitting at the giant-step powers keeps the multiplicative depth at
+/// ceil(log2(degree + 1)) while using roughly 2*sqrt(degree) ciphertext-ciphertext multiplications instead of degree.
+class PatersonStockmeyerEvaluator
+{
+private:
+    /// Statements that must be executed before the returned expression
+    std::vector<std::unique_ptr<AbstractStatement>> &statements;
+
+    /// Prefix of all temporaries that are declared
+    std::string prefix;
+
+    /// Identifier of the input variable
+    std::string input;
+
+    /// Identifiers of the already declared powers of the input
+    std::map<size_t, std::string> powers;
+
+    /// Number of baby steps
+    size_t babySteps = 1;
+
+    /// Declares x^k (if necessary) and returns its identifier
+    std::string power(size_t k);
+
+    std::unique_ptr<AbstractExpression> evaluateRecursive(const Polynomial &p);
+
+public:
+    /// \param statements Declarations of the powers are appended here
+    /// \param prefix Prefix for the identifiers of all declared temporaries, must be unique
+    /// \param input Identifier of the (secret double) variable to evaluate the polynomials in
+    PatersonStockmeyerEvaluator(
+        std::vector<std::unique_ptr<AbstractStatement>> &statements, std::string prefix, std::string input);
+
+    /// Number of baby steps k used for a polynomial of the given degree
+    static size_t chooseBabySteps(size_t degree);
+
+    /// Evaluate p(input)
+    /// \return The expression computing p(input) from the declared powers
+    std::unique_ptr<AbstractExpression> evaluate(const Polynomial &p);
+};
+
+#endif // AST_UTILS_POLYNOMIAL_APPROXIMATION_H_
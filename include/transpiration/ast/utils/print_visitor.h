@@ -5,6 +5,7 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "transpiration/ast/abstract_node.h"
 #include "transpiration/ast/utils/plain_visitor.h"
@@ -25,6 +26,12 @@ private:
     /// Current indentation level
     int indentation_level = 0;
 
+    /// Nodes yet to be printed with their indentation level, the next one on top
+    std::vector<std::pair<AbstractNode *, int>> pending;
+
+    /// Whether a visit() is printing the pending nodes
+    bool visiting = false;
+
     /// Compute the current required indentation string
     /// from the current indentation_level
     [[nodiscard]] std::string getIndentation() const;
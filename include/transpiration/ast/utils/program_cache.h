@@ -0,0 +1,109 @@
+#ifndef AST_UTILS_PROGRAM_CACHE_H_
+#define AST_UTILS_PROGRAM_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "transpiration/ast/utils/seal_emitter_visitor.h"
+
+/// A program that the CompilerPipeline compiled, as stored in a ProgramCache
+struct CompiledProgram
+{
+    /// The source and the hash of the options it was compiled from (see CompilerPipeline), which tell apart programs
+    /// whose keys collide
+    std::string source;
+    uint64_t options = 0;
+
+    /// The emitted translation unit
+    std::string code;
+
+    /// The encryption parameters that the code is written for
+    ParameterSpec spec;
+};
+
+/// Content-addressed cache of whole programs in a directory, e.g. for a service that compiles the same programs over
+/// and over: the key of a program is a hash of its source, the options and the version of the compiler, such that a
+/// hit skips all phases of the CompilerPipeline, including tokenizing and parsing. Every program is a file of its own,
+/// which is written atomically (see writeFileAtomically()), so several processes can share the directory. Once the
+/// files exceed the size limit, the least recently used ones are deleted, where using a program touches its file.
+/// A file starts with a line of JSON (the options, the length and stableHash() of the source, the length of the code
+/// and the parameters), which is followed by the raw source and code. So a lookup only compares the whole source if
+/// its length and hash match, and never parses more than the header.
+/// The compiler is single-threaded (see CompilerPipeline), so is this class.
+class ProgramCache
+{
+private:
+    /// Size and last use of a file in the directory
+    struct Entry
+    {
+        size_t bytes;
+        std::filesystem::file_time_type lastUse;
+    };
+
+    std::string directory;
+
+    size_t maxBytes;
+
+    /// The files that this process knows of, by key, which might miss the files of other processes
+    std::unordered_map<uint64_t, Entry> entries;
+
+    /// Sum of the sizes of the entries
+    size_t bytes = 0;
+
+    size_t hits = 0;
+
+    size_t misses = 0;
+
+    size_t evictions = 0;
+
+    [[nodiscard]] std::string pathOf(uint64_t key) const;
+
+    /// Reads the sizes and last uses of all files in the directory, including those of other processes
+    void scan();
+
+    /// Deletes the least recently used files until the rest is within the size limit
+    void evict();
+
+public:
+    /// Default size limit of the directory
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(1) << 30;
+
+    /// \param directory Directory of the cache, which is created if it does not exist
+    /// \param maxBytes Size limit of the files in the directory, a program that exceeds it on its own is not kept
+    /// \throws std::runtime_error if the directory cannot be created
+    explicit ProgramCache(std::string directory, size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    ProgramCache(const ProgramCache &other) = delete;
+
+    ProgramCache &operator=(const ProgramCache &other) = delete;
+
+    /// Looks up a program and marks it as used, a file that cannot be read counts as a miss
+    /// \param key Key of the program
+    /// \param source The source of the program, which the program of the key must have been compiled from
+    /// \param options Hash of the options, which the program of the key must have been compiled with
+    /// \return The program, or nothing if the cache has no program for the key, source and options
+    std::optional<CompiledProgram> find(uint64_t key, const std::string &source, uint64_t options);
+
+    /// Adds a program (replacing the one with the same key) and evicts programs if the cache exceeds its size limit.
+    /// A program that cannot be written is not cached, i.e., it will be compiled again.
+    /// \param key Key of the program
+    /// \param program The program
+    void insert(uint64_t key, const CompiledProgram &program);
+
+    /// \return The number of calls of find() that found a program
+    [[nodiscard]] size_t getHits() const;
+
+    /// \return The number of calls of find() that did not
+    [[nodiscard]] size_t getMisses() const;
+
+    /// \return The number of programs this cache deleted to stay within its size limit
+    [[nodiscard]] size_t getEvictions() const;
+
+    /// \return The size of the programs in the directory that this cache knows of
+    [[nodiscard]] size_t getBytes() const;
+};
+
+#endif // AST_UTILS_PROGRAM_CACHE_H_
@@ -26,14 +26,12 @@ public:
 
 #include "transpiration/ast/utils/warning_suggest_override_prologue.h"
 
-    void visit(BinaryExpression &elem);
+    /// Prints an expression without recursing into its subexpressions, since unrolled programs nest them arbitrarily
+    /// deep. The Variables and Literals in it are printed by their visit().
+    void visit(AbstractExpression &elem);
 
     void visit(Block &elem);
 
-    void visit(Call &elem);
-
-    void visit(ExpressionList &elem);
-
     void visit(For &elem);
 
     void visit(Function &elem);
@@ -42,8 +40,6 @@ public:
 
     void visit(If &elem);
 
-    void visit(IndexAccess &elem);
-
     void visit(LiteralBool &elem);
 
     void visit(LiteralChar &elem);
@@ -56,14 +52,8 @@ public:
 
     void visit(LiteralString &elem);
 
-    void visit(OperatorExpression &elem);
-
     void visit(Return &elem);
 
-    void visit(TernaryOperator &elem);
-
-    void visit(UnaryExpression &elem);
-
     void visit(Assignment &elem);
 
     void visit(VariableDeclaration &elem);
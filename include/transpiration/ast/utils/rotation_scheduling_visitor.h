@@ -0,0 +1,86 @@
+#ifndef AST_UTILS_ROTATION_SCHEDULING_VISITOR_H_
+#define AST_UTILS_ROTATION_SCHEDULING_VISITOR_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "transpiration/ast/utils/layout_planner.h"
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the RotationSchedulingVisitor's logic
+class SpecialRotationSchedulingVisitor;
+
+/// RotationSchedulingVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialRotationSchedulingVisitor, PlainVisitor> RotationSchedulingVisitor;
+
+/// Replaces loops over the slots of packed secret vectors by rotate() Calls:
+///  - Sum reductions `for (int i = 0; i < n; i = i + 1) { s = s + e; }`, where every array access in e is of the form
+///    x[i] on a secret vector, become e evaluated once on the whole vectors followed by a rotate-and-add tree,
+///    i.e., ceil(log2(n)) rotations instead of n. The sum ends up in slot 0. Since the tree sums the first
+///    2^ceil(log2(n)) slots, e is first multiplied by a plaintext mask of n ones unless n is a power of two or all
+///    arrays in e are declared with a list of at most n values (such that the slots beyond n are zero).
+///  - Matrix-vector products `for (i < n) { for (j < m) { y[i] = y[i] + M[i][j] * v[j]; } }` for which the layout
+///    plan chose a diagonal M and a replicated v become a baby-step giant-step evaluation: the b - 1 baby-step
+///    rotations of v are declared once and shared by all ceil(m / b) giant steps, i.e., about 2*sqrt(m) rotations
+///    instead of m (see SpecialLayoutPlanningVisitor::babyStepCount).
+/// Loops that do not match these patterns exactly are left untouched.
+class SpecialRotationSchedulingVisitor : public PlainVisitor
+{
+private:
+    /// Unique node IDs of the expressions that (may) evaluate to a secret value
+    std::unordered_set<std::string> secretNodes;
+
+    /// Products M[i][j] * v[j] whose operands are in diagonal and replicated layout
+    std::unordered_set<const BinaryExpression *> diagonalProducts;
+
+    /// Declared types of all variables (by identifier)
+    std::unordered_map<std::string, Datatype> declaredTypes;
+
+    /// Number of values of the variables declared with a list of values (by identifier)
+    std::unordered_map<std::string, size_t> listLengths;
+
+    /// Number of loops rewritten so far, used to create fresh identifiers
+    int loopCounter = 0;
+
+    /// Visits the statements of the block and replaces the loops that can be rewritten
+    void visitStatements(Block &block);
+
+    /// Type of the temporaries holding (rotations of) the given variable
+    Datatype temporaryType(const std::string &identifier);
+
+    /// Rewrites a sum reduction
+    /// \return The replacement statements, or an empty vector if the loop is not a sum reduction
+    std::vector<std::unique_ptr<AbstractStatement>> lowerReduction(For &loop);
+
+    /// Rewrites a matrix-vector product with a diagonal matrix
+    /// \return The replacement statements, or an empty vector if the loop nest is not such a product
+    std::vector<std::unique_ptr<AbstractStatement>> lowerMatrixVector(For &loop);
+
+public:
+    /// Only rewrites sum reductions
+    /// \param secretNodes Unique node IDs of the secret expressions, see SecretTaintVisitor::getTaintedNodes()
+    explicit SpecialRotationSchedulingVisitor(std::unordered_set<std::string> secretNodes);
+
+    /// Rewrites sum reductions and the diagonal matrix-vector products of the layout plan
+    /// \param secretNodes Unique node IDs of the secret expressions, see SecretTaintVisitor::getTaintedNodes()
+    /// \param sites The sites found by the LayoutPlanningVisitor
+    /// \param plan The plan computed by the LayoutPlanningVisitor (after inserting its conversions)
+    SpecialRotationSchedulingVisitor(
+        std::unordered_set<std::string> secretNodes, const std::vector<LayoutSite> &sites, const LayoutPlan &plan);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Block &elem);
+
+    void visit(FunctionParameter &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+};
+
+#endif // AST_UTILS_ROTATION_SCHEDULING_VISITOR_H_
@@ -1,7 +1,13 @@
 #ifndef AST_UTILS_SCOPE_H_
 #define AST_UTILS_SCOPE_H_
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "transpiration/ast/abstract_node.h"
@@ -9,14 +15,68 @@
 // forward declarations
 class Scope;
 
+/// Interns identifiers, i.e., maps every distinct identifier to a small integer (its symbol) so that identifiers can be
+/// hashed and compared without looking at their characters. Symbol 0 is the empty identifier.
+/// Every root Scope takes the current table of its thread (see current()), which its nested Scopes and its
+/// ScopedIdentifiers share, i.e., symbols are only comparable within the same tree of Scopes. A table never releases
+/// its symbols, but is released itself with the last Scope (or Context) that uses it: CompilerPipeline::compile() opens
+/// a Context, so that a compiler that runs as a service does not accumulate the identifiers of all programs it has ever
+/// compiled. Outside of a Context, Scopes share a table that lives as long as the process.
+/// A table is not synchronized, but a Context only affects its own thread (the CompilerStatistics are process-wide,
+/// though, see CompilerPipeline).
+class SymbolTable
+{
+private:
+    /// The identifiers by symbol, a deque so that references to them stay valid while symbols are added
+    std::deque<std::string> names = { "" };
+
+    std::unordered_map<std::string, uint32_t> symbols = { { "", 0 } };
+
+public:
+    /// \param id An identifier (e.g., variable's name)
+    /// \return The symbol of id, which is the same for every call with an equal id
+    uint32_t intern(const std::string &id);
+
+    /// \param symbol A symbol returned by intern()
+    /// \return (A reference to) the identifier of the symbol, which stays valid as long as the table
+    [[nodiscard]] const std::string &name(uint32_t symbol) const;
+
+    /// \return The table of the innermost Context of this thread, or the table of the process if there is none
+    static std::shared_ptr<SymbolTable> current();
+
+    /// Makes a new, empty table the current one of this thread until the Context is destroyed
+    class Context
+    {
+    private:
+        std::shared_ptr<SymbolTable> previous;
+
+    public:
+        Context();
+
+        ~Context();
+
+        Context(const Context &other) = delete;
+
+        Context &operator=(const Context &other) = delete;
+    };
+};
+
+/// An identifier together with the Scope that declares it. Two ScopedIdentifiers are equal iff they belong to the same
+/// Scope and have the same identifier, i.e., the key (scope ID, symbol) is all that is hashed and compared.
 class ScopedIdentifier
 {
 private:
     /// (weak) pointer to the Scope this identifier belongs to
-    Scope *scope;
+    Scope *scope = nullptr;
 
-    /// identifier (e.g., variable's name)
-    std::string id;
+    /// (weak) pointer to the SymbolTable of the scope, or nullptr for the empty identifier
+    const SymbolTable *symbols = nullptr;
+
+    /// ID of the scope, so that hashing and comparing does not need to follow the pointer
+    uint64_t scopeId = 0;
+
+    /// identifier (e.g., variable's name), interned in the SymbolTable of the scope
+    uint32_t symbol = 0;
 
 public:
     ~ScopedIdentifier() = default;
@@ -48,26 +108,48 @@ public:
     /// \return (A const string reference to) the identifier of this ScopedIdentifier.
     [[nodiscard]] const std::string &getId() const;
 
-    /// Gets the identifier associated with this ScopedIdentifier.
-    /// \return (A string reference to) the identifier of this ScopedIdentifier.
-    std::string &getId();
+    /// Gets the ID of the scope associated with this ScopedIdentifier.
+    /// \return The ID of the scope of this ScopedIdentifier.
+    [[nodiscard]] uint64_t getScopeId() const;
+
+    /// Gets the interned identifier associated with this ScopedIdentifier.
+    /// \return The symbol of the identifier in the SymbolTable of the scope.
+    [[nodiscard]] uint32_t getSymbol() const;
 };
 
 class Scope
 {
 private:
+    /// Number of scopes created so far (by all threads), see id
+    static std::atomic<uint64_t> scopeCounter;
+
+    /// Unique among all scopes created by this process, never 0
+    uint64_t id;
+
+    /// Rendered by getScopeName() on its first call
+    mutable std::string name;
+
     /// (Weak) pointer to the AST node that creates this scope
     AbstractNode *astNode;
 
-    /// Set of identifiers declared in this scope
-    std::unordered_set<std::unique_ptr<ScopedIdentifier>> identifiers;
+    /// Interns the identifiers of this scope and of all scopes nested in it (or in its root scope)
+    std::shared_ptr<SymbolTable> symbols;
+
+    /// The identifiers declared in this scope, by symbol (see SymbolTable)
+    std::unordered_map<uint32_t, std::unique_ptr<ScopedIdentifier>> identifiers;
 
     /// Parent scope (if it exists)
     Scope *parent = nullptr;
 
-    /// The scopes that are nested in this scope
+    /// The scopes that are nested in this scope, in the order they were created
     std::vector<std::unique_ptr<Scope>> nestedScopes;
 
+    /// The scopes that are nested in this scope, by the node that creates them
+    std::unordered_map<const AbstractNode *, Scope *> nestedScopesByCreator;
+
+    /// The identifier with the given symbol that is declared in this or the closest parent scope, or nullptr
+    [[nodiscard]] const ScopedIdentifier *lookupSymbol(uint32_t symbol) const;
+
 public:
     /// Destructor
     ~Scope() = default;
@@ -133,6 +215,13 @@ public:
     /// The AST node that creates the nested scope. \return (A weak pointer) to the nested scope that is created.
     static Scope *createNestedScope(Scope &parentScope, AbstractNode &scopeOpener);
 
+    /// Determines the ScopedIdentifier of the given identifier, with one hash lookup per scope from this scope up to
+    /// the scope that declares it.
+    /// \param id The identifier for that the ScopedIdentifier should be determined.
+    /// \return (A const pointer to) the ScopedIdentifier object associated with the given identifier, or nullptr if
+    /// the identifier is not declared in this or any parent scope.
+    [[nodiscard]] const ScopedIdentifier *findIdentifier(const std::string &id) const;
+
     /// Determines the ScopedIdentifier of the given identifier.
     /// \param id The identifier for that the ScopedIdentifier should be determined.
     /// \return (A const reference) to the ScopedIdentifier object associated with the given identifier.
@@ -156,9 +245,18 @@ public:
     /// \return (A const reference to) the scope created by the given node.
     const Scope &getNestedScopeByCreator(AbstractNode &node) const;
 
-    /// Get Scope name
-    /// \return the name of this scope (uniqueID of the associated AST node)
-    [[nodiscard]] std::string getScopeName() const;
+    /// Get Scope name, for diagnostics only (ScopedIdentifiers are hashed and compared by getId())
+    /// \return the name of this scope (uniqueID of the associated AST node), rendered once and cached
+    [[nodiscard]] const std::string &getScopeName() const;
+
+    /// Gets the table that the identifiers of this scope are interned in.
+    /// \return (A reference to) the SymbolTable of the root scope.
+    SymbolTable &getSymbolTable() const;
+
+    /// Get Scope ID
+    /// \return the ID of this scope, which is assigned at creation and unique among all scopes created by this
+    /// process
+    [[nodiscard]] uint64_t getId() const;
 };
 
 
@@ -167,7 +265,9 @@ struct std::hash<ScopedIdentifier>
 {
     size_t operator()(const ScopedIdentifier &s) const
     {
-        return std::hash<std::string>{}(s.getScope().getScopeName() + "::" + s.getId());
+        // combines the hashes of the scope and the symbol like boost::hash_combine
+        size_t seed = std::hash<uint64_t>{}(s.getScopeId());
+        return seed ^ (std::hash<uint32_t>{}(s.getSymbol()) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
     }
 };
 
@@ -176,7 +276,7 @@ struct std::equal_to<ScopedIdentifier>
 {
     bool operator()(ScopedIdentifier const &s1, ScopedIdentifier const &s2) const
     {
-        return s1.getId() == s2.getId() && s1.getScope().getScopeName() == s2.getScope().getScopeName();
+        return s1.getScopeId() == s2.getScopeId() && s1.getSymbol() == s2.getSymbol();
     }
 };
 
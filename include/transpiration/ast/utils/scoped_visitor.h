@@ -3,13 +3,18 @@
 
 #include "transpiration/ast/utils/ivisitor.h"
 #include "transpiration/ast/utils/scope.h"
+#include "transpiration/ast/utils/traversal_stack.h"
 
 /// This class implements the "default" behaviour of a visitor
 /// simply visiting a node's children
 /// and setting the scope as required
+/// The default visit() of nodes that do not open a scope visits the children through a TraversalStack, i.e., does not
+/// recurse for every level of a deep expression.
 class ScopedVisitor : public IVisitor
 {
 private:
+    TraversalStack traversal;
+
     /// the outermost scope of the passed AST (i.e., the scope without a parent)
     std::unique_ptr<Scope> rootScope = nullptr;
 
@@ -75,8 +80,19 @@ public:
 
     void setRootScope(std::unique_ptr<Scope> &&scope);
 
+    /// Determines the ScopedIdentifier a Variable refers to. If a BindingResolutionVisitor stamped the Variable with a
+    /// binding in the scopes of this visitor (i.e., its root scope was passed on with setRootScope), that binding is
+    /// returned without any lookup by name, otherwise the identifier is looked up from the current scope.
+    /// \param variable A Variable in the current scope
+    /// \return (A const pointer to) the ScopedIdentifier of the variable, or nullptr if it is not declared
+    [[nodiscard]] const ScopedIdentifier *findIdentifier(const Variable &variable) const;
+
+    /// Like findIdentifier(), but throws if the variable is not declared
+    [[nodiscard]] const ScopedIdentifier &resolveIdentifier(const Variable &variable) const;
+
     void overrideCurrentScope(Scope *scope);
 
+    /// Visits the children of elem, which have all been visited when this returns
     void visitChildren(AbstractNode &elem);
 
     void enterScope(AbstractNode &node);
@@ -0,0 +1,274 @@
+#ifndef AST_UTILS_SEAL_EMITTER_VISITOR_H_
+#define AST_UTILS_SEAL_EMITTER_VISITOR_H_
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// Forward declaration of the class that will actually implement the SealEmitterVisitor's logic
+class SpecialSealEmitterVisitor;
+
+/// SealEmitterVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialSealEmitterVisitor, PlainVisitor> SealEmitterVisitor;
+
+/// Encryption parameters that the generated code is written for
+struct ParameterSpec
+{
+    enum class Scheme
+    {
+        BFV,
+        CKKS
+    };
+
+    Scheme scheme = Scheme::BFV;
+    size_t polyModulusDegree = 8192;
+
+    /// Bit size of the batching-friendly plaintext modulus (BFV only)
+    int plainModulusBits = 20;
+
+    /// Bit sizes of the coefficient modulus primes (CKKS only, BFV uses SEAL's default for the degree)
+    std::vector<int> coeffModulusBits = { 60, 40, 40, 60 };
+
+    /// log2 of the scale of encoded values (CKKS only)
+    int scaleBits = 40;
+};
+
+/// Translates Functions that have been lowered to FHE operations (i.e., after the SecretTaintVisitor,
+/// BranchEliminationVisitor, ComparisonLoweringVisitor and RotationSchedulingVisitor) into a standalone C++
+/// translation unit that calls SEAL directly. For every Function f, it emits
+///  - seal::EncryptionParameters f_parameters(), the parameters described by the ParameterSpec, and
+///  - f(SealRuntime &runtime, ...), with secret parameters and results as seal::Ciphertext (see SealRuntime).
+/// Secret values only live in ciphertexts, all other values in plain C++ variables. The emitted code
+///  - keeps the ciphertext variables in a fixed set of buffers declared at the top of the function, which the
+///    CiphertextAllocationVisitor assigns based on their live ranges (the variables of the Function are renamed to
+///    their buffers), such that the peak memory only depends on the number of simultaneously live ciphertexts,
+///  - uses the in-place Evaluator operations (add_inplace, multiply_inplace, relinearize_inplace, ...) and computes
+///    the value of an assignment directly into the target's buffer whenever the target is not read after being
+///    overwritten, e.g., x = x * y becomes multiply_inplace(x, y) and relinearize_inplace(x), and so does
+///    z = x * y if x dies there and z takes over its buffer,
+///  - evaluates nested expressions in a stack of scratch ciphertexts, which is as deep as the deepest expression,
+///  - allocates all ciphertexts from the runtime's memory pool, such that their memory is recycled,
+///  - computes the rotations of a variable that the hoist-rotations pass grouped into an ast.ssa.multi_rotate (see
+///    setRotationGroups()) with a single call to the HoistedRotator (Galois keys for the powers of two suffice for
+///    all offsets) and releases the rotations after their last use,
+///  - optionally runs independent homomorphic operations concurrently: every sequence of ciphertext statements
+///    whose dependency DAG is not a chain becomes an OpenMP task graph, i.e., one task per statement (and per group
+///    of hoisted rotations) with `depend` clauses for the ciphertexts it reads and writes, executed by
+///    SealRuntime::threads threads. Without -fopenmp, the pragmas are ignored and the code runs sequentially.
+/// The same code can also be compiled against the MockRuntime, which simulates the operations without SEAL.
+/// Secret control flow, secret comparisons and writes to single slots of a ciphertext cannot be expressed and must
+/// have been lowered by the earlier passes.
+class SpecialSealEmitterVisitor : public PlainVisitor
+{
+private:
+    /// Stream the translation unit is written to
+    std::ostream &os;
+
+    /// Body of the current function, which is only written once its buffers are known
+    std::ostringstream code;
+
+    ParameterSpec spec;
+
+    /// Has the prologue (includes) been written yet?
+    bool prologueEmitted = false;
+
+    /// Current indentation level
+    int indentationLevel = 0;
+
+    /// Variables of the current function that hold ciphertexts (by identifier)
+    std::unordered_set<std::string> cipherVariables;
+
+    /// Plain variables of the current function that hold arrays (by identifier)
+    std::unordered_set<std::string> plainArrays;
+
+    /// Does the current function return a ciphertext?
+    bool cipherResult = false;
+
+    /// Emit OpenMP task graphs for independent statements?
+    bool parallel;
+
+    /// Emit code for the MockRuntime instead of SEAL?
+    bool mockRuntime;
+
+    /// Rotations of one variable by several literal offsets that are computed together
+    struct RotationGroup
+    {
+        std::string variable;
+        std::vector<int> offsets;
+        std::string identifier;
+        bool declared = false;
+
+        /// The rotations are released after this statement
+        const AbstractStatement *lastStatement = nullptr;
+    };
+
+    std::vector<RotationGroup> rotationGroups;
+
+    /// (index into rotationGroups, index into its offsets) of the hoisted rotate() Calls (by unique node ID)
+    std::unordered_map<std::string, std::pair<size_t, size_t>> hoistedRotations;
+
+    /// Index of the group passed to setRotationGroups() of every rotate() Call in one (by unique node ID)
+    std::unordered_map<std::string, size_t> plannedRotations;
+
+    /// Number of rotation groups declared so far, used to create fresh identifiers
+    int groupCounter = 0;
+
+    /// Number of scratch ciphertexts currently in use
+    size_t temporaryDepth = 0;
+
+    /// Number of scratch ciphertexts that the current function needs
+    size_t temporaryCount = 0;
+
+    [[nodiscard]] std::string getIndentation() const;
+
+    /// C++ type of plain values combined with ciphertexts, i.e., int64_t (BFV) or double (CKKS)
+    [[nodiscard]] std::string slotType() const;
+
+    /// C++ type of a plain variable
+    [[nodiscard]] std::string plainType(const Datatype &datatype, bool array) const;
+
+    /// Memoized results of isCipher(), since the emission asks for every subexpression of nested expressions. Only
+    /// valid as long as cipherVariables does not change.
+    std::unordered_map<const AbstractNode *, bool> cipherExpressions;
+
+    /// Identifiers of all Variables in the current function, such that readsVariable() is only needed for them
+    std::unordered_set<std::string> variableIdentifiers;
+
+    /// A step of emitCipherInto(), which keeps the steps that remain on a stack instead of recursing into the operands,
+    /// since unrolled programs nest expressions too deep for the call stack
+    struct EmitStep
+    {
+        /// COMPUTE expression into destination, APPLY destination = destination op expression, or write text and
+        /// release the scratch ciphertexts taken since it was pushed, i.e., restore temporaryDepth to depth
+        enum Kind
+        {
+            COMPUTE,
+            APPLY,
+            TEXT
+        } kind;
+        AbstractExpression *expression;
+        std::string destination;
+        const Operator *op;
+        std::string text;
+        size_t depth;
+
+        static EmitStep compute(AbstractExpression &expression, const std::string &destination)
+        {
+            return { COMPUTE, &expression, destination, nullptr, "", 0 };
+        }
+
+        static EmitStep apply(const Operator &op, AbstractExpression &operand, const std::string &destination)
+        {
+            return { APPLY, &operand, destination, &op, "", 0 };
+        }
+
+        static EmitStep write(std::string text, size_t depth)
+        {
+            return { TEXT, nullptr, "", nullptr, std::move(text), depth };
+        }
+    };
+
+    /// Does the expression evaluate to a ciphertext?
+    bool isCipher(AbstractExpression &expr);
+
+    /// The expression as a C++ expression on plain values
+    /// \throws runtime_error if the expression reads a ciphertext
+    std::string plainExpression(AbstractExpression &expr);
+
+    /// The plain expression as an argument to SealRuntime::encode or SealRuntime::encrypt
+    std::string encodable(AbstractExpression &expr);
+
+    /// Writes the statements that compute a secret expression into the (existing) ciphertext variable destination
+    void emitCipherInto(AbstractExpression &expr, const std::string &destination);
+
+    /// Writes the statements of emitCipherInto() for the expression itself, and pushes the steps for its operands and
+    /// the statements that have to follow them onto steps (in reverse order)
+    void computeInto(AbstractExpression &expr, const std::string &destination, std::vector<EmitStep> &steps);
+
+    /// Applies `destination = destination op operand` in place, pushing the steps that compute a nested operand
+    void emitBinaryInplace(
+        const Operator &op, AbstractExpression &operand, const std::string &destination, std::vector<EmitStep> &steps);
+
+    /// Writes the statements that compute the rotation of a secret expression into the ciphertext variable destination,
+    /// pushing the steps that compute a nested source
+    void emitRotation(
+        AbstractExpression &source, AbstractExpression &offset, const std::string &destination,
+        std::vector<EmitStep> &steps);
+
+    /// The ciphertext variable that holds the value of a secret expression without computing anything
+    /// \return The Variable, the hoisted rotation or slot 0 of a Variable, or an empty string for other expressions
+    std::string directOperand(AbstractExpression &expr);
+
+    /// Makes the value of a secret expression available as a ciphertext variable
+    /// \return The variable, which is a scratch ciphertext unless expr is a Variable or a hoisted rotation
+    std::string cipherOperand(AbstractExpression &expr);
+
+    /// Takes the next scratch ciphertext from the stack, the caller releases it by restoring temporaryDepth
+    std::string acquireTemporary();
+
+    /// Finds the rotations of the groups passed to setRotationGroups() in straight-line code, starting at statement
+    /// `first` of the block. Each group is computed by a single HoistedRotator::rotate.
+    /// \return Index of the first statement that ends the straight-line code
+    size_t findRotationGroups(Block &block, size_t first);
+
+    /// The C++ expression of a hoisted rotation, the group is declared on its first use
+    std::string hoistedRotation(Call &call);
+
+    /// Writes the statements of a block, without braces
+    void emitStatements(Block &block);
+
+    /// Is the statement an assignment to a ciphertext, i.e., something that can become a task?
+    bool isCipherStatement(AbstractStatement *statement);
+
+    /// Writes the ciphertext statements [first, end) of the block as an OpenMP task graph
+    /// \return false (without writing anything) if their dependency DAG is a chain, i.e., there is nothing to gain
+    bool emitTaskGraph(Block &block, size_t first, size_t end);
+
+public:
+    /// \param os Stream the translation unit is written to
+    /// \param spec Encryption parameters that the generated code is written for
+    /// \param parallel Emit OpenMP task graphs for independent statements?
+    /// \param mockRuntime Emit code for the MockRuntime, which simulates SEAL's operations, instead of SEAL?
+    explicit SpecialSealEmitterVisitor(
+        std::ostream &os, ParameterSpec spec = ParameterSpec(), bool parallel = false, bool mockRuntime = false);
+
+    /// Writes the prologue of the translation unit (the includes), unless it has been written already. The first
+    /// Function writes it anyway, this is only needed to write it on its own.
+    void emitPrologue();
+
+    /// Does not write the prologue, e.g. for Functions that are appended to a translation unit whose prologue has been
+    /// written by another SealEmitterVisitor
+    void omitPrologue();
+
+    /// Sets the rotations to compute together, as grouped by the hoist-rotations pass (see collectHoistedRotations()).
+    /// Without groups, every rotation is computed on its own.
+    /// \param groups The unique node IDs of the rotate() Calls of every group
+    void setRotationGroups(const std::vector<std::vector<std::string>> &groups);
+
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    void visit(Assignment &elem);
+
+    void visit(Block &elem);
+
+    void visit(For &elem);
+
+    void visit(Function &elem);
+
+    void visit(If &elem);
+
+    void visit(Return &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+};
+
+#endif // AST_UTILS_SEAL_EMITTER_VISITOR_H_
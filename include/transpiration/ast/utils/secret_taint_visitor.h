@@ -0,0 +1,155 @@
+#ifndef AST_UTILS_SECRET_TAINT_VISITOR_H_
+#define AST_UTILS_SECRET_TAINT_VISITOR_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "transpiration/ast/utils/operator.h"
+#include "transpiration/ast/utils/persistent_variable_map.h"
+#include "transpiration/ast/utils/scoped_visitor.h"
+#include "transpiration/ast/utils/variable_map.h"
+#include "transpiration/ast/utils/visitor.h"
+
+/// How the operands of an operation are represented, ordered from cheapest to most expensive evaluation
+enum class OpSpecialization
+{
+    /// All operands are plaintext: evaluated natively, e.g. a * b
+    PLAIN_PLAIN,
+    /// Exactly one operand is a ciphertext: e.g. multiply_plain, add_plain
+    CIPHER_PLAIN,
+    /// At least two operands are ciphertexts: e.g. multiply followed by relinearize
+    CIPHER_CIPHER
+};
+
+/// String representation of enums
+std::string enumToString(const OpSpecialization specialization);
+
+/// Forward declaration of the class that will actually implement the SecretTaintVisitor's logic
+class SpecialSecretTaintVisitor;
+
+/// SecretTaintVisitor uses the Visitor<T> template to allow specifying default behaviour
+typedef Visitor<SpecialSecretTaintVisitor> SecretTaintVisitor;
+
+/// Dataflow analysis that propagates secret-ness from secret FunctionParameters and VariableDeclarations through
+/// Assignments, VariableDeclarations, Calls, Ifs and Fors, and then specializes every arithmetic expression:
+///  - plain op plain: the native operator (+, -, *), even if the user wrote the FHE operator
+///  - cipher op plain / cipher op cipher: the FHE operator (+++, ---, ***)
+/// The chosen OpSpecialization is recorded per expression, so that the lowering can pick e.g. multiply_plain over
+/// multiply + relinearize. Assignments that are control-dependent on a secret condition taint their target
+/// (implicit flow). Variables that become secret get their VariableDeclaration's Datatype marked as secret.
+/// Loops are iterated until the set of secret variables reaches a fixpoint, each iteration on a fork of the variable
+/// map, so that detecting the fixpoint only costs as much as the variables changed in the iteration. Since taint only
+/// ever grows, If branches are simply analysed one after the other, without forking the variable map.
+/// Across Functions, a Call with a secret argument makes the corresponding FunctionParameter of the called Function
+/// secret (marking its Datatype), and a Call to a function that returns a secret value is secret. Since a Call may
+/// precede the Function it calls, the Functions of a program (a Block of Functions) are analysed again until neither
+/// the secret functions nor the secret parameters change.
+class SpecialSecretTaintVisitor : public ScopedVisitor
+{
+private:
+    /// Secret-ness of every variable that has been declared so far
+    PersistentVariableMap<bool> taintedVariables;
+
+    /// Unique node IDs of all expressions that (may) evaluate to a secret value
+    std::unordered_set<std::string> taintedNodes;
+
+    /// Specialization chosen for each BinaryExpression and OperatorExpression, indexed by unique node ID
+    std::unordered_map<std::string, OpSpecialization> specializations;
+
+    /// Names of the functions that (may) return a secret value
+    std::unordered_set<std::string> secretFunctions;
+
+    /// Declaration of every variable, in order to mark its Datatype as secret once the variable becomes secret
+    VariableMap<VariableDeclaration *> declarations;
+
+    /// Functions of the visited program by name, whose parameters are joined with the arguments of Calls to them
+    std::unordered_map<std::string, Function *> functions;
+
+    /// Number of FunctionParameters that have become secret because a Call passes a secret argument
+    size_t numSecretArguments = 0;
+
+    /// Name of the function that is currently analysed
+    std::string currentFunction;
+
+    /// Number of enclosing If/For statements with a secret condition
+    int secretControlDepth = 0;
+
+    /// Marks the variable as secret and updates the Datatype of its declaration (if known)
+    void taintVariable(const ScopedIdentifier &scopedIdentifier);
+
+    /// Marks the node as secret (if tainted is true) and returns tainted
+    bool setTainted(AbstractNode &node, bool tainted);
+
+    /// Runs the analysis on a fork of taintedVariables and merges the fork back
+    /// \return true iff a variable became secret
+    bool analyseOnFork(const std::function<void()> &analysis);
+
+    /// Records the specialization of an arithmetic expression and rewrites its operator accordingly
+    OpSpecialization specialize(Operator &op, size_t numSecretOperands);
+
+    /// Taints an expression whose children have been tainted already, see visit(AbstractExpression &)
+    void taint(AbstractExpression &elem);
+
+    void taint(BinaryExpression &elem);
+
+    void taint(Call &elem);
+
+    void taint(OperatorExpression &elem);
+
+    void taint(Variable &elem);
+
+public:
+#include "transpiration/ast/utils/warning_suggest_override_prologue.h"
+
+    /// Taints the expression and its subexpressions bottom-up in a single walk() (see static_visitor.h), since unrolled
+    /// programs nest expressions too deep to visit them recursively. Expressions contain no statements, i.e., no
+    /// scopes.
+    void visit(AbstractExpression &elem);
+
+    void visit(Assignment &elem);
+
+    void visit(Block &elem);
+
+    void visit(For &elem);
+
+    void visit(Function &elem);
+
+    void visit(FunctionParameter &elem);
+
+    void visit(If &elem);
+
+    void visit(Return &elem);
+
+    void visit(VariableDeclaration &elem);
+
+#include "transpiration/ast/utils/warning_epilogue.h"
+
+    /// Does the node (may) evaluate to a secret value?
+    /// \param node Any expression that has been visited by this visitor
+    /// \return true iff the node is tainted by secret data
+    [[nodiscard]] bool isSecretTainted(const AbstractNode &node) const;
+
+    /// Get the specialization chosen for a BinaryExpression or OperatorExpression
+    /// \param node An arithmetic expression that has been visited by this visitor
+    /// \return The chosen specialization
+    /// \throws runtime_error if no specialization was recorded for node
+    [[nodiscard]] OpSpecialization getSpecialization(const AbstractNode &node) const;
+
+    /// Get the specializations of all visited arithmetic expressions, indexed by unique node ID
+    [[nodiscard]] const std::unordered_map<std::string, OpSpecialization> &getSpecializations() const;
+
+    /// Get the unique node IDs of all expressions that (may) evaluate to a secret value
+    [[nodiscard]] const std::unordered_set<std::string> &getTaintedNodes() const;
+
+    /// Declares functions that are not part of the visited AST as returning a secret value, e.g. the other Functions of
+    /// the program when a Function is analysed on its own (see CompilerPipeline), so that Calls to them are tainted
+    /// \param functions Names of the functions
+    void setSecretFunctions(std::unordered_set<std::string> functions);
+
+    /// Get the names of the functions that (may) return a secret value, including those set by setSecretFunctions()
+    [[nodiscard]] const std::unordered_set<std::string> &getSecretFunctions() const;
+};
+
+#endif // AST_UTILS_SECRET_TAINT_VISITOR_H_
@@ -0,0 +1,388 @@
+#ifndef AST_UTILS_STATIC_VISITOR_H_
+#define AST_UTILS_STATIC_VISITOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// includes all ast classes, which dispatch() casts to, and has_visit
+#include "transpiration/ast/utils/visitor.h"
+
+/// To, const if From is const
+template <typename From, typename To>
+using match_const_t = std::conditional_t<std::is_const_v<From>, const To, To>;
+
+#define DISPATCH_NODE_KIND(Kind) \
+    case NodeKind::Kind:         \
+        return std::forward<F>(f)(static_cast<match_const_t<N, Kind> &>(base));
+
+/// Calls f with the node cast to its concrete class (e.g. Variable &), i.e., the overload of f (or the instantiation of
+/// a generic lambda) is selected at compile time and can be inlined. Unlike accept(), which calls the virtual visit()
+/// of an IVisitor, this costs a single switch on the node's kind.
+/// \param node Any node, possibly const
+/// \param f Callable with every concrete class of node, which must return the same type for all of them
+/// \return What f returns
+/// \throws std::logic_error if the node has an unknown kind
+template <typename N, typename F>
+decltype(auto) dispatch(N &node, F &&f)
+{
+    match_const_t<N, AbstractNode> &base = node;
+    switch (base.getNodeKind())
+    {
+        DISPATCH_NODE_KIND(Assignment)
+        DISPATCH_NODE_KIND(BinaryExpression)
+        DISPATCH_NODE_KIND(Block)
+        DISPATCH_NODE_KIND(Call)
+        DISPATCH_NODE_KIND(ExpressionList)
+        DISPATCH_NODE_KIND(For)
+        DISPATCH_NODE_KIND(Function)
+        DISPATCH_NODE_KIND(FunctionParameter)
+        DISPATCH_NODE_KIND(If)
+        DISPATCH_NODE_KIND(IndexAccess)
+        DISPATCH_NODE_KIND(LiteralBool)
+        DISPATCH_NODE_KIND(LiteralChar)
+        DISPATCH_NODE_KIND(LiteralInt)
+        DISPATCH_NODE_KIND(LiteralFloat)
+        DISPATCH_NODE_KIND(LiteralDouble)
+        DISPATCH_NODE_KIND(LiteralString)
+        DISPATCH_NODE_KIND(OperatorExpression)
+        DISPATCH_NODE_KIND(Return)
+        DISPATCH_NODE_KIND(TernaryOperator)
+        DISPATCH_NODE_KIND(UnaryExpression)
+        DISPATCH_NODE_KIND(Variable)
+        DISPATCH_NODE_KIND(VariableDeclaration)
+    }
+    throw std::logic_error("Cannot dispatch on a node of unknown kind.");
+}
+
+#undef DISPATCH_NODE_KIND
+
+/// Combines several lambdas into one callable, e.g. for dispatch() or walk():
+///   walk(ast, overloaded{ [&](Variable &variable) { ... }, [](AbstractNode &) {} });
+template <typename... Fs>
+struct overloaded : Fs...
+{
+    using Fs::operator()...;
+};
+
+template <typename... Fs>
+overloaded(Fs...) -> overloaded<Fs...>;
+
+/// Calls f with every (non-null) child of the node, in the order of the node's NodeIterator. Unlike the NodeIterator,
+/// which allocates its implementation and calls it virtually, this uses the getters of the concrete class.
+/// \param node A node of a concrete class (e.g. as passed to the callable of dispatch()), possibly const
+/// \param f Callable with a child, which is passed as (const) AbstractNode &
+template <typename N, typename F>
+void forEachChild(N &node, F &&f)
+{
+    using Node = std::remove_const_t<N>;
+    using Child = match_const_t<N, AbstractNode>;
+    auto each = [&f](auto &&children) {
+        for (auto &child : children)
+            f(static_cast<Child &>(child.get()));
+    };
+
+    if constexpr (std::is_same_v<Node, Assignment> || std::is_same_v<Node, VariableDeclaration>)
+    {
+        if (node.hasTarget())
+            f(static_cast<Child &>(node.getTarget()));
+        if (node.hasValue())
+            f(static_cast<Child &>(node.getValue()));
+    }
+    else if constexpr (std::is_same_v<Node, BinaryExpression>)
+    {
+        if (node.hasLeft())
+            f(static_cast<Child &>(node.getLeft()));
+        if (node.hasRight())
+            f(static_cast<Child &>(node.getRight()));
+    }
+    else if constexpr (std::is_same_v<Node, Block>)
+    {
+        each(node.getStatements());
+    }
+    else if constexpr (std::is_same_v<Node, Call>)
+    {
+        each(node.getArguments());
+    }
+    else if constexpr (std::is_same_v<Node, ExpressionList>)
+    {
+        each(node.getExpressions());
+    }
+    else if constexpr (std::is_same_v<Node, OperatorExpression>)
+    {
+        each(node.getOperands());
+    }
+    else if constexpr (std::is_same_v<Node, For>)
+    {
+        if (node.hasInitializer())
+            f(static_cast<Child &>(node.getInitializer()));
+        if (node.hasCondition())
+            f(static_cast<Child &>(node.getCondition()));
+        if (node.hasUpdate())
+            f(static_cast<Child &>(node.getUpdate()));
+        if (node.hasBody())
+            f(static_cast<Child &>(node.getBody()));
+    }
+    else if constexpr (std::is_same_v<Node, Function>)
+    {
+        each(node.getParameters());
+        if (node.hasBody())
+            f(static_cast<Child &>(node.getBody()));
+    }
+    else if constexpr (std::is_same_v<Node, If>)
+    {
+        if (node.hasCondition())
+            f(static_cast<Child &>(node.getCondition()));
+        if (node.hasThenBranch())
+            f(static_cast<Child &>(node.getThenBranch()));
+        if (node.hasElseBranch())
+            f(static_cast<Child &>(node.getElseBranch()));
+    }
+    else if constexpr (std::is_same_v<Node, IndexAccess>)
+    {
+        if (node.hasTarget())
+            f(static_cast<Child &>(node.getTarget()));
+        if (node.hasIndex())
+            f(static_cast<Child &>(node.getIndex()));
+    }
+    else if constexpr (std::is_same_v<Node, Return>)
+    {
+        if (node.hasValue())
+            f(static_cast<Child &>(node.getValue()));
+    }
+    else if constexpr (std::is_same_v<Node, TernaryOperator>)
+    {
+        if (node.hasCondition())
+            f(static_cast<Child &>(node.getCondition()));
+        if (node.hasThenExpr())
+            f(static_cast<Child &>(node.getThenExpr()));
+        if (node.hasElseExpr())
+            f(static_cast<Child &>(node.getElseExpr()));
+    }
+    else if constexpr (std::is_same_v<Node, UnaryExpression>)
+    {
+        if (node.hasOperand())
+            f(static_cast<Child &>(node.getOperand()));
+    }
+    else
+    {
+        // FunctionParameter, the Literals and Variable have no children
+        static_assert(std::is_same_v<Node, FunctionParameter> || std::is_same_v<Node, Variable> ||
+                          std::is_same_v<Node, LiteralBool> || std::is_same_v<Node, LiteralChar> ||
+                          std::is_same_v<Node, LiteralInt> || std::is_same_v<Node, LiteralFloat> ||
+                          std::is_same_v<Node, LiteralDouble> || std::is_same_v<Node, LiteralString>,
+                      "forEachChild() must be called with a node of a concrete class.");
+    }
+}
+
+/// Handler of walk() that does nothing
+struct NoHandler
+{
+    template <typename N>
+    void operator()(N &) const
+    {}
+};
+
+/// Traverses the AST in depth-first order without defining a visitor, calling pre before and post after the children
+/// of every node, both with the node cast to its concrete class (see dispatch()). If pre returns a bool, the children
+/// of the nodes for which it returns false are skipped. pre may change the children of the node it is called with.
+/// Uses an explicit stack, since unrolled programs nest expressions arbitrarily deep.
+/// \param root The node to start at, which is visited as well
+/// \param pre Called before the children of a node, e.g. a generic lambda or overloaded{...}
+/// \param post Called after the children of a node
+template <typename N, typename Pre, typename Post = NoHandler>
+void walk(N &root, Pre &&pre, Post &&post = Post())
+{
+    using Node = match_const_t<N, AbstractNode>;
+    constexpr bool hasPost = !std::is_same_v<std::decay_t<Post>, NoHandler>;
+
+    // a node is pushed again (as visited) below its children, such that post runs once they are done
+    std::vector<std::pair<Node *, bool>> stack{ { &root, false } };
+    while (!stack.empty())
+    {
+        auto [node, visited] = stack.back();
+        stack.pop_back();
+        if (visited)
+        {
+            dispatch(*node, post);
+            continue;
+        }
+
+        dispatch(*node, [&pre, &stack, node = node](auto &concrete) {
+            if constexpr (std::is_same_v<decltype(pre(concrete)), bool>)
+            {
+                if (!pre(concrete))
+                    return;
+            }
+            else
+            {
+                pre(concrete);
+            }
+
+            if constexpr (hasPost)
+                stack.emplace_back(node, true);
+            auto first = stack.size();
+            forEachChild(concrete, [&stack](Node &child) { stack.emplace_back(&child, false); });
+            std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(first), stack.end());
+        });
+    }
+}
+
+/// Replaces expressions bottom-up without defining a visitor: like the post handler of walk(), f is called with every
+/// expression below and including root (cast to its concrete class) once the replacements of its children have been
+/// swapped in, and returns the replacement of the expression or nullptr to keep it. Replacements are not traversed.
+/// \param root The expression to start at, which may be replaced as well
+/// \param f Callable with every concrete expression class, returning a std::unique_ptr<AbstractExpression>
+/// \return The replacement of root, which the caller has to swap in, or nullptr if root is kept
+/// \throws std::logic_error if f replaces the target of an IndexAccess, which must remain an AbstractTarget
+template <typename F>
+std::unique_ptr<AbstractExpression> rewriteBottomUp(AbstractExpression &root, F &&f)
+{
+    // replacements of the expressions whose parent has not been reached yet, which are all still alive
+    std::unordered_map<const AbstractNode *, std::unique_ptr<AbstractExpression>> replacements;
+    auto take = [&replacements](AbstractExpression &expr) {
+        std::unique_ptr<AbstractExpression> replacement;
+        auto it = replacements.find(&expr);
+        if (it != replacements.end())
+        {
+            replacement = std::move(it->second);
+            replacements.erase(it);
+        }
+        return replacement;
+    };
+    auto replaceEach = [&take](std::vector<std::unique_ptr<AbstractExpression>> &children, AbstractNode &parent) {
+        for (auto &child : children)
+        {
+            if (!child)
+                continue;
+            if (auto replacement = take(*child))
+            {
+                child = std::move(replacement);
+                child->setParent(parent);
+            }
+        }
+    };
+
+    walk(root, NoHandler(), [&](auto &node) {
+        using Node = std::remove_reference_t<decltype(node)>;
+        if constexpr (std::is_base_of_v<AbstractExpression, Node>)
+        {
+            if (!replacements.empty())
+            {
+                if constexpr (std::is_same_v<Node, BinaryExpression>)
+                {
+                    if (node.hasLeft())
+                        if (auto replacement = take(node.getLeft()))
+                            node.setLeft(std::move(replacement));
+                    if (node.hasRight())
+                        if (auto replacement = take(node.getRight()))
+                            node.setRight(std::move(replacement));
+                }
+                else if constexpr (std::is_same_v<Node, Call>)
+                {
+                    replaceEach(node.getArgumentPtrs(), node);
+                }
+                else if constexpr (std::is_same_v<Node, ExpressionList>)
+                {
+                    replaceEach(node.getExpressionPtrs(), node);
+                }
+                else if constexpr (std::is_same_v<Node, IndexAccess>)
+                {
+                    if (node.hasTarget() && take(node.getTarget()))
+                        throw std::logic_error("The target of an IndexAccess cannot be replaced.");
+                    if (node.hasIndex())
+                        if (auto replacement = take(node.getIndex()))
+                            node.setIndex(std::move(replacement));
+                }
+                else if constexpr (std::is_same_v<Node, OperatorExpression>)
+                {
+                    replaceEach(node.getOperandPtrs(), node);
+                }
+                else if constexpr (std::is_same_v<Node, TernaryOperator>)
+                {
+                    if (node.hasCondition())
+                        if (auto replacement = take(node.getCondition()))
+                            node.setCondition(std::move(replacement));
+                    if (node.hasThenExpr())
+                        if (auto replacement = take(node.getThenExpr()))
+                            node.setThenExpr(std::move(replacement));
+                    if (node.hasElseExpr())
+                        if (auto replacement = take(node.getElseExpr()))
+                            node.setElseExpr(std::move(replacement));
+                }
+                else if constexpr (std::is_same_v<Node, UnaryExpression>)
+                {
+                    if (node.hasOperand())
+                        if (auto replacement = take(node.getOperand()))
+                            node.setOperand(std::move(replacement));
+                }
+            }
+
+            if (auto replacement = f(node))
+                replacements.emplace(&node, std::move(replacement));
+        }
+    });
+    return take(root);
+}
+
+/// CRTP base class for visitors whose handlers are resolved at compile time, such that they can be inlined. This is
+/// meant for analyses that visit every node of large ASTs, where the virtual accept() and visit() of an IVisitor
+/// dominate the analysis itself.
+///
+/// Like a SpecialVisitor for the Visitor<..> template, Derived defines visit() only for the classes it is interested
+/// in, which may also be base classes like AbstractExpression. traverse() calls the most specific visit() of Derived
+/// for a node and visits the children of the nodes Derived has no visit() for. A visit() has to call visitChildren()
+/// itself to continue into the children of its node:
+///   class VariableCounter : public StaticVisitor<VariableCounter>
+///   {
+///   public:
+///       size_t count = 0;
+///       void visit(Variable &) { ++count; }
+///   };
+///   VariableCounter counter;
+///   counter.traverse(*ast);
+///
+/// The handlers must be public, since they are detected with has_visit. Note that this recurses into the children,
+/// like the IVisitor based visitors, see walk() for an iterative traversal.
+/// \tparam Derived The class implementing the visit() functions
+template <typename Derived>
+class StaticVisitor
+{
+public:
+    /// Visits the node with the most specific visit() of Derived, or its children if there is none
+    /// \param node Any node, possibly const
+    template <typename N>
+    void traverse(N &node)
+    {
+        dispatch(node, [this](auto &concrete) {
+            if constexpr (has_visit<Derived &, decltype(concrete)>)
+                derived().visit(concrete);
+            else
+                visitChildren(concrete);
+        });
+    }
+
+    /// Traverses all children of the node
+    template <typename N>
+    void visitChildren(N &node)
+    {
+        auto visit = [this](auto &child) { traverse(child); };
+        if constexpr (std::is_abstract_v<std::remove_const_t<N>>)
+            dispatch(node, [&visit](auto &concrete) { forEachChild(concrete, visit); });
+        else
+            forEachChild(node, visit);
+    }
+
+protected:
+    Derived &derived()
+    {
+        return static_cast<Derived &>(*this);
+    }
+};
+
+#endif // AST_UTILS_STATIC_VISITOR_H_
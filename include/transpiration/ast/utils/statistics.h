@@ -0,0 +1,151 @@
+#ifndef AST_UTILS_STATISTICS_H_
+#define AST_UTILS_STATISTICS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+/// What the compiler counts while it runs
+enum class Counter
+{
+    TOKENS,
+    NODES_ALLOCATED,
+    SCOPES_CREATED,
+    IDENTIFIERS_RESOLVED,
+    MLIR_OPERATIONS_CREATED,
+    FUNCTIONS_COMPILED,
+    FUNCTIONS_REUSED,
+    PROGRAMS_REUSED,
+    COUNT // number of counters, not a counter
+};
+
+/// String representation of enums
+std::string enumToString(Counter counter);
+
+/// Process-wide instrumentation of the compiler, i.e., of the Parser, the visitors and the MLIR pass manager:
+///  - counters that are always updated, since an increment per node is negligible compared to building the node,
+///  - the bytes of all live AST nodes and their peak (AbstractNode allocates through this class),
+///  - a tree of nested phases (see PhaseTimer), which is only timed while timing is enabled,
+/// which toJson() reports for scraping and print() for humans (see transpiration-compile --stats/--time-phases).
+/// The compiler is single-threaded, so is this class.
+class CompilerStatistics
+{
+private:
+    /// A phase and its nested phases, with all calls of the same phase within the same parent merged
+    struct Phase
+    {
+        std::string name;
+        size_t parent;
+        std::vector<size_t> children;
+        size_t calls = 0;
+        double milliseconds = 0;
+
+        /// Peak resident set size of the process when the phase ended (the last time)
+        size_t peakResidentBytes = 0;
+    };
+
+    static bool timingEnabled;
+
+    static size_t counters[static_cast<size_t>(Counter::COUNT)];
+
+    static size_t liveNodeBytes;
+
+    static size_t peakNodeBytes;
+
+    /// Index 0 is the root, which is never timed
+    static std::vector<Phase> phases;
+
+    /// A phase that is currently running
+    struct Run
+    {
+        size_t phase;
+        std::chrono::steady_clock::time_point start;
+
+        /// Started while the phase was already running, i.e., part of the outer run
+        bool reentrant;
+    };
+
+    /// Innermost last
+    static std::vector<Run> running;
+
+    static nlohmann::json phaseToJson(size_t index);
+
+    static void printPhase(std::ostream &os, size_t index, size_t depth);
+
+public:
+    /// Starts timing phases (the counters are always updated)
+    static void enableTiming(bool enabled = true);
+
+    [[nodiscard]] static bool isTimingEnabled();
+
+    static void increment(Counter counter, size_t n = 1)
+    {
+        counters[static_cast<size_t>(counter)] += n;
+    }
+
+    [[nodiscard]] static size_t get(Counter counter);
+
+    static void allocateNodeBytes(size_t bytes)
+    {
+        liveNodeBytes += bytes;
+        if (liveNodeBytes > peakNodeBytes)
+            peakNodeBytes = liveNodeBytes;
+    }
+
+    static void releaseNodeBytes(size_t bytes)
+    {
+        liveNodeBytes -= bytes;
+    }
+
+    [[nodiscard]] static size_t getLiveNodeBytes();
+
+    [[nodiscard]] static size_t getPeakNodeBytes();
+
+    /// Starts a phase nested into the phase that is currently running (no-op unless timing is enabled). Starting the
+    /// phase that is currently running again, e.g., the Parser's "parse" within the CompilerPipeline's or a recursive
+    /// visit, does not nest it into itself.
+    static void startPhase(const std::string &name);
+
+    /// Ends the innermost running phase, if any
+    static void stopPhase();
+
+    /// Peak resident set size of the process so far, in bytes
+    static size_t peakResidentBytes();
+
+    /// Resets the counters, the peak node bytes (to the live node bytes) and the phases, but not whether timing is
+    /// enabled
+    static void reset();
+
+    /// The counters and the phase tree:
+    ///   { "counters": { "tokens": 1423, ..., "live_node_bytes": 0, "peak_node_bytes": 98304 },
+    ///     "phases": [ { "name": "ast-passes", "calls": 1, "ms": 1.3, "peak_rss_bytes": 5693440,
+    ///                   "phases": [ { "name": "secret-taint", ... } ] }, ... ] }
+    [[nodiscard]] static nlohmann::json toJson();
+
+    /// Prints the phase tree with one indented line per phase, followed by the counters
+    static void print(std::ostream &os);
+};
+
+/// Times the enclosing scope as a phase of the CompilerStatistics:
+///   { PhaseTimer timer("parse"); ... }
+class PhaseTimer
+{
+private:
+    /// Was timing enabled when the phase started?
+    bool timed;
+
+public:
+    explicit PhaseTimer(const std::string &name);
+
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer &other) = delete;
+
+    PhaseTimer &operator=(const PhaseTimer &other) = delete;
+};
+
+#endif // AST_UTILS_STATISTICS_H_
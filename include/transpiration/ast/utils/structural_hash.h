@@ -0,0 +1,28 @@
+#ifndef AST_UTILS_STRUCTURAL_HASH_H_
+#define AST_UTILS_STRUCTURAL_HASH_H_
+
+#include <cstdint>
+#include <string>
+
+#include "transpiration/ast/abstract_node.h"
+
+/// Hash of what a subtree means to the compiler: the classes of its nodes, their attributes (identifiers, operators,
+/// datatypes including the secret flag, values of literals) and which of their children are present, but not the
+/// unique node IDs, parents or bindings of the nodes. The same Function parsed from two versions of a program thus has
+/// the same hash as long as it has not been edited, which is what the CompilerPipeline caches compiled Functions by
+/// (see FunctionCache). The hash does not depend on the standard library's std::hash, so it can be persisted.
+/// \param node Root of the subtree, which is traversed iteratively (see walk())
+/// \return The hash
+uint64_t structuralHash(const AbstractNode &node);
+
+/// Hash of a string that can be persisted (64-bit FNV-1a)
+uint64_t stableHash(const std::string &s);
+
+/// Combines two hashes like boost::hash_combine (with the 64-bit constant), e.g. the structural hash of a Function
+/// with the hash of the options it is compiled with
+inline uint64_t combineHashes(uint64_t seed, uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+#endif // AST_UTILS_STRUCTURAL_HASH_H_
@@ -0,0 +1,47 @@
+#ifndef AST_UTILS_TRAVERSAL_STACK_H_
+#define AST_UTILS_TRAVERSAL_STACK_H_
+
+#include <vector>
+
+#include "transpiration/ast/abstract_node.h"
+#include "transpiration/ast/utils/ivisitor.h"
+
+/// Explicit stack of the nodes a visitor has yet to visit, which drives the default traversal of the ScopedVisitor and
+/// the PlainVisitor without recursing on the C++ stack for every level of the AST. Otherwise, deep ASTs like the
+/// left-deep chain x0 + x1 + ... + x1000000, which unrolled kernels consist of, overflow the stack.
+///
+/// visitChildren() visits the children of a node one after the other and returns once they have all been visited,
+/// like a loop that calls accept() on every child. A default visit(), which does nothing after visiting the children of
+/// its node, calls deferChildren() instead: if its node was dispatched by visitChildren() directly, the children are
+/// only pushed on the stack and visited by that visitChildren() after the default visit() returned. Otherwise (e.g. if
+/// a visit() of a SpecialVisitor called accept() on the node and inspects its subtree afterwards), deferChildren()
+/// visits the children right away. Either way, the nodes are visited in the same order as if every visit() recursed.
+///
+/// Handlers of a SpecialVisitor that visit the children themselves still recurse, so do those that call a default
+/// visit() of their base class. The latter must not inspect the subtree of the node afterwards, since the children
+/// might not have been visited yet.
+class TraversalStack
+{
+private:
+    /// Nodes yet to be visited, the next one on top
+    std::vector<AbstractNode *> nodes;
+
+    /// The node whose visit() visitChildren() is currently calling, if any
+    AbstractNode *dispatched = nullptr;
+
+    /// Pushes the children of the node such that the first child is on top
+    void pushChildren(AbstractNode &node);
+
+public:
+    /// Visits all children of the node in order
+    /// \param node Node whose children are visited
+    /// \param visitor The visitor whose visit() is called for every child
+    void visitChildren(AbstractNode &node, IVisitor &visitor);
+
+    /// Visits all children of the node in order, possibly after the caller returned (see above)
+    /// \param node Node whose children are visited
+    /// \param visitor The visitor whose visit() is called for every child
+    void deferChildren(AbstractNode &node, IVisitor &visitor);
+};
+
+#endif // AST_UTILS_TRAVERSAL_STACK_H_
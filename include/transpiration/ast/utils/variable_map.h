@@ -6,6 +6,9 @@
 
 #include "transpiration/ast/utils/scope.h"
 
+/// Maps variables to values (e.g., their taint or their value in an interpreter) with expected O(1) operations, since a
+/// ScopedIdentifier is hashed and compared by its (scope, symbol) key only: different ScopedIdentifier objects for the
+/// same variable are the same entry.
 template <typename T>
 class VariableMap
 {
@@ -30,63 +33,21 @@ public:
 
     VariableMap &operator=(VariableMap &&other) noexcept = default;
 
+    /// \throws std::out_of_range if there is no entry for s
     [[nodiscard]] const T &get(const ScopedIdentifier &s) const
     {
-        // This is inefficient, but having "semantically" unique entries is worth it
-        // If there already exists a ScopedIdentifier that's basically the same,
-        // but wrapped int a different object, then use the existing value
-        if (map.find(s) == map.end())
-        {
-            for (auto &[si, v] : map)
-            {
-                if (&si.getScope() == &s.getScope() && si.getId() == s.getId())
-                {
-                    return map.find(si)->second;
-                }
-            }
-        }
-
-        return map.find(s)->second;
+        return map.at(s);
     }
 
+    /// \throws std::out_of_range if there is no entry for s
     [[nodiscard]] const T &at(const ScopedIdentifier &s) const
     {
-        // This is inefficient, but having "semantically" unique entries is worth it
-        // If there already exists a ScopedIdentifier that's basically the same,
-        // but wrapped int a different object, then use the existing value
-        if (map.find(s) == map.end())
-        {
-            for (auto &[si, v] : map)
-            {
-                if (&si.getScope() == &s.getScope() && si.getId() == s.getId())
-                {
-                    return map.find(si)->second;
-                }
-            }
-        }
-        return map.find(s)->second;
+        return map.at(s);
     }
 
     void erase(const ScopedIdentifier &s)
     {
-        // This is inefficient, but having "semantically" unique entries is worth it
-        // If there already exists a ScopedIdentifier that's basically the same,
-        // but wrapped int a different object, then use the existing value
-        if (map.find(s) == map.end())
-        {
-            for (auto &[si, v] : map)
-            {
-                if (&si.getScope() == &s.getScope() && si.getId() == s.getId())
-                {
-                    auto it = map.find(si);
-                    map.erase(it);
-                    changed.erase(si);
-                }
-            }
-        }
-
-        auto it = map.find(s);
-        map.erase(it);
+        map.erase(s);
         changed.erase(s);
     }
 
@@ -96,22 +57,8 @@ public:
         changed.insert(s);
     }
 
-    void insert_or_assign(ScopedIdentifier s, T &&v)
+    void insert_or_assign(const ScopedIdentifier &s, T &&v)
     {
-        // This is inefficient, but having "semantically" unique entries is worth it
-        // If there already exists a ScopedIdentifier that's basically the same,
-        // but wrapped int a different object, then use the existing value
-        if (map.find(s) == map.end())
-        {
-            for (auto &[si, v_ignored] : map)
-            {
-                if (&si.getScope() == &s.getScope() && si.getId() == s.getId())
-                {
-                    s = si;
-                }
-            }
-        }
-
         map.insert_or_assign(s, std::move(v));
         changed.insert(s);
     }
@@ -130,17 +77,9 @@ public:
         }
     }
 
-    bool has(const ScopedIdentifier &s)
+    [[nodiscard]] bool has(const ScopedIdentifier &s) const
     {
-        // This is somewhat inefficient, but comparing by actual semantics is so much more useful
-        for (auto &[sv, expr] : map)
-        {
-            if (&sv.getScope() == &s.getScope() && sv.getId() == s.getId())
-            {
-                return true;
-            }
-        }
-        return false;
+        return map.find(s) != map.end();
     }
 
     void resetChangeFlags()
@@ -158,7 +97,7 @@ public:
         return map.end();
     }
 
-    [[nodiscard]] size_t count(ScopedIdentifier s) const
+    [[nodiscard]] size_t count(const ScopedIdentifier &s) const
     {
         return map.count(s);
     }
@@ -110,6 +110,11 @@ public:
         VISIT_SPECIAL_VISITOR_IF_EXISTS(Block);
     }
 
+    void visit(Call &elem) override
+    {
+        VISIT_SPECIAL_VISITOR_IF_EXISTS(Call);
+    }
+
     void visit(ExpressionList &elem) override
     {
         VISIT_SPECIAL_VISITOR_IF_EXISTS(ExpressionList);
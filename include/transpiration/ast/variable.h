@@ -1,12 +1,16 @@
 #ifndef AST_VARIABLE_H_
 #define AST_VARIABLE_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "transpiration/ast/abstract_target.h"
 
+// forward declarations
+class ScopedIdentifier;
+
 /// Named lvalue (any string)
 class Variable : public AbstractTarget
 {
@@ -14,6 +18,12 @@ private:
     /// Name of this variable
     std::string identifier;
 
+    /// The declaration this variable refers to, if stamped by the BindingResolutionVisitor (see setBinding())
+    const ScopedIdentifier *binding = nullptr;
+
+    /// ID of the root scope of the scopes that binding belongs to
+    uint64_t bindingRootScopeId = 0;
+
     /// Creates a deep copy of the current node
     /// Should be used only by Nodes' clone()
     /// \return a copy of the current node
@@ -51,6 +61,22 @@ public:
 
     [[nodiscard]] std::string getIdentifier() const;
 
+    /// Rename the variable, which removes its binding
+    /// \param newIdentifier The new name of the variable
+    void setIdentifier(std::string newIdentifier);
+
+    /// Stamps the variable with the declaration it refers to, see BindingResolutionVisitor. Copies and clones of the
+    /// variable are not bound.
+    /// \param scopedIdentifier The ScopedIdentifier of the declaration
+    /// \param rootScopeId The ID of the root scope of the scopes that scopedIdentifier belongs to
+    void setBinding(const ScopedIdentifier &scopedIdentifier, uint64_t rootScopeId);
+
+    /// Gets the declaration stamped by setBinding(), if it belongs to the given scopes. Since scope IDs are never
+    /// reused, a binding into scopes that no longer exist is never returned to owners of other scopes.
+    /// \param rootScopeId The ID of the root scope of the caller's scopes
+    /// \return (A const pointer to) the ScopedIdentifier of the declaration or nullptr
+    [[nodiscard]] const ScopedIdentifier *getBinding(uint64_t rootScopeId) const;
+
     /// Create a Variable node from a nlohmann::json representation of this node.
     /// \return unique_ptr to a new Variable node
     static std::unique_ptr<Variable> fromJson(nlohmann::json j);
@@ -59,6 +85,7 @@ public:
     ////////// AbstractNode Interface /////////////
     ///////////////////////////////////////////////
     void accept(IVisitor &v) override;
+    NodeKind getNodeKind() const override;
     iterator begin() override;
     const_iterator begin() const override;
     iterator end() override;
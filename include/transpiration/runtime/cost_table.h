@@ -0,0 +1,64 @@
+#ifndef RUNTIME_COST_TABLE_H_
+#define RUNTIME_COST_TABLE_H_
+
+#include <map>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+/// Latencies of the homomorphic primitives for one parameter set, measured on the machine that will run the programs
+/// (see test/bench), which the MockRuntime uses to estimate the latency of a program without running it under FHE.
+/// Stored as JSON:
+///   { "scheme": "bfv", "poly_modulus_degree": 8192, "coeff_modulus_count": 4,
+///     "latencies_us": { "add": 21.0, "multiply": 2500.0, ... } }
+/// where coeff_modulus_count is the number of primes of the ciphertexts at the top level, i.e., without the special
+/// prime. Operations: add (also sub), add_plain (also sub_plain), multiply, multiply_plain, square, negate,
+/// relinearize, rescale, mod_switch, rotate (a single key switch), encode and encrypt.
+class CostTable
+{
+private:
+    std::string scheme;
+    size_t polyModulusDegree;
+    size_t coeffModulusCount;
+
+    /// Latency of each operation at the top level, in microseconds
+    std::map<std::string, double> latencies;
+
+public:
+    CostTable(std::string scheme, size_t polyModulusDegree, size_t coeffModulusCount,
+              std::map<std::string, double> latencies);
+
+    /// Rough latencies of SEAL on a single core of a recent x86 CPU, for N = 8192
+    /// \param scheme "bfv" or "ckks"
+    static CostTable defaults(const std::string &scheme = "bfv");
+
+    /// \throws std::invalid_argument if the JSON does not describe a cost table
+    static CostTable fromJson(const nlohmann::json &j);
+
+    /// Reads a cost table written by toJson()
+    /// \throws std::invalid_argument if the file cannot be read or does not describe a cost table
+    static CostTable load(const std::string &path);
+
+    [[nodiscard]] nlohmann::json toJson() const;
+
+    void save(const std::string &path) const;
+
+    /// Estimated latency of an operation on ciphertexts with the given parameters. Latencies measured for another ring
+    /// dimension or number of primes are scaled by N log N and linearly by the number of primes, which is accurate
+    /// enough to compare programs and parameter sets, but not a substitute for measuring the actual parameters.
+    /// \param operation One of the operations listed above
+    /// \param degree The ring dimension N
+    /// \param primes Number of primes of the operands (CKKS ciphertexts lose one prime with every rescale)
+    /// \return The latency in microseconds, 0 for unknown operations
+    [[nodiscard]] double latency(const std::string &operation, size_t degree, size_t primes) const;
+
+    [[nodiscard]] const std::string &getScheme() const;
+
+    [[nodiscard]] size_t getPolyModulusDegree() const;
+
+    [[nodiscard]] size_t getCoeffModulusCount() const;
+
+    [[nodiscard]] const std::map<std::string, double> &getLatencies() const;
+};
+
+#endif // RUNTIME_COST_TABLE_H_
@@ -0,0 +1,133 @@
+#ifndef RUNTIME_MOCK_MOCK_RUNTIME_H_
+#define RUNTIME_MOCK_MOCK_RUNTIME_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "transpiration/runtime/cost_table.h"
+#include "transpiration/runtime/mock/mock_seal.h"
+
+/// Counterpart of the HoistedRotator for the simulated schemes: performs the same key switches, assuming Galois keys
+/// for all (positive and negative) powers of two, which is what SEAL's KeyGenerator creates by default
+class MockRotator
+{
+private:
+    mock::Evaluator &evaluator;
+
+    /// Number of slots that a rotation cycles through
+    int rowSize;
+
+public:
+    MockRotator(const mock::Context &context, mock::Evaluator &evaluator);
+
+    [[nodiscard]] bool hasKey(int offset) const;
+
+    /// Maps an offset into [-rowSize / 2, rowSize / 2)
+    int normalize(int offset) const;
+
+    /// Signed powers of two, largest magnitude first
+    static std::vector<int> nonAdjacentForm(int offset);
+
+    /// \return One rotated ciphertext per offset, with the shared partial rotations only computed once
+    std::vector<mock::Ciphertext> rotate(
+        const mock::Ciphertext &ciphertext, const std::vector<int> &offsets, mock::MemoryPoolHandle pool = {});
+};
+
+/// Drop-in replacement of the SealRuntime that simulates the schemes (see mock_seal.h) instead of calling SEAL. Code
+/// that the SealEmitterVisitor generates with mockRuntime set compiles against it without SEAL being installed, and
+/// runs several orders of magnitude faster, e.g., in CI:
+///   MockRuntime runtime(f_parameters(), CostTable::load("costs.json"));
+///   auto result = runtime.decrypt(f(runtime, runtime.encrypt(std::vector<int64_t>{ 1, 2, 3 })));
+///   // runtime.getLatency(), runtime.getOperationCounts(), runtime.isNoiseBudgetExhausted()
+/// The decrypted slots are exact (BFV: modulo the plain modulus), while the noise budget, the levels, the sizes and the
+/// latency are estimates, which makes it suitable to tune parameters and passes but not to validate precision.
+class MockRuntime
+{
+private:
+    mock::Statistics statistics;
+
+    CostTable costs;
+
+    template <typename T>
+    std::vector<double> pad(const std::vector<T> &values) const;
+
+public:
+    mock::Context context;
+    mock::Evaluator evaluator;
+    mock::RelinKeys relinKeys;
+    MockRotator rotator;
+    mock::MemoryPoolHandle pool;
+
+    /// Scale of freshly encoded CKKS plaintexts (ignored for BFV/BGV)
+    double scale;
+
+    /// Ignored, operations are simulated faster than threads could be scheduled
+    int threads = 1;
+
+    /// \param parameters Encryption parameters, e.g. the f_parameters() of the generated code
+    /// \param costs Latencies of the operations, by default a rough estimate for SEAL
+    /// \param scale Scale of encoded constants (CKKS only)
+    /// \throws std::invalid_argument if the parameters are incomplete
+    explicit MockRuntime(const mock::EncryptionParameters &parameters, CostTable costs = CostTable::defaults(),
+                         double scale = 0);
+
+    MockRuntime(const MockRuntime &other) = delete;
+
+    MockRuntime &operator=(const MockRuntime &other) = delete;
+
+    [[nodiscard]] bool isCkks() const;
+
+    /// Number of slots of a plaintext
+    [[nodiscard]] size_t slotCount() const;
+
+    /// An empty ciphertext, which must be written before it is read
+    [[nodiscard]] mock::Ciphertext allocate() const;
+
+    /// Encodes a single value into every slot, at the level and scale of `like` (CKKS)
+    mock::Plaintext encode(double value, const mock::Ciphertext &like);
+    mock::Plaintext encode(int64_t value, const mock::Ciphertext &like);
+
+    /// Encodes a vector into the first slots (the remaining slots are zero), at the level and scale of `like` (CKKS)
+    mock::Plaintext encode(const std::vector<double> &values, const mock::Ciphertext &like);
+    mock::Plaintext encode(const std::vector<int64_t> &values, const mock::Ciphertext &like);
+
+    /// Encrypts a constant, see encode() for the slot layout
+    mock::Ciphertext encrypt(double value);
+    mock::Ciphertext encrypt(int64_t value);
+    mock::Ciphertext encrypt(const std::vector<double> &values);
+    mock::Ciphertext encrypt(const std::vector<int64_t> &values);
+
+    /// Rotates to the left by offset slots (to the right if negative), directly if there is a Galois key for the
+    /// offset and via the MockRotator otherwise
+    void rotate(const mock::Ciphertext &ciphertext, int offset, mock::Ciphertext &destination);
+    void rotateInplace(mock::Ciphertext &ciphertext, int offset);
+
+    /// Brings two CKKS ciphertexts to the same level and scale before they are combined (no-op for BFV/BGV)
+    void align(mock::Ciphertext &x, mock::Ciphertext &y);
+
+    /// The slots of a ciphertext, i.e., the result of decrypting and decoding it
+    /// \throws std::runtime_error if the ciphertext ran out of noise budget, i.e., SEAL would decrypt garbage
+    std::vector<double> decrypt(const mock::Ciphertext &ciphertext) const;
+
+    /// Noise budget (BFV) or room for the scale (CKKS) that is left in the ciphertext, in bits
+    [[nodiscard]] double noiseBudget(const mock::Ciphertext &ciphertext) const;
+
+    /// Estimated latency of all operations so far, in microseconds
+    [[nodiscard]] double getLatency() const;
+
+    /// Number of executions of each operation so far
+    [[nodiscard]] const std::map<std::string, size_t> &getOperationCounts() const;
+
+    /// Has any ciphertext run out of noise budget (or room for its scale) so far?
+    [[nodiscard]] bool isNoiseBudgetExhausted() const;
+
+    /// The first operation that exhausted the noise budget of a ciphertext, empty if there was none
+    [[nodiscard]] const std::string &getExhaustingOperation() const;
+
+    /// Resets the latency, the operation counts and the exhaustion flag
+    void resetStatistics();
+};
+
+#endif // RUNTIME_MOCK_MOCK_RUNTIME_H_
@@ -0,0 +1,251 @@
+#ifndef RUNTIME_MOCK_MOCK_SEAL_H_
+#define RUNTIME_MOCK_MOCK_SEAL_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "transpiration/runtime/cost_table.h"
+
+/// Stand-ins for the parts of SEAL's API that the code generated by the SealEmitterVisitor uses, which simulate the
+/// schemes instead of computing on polynomials: a ciphertext is its vector of plaintext slots plus an estimate of its
+/// noise budget (BFV) or its scale (CKKS), its level and its size. Every operation updates these like SEAL would,
+/// throws where SEAL would throw (e.g., multiplying CKKS ciphertexts at different levels) and adds its latency from a
+/// CostTable to the Statistics, which makes running a program several orders of magnitude faster than under SEAL.
+/// The noise model is a heuristic for the worst case of typical inputs (log2 of the noise, in bits):
+///  - fresh BFV ciphertexts have log2(q) - log2(t) - log2(N) / 2 - 1 bits of budget,
+///  - additions add the noise of both operands and key switching (relinearize, rotate) adds the noise of a fresh
+///    ciphertext,
+///  - multiplications consume log2(t) + log2(N) bits, plaintext multiplications log2(t) + log2(N) / 2 bits.
+/// For CKKS, the scale is tracked exactly and the budget is the room left between the scale times the largest slot
+/// and the modulus at the current level.
+namespace mock
+{
+enum class scheme_type
+{
+    bfv,
+    ckks
+};
+
+class Modulus
+{
+private:
+    uint64_t value_ = 0;
+
+public:
+    Modulus() = default;
+
+    explicit Modulus(uint64_t value) : value_(value){};
+
+    [[nodiscard]] uint64_t value() const
+    {
+        return value_;
+    }
+
+    [[nodiscard]] int bit_count() const;
+};
+
+/// Primes p = 1 mod 2N, like SEAL's
+struct CoeffModulus
+{
+    static std::vector<Modulus> Create(size_t polyModulusDegree, const std::vector<int> &bitSizes);
+
+    /// SEAL's default coefficient modulus for BFV at 128 bit security
+    static std::vector<Modulus> BFVDefault(size_t polyModulusDegree);
+};
+
+struct PlainModulus
+{
+    static Modulus Batching(size_t polyModulusDegree, int bitSize);
+};
+
+class EncryptionParameters
+{
+private:
+    scheme_type scheme_;
+    size_t polyModulusDegree = 0;
+    std::vector<Modulus> coeffModulus;
+    Modulus plainModulus;
+
+public:
+    explicit EncryptionParameters(scheme_type scheme) : scheme_(scheme){};
+
+    void set_poly_modulus_degree(size_t degree)
+    {
+        polyModulusDegree = degree;
+    }
+
+    void set_coeff_modulus(const std::vector<Modulus> &modulus)
+    {
+        coeffModulus = modulus;
+    }
+
+    void set_plain_modulus(const Modulus &modulus)
+    {
+        plainModulus = modulus;
+    }
+
+    [[nodiscard]] scheme_type scheme() const
+    {
+        return scheme_;
+    }
+
+    [[nodiscard]] size_t poly_modulus_degree() const
+    {
+        return polyModulusDegree;
+    }
+
+    [[nodiscard]] const std::vector<Modulus> &coeff_modulus() const
+    {
+        return coeffModulus;
+    }
+
+    [[nodiscard]] const Modulus &plain_modulus() const
+    {
+        return plainModulus;
+    }
+};
+
+/// Memory is not pooled, the handles only exist for the signatures
+struct MemoryPoolHandle
+{
+    static MemoryPoolHandle New()
+    {
+        return {};
+    }
+};
+
+struct RelinKeys
+{};
+
+struct Plaintext
+{
+    std::vector<double> slots;
+    double scale = 1;
+    size_t level = 0;
+};
+
+struct Ciphertext
+{
+    std::vector<double> slots;
+
+    /// Number of polynomials, 3 after a multiplication until it is relinearized
+    size_t size = 2;
+
+    /// Index of the last prime of the modulus, i.e., the number of rescales that are left
+    size_t level = 0;
+
+    /// CKKS only
+    double scale = 1;
+
+    /// BFV only, in bits
+    double noiseBudget = 0;
+};
+
+/// The parameters and everything derived from them
+class Context
+{
+public:
+    scheme_type scheme;
+    size_t polyModulusDegree;
+
+    /// Primes of the data level, without the special prime
+    std::vector<Modulus> primes;
+
+    /// BFV only
+    uint64_t plainModulus;
+
+    size_t slotCount;
+
+    /// Noise budget of a fresh BFV ciphertext
+    double freshNoiseBudget;
+
+    /// \throws std::invalid_argument if the parameters are incomplete
+    explicit Context(const EncryptionParameters &parameters);
+
+    [[nodiscard]] size_t topLevel() const;
+
+    /// log2 of the product of the primes up to level
+    [[nodiscard]] double modulusBits(size_t level) const;
+};
+
+/// What the operations have cost so far
+struct Statistics
+{
+    /// Sum of the latencies of all operations, in microseconds
+    double latency = 0;
+
+    /// Number of executions of each operation
+    std::map<std::string, size_t> operations;
+
+    /// Has any ciphertext run out of noise budget (BFV) or room for its scale (CKKS)?
+    bool noiseBudgetExhausted = false;
+
+    /// The operation that exhausted the budget first
+    std::string exhaustedBy;
+
+    /// Generated code with task graphs runs operations from several threads
+    std::mutex mutex;
+};
+
+class Evaluator
+{
+private:
+    const Context &context;
+    const CostTable &costs;
+    Statistics &statistics;
+
+    /// Adds the latency of the operation at the level of the ciphertext and checks its budget afterwards
+    void record(const std::string &operation, const Ciphertext &result);
+
+    /// Reduces a value to the centered representative modulo the plain modulus (BFV only)
+    [[nodiscard]] double reduce(double value) const;
+
+    /// Checks that both operands are at the same level (and, for CKKS, have the same scale)
+    void checkCompatible(const Ciphertext &x, size_t level, double scale, bool multiplication) const;
+
+    void multiplySlots(Ciphertext &x, const std::vector<double> &y) const;
+
+public:
+    Evaluator(const Context &context, const CostTable &costs, Statistics &statistics);
+
+    /// Budget left in bits: the noise budget (BFV) or the room for the scale times the largest slot (CKKS)
+    [[nodiscard]] double budget(const Ciphertext &ciphertext) const;
+
+    void add_inplace(Ciphertext &x, const Ciphertext &y);
+
+    void sub_inplace(Ciphertext &x, const Ciphertext &y);
+
+    void multiply_inplace(Ciphertext &x, const Ciphertext &y, MemoryPoolHandle pool = {});
+
+    void square_inplace(Ciphertext &x, MemoryPoolHandle pool = {});
+
+    void add_plain_inplace(Ciphertext &x, const Plaintext &y);
+
+    void sub_plain_inplace(Ciphertext &x, const Plaintext &y);
+
+    void multiply_plain_inplace(Ciphertext &x, const Plaintext &y, MemoryPoolHandle pool = {});
+
+    void negate_inplace(Ciphertext &x);
+
+    void relinearize_inplace(Ciphertext &x, const RelinKeys &relinKeys, MemoryPoolHandle pool = {});
+
+    void rescale_to_next_inplace(Ciphertext &x, MemoryPoolHandle pool = {});
+
+    /// Drops primes until the ciphertext is at the given level
+    void mod_switch_to_inplace(Ciphertext &x, size_t level, MemoryPoolHandle pool = {});
+
+    /// A single key switch: rotate_rows (BFV, each of the two rows of N / 2 slots) or rotate_vector (CKKS)
+    void rotate_inplace(Ciphertext &x, int steps, MemoryPoolHandle pool = {});
+
+    /// Accounts for encoding a plaintext, which the MockRuntime does itself
+    void recordEncoding(const Plaintext &plaintext);
+
+    /// Accounts for encrypting a plaintext, which the MockRuntime does itself
+    void recordEncryption(const Ciphertext &ciphertext);
+};
+} // namespace mock
+
+#endif // RUNTIME_MOCK_MOCK_SEAL_H_
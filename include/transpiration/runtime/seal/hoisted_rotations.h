@@ -0,0 +1,57 @@
+#ifndef RUNTIME_SEAL_HOISTED_ROTATIONS_H_
+#define RUNTIME_SEAL_HOISTED_ROTATIONS_H_
+
+#include <map>
+#include <vector>
+
+#include "seal/seal.h"
+
+/// Rotates one ciphertext by several offsets at once, which is what the code generated for an
+/// ast.ssa.multi_rotate (or a group of rotate() calls on the same variable) calls into.
+/// SEAL does not expose the key-switching decomposition of a ciphertext, so the decomposition itself cannot be shared
+/// between rotations. Instead, offsets without a dedicated Galois key are decomposed into signed powers of two (NAF),
+/// and the partial rotations that several offsets have in common are only computed once, e.g., 5 = 4 + 1 and
+/// 7 = 8 - 1 share nothing, but 5 = 4 + 1 and 6 = 4 + 2 share the rotation by 4. Offsets with a dedicated Galois key
+/// are rotated directly, duplicate offsets are only rotated once.
+class HoistedRotator
+{
+private:
+    const seal::SEALContext &context;
+    seal::Evaluator &evaluator;
+    const seal::GaloisKeys &galoisKeys;
+
+    /// Number of slots that a rotation cycles through, i.e., the row size for BFV/BGV
+    int rowSize;
+
+    /// rotate_vector (CKKS) or rotate_rows (BFV/BGV)
+    bool ckks;
+
+    /// Rotates by a single offset, for which a Galois key must exist
+    void rotate(const seal::Ciphertext &ciphertext, int offset, seal::Ciphertext &destination,
+                seal::MemoryPoolHandle pool);
+
+public:
+    HoistedRotator(const seal::SEALContext &context, seal::Evaluator &evaluator, const seal::GaloisKeys &galoisKeys);
+
+    /// Is there a Galois key for rotating by exactly this offset?
+    [[nodiscard]] bool hasKey(int offset) const;
+
+    /// Maps an offset into [-rowSize / 2, rowSize / 2), where its NAF is shortest
+    int normalize(int offset) const;
+
+    /// Non-adjacent form of the offset, i.e., signed powers of two, largest magnitude first
+    static std::vector<int> nonAdjacentForm(int offset);
+
+    /// \param ciphertext The ciphertext to rotate
+    /// \param offsets Left rotations, negative offsets rotate to the right
+    /// \param pool Memory pool for all temporaries
+    /// \return One rotated ciphertext per offset
+    /// \throws std::invalid_argument if neither a key for an offset nor for the powers of two in its NAF exists
+    std::vector<seal::Ciphertext> rotate(const seal::Ciphertext &ciphertext, const std::vector<int> &offsets,
+                                         seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool());
+
+    /// Number of key switches that rotate() performs for the given offsets
+    [[nodiscard]] size_t countKeySwitches(const std::vector<int> &offsets) const;
+};
+
+#endif // RUNTIME_SEAL_HOISTED_ROTATIONS_H_
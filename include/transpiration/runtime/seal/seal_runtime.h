@@ -0,0 +1,82 @@
+#ifndef RUNTIME_SEAL_SEAL_RUNTIME_H_
+#define RUNTIME_SEAL_SEAL_RUNTIME_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "seal/seal.h"
+#include "transpiration/runtime/seal/hoisted_rotations.h"
+
+/// Everything the code generated by the SealEmitterVisitor needs at runtime. The generated functions call the
+/// Evaluator directly and only use the helpers below for encoding, encryption of constants and (for CKKS) level
+/// management. All temporaries are allocated from a single memory pool, which can be preallocated by the caller.
+/// Generated code with task graphs (see SealEmitterVisitor) calls into the runtime from several threads at once, which
+/// is safe as long as the pool is thread-safe.
+class SealRuntime
+{
+private:
+    std::unique_ptr<seal::BatchEncoder> batchEncoder;
+    std::unique_ptr<seal::CKKSEncoder> ckksEncoder;
+
+    template <typename T>
+    std::vector<T> pad(std::vector<T> values) const;
+
+public:
+    const seal::SEALContext &context;
+    seal::Evaluator evaluator;
+    seal::Encryptor encryptor;
+    const seal::RelinKeys &relinKeys;
+    const seal::GaloisKeys &galoisKeys;
+    HoistedRotator rotator;
+    seal::MemoryPoolHandle pool;
+
+    /// Scale of freshly encoded CKKS plaintexts (ignored for BFV/BGV)
+    double scale;
+
+    /// Number of threads that execute the task graphs in the generated code
+    int threads = 1;
+
+    /// \param context SEAL context the ciphertexts belong to
+    /// \param publicKey Used to encrypt constants that are combined with ciphertexts
+    /// \param relinKeys Used after every ciphertext-ciphertext multiplication
+    /// \param galoisKeys Used for all rotations
+    /// \param scale Scale of encoded constants (CKKS only)
+    /// \param pool Memory pool for all ciphertexts and temporaries, by default a new thread-safe pool
+    SealRuntime(
+        const seal::SEALContext &context, const seal::PublicKey &publicKey, const seal::RelinKeys &relinKeys,
+        const seal::GaloisKeys &galoisKeys, double scale = 0,
+        seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::New());
+
+    [[nodiscard]] bool isCkks() const;
+
+    /// Number of slots of a plaintext
+    [[nodiscard]] size_t slotCount() const;
+
+    /// A ciphertext from the pool with room for the three polynomials of an unrelinearized product
+    [[nodiscard]] seal::Ciphertext allocate() const;
+
+    /// Encodes a single value into every slot, at the level and scale of `like` (CKKS)
+    seal::Plaintext encode(double value, const seal::Ciphertext &like);
+    seal::Plaintext encode(int64_t value, const seal::Ciphertext &like);
+
+    /// Encodes a vector into the first slots (the remaining slots are zero), at the level and scale of `like` (CKKS)
+    seal::Plaintext encode(const std::vector<double> &values, const seal::Ciphertext &like);
+    seal::Plaintext encode(const std::vector<int64_t> &values, const seal::Ciphertext &like);
+
+    /// Encrypts a constant, see encode() for the slot layout
+    seal::Ciphertext encrypt(double value);
+    seal::Ciphertext encrypt(int64_t value);
+    seal::Ciphertext encrypt(const std::vector<double> &values);
+    seal::Ciphertext encrypt(const std::vector<int64_t> &values);
+
+    /// Rotates to the left by offset slots (to the right if negative), directly if there is a Galois key for the
+    /// offset and via the HoistedRotator otherwise
+    void rotate(const seal::Ciphertext &ciphertext, int offset, seal::Ciphertext &destination);
+    void rotateInplace(seal::Ciphertext &ciphertext, int offset);
+
+    /// Brings two CKKS ciphertexts to the same level and scale before they are combined (no-op for BFV/BGV)
+    void align(seal::Ciphertext &x, seal::Ciphertext &y);
+};
+
+#endif // RUNTIME_SEAL_SEAL_RUNTIME_H_
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "transpiration/IR/ast/ASTDialect.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "mlir/IR/DialectImplementation.h"
 #include "mlir/IR/TypeSupport.h"
@@ -96,6 +97,24 @@ bool containsExactlyOneStatementNode(Region &region)
     }
 }
 
+bool endsWithSsaExpressionValue(Region &region)
+{
+    if (region.empty() || region.front().empty())
+    {
+        emitError(region.getLoc(), "Region must end with an AST_SsaExpressionOp but is empty.");
+        return false;
+    }
+    else if (!region.front().back().hasTrait<OpTrait::isAbcSsaExpression>())
+    {
+        emitError(region.front().back().getLoc(), "Last op in region must be an AST_SsaExpressionOp.");
+        return false;
+    }
+    else
+    {
+        return true;
+    }
+}
+
 #include "transpiration/IR/ast/ASTDialect.cpp.inc"
 
 #define GET_TYPEDEF_CLASSES
@@ -122,6 +141,28 @@ void ASTDialect::initialize()
 // TableGen'd op method definitions
 //===----------------------------------------------------------------------===//
 
+LogicalResult SsaMultiRotateOp::verify()
+{
+    auto offsets = getOffsets();
+    if (offsets.size() != getNumResults())
+        return emitOpError("requires one result per offset, but has ") << offsets.size() << " offsets and "
+                                                                      << getNumResults() << " results";
+
+    llvm::SmallDenseSet<int64_t> seen;
+    for (auto offset : offsets.getAsValueRange<IntegerAttr>())
+    {
+        if (!seen.insert(offset.getSExtValue()).second)
+            return emitOpError("has duplicate offset ") << offset.getSExtValue();
+    }
+
+    for (auto result : getResults())
+    {
+        if (result.getType() != getValue().getType())
+            return emitOpError("requires all results to have the type of the rotated value");
+    }
+    return success();
+}
+
 //::mlir::LogicalResult RotateOp::canonicalize(RotateOp op, ::mlir::PatternRewriter &rewriter) {
 //  // First check if this is a constant we can reason about statically
 //  Operation *valueOp = op.rotation().getDefiningOp();
@@ -0,0 +1,171 @@
+#include "transpiration/IR/ast/HoistRotations.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+
+using namespace mlir;
+using namespace heco::ast;
+
+namespace
+{
+/// Rotations of one value within a block, in program order
+struct RotationGroup
+{
+    std::vector<SsaCallOp> calls;
+    std::vector<int64_t> offsets;
+};
+
+/// Identifies the rotated value: either an SSA value, or a variable in between two writes to it
+typedef std::tuple<void *, std::string, unsigned> RotationSource;
+
+/// The literal offset of a rotate(x, k) call
+/// \return false if the call is no rotation or the offset is not a literal integer
+bool getLiteralOffset(SsaCallOp call, int64_t &offset)
+{
+    if (call.getName() != "rotate" || call.getArguments().size() != 2)
+        return false;
+    auto literal = call.getArguments()[1].getDefiningOp<SsaLiteralOp>();
+    if (!literal)
+        return false;
+    auto attr = literal.getValue().dyn_cast<IntegerAttr>();
+    if (!attr)
+        return false;
+    offset = attr.getInt();
+    return true;
+}
+
+void hoistRotations(Block &block)
+{
+    // every write to a variable (and every op with regions, which might write any variable) starts a new epoch
+    std::map<std::string, unsigned> epochs;
+    unsigned barrier = 0;
+    std::map<RotationSource, RotationGroup> groups;
+
+    for (auto &op : block)
+    {
+        if (op.getNumRegions() > 0)
+        {
+            ++barrier;
+        }
+        else if (auto assignment = dyn_cast<SsaAssignmentOp>(&op))
+        {
+            ++epochs[assignment.getTarget().str()];
+        }
+        else if (auto declaration = dyn_cast<SsaVariableDeclarationOp>(&op))
+        {
+            ++epochs[declaration.getName().str()];
+        }
+        else if (auto call = dyn_cast<SsaCallOp>(&op))
+        {
+            int64_t offset;
+            if (!getLiteralOffset(call, offset))
+                continue;
+
+            auto value = call.getArguments()[0];
+            RotationSource source = { value.getAsOpaquePointer(), "", 0 };
+            if (auto variable = value.getDefiningOp<SsaVariableOp>())
+            {
+                auto name = variable.getName().str();
+                source = { nullptr, name, (barrier << 16) + epochs[name] };
+            }
+            groups[source].calls.push_back(call);
+            groups[source].offsets.push_back(offset);
+        }
+    }
+
+    for (auto &[source, group] : groups)
+    {
+        if (group.calls.size() < 2)
+            continue;
+
+        // one result per distinct offset
+        std::vector<int64_t> offsets;
+        std::vector<size_t> resultIndex;
+        for (auto offset : group.offsets)
+        {
+            auto it = std::find(offsets.begin(), offsets.end(), offset);
+            resultIndex.push_back(it - offsets.begin());
+            if (it == offsets.end())
+                offsets.push_back(offset);
+        }
+
+        auto first = group.calls.front();
+        OpBuilder builder(first);
+        auto value = first.getArguments()[0];
+        std::vector<Type> resultTypes(offsets.size(), first.getResult().getType());
+        std::vector<Location> locations;
+        for (auto call : group.calls)
+            locations.push_back(call.getLoc());
+        auto multiRotate = builder.create<SsaMultiRotateOp>(
+            builder.getFusedLoc(locations), resultTypes, value, builder.getI64ArrayAttr(offsets));
+
+        for (size_t i = 0; i < group.calls.size(); ++i)
+        {
+            auto call = group.calls[i];
+            auto rotated = call.getArguments()[0].getDefiningOp();
+            auto offset = call.getArguments()[1].getDefiningOp();
+            call.getResult().replaceAllUsesWith(multiRotate.getResult(resultIndex[i]));
+            call.erase();
+
+            // the variable reads and offset literals of the other calls are now dead
+            if (rotated && rotated->use_empty() && isa<SsaVariableOp>(rotated))
+                rotated->erase();
+            if (offset && offset->use_empty())
+                offset->erase();
+        }
+    }
+}
+
+struct HoistRotationsPass : public PassWrapper<HoistRotationsPass, OperationPass<ModuleOp>>
+{
+    StringRef getArgument() const final
+    {
+        return "hoist-rotations";
+    }
+
+    StringRef getDescription() const final
+    {
+        return "Group rotations of the same value into ast.ssa.multi_rotate ops";
+    }
+
+    void runOnOperation() override
+    {
+        getOperation()->walk([](Block *block) { hoistRotations(*block); });
+    }
+};
+} // namespace
+
+std::unique_ptr<Pass> createHoistRotationsPass()
+{
+    return std::make_unique<HoistRotationsPass>();
+}
+
+std::vector<std::vector<std::string>> collectHoistedRotations(ModuleOp module)
+{
+    std::vector<std::vector<std::string>> groups;
+    module->walk([&groups](SsaMultiRotateOp multiRotate) {
+        std::vector<Location> locations = { multiRotate.getLoc() };
+        if (auto fused = multiRotate.getLoc().dyn_cast<FusedLoc>())
+            locations.assign(fused.getLocations().begin(), fused.getLocations().end());
+
+        std::vector<std::string> names;
+        for (auto location : locations)
+        {
+            if (auto name = location.dyn_cast<NameLoc>())
+                names.push_back(name.getName().str());
+        }
+        groups.push_back(std::move(names));
+    });
+    return groups;
+}
+
+void registerHoistRotationsPass()
+{
+    PassRegistration<HoistRotationsPass>();
+}
@@ -1,13 +1,114 @@
 #include "transpiration/ast/abstract_node.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <queue>
 #include <set>
 #include <sstream>
+#include <vector>
+
+#include "transpiration/ast/utils/node_arena.h"
+#include "transpiration/ast/utils/statistics.h"
+
+namespace
+{
+/// Nodes whose deletion the outermost AbstractNode::destroyNode() of the thread has deferred, if it is running
+thread_local std::vector<std::unique_ptr<AbstractNode>> *deferredDeletions = nullptr;
+
+/// A clone that AbstractNode::cloneNode() has deferred
+struct DeferredClone
+{
+    const AbstractNode *original;
+    AbstractNode *parent;
+    void *member;
+    void (*setter)(void *member, AbstractNode *clone);
+};
+
+/// Clones that the outermost AbstractNode::cloneNode() of the thread has deferred, if it is running
+thread_local std::vector<DeferredClone> *deferredClones = nullptr;
+} // namespace
 
 ///////////////////////////// GENERAL ////////////////////////////////
 // C++ requires a body for the destructor even if it is declared pure virtual
 AbstractNode::~AbstractNode() = default;
 
+void AbstractNode::destroyNode(std::unique_ptr<AbstractNode> node)
+{
+    if (deferredDeletions)
+    {
+        deferredDeletions->push_back(std::move(node));
+        return;
+    }
+
+    // explicit stack instead of recursion: the destructor of every node pushes its children, see destroyChild()
+    std::vector<std::unique_ptr<AbstractNode>> nodes;
+    nodes.push_back(std::move(node));
+    deferredDeletions = &nodes;
+    while (!nodes.empty())
+    {
+        auto next = std::move(nodes.back());
+        nodes.pop_back();
+        next.reset();
+    }
+    deferredDeletions = nullptr;
+}
+
+void AbstractNode::cloneNode(const AbstractNode &original, AbstractNode &parent, void *member, CloneSetter setter)
+{
+    if (deferredClones)
+    {
+        deferredClones->push_back({ &original, &parent, member, setter });
+        return;
+    }
+
+    // explicit stack instead of recursion: the copy constructor of every clone pushes its children, see cloneChild()
+    std::vector<DeferredClone> clones{ { &original, &parent, member, setter } };
+    deferredClones = &clones;
+    try
+    {
+        while (!clones.empty())
+        {
+            auto next = clones.back();
+            clones.pop_back();
+            next.setter(next.member, next.original->clone_impl(next.parent));
+        }
+    }
+    catch (...)
+    {
+        deferredClones = nullptr;
+        throw;
+    }
+    deferredClones = nullptr;
+}
+
+void *AbstractNode::operator new(size_t size)
+{
+    CompilerStatistics::increment(Counter::NODES_ALLOCATED);
+    CompilerStatistics::allocateNodeBytes(size);
+    return ::operator new(size);
+}
+
+void *AbstractNode::operator new(size_t size, NodeArena &arena)
+{
+    CompilerStatistics::increment(Counter::NODES_ALLOCATED);
+    CompilerStatistics::allocateNodeBytes(size);
+    return arena.allocate(size);
+}
+
+void AbstractNode::operator delete(void *pointer, size_t size)
+{
+    CompilerStatistics::releaseNodeBytes(size);
+    if (auto arena = NodeArena::find(pointer))
+        arena->deallocate(size);
+    else
+        ::operator delete(pointer);
+}
+
+void AbstractNode::operator delete(void *, NodeArena &)
+{
+    // the size is unknown here, so the node stays counted (as live) until the arena is destroyed
+}
+
 std::unique_ptr<AbstractNode> AbstractNode::clone(AbstractNode *parent_) const
 {
     return std::unique_ptr<AbstractNode>(clone_impl(parent_));
@@ -108,8 +209,27 @@ std::string AbstractNode::toStringHelper(bool printChildren, std::vector<std::st
     ss << std::endl;
     if (printChildren)
     {
-        for (auto &it : *this)
-            ss << indentationCharacter << it.toString(printChildren);
+        // Every descendant is printed on its own line(s), indented by a single tab, in pre-order. Rather than having
+        // the children print themselves with toString(true) recursively, which the AST might be too deep for, their
+        // toString(false) is extended with the ":" that toString(true) adds for a node with children.
+        std::vector<const AbstractNode *> stack;
+        auto pushChildren = [&stack](const AbstractNode &node) {
+            auto first = stack.size();
+            for (auto &child : node)
+                stack.push_back(&child);
+            std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(first), stack.end());
+        };
+        pushChildren(*this);
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+            auto line = node->toString(false);
+            if (node->countChildren() > 0)
+                line.insert(line.size() - 1, ":");
+            ss << indentationCharacter << line;
+            pushChildren(*node);
+        }
     }
     return ss.str();
 }
@@ -3,26 +3,36 @@
 #include "transpiration/ast/parser/parser.h"
 #include "transpiration/ast/utils/ivisitor.h"
 
-Assignment::~Assignment() = default;
+Assignment::~Assignment()
+{
+    destroyChild(target);
+    destroyChild(value);
+}
 
 Assignment::Assignment(std::unique_ptr<AbstractTarget> target_, std::unique_ptr<AbstractExpression> value_)
     : target(std::move(target_)), value(std::move(value_))
 {
-    target->setParent(*this);
-    value->setParent(*this);
+    adoptChild(target);
+    adoptChild(value);
 }
 
 Assignment::Assignment(const Assignment &other)
-    : target(other.target ? other.target->clone(this) : nullptr),
-      value(other.value ? other.value->clone(this) : nullptr){};
+{
+    cloneChild(target, other.target);
+    cloneChild(value, other.value);
+}
 
-Assignment::Assignment(Assignment &&other) noexcept : target(std::move(other.target)), value(std::move(other.value)){};
+Assignment::Assignment(Assignment &&other) noexcept : target(std::move(other.target)), value(std::move(other.value))
+{
+    adoptChild(target);
+    adoptChild(value);
+}
 
 Assignment &Assignment::operator=(const Assignment &other)
 {
     AbstractStatement::operator=(other);
-    target = other.target ? other.target->clone(this) : nullptr;
-    value = other.value ? other.value->clone(this) : nullptr;
+    cloneChild(target, other.target);
+    cloneChild(value, other.value);
     return *this;
 }
 
@@ -31,6 +41,8 @@ Assignment &Assignment::operator=(Assignment &&other) noexcept
     AbstractStatement::operator=(other);
     target = std::move(other.target);
     value = std::move(other.value);
+    adoptChild(target);
+    adoptChild(value);
     return *this;
 }
 
@@ -110,11 +122,13 @@ std::unique_ptr<AbstractExpression> Assignment::takeValue()
 void Assignment::setTarget(std::unique_ptr<AbstractTarget> newTarget)
 {
     target = std::move(newTarget);
+    adoptChild(target);
 }
 
 void Assignment::setValue(std::unique_ptr<AbstractExpression> newValue)
 {
     value = std::move(newValue);
+    adoptChild(value);
 }
 
 ///////////////////////////////////////////////
@@ -187,3 +201,8 @@ std::string Assignment::getNodeType() const
 {
     return "Assignment";
 }
+
+NodeKind Assignment::getNodeKind() const
+{
+    return NodeKind::Assignment;
+}
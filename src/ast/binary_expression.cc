@@ -5,27 +5,39 @@
 #include "transpiration/ast/parser/parser.h"
 #include "transpiration/ast/utils/ivisitor.h"
 
-BinaryExpression::~BinaryExpression() = default;
+BinaryExpression::~BinaryExpression()
+{
+    destroyChild(left);
+    destroyChild(right);
+}
 
 BinaryExpression::BinaryExpression(
     std::unique_ptr<AbstractExpression> left, Operator op, std::unique_ptr<AbstractExpression> right)
     : left(std::move(left)), op(op), right(std::move(right))
-{}
+{
+    adoptChild(this->left);
+    adoptChild(this->right);
+}
 
 BinaryExpression::BinaryExpression(const BinaryExpression &other)
-    : left(other.left ? other.left->clone(this) : nullptr), op(other.op),
-      right(other.right ? other.right->clone(this) : nullptr)
-{}
+    : op(other.op)
+{
+    cloneChild(left, other.left);
+    cloneChild(right, other.right);
+}
 
 BinaryExpression::BinaryExpression(BinaryExpression &&other) noexcept
     : left(std::move(other.left)), op(other.op), right(std::move(other.right))
-{}
+{
+    adoptChild(left);
+    adoptChild(right);
+}
 
 BinaryExpression &BinaryExpression::operator=(const BinaryExpression &other)
 {
-    left = other.left ? other.left->clone(this) : nullptr;
+    cloneChild(left, other.left);
     op = other.op;
-    right = other.right ? other.right->clone(this) : nullptr;
+    cloneChild(right, other.right);
     return *this;
 }
 
@@ -34,6 +46,8 @@ BinaryExpression &BinaryExpression::operator=(BinaryExpression &&other) noexcept
     left = std::move(other.left);
     op = other.op;
     right = std::move(other.right);
+    adoptChild(left);
+    adoptChild(right);
     return *this;
 }
 
@@ -113,6 +127,7 @@ const AbstractExpression &BinaryExpression::getRight() const
 void BinaryExpression::setLeft(std::unique_ptr<AbstractExpression> newLeft)
 {
     left = std::move(newLeft);
+    adoptChild(left);
 }
 
 void BinaryExpression::setOperator(Operator newOperator)
@@ -123,6 +138,7 @@ void BinaryExpression::setOperator(Operator newOperator)
 void BinaryExpression::setRight(std::unique_ptr<AbstractExpression> newRight)
 {
     right = std::move(newRight);
+    adoptChild(right);
 }
 
 ///////////////////////////////////////////////
@@ -207,3 +223,8 @@ std::string BinaryExpression::getNodeType() const
 {
     return "BinaryExpression";
 }
+
+NodeKind BinaryExpression::getNodeKind() const
+{
+    return NodeKind::BinaryExpression;
+}
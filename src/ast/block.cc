@@ -9,7 +9,11 @@
 /// Convenience typedef for conciseness
 typedef std::unique_ptr<AbstractStatement> stmtPtr;
 
-Block::~Block() = default;
+Block::~Block()
+{
+    for (auto &statement : statements)
+        destroyChild(statement);
+}
 
 Block::Block() = default;
 
@@ -17,38 +21,41 @@ Block::Block(std::unique_ptr<AbstractStatement> statement)
 {
     statements = std::vector<stmtPtr>(1);
     statements[0] = std::move(statement);
+    adoptChildren(statements);
 }
 
 Block::Block(std::vector<std::unique_ptr<AbstractStatement>> &&vectorOfStatements)
-    : statements(std::move(vectorOfStatements)){};
+    : statements(std::move(vectorOfStatements))
+{
+    adoptChildren(statements);
+}
 
 Block::Block(const Block &other)
 {
     // deep-copy the statements, including nullptrs
-    statements.reserve(other.statements.size());
-    for (auto &s : other.statements)
-    {
-        statements.emplace_back(s ? s->clone(this) : nullptr);
-    }
+    statements.resize(other.statements.size());
+    for (size_t i = 0; i < statements.size(); ++i)
+        cloneChild(statements[i], other.statements[i]);
 }
 
 Block::Block(Block &&other) noexcept : statements(std::move(other.statements))
-{}
+{
+    adoptChildren(statements);
+}
 
 Block &Block::operator=(const Block &other)
 {
     statements.clear();
     // deep-copy the statements, including nullptrs
-    statements.reserve(other.statements.size());
-    for (auto &s : other.statements)
-    {
-        statements.emplace_back(s ? s->clone(this) : nullptr);
-    }
+    statements.resize(other.statements.size());
+    for (size_t i = 0; i < statements.size(); ++i)
+        cloneChild(statements[i], other.statements[i]);
     return *this;
 }
 Block &Block::operator=(Block &&other) noexcept
 {
     statements = std::move(other.statements);
+    adoptChildren(statements);
     return *this;
 }
 std::unique_ptr<Block> Block::clone(AbstractNode *parent_) const
@@ -108,11 +115,13 @@ std::vector<std::reference_wrapper<const AbstractStatement>> Block::getStatement
 
 void Block::appendStatement(std::unique_ptr<AbstractStatement> statement)
 {
+    adoptChild(statement);
     statements.emplace_back(std::move(statement));
 }
 
 void Block::prependStatement(std::unique_ptr<AbstractStatement> statement)
 {
+    adoptChild(statement);
     statements.insert(statements.begin(), std::move(statement));
 }
 
@@ -216,3 +225,8 @@ std::string Block::getNodeType() const
 {
     return "Block";
 }
+
+NodeKind Block::getNodeKind() const
+{
+    return NodeKind::Block;
+}
@@ -5,41 +5,46 @@
 /// Convenience typedef for conciseness
 typedef std::unique_ptr<AbstractExpression> exprPtr;
 
-Call::~Call() = default;
+Call::~Call()
+{
+    for (auto &argument : arguments)
+        destroyChild(argument);
+}
 
 Call::Call(std::string identifier, std::vector<std::unique_ptr<AbstractExpression>> &&arguments)
     : identifier(std::move(identifier)), arguments(std::move(arguments))
-{}
+{
+    adoptChildren(this->arguments);
+}
 
 Call::Call(const Call &other) : identifier(other.identifier)
 {
     // deep-copy the arguments, including nullptrs
-    arguments.reserve(other.arguments.size());
-    for (auto &a : other.arguments)
-    {
-        arguments.emplace_back(a ? a->clone(this) : nullptr);
-    }
+    arguments.resize(other.arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
+        cloneChild(arguments[i], other.arguments[i]);
 }
 
 Call::Call(Call &&other) noexcept : identifier(std::move(other.identifier)), arguments(std::move(other.arguments))
-{}
+{
+    adoptChildren(arguments);
+}
 
 Call &Call::operator=(const Call &other)
 {
     identifier = other.identifier;
-    // deep-copy the statements, including nullptrs
     arguments.clear();
-    arguments.reserve(other.arguments.size());
-    for (auto &a : other.arguments)
-    {
-        arguments.emplace_back(a ? a->clone(this) : nullptr);
-    }
+    // deep-copy the arguments, including nullptrs
+    arguments.resize(other.arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
+        cloneChild(arguments[i], other.arguments[i]);
     return *this;
 }
 Call &Call::operator=(Call &&other) noexcept
 {
     identifier = std::move(other.identifier);
     arguments = std::move(other.arguments);
+    adoptChildren(arguments);
     return *this;
 }
 std::unique_ptr<Call> Call::clone(AbstractNode *parent_) const
@@ -77,6 +82,11 @@ std::vector<std::reference_wrapper<AbstractExpression>> Call::getArguments()
     return r;
 }
 
+std::vector<std::unique_ptr<AbstractExpression>> &Call::getArgumentPtrs()
+{
+    return arguments;
+}
+
 ///////////////////////////////////////////////
 ////////// AbstractNode Interface /////////////
 ///////////////////////////////////////////////
@@ -166,4 +176,9 @@ std::string Call::toString(bool printChildren) const
 std::string Call::getNodeType() const
 {
     return "Call";
-}
\ No newline at end of file
+}
+
+NodeKind Call::getNodeKind() const
+{
+    return NodeKind::Call;
+}
@@ -9,39 +9,44 @@
 /// Convenience typedef for conciseness
 typedef std::unique_ptr<AbstractExpression> exprPtr;
 
-ExpressionList::~ExpressionList() = default;
+ExpressionList::~ExpressionList()
+{
+    for (auto &expression : expressions)
+        destroyChild(expression);
+}
 
 ExpressionList::ExpressionList(std::vector<std::unique_ptr<AbstractExpression>> &&expressions)
     : expressions(std::move(expressions))
-{}
+{
+    adoptChildren(this->expressions);
+}
 
 ExpressionList::ExpressionList(const ExpressionList &other)
 {
     // deep-copy the expressions, including nullptrs
-    expressions.reserve(other.expressions.size());
-    for (auto &s : other.expressions)
-    {
-        expressions.emplace_back(s ? s->clone(this) : nullptr);
-    }
+    expressions.resize(other.expressions.size());
+    for (size_t i = 0; i < expressions.size(); ++i)
+        cloneChild(expressions[i], other.expressions[i]);
 }
 
 ExpressionList::ExpressionList(ExpressionList &&other) noexcept : expressions(std::move(other.expressions))
-{}
+{
+    adoptChildren(expressions);
+}
 
 ExpressionList &ExpressionList::operator=(const ExpressionList &other)
 {
     expressions.clear();
     // deep-copy the expressions, including nullptrs
-    expressions.reserve(other.expressions.size());
-    for (auto &s : other.expressions)
-    {
-        expressions.emplace_back(s ? s->clone(this) : nullptr);
-    }
+    expressions.resize(other.expressions.size());
+    for (size_t i = 0; i < expressions.size(); ++i)
+        cloneChild(expressions[i], other.expressions[i]);
     return *this;
 }
 ExpressionList &ExpressionList::operator=(ExpressionList &&other) noexcept
 {
     expressions = std::move(other.expressions);
+    adoptChildren(expressions);
     return *this;
 }
 std::unique_ptr<ExpressionList> ExpressionList::clone(AbstractNode *parent_) const
@@ -102,14 +107,17 @@ std::vector<std::unique_ptr<AbstractExpression>> ExpressionList::takeExpressions
 void ExpressionList::setExpressions(std::vector<std::unique_ptr<AbstractExpression>> new_expressions)
 {
     expressions = std::move(new_expressions);
+    adoptChildren(expressions);
 }
 void ExpressionList::appendExpression(std::unique_ptr<AbstractExpression> expression)
 {
+    adoptChild(expression);
     expressions.emplace_back(std::move(expression));
 }
 
 void ExpressionList::prependExpression(std::unique_ptr<AbstractExpression> expression)
 {
+    adoptChild(expression);
     expressions.insert(expressions.begin(), std::move(expression));
 }
 
@@ -214,3 +222,8 @@ std::string ExpressionList::getNodeType() const
 {
     return "ExpressionList";
 }
+
+NodeKind ExpressionList::getNodeKind() const
+{
+    return NodeKind::ExpressionList;
+}
@@ -4,31 +4,48 @@
 #include "transpiration/ast/utils/node_utils.h"
 
 For::~For()
-{}
+{
+    destroyChild(initializer);
+    destroyChild(condition);
+    destroyChild(update);
+    destroyChild(body);
+}
 For::For(
     std::unique_ptr<Block> initializer, std::unique_ptr<AbstractExpression> condition, std::unique_ptr<Block> update,
     std::unique_ptr<Block> body)
     : initializer(std::move(initializer)), condition(std::move(condition)), update(std::move(update)),
       body(std::move(body))
-{}
+{
+    adoptChild(this->initializer);
+    adoptChild(this->condition);
+    adoptChild(this->update);
+    adoptChild(this->body);
+}
 
 For::For(const For &other)
-    : initializer(other.initializer ? other.initializer->clone(this) : nullptr),
-      condition(other.condition ? other.condition->clone(this) : nullptr),
-      update(other.update ? other.update->clone(this) : nullptr), body(other.body ? other.body->clone(this) : nullptr)
-{}
+{
+    cloneChild(initializer, other.initializer);
+    cloneChild(condition, other.condition);
+    cloneChild(update, other.update);
+    cloneChild(body, other.body);
+}
 
 For::For(For &&other) noexcept
     : initializer(std::move(other.initializer)), condition(std::move(other.condition)), update(std::move(other.update)),
       body(std::move(other.body))
-{}
+{
+    adoptChild(initializer);
+    adoptChild(condition);
+    adoptChild(update);
+    adoptChild(body);
+}
 
 For &For::operator=(const For &other)
 {
-    initializer = other.initializer ? other.initializer->clone(this) : nullptr;
-    condition = other.condition ? other.condition->clone(this) : nullptr;
-    update = other.update ? other.update->clone(this) : nullptr;
-    body = other.body ? other.body->clone(this) : nullptr;
+    cloneChild(initializer, other.initializer);
+    cloneChild(condition, other.condition);
+    cloneChild(update, other.update);
+    cloneChild(body, other.body);
     return *this;
 }
 
@@ -38,6 +55,10 @@ For &For::operator=(For &&other) noexcept
     condition = std::move(other.condition);
     update = std::move(other.update);
     body = std::move(other.body);
+    adoptChild(initializer);
+    adoptChild(condition);
+    adoptChild(update);
+    adoptChild(body);
     return *this;
 }
 
@@ -165,21 +186,25 @@ const Block &For::getBody() const
 void For::setInitializer(std::unique_ptr<Block> newInitializer)
 {
     initializer = std::move(newInitializer);
+    adoptChild(initializer);
 }
 
 void For::setCondition(std::unique_ptr<AbstractExpression> newCondition)
 {
     condition = std::move(newCondition);
+    adoptChild(condition);
 }
 
 void For::setUpdate(std::unique_ptr<Block> newUpdate)
 {
     update = std::move(newUpdate);
+    adoptChild(update);
 }
 
 void For::setBody(std::unique_ptr<Block> newBody)
 {
     body = std::move(newBody);
+    adoptChild(body);
 }
 
 ///////////////////////////////////////////////
@@ -261,4 +286,9 @@ std::string For::toString(bool printChildren) const
 std::string For::getNodeType() const
 {
     return "For";
-}
\ No newline at end of file
+}
+
+NodeKind For::getNodeKind() const
+{
+    return NodeKind::For;
+}
@@ -11,43 +11,51 @@
 /// Convenience typedef for conciseness
 typedef std::unique_ptr<AbstractStatement> exprPtr;
 
-Function::~Function() = default;
+Function::~Function()
+{
+    for (auto &parameter : parameters)
+        destroyChild(parameter);
+    destroyChild(body);
+}
 
 Function::Function(
     Datatype return_type, std::string identifier, std::vector<std::unique_ptr<FunctionParameter>> parameters,
     std::unique_ptr<Block> body)
     : return_type(return_type), identifier(std::move(identifier)), parameters(std::move(parameters)),
       body(std::move(body))
-{}
+{
+    adoptChildren(this->parameters);
+    adoptChild(this->body);
+}
 
 Function::Function(const Function &other)
-    : return_type(other.return_type), identifier(other.identifier), body(other.body->clone(this))
+    : return_type(other.return_type), identifier(other.identifier)
 {
     // deep-copy the parameters, including nullptrs
-    parameters.reserve(other.parameters.size());
-    for (auto &p : other.parameters)
-    {
-        parameters.emplace_back(p ? p->clone(this) : nullptr);
-    }
+    parameters.resize(other.parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+        cloneChild(parameters[i], other.parameters[i]);
+    cloneChild(body, other.body);
 }
 
 Function::Function(Function &&other) noexcept
     : return_type(std::move(other.return_type)), identifier(std::move(other.identifier)),
       parameters(std::move(other.parameters)), body(std::move(other.body))
-{}
+{
+    adoptChildren(parameters);
+    adoptChild(body);
+}
 
 Function &Function::operator=(const Function &other)
 {
     return_type = other.return_type;
     identifier = other.identifier;
-    // deep-copy the statements, including nullptrs
     parameters.clear();
-    parameters.reserve(other.parameters.size());
-    for (auto &p : other.parameters)
-    {
-        parameters.emplace_back(p ? p->clone(this) : nullptr);
-    }
-    body = other.body->clone(this);
+    // deep-copy the parameters, including nullptrs
+    parameters.resize(other.parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+        cloneChild(parameters[i], other.parameters[i]);
+    cloneChild(body, other.body);
     return *this;
 }
 Function &Function::operator=(Function &&other) noexcept
@@ -56,6 +64,8 @@ Function &Function::operator=(Function &&other) noexcept
     identifier = std::move(other.identifier);
     parameters = std::move(other.parameters);
     body = std::move(other.body);
+    adoptChildren(parameters);
+    adoptChild(body);
     return *this;
 }
 std::unique_ptr<Function> Function::clone(AbstractNode *parent_) const
@@ -214,3 +224,8 @@ std::string Function::getNodeType() const
 {
     return "Function";
 }
+
+NodeKind Function::getNodeKind() const
+{
+    return NodeKind::Function;
+}
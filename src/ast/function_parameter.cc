@@ -118,3 +118,8 @@ std::string FunctionParameter::getNodeType() const
 {
     return "FunctionParameter";
 }
+
+NodeKind FunctionParameter::getNodeKind() const
+{
+    return NodeKind::FunctionParameter;
+}
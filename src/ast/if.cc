@@ -3,30 +3,44 @@
 #include "transpiration/ast/utils/ivisitor.h"
 #include "transpiration/ast/utils/node_utils.h"
 
-If::~If() = default;
+If::~If()
+{
+    destroyChild(condition);
+    destroyChild(thenBranch);
+    destroyChild(elseBranch);
+}
 
 If::If(
     std::unique_ptr<AbstractExpression> &&condition, std::unique_ptr<Block> &&thenBranch,
     std::unique_ptr<Block> &&elseBranch)
     : condition(std::move(condition)), thenBranch(std::move(thenBranch)), elseBranch(std::move(elseBranch))
-{}
+{
+    adoptChild(this->condition);
+    adoptChild(this->thenBranch);
+    adoptChild(this->elseBranch);
+}
 
 If::If(const If &other)
-    : condition(other.condition ? other.condition->clone(this) : nullptr),
-      thenBranch(other.thenBranch ? other.thenBranch->clone(this) : nullptr),
-      elseBranch(other.elseBranch ? other.elseBranch->clone(this) : nullptr)
-{}
+{
+    cloneChild(condition, other.condition);
+    cloneChild(thenBranch, other.thenBranch);
+    cloneChild(elseBranch, other.elseBranch);
+}
 
 If::If(If &&other) noexcept
     : condition(std::move(other.condition)), thenBranch(std::move(other.thenBranch)),
       elseBranch(std::move(other.elseBranch))
-{}
+{
+    adoptChild(condition);
+    adoptChild(thenBranch);
+    adoptChild(elseBranch);
+}
 
 If &If::operator=(const If &other)
 {
-    condition = other.condition ? other.condition->clone(this) : nullptr;
-    thenBranch = other.thenBranch ? other.thenBranch->clone(this) : nullptr;
-    elseBranch = other.elseBranch ? other.elseBranch->clone(this) : nullptr;
+    cloneChild(condition, other.condition);
+    cloneChild(thenBranch, other.thenBranch);
+    cloneChild(elseBranch, other.elseBranch);
     return *this;
 }
 
@@ -35,6 +49,9 @@ If &If::operator=(If &&other) noexcept
     condition = std::move(other.condition);
     thenBranch = std::move(other.thenBranch);
     elseBranch = std::move(other.elseBranch);
+    adoptChild(condition);
+    adoptChild(thenBranch);
+    adoptChild(elseBranch);
     return *this;
 }
 std::unique_ptr<If> If::clone(AbstractNode *parent_) const
@@ -132,16 +149,19 @@ const Block &If::getElseBranch() const
 void If::setCondition(std::unique_ptr<AbstractExpression> &&newCondition)
 {
     condition = std::move(newCondition);
+    adoptChild(condition);
 }
 
 void If::setThenBranch(std::unique_ptr<Block> &&newThenBranch)
 {
     thenBranch = std::move(newThenBranch);
+    adoptChild(thenBranch);
 }
 
 void If::setElseBranch(std::unique_ptr<Block> &&newElseBranch)
 {
     elseBranch = std::move(newElseBranch);
+    adoptChild(elseBranch);
 }
 
 ///////////////////////////////////////////////
@@ -227,4 +247,9 @@ std::string If::toString(bool printChildren) const
 std::string If::getNodeType() const
 {
     return "If";
-}
\ No newline at end of file
+}
+
+NodeKind If::getNodeKind() const
+{
+    return NodeKind::If;
+}
@@ -2,24 +2,35 @@
 #include "transpiration/ast/parser/parser.h"
 #include "transpiration/ast/utils/ivisitor.h"
 
-IndexAccess::~IndexAccess() = default;
+IndexAccess::~IndexAccess()
+{
+    destroyChild(target);
+    destroyChild(index);
+}
 
 IndexAccess::IndexAccess(std::unique_ptr<AbstractTarget> &&target, std::unique_ptr<AbstractExpression> &&index)
     : target(std::move(target)), index(std::move(index))
-{}
+{
+    adoptChild(this->target);
+    adoptChild(this->index);
+}
 
 IndexAccess::IndexAccess(const IndexAccess &other)
-    : target(other.target ? other.target->clone(this) : nullptr),
-      index(other.index ? other.index->clone(this) : nullptr)
-{}
+{
+    cloneChild(target, other.target);
+    cloneChild(index, other.index);
+}
 
 IndexAccess::IndexAccess(IndexAccess &&other) noexcept : target(std::move(other.target)), index(std::move(other.index))
-{}
+{
+    adoptChild(target);
+    adoptChild(index);
+}
 
 IndexAccess &IndexAccess::operator=(const IndexAccess &other)
 {
-    target = other.target ? other.target->clone(this) : nullptr;
-    index = other.index ? other.index->clone(this) : nullptr;
+    cloneChild(target, other.target);
+    cloneChild(index, other.index);
     return *this;
 }
 
@@ -27,6 +38,8 @@ IndexAccess &IndexAccess::operator=(IndexAccess &&other) noexcept
 {
     target = std::move(other.target);
     index = std::move(other.index);
+    adoptChild(target);
+    adoptChild(index);
     return *this;
 }
 std::unique_ptr<IndexAccess> IndexAccess::clone(AbstractNode *parent_) const
@@ -100,11 +113,13 @@ const AbstractExpression &IndexAccess::getIndex() const
 void IndexAccess::setTarget(std::unique_ptr<AbstractTarget> &&newTarget)
 {
     target = std::move(newTarget);
+    adoptChild(target);
 }
 
 void IndexAccess::setIndex(std::unique_ptr<AbstractExpression> &&newIndex)
 {
     index = std::move(newIndex);
+    adoptChild(index);
 }
 
 ///////////////////////////////////////////////
@@ -177,4 +192,9 @@ std::string IndexAccess::toString(bool printChildren) const
 std::string IndexAccess::getNodeType() const
 {
     return "IndexAccess";
-}
\ No newline at end of file
+}
+
+NodeKind IndexAccess::getNodeKind() const
+{
+    return NodeKind::IndexAccess;
+}
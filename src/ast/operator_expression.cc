@@ -8,42 +8,47 @@
 /// Convenience typedef for conciseness
 typedef std::unique_ptr<AbstractExpression> exprPtr;
 
-OperatorExpression::~OperatorExpression() = default;
+OperatorExpression::~OperatorExpression()
+{
+    for (auto &operand : operands)
+        destroyChild(operand);
+}
 
 OperatorExpression::OperatorExpression(Operator op, std::vector<std::unique_ptr<AbstractExpression>> &&operands)
     : op(std::move(op)), operands(std::move(operands))
-{}
+{
+    adoptChildren(this->operands);
+}
 
 OperatorExpression::OperatorExpression(const OperatorExpression &other) : op(other.op)
 {
     // deep-copy the operands, including nullptrs
-    operands.reserve(other.operands.size());
-    for (auto &s : other.operands)
-    {
-        operands.emplace_back(s ? s->clone(this) : nullptr);
-    }
+    operands.resize(other.operands.size());
+    for (size_t i = 0; i < operands.size(); ++i)
+        cloneChild(operands[i], other.operands[i]);
 }
 
 OperatorExpression::OperatorExpression(OperatorExpression &&other) noexcept
     : op(std::move(other.op)), operands(std::move(other.operands))
-{}
+{
+    adoptChildren(operands);
+}
 
 OperatorExpression &OperatorExpression::operator=(const OperatorExpression &other)
 {
     op = other.op;
     operands.clear();
     // deep-copy the operands, including nullptrs
-    operands.reserve(other.operands.size());
-    for (auto &s : other.operands)
-    {
-        operands.emplace_back(s ? s->clone(this) : nullptr);
-    }
+    operands.resize(other.operands.size());
+    for (size_t i = 0; i < operands.size(); ++i)
+        cloneChild(operands[i], other.operands[i]);
     return *this;
 }
 OperatorExpression &OperatorExpression::operator=(OperatorExpression &&other) noexcept
 {
     op = std::move(other.op);
     operands = std::move(other.operands);
+    adoptChildren(operands);
     return *this;
 }
 std::unique_ptr<OperatorExpression> OperatorExpression::clone(AbstractNode *parent_) const
@@ -78,6 +83,11 @@ std::vector<std::reference_wrapper<AbstractExpression>> OperatorExpression::getO
     return r;
 }
 
+std::vector<std::unique_ptr<AbstractExpression>> &OperatorExpression::getOperandPtrs()
+{
+    return operands;
+}
+
 std::vector<std::reference_wrapper<const AbstractExpression>> OperatorExpression::getOperands() const
 {
     std::vector<std::reference_wrapper<const AbstractExpression>> r;
@@ -93,11 +103,13 @@ std::vector<std::reference_wrapper<const AbstractExpression>> OperatorExpression
 
 void OperatorExpression::appendOperand(std::unique_ptr<AbstractExpression> operand)
 {
+    adoptChild(operand);
     operands.emplace_back(std::move(operand));
 }
 
 void OperatorExpression::prependOperand(std::unique_ptr<AbstractExpression> operand)
 {
+    adoptChild(operand);
     operands.insert(operands.begin(), std::move(operand));
 }
 
@@ -207,3 +219,8 @@ std::string OperatorExpression::getNodeType() const
 {
     return "OperatorExpression";
 }
+
+NodeKind OperatorExpression::getNodeKind() const
+{
+    return NodeKind::OperatorExpression;
+}
@@ -26,7 +26,7 @@
 #include "transpiration/ast/parser/errors.h"
 #include "transpiration/ast/parser/push_back_stream.h"
 #include "transpiration/ast/utils/node_utils.h"
-#include "transpiration/ast/utils/parent_setting_visitor.h"
+#include "transpiration/ast/utils/statistics.h"
 
 using std::to_string;
 using json = nlohmann::json;
@@ -38,13 +38,39 @@ void addParsedNode(AbstractNode *parsedNode)
 
 std::unique_ptr<AbstractNode> Parser::parse(std::string s)
 {
+    PhaseTimer timer("parse");
     parsedNodes.clear();
 
     // Setup Tokenizer from String
     auto getCharacter = getCharacterFunc(s);
     PushBackStream stream(&getCharacter);
     tokens_iterator it(stream);
+    return parseProgram(it);
+}
+
+std::deque<token> Parser::tokenize(std::string s)
+{
+    PhaseTimer timer("tokenize");
+    auto getCharacter = getCharacterFunc(s);
+    PushBackStream stream(&getCharacter);
+    std::deque<token> tokens;
+    for (tokens_iterator it(stream); !it->isEof(); ++it)
+    {
+        tokens.push_back(*it);
+    }
+    return tokens;
+}
+
+std::unique_ptr<AbstractNode> Parser::parse(std::deque<token> &tokens)
+{
+    PhaseTimer timer("parse");
+    parsedNodes.clear();
+    tokens_iterator it(tokens);
+    return parseProgram(it);
+}
 
+std::unique_ptr<AbstractNode> Parser::parseProgram(tokens_iterator &it)
+{
     auto block = std::make_unique<Block>();
     // Parse statements until end of file
     while (!it->isEof())
@@ -53,10 +79,6 @@ std::unique_ptr<AbstractNode> Parser::parse(std::string s)
         block->appendStatement(std::move(statement));
     }
 
-    // TODO: Remove this workaround once parser sets parents properly
-    ParentSettingVisitor p;
-    block->accept(p);
-
     return std::move(block);
 }
 
@@ -281,17 +303,103 @@ AbstractExpression *Parser::parseExpression(tokens_iterator &it)
     std::stack<AbstractExpression *, std::vector<AbstractExpression *>> operands;
     std::stack<Operator, std::vector<Operator>> operator_stack;
 
+    // Sizes of both stacks at every open parenthesis, the innermost one last. A parenthesized expression is parsed on
+    // top of the stacks of the enclosing one rather than recursively, since generated programs nest them arbitrarily
+    // deep. Hence, the operands and operators of the innermost parenthesized expression are those above its sizes.
+    struct Parenthesis
+    {
+        size_t operands;
+        size_t operators;
+    };
+    std::vector<Parenthesis> parentheses;
+    auto ownOperands = [&]() { return operands.size() - (parentheses.empty() ? 0 : parentheses.back().operands); };
+    auto ownOperators = [&]() {
+        return operator_stack.size() - (parentheses.empty() ? 0 : parentheses.back().operators);
+    };
+
+    // Check if we have a right-associative operator (currently only unary supported) ready to go on the stack
+    auto applyUnaryOperator = [&]() {
+        if (ownOperators() > 0 && operator_stack.top().isRightAssociative() && ownOperands() > 0)
+        {
+            if (!operator_stack.top().isUnary())
+            {
+                throw parsingError(
+                    "Cannot handle non-unary right-associative operators!", it->getLineNumber(), it->getCharIndex());
+            }
+            else
+            {
+                Operator op = operator_stack.top();
+                operator_stack.pop();
+                AbstractExpression *exp = operands.top();
+                operands.pop();
+                auto unaryExpression = new UnaryExpression(std::unique_ptr<AbstractExpression>(exp), op);
+                addParsedNode(unaryExpression);
+                operands.push(unaryExpression);
+            }
+        }
+    };
+
+    // cleanup any remaining operators of the innermost (parenthesized) expression, which leaves its single operand
+    auto reduceOperators = [&]() {
+        while (ownOperators() > 0)
+        {
+            Operator op = operator_stack.top();
+            operator_stack.pop();
+
+            // has to be binary?
+            if (op.isUnary())
+            {
+                throw unexpectedSyntaxError("Unresolved Unary Operator", it->getLineNumber(), it->getCharIndex());
+            }
+            else
+            {
+                // Try to get two operands
+                if (ownOperands() < 2)
+                {
+                    throw unexpectedSyntaxError(
+                        "Missing at least one Operand for Binary Operator", it->getLineNumber(), it->getCharIndex());
+                }
+                else
+                {
+                    auto e1 = operands.top();
+                    operands.pop();
+                    auto e2 = operands.top();
+                    operands.pop();
+                    auto binaryExpression = new BinaryExpression(
+                        std::unique_ptr<AbstractExpression>(e2), op, std::unique_ptr<AbstractExpression>(e1));
+                    addParsedNode(binaryExpression);
+                    operands.push(binaryExpression);
+                }
+            }
+        }
+
+        if (ownOperands() == 0)
+        {
+            throw unexpectedSyntaxError("Empty Expression", it->getLineNumber(), it->getCharIndex());
+        }
+        else if (ownOperands() > 1)
+        {
+            throw unexpectedSyntaxError("Unresolved Operands", it->getLineNumber(), it->getCharIndex());
+        }
+    };
+
     bool running = true;
     while (running)
     {
         if (isBinaryOperator(it))
         {
             Operator op1 = parseOperator(it);
-            while (!operator_stack.empty())
+            while (ownOperators() > 0)
             {
                 Operator op2 = operator_stack.top();
                 if ((!op1.isRightAssociative() && comparePrecedence(op1, op2) == 0) || comparePrecedence(op1, op2) < 0)
                 {
+                    if (ownOperands() < 2)
+                    {
+                        throw unexpectedSyntaxError(
+                            "Missing at least one Operand for Binary Operator", it->getLineNumber(),
+                            it->getCharIndex());
+                    }
                     operator_stack.pop();
                     AbstractExpression *rhs = operands.top();
                     operands.pop();
@@ -328,7 +436,7 @@ AbstractExpression *Parser::parseExpression(tokens_iterator &it)
             {
                 throw parsingError("Unexpected Postfix Operator", it->getLineNumber(), it->getCharIndex());
             }
-            if (operands.empty())
+            if (ownOperands() == 0)
             {
                 throw expectedSyntaxError(
                     "operand for postfix operator", it->getLineNumber(), it->getCharIndex());
@@ -348,7 +456,7 @@ AbstractExpression *Parser::parseExpression(tokens_iterator &it)
             // This handles the special case of negative values as the minus sign is recognized as separate token.
             // If we detected a minus sign but have not collected any lhs operand yet, we know that the minus does not
             // act as a binary operator but belong to the operand.
-            if (operands.empty() && !operator_stack.empty() &&
+            if (ownOperands() == 0 && ownOperators() > 0 &&
                 operator_stack.top().toString() == Operator(SUBTRACTION).toString())
             {
                 operands.push(parseLiteral(it, true));
@@ -371,10 +479,17 @@ AbstractExpression *Parser::parseExpression(tokens_iterator &it)
         }
         else if (it->hasValue(reservedTokens::open_round))
         {
-            // If we see an (, we have nested expressions going on, so use recursion.
+            // If we see an (, we have nested expressions going on, which are parsed on top of the stacks
             parseTokenValue(it, reservedTokens::open_round);
-            operands.push(parseExpression(it));
+            parentheses.push_back({ operands.size(), operator_stack.size() });
+        }
+        else if (!parentheses.empty() && it->hasValue(reservedTokens::close_round))
+        {
+            // The parenthesized expression is complete, i.e., becomes an operand of the enclosing one
+            applyUnaryOperator();
+            reduceOperators();
             parseTokenValue(it, reservedTokens::close_round);
+            parentheses.pop_back();
         }
         else if (it->hasValue(reservedTokens::open_curly))
         {
@@ -403,73 +518,18 @@ AbstractExpression *Parser::parseExpression(tokens_iterator &it)
             running = false;
         }
 
-        // Check if we have a right-associative operator (currently only unary supported) ready to go on the stack
-        if (!operator_stack.empty() && operator_stack.top().isRightAssociative() && !operands.empty())
-        {
-            if (!operator_stack.top().isUnary())
-            {
-                throw parsingError(
-                    "Cannot handle non-unary right-associative operators!", it->getLineNumber(), it->getCharIndex());
-            }
-            else
-            {
-                Operator op = operator_stack.top();
-                operator_stack.pop();
-                AbstractExpression *exp = operands.top();
-                operands.pop();
-                auto unaryExpression = new UnaryExpression(std::unique_ptr<AbstractExpression>(exp), op);
-                addParsedNode(unaryExpression);
-                operands.push(unaryExpression);
-            }
-        }
-
+        applyUnaryOperator();
     } // end of while loop
 
-    // cleanup any remaining operators
-    while (!operator_stack.empty())
+    // a parenthesized expression that is not closed
+    if (!parentheses.empty())
     {
-        Operator op = operator_stack.top();
-        operator_stack.pop();
-
-        // has to be binary?
-        if (op.isUnary())
-        {
-            throw unexpectedSyntaxError("Unresolved Unary Operator", it->getLineNumber(), it->getCharIndex());
-        }
-        else
-        {
-            // Try to get two operands
-            if (operands.size() < 2)
-            {
-                throw unexpectedSyntaxError(
-                    "Missing at least one Operand for Binary Operator", it->getLineNumber(), it->getCharIndex());
-            }
-            else
-            {
-                auto e1 = operands.top();
-                operands.pop();
-                auto e2 = operands.top();
-                operands.pop();
-                auto binaryExpression = new BinaryExpression(
-                    std::unique_ptr<AbstractExpression>(e2), op, std::unique_ptr<AbstractExpression>(e1));
-                addParsedNode(binaryExpression);
-                operands.push(binaryExpression);
-            }
-        }
+        reduceOperators();
+        parseTokenValue(it, reservedTokens::close_round);
     }
 
-    if (operands.empty())
-    {
-        throw unexpectedSyntaxError("Empty Expression", it->getLineNumber(), it->getCharIndex());
-    }
-    else if (operands.size() == 1)
-    {
-        return operands.top();
-    }
-    else
-    {
-        throw unexpectedSyntaxError("Unresolved Operands", it->getLineNumber(), it->getCharIndex());
-    }
+    reduceOperators();
+    return operands.top();
 }
 
 AbstractTarget *Parser::parseTarget(tokens_iterator &it)
@@ -8,6 +8,7 @@
 
 #include "transpiration/ast/parser/errors.h"
 #include "transpiration/ast/parser/push_back_stream.h"
+#include "transpiration/ast/utils/statistics.h"
 
 
 namespace
@@ -274,7 +275,14 @@ namespace
 } // namespace
 
 tokens_iterator::tokens_iterator(PushBackStream &stream)
-    : _current(eof(), 0, 0), _get_next_token([&stream]() { return tokenize(stream); })
+    : _current(eof(), 0, 0), _get_next_token([&stream]() {
+            token next = tokenize(stream);
+            if (!next.isEof())
+            {
+                CompilerStatistics::increment(Counter::TOKENS);
+            }
+            return next;
+        })
 {
     ++(*this);
 }
@@ -5,26 +5,36 @@
 #include "transpiration/ast/parser/parser.h"
 #include "transpiration/ast/utils/ivisitor.h"
 
-Return::~Return() = default;
+Return::~Return()
+{
+    destroyChild(value);
+}
 
 Return::Return(std::unique_ptr<AbstractExpression> value) : value(std::move(value))
-{}
+{
+    adoptChild(this->value);
+}
 
-Return::Return(const Return &other) : value(other.value ? other.value->clone(this) : nullptr)
-{}
+Return::Return(const Return &other)
+{
+    cloneChild(value, other.value);
+}
 
 Return::Return(Return &&other) noexcept : value(std::move(other.value))
-{}
+{
+    adoptChild(value);
+}
 
 Return &Return::operator=(const Return &other)
 {
-    value = other.value ? other.value->clone(this) : nullptr;
+    cloneChild(value, other.value);
     return *this;
 }
 
 Return &Return::operator=(Return &&other) noexcept
 {
     value = std::move(other.value);
+    adoptChild(value);
     return *this;
 }
 
@@ -64,6 +74,7 @@ const AbstractExpression &Return::getValue() const
 void Return::setValue(std::unique_ptr<AbstractExpression> newValue)
 {
     value = std::move(newValue);
+    adoptChild(value);
 }
 
 ///////////////////////////////////////////////
@@ -133,4 +144,9 @@ std::string Return::toString(bool printChildren) const
 std::string Return::getNodeType() const
 {
     return "Return";
-}
\ No newline at end of file
+}
+
+NodeKind Return::getNodeKind() const
+{
+    return NodeKind::Return;
+}
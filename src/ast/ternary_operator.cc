@@ -1,29 +1,43 @@
 #include "transpiration/ast/ternary_operator.h"
 #include "transpiration/ast/utils/ivisitor.h"
 
-TernaryOperator::~TernaryOperator() = default;
+TernaryOperator::~TernaryOperator()
+{
+    destroyChild(condition);
+    destroyChild(thenExpr);
+    destroyChild(elseExpr);
+}
 
 TernaryOperator::TernaryOperator(
     std::unique_ptr<AbstractExpression> &&condition, std::unique_ptr<AbstractExpression> &&thenExpr,
     std::unique_ptr<AbstractExpression> &&elseExpr)
     : condition(std::move(condition)), thenExpr(std::move(thenExpr)), elseExpr(std::move(elseExpr))
-{}
+{
+    adoptChild(this->condition);
+    adoptChild(this->thenExpr);
+    adoptChild(this->elseExpr);
+}
 
 TernaryOperator::TernaryOperator(const TernaryOperator &other)
-    : condition(other.condition ? other.condition->clone(this) : nullptr),
-      thenExpr(other.thenExpr ? other.thenExpr->clone(this) : nullptr),
-      elseExpr(other.elseExpr ? other.elseExpr->clone(this) : nullptr)
-{}
+{
+    cloneChild(condition, other.condition);
+    cloneChild(thenExpr, other.thenExpr);
+    cloneChild(elseExpr, other.elseExpr);
+}
 
 TernaryOperator::TernaryOperator(TernaryOperator &&other) noexcept
     : condition(std::move(other.condition)), thenExpr(std::move(other.thenExpr)), elseExpr(std::move(other.elseExpr))
-{}
+{
+    adoptChild(condition);
+    adoptChild(thenExpr);
+    adoptChild(elseExpr);
+}
 
 TernaryOperator &TernaryOperator::operator=(const TernaryOperator &other)
 {
-    condition = other.condition ? other.condition->clone(this) : nullptr;
-    thenExpr = other.thenExpr ? other.thenExpr->clone(this) : nullptr;
-    elseExpr = other.elseExpr ? other.elseExpr->clone(this) : nullptr;
+    cloneChild(condition, other.condition);
+    cloneChild(thenExpr, other.thenExpr);
+    cloneChild(elseExpr, other.elseExpr);
     return *this;
 }
 
@@ -32,6 +46,9 @@ TernaryOperator &TernaryOperator::operator=(TernaryOperator &&other) noexcept
     condition = std::move(other.condition);
     thenExpr = std::move(other.thenExpr);
     elseExpr = std::move(other.elseExpr);
+    adoptChild(condition);
+    adoptChild(thenExpr);
+    adoptChild(elseExpr);
     return *this;
 }
 
@@ -130,16 +147,19 @@ const AbstractExpression &TernaryOperator::getElseExpr() const
 void TernaryOperator::setCondition(std::unique_ptr<AbstractExpression> &&newCondition)
 {
     condition = std::move(newCondition);
+    adoptChild(condition);
 }
 
 void TernaryOperator::setThenExpr(std::unique_ptr<AbstractExpression> &&newthenExpr)
 {
     thenExpr = std::move(newthenExpr);
+    adoptChild(thenExpr);
 }
 
 void TernaryOperator::setElseExpr(std::unique_ptr<AbstractExpression> &&newelseExpr)
 {
     elseExpr = std::move(newelseExpr);
+    adoptChild(elseExpr);
 }
 
 ///////////////////////////////////////////////
@@ -208,4 +228,9 @@ std::string TernaryOperator::toString(bool printChildren) const
 std::string TernaryOperator::getNodeType() const
 {
     return "TernaryExpression";
-}
\ No newline at end of file
+}
+
+NodeKind TernaryOperator::getNodeKind() const
+{
+    return NodeKind::TernaryOperator;
+}
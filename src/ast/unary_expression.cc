@@ -4,22 +4,31 @@
 
 #include "transpiration/ast/utils/ivisitor.h"
 
-UnaryExpression::~UnaryExpression() = default;
+UnaryExpression::~UnaryExpression()
+{
+    destroyChild(operand);
+}
 
 UnaryExpression::UnaryExpression(std::unique_ptr<AbstractExpression> operand, Operator op)
     : operand(std::move(operand)), op(op)
-{}
+{
+    adoptChild(this->operand);
+}
 
 UnaryExpression::UnaryExpression(const UnaryExpression &other)
-    : operand(other.operand ? other.operand->clone(this) : nullptr), op(other.op)
-{}
+    : op(other.op)
+{
+    cloneChild(operand, other.operand);
+}
 
 UnaryExpression::UnaryExpression(UnaryExpression &&other) noexcept : operand(std::move(other.operand)), op(other.op)
-{}
+{
+    adoptChild(operand);
+}
 
 UnaryExpression &UnaryExpression::operator=(const UnaryExpression &other)
 {
-    operand = other.operand ? other.operand->clone(this) : nullptr;
+    cloneChild(operand, other.operand);
     op = other.op;
     return *this;
 }
@@ -28,6 +37,7 @@ UnaryExpression &UnaryExpression::operator=(UnaryExpression &&other) noexcept
 {
     operand = std::move(other.operand);
     op = other.op;
+    adoptChild(operand);
     return *this;
 }
 
@@ -83,6 +93,7 @@ const Operator &UnaryExpression::getOperator() const
 void UnaryExpression::setOperand(std::unique_ptr<AbstractExpression> newOperand)
 {
     operand = std::move(newOperand);
+    adoptChild(operand);
 }
 
 void UnaryExpression::setOperator(Operator newOperator)
@@ -153,3 +164,8 @@ std::string UnaryExpression::getNodeType() const
 {
     return "UnaryExpression";
 }
+
+NodeKind UnaryExpression::getNodeKind() const
+{
+    return NodeKind::UnaryExpression;
+}
@@ -1,6 +1,11 @@
 
 #include "transpiration/ast/utils/abc_ast_to_mlir_visitor.h"
+
+#include <algorithm>
+#include <cstddef>
+
 #include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/statistics.h"
 
 /*
  * Private functions
@@ -18,6 +23,13 @@ void SpecialAbcAstToMlirVisitor::add_recursive_result_to_region(AbstractNode &no
     recursive_visit(node, block);
 }
 
+void SpecialAbcAstToMlirVisitor::add_deferred_result_to_region(AbstractNode &node, mlir::Region &region)
+{
+    mlir::Block *block = new mlir::Block();
+    region.push_back(block);
+    deferred_visit(node, block);
+}
+
 mlir::Type SpecialAbcAstToMlirVisitor::translate_type(Datatype abc_type)
 {
     // TODO (Miro): For some reason, there are no get*Type functions for Bool, Char, String
@@ -42,9 +54,40 @@ mlir::Type SpecialAbcAstToMlirVisitor::translate_type(Datatype abc_type)
 
 void SpecialAbcAstToMlirVisitor::recursive_visit(AbstractNode &node, mlir::Block *childBlock)
 {
-    // Store current block and use a fresh one for the recursive child visit
+    // Store current block and use a fresh one for the child visit. The nodes that it defers are translated here too,
+    // with an explicit stack instead of recursion, such that the node has been translated completely once this returns
     mlir::Block *parentBlock = block;
-    block = childBlock;
+    auto bottom = pending.size();
+    pending.emplace_back(&node, childBlock);
+    ++translating;
+    while (pending.size() > bottom)
+    {
+        auto [next, nextBlock] = pending.back();
+        pending.pop_back();
+        block = nextBlock;
+        auto deferred = pending.size();
+        translate(*next);
+        // translate the deferred nodes in the order they were deferred in
+        std::reverse(pending.begin() + static_cast<std::ptrdiff_t>(deferred), pending.end());
+    }
+    --translating;
+    block = parentBlock;
+}
+
+void SpecialAbcAstToMlirVisitor::deferred_visit(AbstractNode &node, mlir::Block *childBlock)
+{
+    if (translating > 0)
+    {
+        pending.emplace_back(&node, childBlock);
+    }
+    else
+    {
+        recursive_visit(node, childBlock);
+    }
+}
+
+void SpecialAbcAstToMlirVisitor::translate(AbstractNode &node)
+{
     if (auto expr = dynamic_cast<AbstractExpression *>(&node))
     {
         visit(*expr);
@@ -57,7 +100,6 @@ void SpecialAbcAstToMlirVisitor::recursive_visit(AbstractNode &node, mlir::Block
     {
         throw runtime_error("Unknown subclass of AbstractNode.");
     }
-    block = parentBlock;
 }
 
 /*
@@ -149,12 +191,12 @@ void SpecialAbcAstToMlirVisitor::visit(Assignment &elem)
     // Target
     mlir::Block *tarBlock = new mlir::Block();
     assignOp.target().push_back(tarBlock);
-    recursive_visit(elem.getTarget(), tarBlock);
+    deferred_visit(elem.getTarget(), tarBlock);
 
     // Value
     mlir::Block *valBlock = new mlir::Block();
     assignOp.value().push_back(valBlock);
-    recursive_visit(elem.getValue(), valBlock);
+    deferred_visit(elem.getValue(), valBlock);
 
     // Add new assignment operation
     add_op(assignOp);
@@ -168,12 +210,12 @@ void SpecialAbcAstToMlirVisitor::visit(BinaryExpression &elem)
     // Add LHS
     mlir::Block *lhsBlock = new mlir::Block();
     binExpr.left().push_back(lhsBlock);
-    recursive_visit(elem.getLeft(), lhsBlock);
+    deferred_visit(elem.getLeft(), lhsBlock);
 
     // Add RHS
     mlir::Block *rhsBlock = new mlir::Block();
     binExpr.right().push_back(rhsBlock);
-    recursive_visit(elem.getRight(), rhsBlock);
+    deferred_visit(elem.getRight(), rhsBlock);
 
     // Add binary operation
     add_op(binExpr);
@@ -210,7 +252,7 @@ void SpecialAbcAstToMlirVisitor::visit(Call &elem)
     {
         argBlock = new mlir::Block();
         callOp.arguments().push_back(argBlock);
-        recursive_visit(argExpr, argBlock);
+        deferred_visit(argExpr, argBlock);
     }
 
     // Add for operation
@@ -222,16 +264,16 @@ void SpecialAbcAstToMlirVisitor::visit(For &elem)
     auto forOp = builder.create<ForOp>(builder.getUnknownLoc());
 
     // Convert initializer
-    add_recursive_result_to_region(elem.getInitializer(), forOp.initializer());
+    add_deferred_result_to_region(elem.getInitializer(), forOp.initializer());
 
     // Convert condition
-    add_recursive_result_to_region(elem.getCondition(), forOp.condition());
+    add_deferred_result_to_region(elem.getCondition(), forOp.condition());
 
     // Convert update
-    add_recursive_result_to_region(elem.getUpdate(), forOp.update());
+    add_deferred_result_to_region(elem.getUpdate(), forOp.update());
 
     // Convert body
-    add_recursive_result_to_region(elem.getBody(), forOp.body());
+    add_deferred_result_to_region(elem.getBody(), forOp.body());
 
     // Add for operation
     add_op(forOp);
@@ -239,6 +281,8 @@ void SpecialAbcAstToMlirVisitor::visit(For &elem)
 
 void SpecialAbcAstToMlirVisitor::visit(Function &elem)
 {
+    PhaseTimer timer("ast-to-mlir");
+
     auto fnName = builder.getStringAttr(llvm::Twine(elem.getIdentifier()));
     auto type = translate_type(elem.getReturnType());
     auto fnOp = builder.create<FunctionOp>(builder.getUnknownLoc(), fnName, type);
@@ -252,8 +296,10 @@ void SpecialAbcAstToMlirVisitor::visit(Function &elem)
     // Add body
     add_recursive_result_to_region(elem.getBody(), fnOp.body());
 
-    // Add function to module (XXX: this makes the assumption that there are no nested functions...)
+    // Add function to module, the parameters and the body have been translated completely
+    // (XXX: this makes the assumption that there are no nested functions...)
     add_op(fnOp);
+    fnOp->walk([](mlir::Operation *) { CompilerStatistics::increment(Counter::MLIR_OPERATIONS_CREATED); });
 }
 
 void SpecialAbcAstToMlirVisitor::visit(FunctionParameter &elem)
@@ -271,16 +317,16 @@ void SpecialAbcAstToMlirVisitor::visit(If &elem)
     auto ifOp = builder.create<IfOp>(builder.getUnknownLoc(), elem.hasElseBranch() ? 1 : 0);
 
     // Add condition
-    add_recursive_result_to_region(elem.getCondition(), ifOp.condition());
+    add_deferred_result_to_region(elem.getCondition(), ifOp.condition());
 
     // Add then branch
-    add_recursive_result_to_region(elem.getThenBranch(), ifOp.thenBranch());
+    add_deferred_result_to_region(elem.getThenBranch(), ifOp.thenBranch());
 
     // Add else branch if present.
     if (elem.hasElseBranch())
     {
         // Note that MLIR would support multiple else (if) branches, but the ABC AST only supports one.
-        add_recursive_result_to_region(elem.getElseBranch(), ifOp.elseBranch().front());
+        add_deferred_result_to_region(elem.getElseBranch(), ifOp.elseBranch().front());
     }
 
     // Add if condition
@@ -350,7 +396,7 @@ void SpecialAbcAstToMlirVisitor::visit(OperatorExpression &elem)
     int i = 1; // the i = 0 region is not used for operands
     for (auto operand : elem.getOperands())
     {
-        add_recursive_result_to_region(operand, opExpr.getRegion(i));
+        add_deferred_result_to_region(operand, opExpr.getRegion(i));
         ++i;
     }
 
@@ -366,7 +412,7 @@ void SpecialAbcAstToMlirVisitor::visit(Return &elem)
     if (elem.hasValue())
     {
         // Note that the frontend currently only supports returning a single expression
-        add_recursive_result_to_region(elem.getValue(), returnOp.value().front());
+        add_deferred_result_to_region(elem.getValue(), returnOp.value().front());
     }
 
     // Add return op
@@ -415,7 +461,7 @@ void SpecialAbcAstToMlirVisitor::visit(UnaryExpression &elem)
     auto unExpr = builder.create<UnaryExpressionOp>(builder.getUnknownLoc(), opAttr);
 
     // Add operand
-    add_recursive_result_to_region(elem.getOperand(), unExpr.operand());
+    add_deferred_result_to_region(elem.getOperand(), unExpr.operand());
 
     // Add unary expression operation
     add_op(unExpr);
@@ -0,0 +1,381 @@
+#include "transpiration/ast/utils/abc_ast_to_ssa_visitor.h"
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/static_visitor.h"
+#include "transpiration/ast/utils/statistics.h"
+
+/*
+ * Private functions
+ */
+
+mlir::Type SpecialAbcAstToSsaVisitor::translate_type(Datatype abc_type)
+{
+    switch (abc_type.getType())
+    {
+    case Type::BOOL:
+        return builder.getI1Type();
+    case Type::CHAR:
+        return builder.getIntegerType(8);
+    case Type::INT:
+        return builder.getI64Type();
+    case Type::FLOAT:
+        return builder.getF32Type();
+    case Type::DOUBLE:
+        return builder.getF64Type();
+    case Type::STRING:
+        return builder.getStringAttr(mlir::Twine("..")).getType();
+    case Type::VOID:
+        return builder.getNoneType();
+    default:
+        throw runtime_error("Unknown ABC type");
+    }
+}
+
+mlir::Value SpecialAbcAstToSsaVisitor::lower_expression(AbstractExpression &expr)
+{
+    // every subexpression is lowered after its operands, which leave their values on the stack for it
+    walk(expr, NoHandler(), [this](auto &node) {
+        value = nullptr;
+        visit(node);
+        if (!value)
+        {
+            throw runtime_error("Lowering of " + node.getUniqueNodeId() + " did not produce an SSA value.");
+        }
+        values.push_back(value);
+    });
+    return pop_value();
+}
+
+mlir::Value SpecialAbcAstToSsaVisitor::pop_value()
+{
+    if (values.empty())
+    {
+        throw runtime_error("Missing operand in ABC to SSA translation.");
+    }
+    auto top = values.back();
+    values.pop_back();
+    return top;
+}
+
+std::vector<mlir::Value> SpecialAbcAstToSsaVisitor::pop_values(size_t count)
+{
+    std::vector<mlir::Value> popped(count);
+    for (auto it = popped.rbegin(); it != popped.rend(); ++it)
+    {
+        *it = pop_value();
+    }
+    return popped;
+}
+
+void SpecialAbcAstToSsaVisitor::lower_statements_into(AbstractStatement &stmt, mlir::Region &region)
+{
+    // Store current block and insertion point, and use a fresh block for the statements
+    mlir::OpBuilder::InsertionGuard guard(builder);
+    mlir::Block *parentBlock = block;
+    block = new mlir::Block();
+    region.push_back(block);
+    builder.setInsertionPointToEnd(block);
+
+    // The statements of a Block are emitted directly into the region, no ast.block op is needed
+    if (auto blockStmt = dynamic_cast<Block *>(&stmt))
+    {
+        for (auto &s : blockStmt->getStatements())
+        {
+            s.get().accept(*this);
+        }
+    }
+    else
+    {
+        stmt.accept(*this);
+    }
+    block = parentBlock;
+}
+
+mlir::Type SpecialAbcAstToSsaVisitor::lookup_type(const std::string &identifier)
+{
+    for (auto scope = declaredTypes.rbegin(); scope != declaredTypes.rend(); ++scope)
+    {
+        auto it = scope->find(identifier);
+        if (it != scope->end())
+        {
+            return it->second;
+        }
+    }
+    return builder.getNoneType();
+}
+
+/*
+ * Public functions
+ */
+
+SpecialAbcAstToSsaVisitor::SpecialAbcAstToSsaVisitor(mlir::MLIRContext &ctx) : builder(&ctx)
+{
+    block = new mlir::Block();
+    builder.setInsertionPointToEnd(block);
+    declaredTypes.emplace_back();
+}
+
+mlir::Block *SpecialAbcAstToSsaVisitor::getBlockPtr()
+{
+    return block;
+}
+
+void SpecialAbcAstToSsaVisitor::visit(Assignment &elem)
+{
+    // Unwrap (possibly nested) index accesses, e.g. x[i][j] is stored as IndexAccess(IndexAccess(x, i), j)
+    std::vector<AbstractExpression *> indexExprs;
+    AbstractTarget *target = &elem.getTarget();
+    while (auto idxAccess = dynamic_cast<IndexAccess *>(target))
+    {
+        indexExprs.push_back(&idxAccess->getIndex());
+        target = &idxAccess->getTarget();
+    }
+
+    std::string name;
+    if (auto variable = dynamic_cast<Variable *>(target))
+        name = variable->getIdentifier();
+    else if (auto fnParam = dynamic_cast<FunctionParameter *>(target))
+        name = fnParam->getIdentifier();
+    else
+        throw runtime_error("Unsupported assignment target in ABC to SSA translation.");
+
+    // Indices are evaluated outermost first
+    std::vector<mlir::Value> indices;
+    for (auto it = indexExprs.rbegin(); it != indexExprs.rend(); ++it)
+    {
+        indices.push_back(lower_expression(**it));
+    }
+
+    auto val = lower_expression(elem.getValue());
+    builder.create<SsaAssignmentOp>(builder.getUnknownLoc(), name, indices, val);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(BinaryExpression &elem)
+{
+    auto rhs = pop_value();
+    auto lhs = pop_value();
+
+    // Relational and logical operators produce a boolean, arithmetic ones keep the type of the left operand
+    auto &op = elem.getOperator();
+    mlir::Type resultType = lhs.getType();
+    if (op.isRelationalOperator() || op == Operator(LOGICAL_AND) || op == Operator(LOGICAL_OR))
+        resultType = builder.getI1Type();
+
+    auto opAttr = builder.getStringAttr(llvm::Twine(op.toString()));
+    value = builder.create<SsaBinaryExpressionOp>(builder.getUnknownLoc(), resultType, opAttr, lhs, rhs);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(Block &elem)
+{
+    auto blockOp = builder.create<BlockOp>(builder.getUnknownLoc());
+    declaredTypes.emplace_back();
+    lower_statements_into(elem, blockOp.getRegion());
+    declaredTypes.pop_back();
+}
+
+void SpecialAbcAstToSsaVisitor::visit(Call &elem)
+{
+    auto args = pop_values(elem.getArguments().size());
+
+    // rotate(x, k) has the type of the rotated value, we do not know anything about other functions yet
+    mlir::Type resultType = builder.getNoneType();
+    if (elem.getIdentifier() == "rotate" && !args.empty())
+        resultType = args.front().getType();
+
+    // the unique node ID lets passes on the module refer back to the Call, see collectHoistedRotations()
+    auto location = mlir::NameLoc::get(builder.getStringAttr(llvm::Twine(elem.getUniqueNodeId())));
+    value = builder.create<SsaCallOp>(location, resultType, elem.getIdentifier(), args);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(ExpressionList &elem)
+{
+    auto elements = pop_values(elem.getExpressions().size());
+
+    mlir::Type elementType = elements.empty() ? builder.getNoneType() : elements.front().getType();
+    auto resultType = mlir::RankedTensorType::get({ static_cast<int64_t>(elements.size()) }, elementType);
+    value = builder.create<SsaExpressionListOp>(builder.getUnknownLoc(), resultType, elements);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(For &elem)
+{
+    auto forOp = builder.create<SsaForOp>(builder.getUnknownLoc());
+
+    // variables declared in the initializer must be visible in condition, update and body
+    declaredTypes.emplace_back();
+
+    // Convert initializer
+    lower_statements_into(elem.getInitializer(), forOp.initializer());
+
+    // Convert condition, which must be re-evaluated on every iteration and therefore lives in its own region
+    {
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        auto condBlock = new mlir::Block();
+        forOp.condition().push_back(condBlock);
+        builder.setInsertionPointToEnd(condBlock);
+        lower_expression(elem.getCondition());
+    }
+
+    // Convert update
+    lower_statements_into(elem.getUpdate(), forOp.update());
+
+    // Convert body
+    lower_statements_into(elem.getBody(), forOp.body());
+    declaredTypes.pop_back();
+}
+
+void SpecialAbcAstToSsaVisitor::visit(Function &elem)
+{
+    PhaseTimer timer("ast-to-ssa");
+
+    auto fnName = builder.getStringAttr(llvm::Twine(elem.getIdentifier()));
+    auto type = translate_type(elem.getReturnType());
+    auto fnOp = builder.create<FunctionOp>(builder.getUnknownLoc(), fnName, type);
+    declaredTypes.emplace_back();
+
+    // Add parameters
+    {
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        auto paramBlock = new mlir::Block();
+        fnOp.parameters().push_back(paramBlock);
+        builder.setInsertionPointToEnd(paramBlock);
+        for (auto param : elem.getParameters())
+        {
+            param.get().accept(*this);
+        }
+    }
+
+    // Add body
+    lower_statements_into(elem.getBody(), fnOp.body());
+    declaredTypes.pop_back();
+    fnOp->walk([](mlir::Operation *) { CompilerStatistics::increment(Counter::MLIR_OPERATIONS_CREATED); });
+}
+
+void SpecialAbcAstToSsaVisitor::visit(FunctionParameter &elem)
+{
+    auto fnParamType = translate_type(elem.getParameterType());
+    declaredTypes.back()[elem.getIdentifier()] = fnParamType;
+    builder.create<FunctionParameterOp>(builder.getUnknownLoc(), elem.getIdentifier(), fnParamType);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(If &elem)
+{
+    auto cond = lower_expression(elem.getCondition());
+    auto ifOp = builder.create<SsaIfOp>(builder.getUnknownLoc(), cond, elem.hasElseBranch() ? 1 : 0);
+
+    // Add then branch
+    declaredTypes.emplace_back();
+    lower_statements_into(elem.getThenBranch(), ifOp.thenBranch());
+    declaredTypes.pop_back();
+
+    // Add else branch if present.
+    if (elem.hasElseBranch())
+    {
+        declaredTypes.emplace_back();
+        lower_statements_into(elem.getElseBranch(), ifOp.elseBranch().front());
+        declaredTypes.pop_back();
+    }
+}
+
+void SpecialAbcAstToSsaVisitor::visit(IndexAccess &)
+{
+    auto index = pop_value();
+    auto target = pop_value();
+
+    // Indexing into an ExpressionList yields its element type, otherwise we cannot know better than the target type
+    mlir::Type resultType = target.getType();
+    if (auto tensorType = resultType.dyn_cast<mlir::RankedTensorType>())
+        resultType = tensorType.getElementType();
+
+    value = builder.create<SsaIndexAccessOp>(builder.getUnknownLoc(), resultType, target, index);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(LiteralBool &elem)
+{
+    auto bval = builder.getBoolAttr(elem.getValue());
+    value = builder.create<SsaLiteralOp>(builder.getUnknownLoc(), builder.getI1Type(), bval);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(LiteralChar &elem)
+{
+    auto cval = builder.getI8IntegerAttr(elem.getValue());
+    value = builder.create<SsaLiteralOp>(builder.getUnknownLoc(), builder.getIntegerType(8), cval);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(LiteralInt &elem)
+{
+    auto i64val = builder.getI64IntegerAttr(elem.getValue());
+    value = builder.create<SsaLiteralOp>(builder.getUnknownLoc(), builder.getI64Type(), i64val);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(LiteralFloat &elem)
+{
+    auto f32val = builder.getF32FloatAttr(elem.getValue());
+    value = builder.create<SsaLiteralOp>(builder.getUnknownLoc(), builder.getF32Type(), f32val);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(LiteralDouble &elem)
+{
+    auto f64val = builder.getF64FloatAttr(elem.getValue());
+    value = builder.create<SsaLiteralOp>(builder.getUnknownLoc(), builder.getF64Type(), f64val);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(LiteralString &elem)
+{
+    auto sval = builder.getStringAttr(llvm::Twine(elem.getValue()));
+    value = builder.create<SsaLiteralOp>(builder.getUnknownLoc(), sval.getType(), sval);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(OperatorExpression &elem)
+{
+    auto operands = pop_values(elem.getOperands().size());
+
+    mlir::Type resultType = operands.empty() ? builder.getNoneType() : operands.front().getType();
+    if (elem.getOperator().isRelationalOperator())
+        resultType = builder.getI1Type();
+
+    auto opAttr = builder.getStringAttr(llvm::Twine(elem.getOperator().toString()));
+    value = builder.create<SsaOperatorExpressionOp>(builder.getUnknownLoc(), resultType, opAttr, operands);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(Return &elem)
+{
+    // Note that the frontend currently only supports returning a single expression
+    mlir::Value val = elem.hasValue() ? lower_expression(elem.getValue()) : mlir::Value();
+    builder.create<SsaReturnOp>(builder.getUnknownLoc(), val);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(TernaryOperator &)
+{
+    auto elseVal = pop_value();
+    auto thenVal = pop_value();
+    auto cond = pop_value();
+    value = builder.create<SsaTernaryOperatorOp>(builder.getUnknownLoc(), thenVal.getType(), cond, thenVal, elseVal);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(UnaryExpression &elem)
+{
+    auto operand = pop_value();
+    auto opAttr = builder.getStringAttr(llvm::Twine(elem.getOperator().toString()));
+    value = builder.create<SsaUnaryExpressionOp>(builder.getUnknownLoc(), operand.getType(), opAttr, operand);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(VariableDeclaration &elem)
+{
+    if (!elem.hasTarget())
+    {
+        throw runtime_error("Variable declaration must have a target.");
+    }
+    std::string name = elem.getTarget().getIdentifier();
+    auto type = translate_type(elem.getDatatype());
+
+    mlir::Value val = elem.hasValue() ? lower_expression(elem.getValue()) : mlir::Value();
+
+    // Register the type only after lowering the value, so that e.g. "int x = x + 1" reads the outer x
+    declaredTypes.back()[name] = type;
+    builder.create<SsaVariableDeclarationOp>(builder.getUnknownLoc(), name, type, val);
+}
+
+void SpecialAbcAstToSsaVisitor::visit(Variable &elem)
+{
+    auto type = lookup_type(elem.getIdentifier());
+    value = builder.create<SsaVariableOp>(builder.getUnknownLoc(), type, elem.getIdentifier());
+}
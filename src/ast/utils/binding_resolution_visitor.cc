@@ -0,0 +1,15 @@
+#include "transpiration/ast/utils/binding_resolution_visitor.h"
+
+void SpecialBindingResolutionVisitor::visit(Variable &elem)
+{
+    if (auto scopedIdentifier = getCurrentScope().findIdentifier(elem.getIdentifier()))
+    {
+        elem.setBinding(*scopedIdentifier, getRootScope().getId());
+        ++numBindings;
+    }
+}
+
+size_t SpecialBindingResolutionVisitor::getNumBindings() const
+{
+    return numBindings;
+}
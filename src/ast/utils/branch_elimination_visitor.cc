@@ -0,0 +1,426 @@
+#include "transpiration/ast/utils/branch_elimination_visitor.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+/// Collects the identifiers of all variables that are assigned (in order of their first assignment) or declared
+/// anywhere in node
+/// \throws runtime_error if node contains a Return, which cannot be executed obliviously
+void collectWrittenVariables(
+    AbstractNode &node, std::vector<std::string> &written, std::unordered_set<std::string> &declared)
+{
+    auto collect = overloaded{
+        [](Return &) {
+            throw runtime_error("Cannot eliminate a branch with a secret condition that contains a return statement.");
+        },
+        [&written](Assignment &assignment) {
+            AbstractExpression *target = &assignment.getTarget();
+            while (auto indexAccess = dynamic_cast<IndexAccess *>(target))
+            {
+                target = &indexAccess->getTarget();
+            }
+            if (auto variable = dynamic_cast<Variable *>(target))
+            {
+                if (std::find(written.begin(), written.end(), variable->getIdentifier()) == written.end())
+                {
+                    written.push_back(variable->getIdentifier());
+                }
+            }
+        },
+        [&declared](VariableDeclaration &declaration) { declared.insert(declaration.getTarget().getIdentifier()); },
+        [](AbstractNode &) {}
+    };
+    walk(node, collect);
+}
+
+/// Renames all variables in node according to renames
+void renameVariables(AbstractNode &node, const std::unordered_map<std::string, std::string> &renames)
+{
+    walk(node, overloaded{ [&renames](Variable &variable) {
+                              auto it = renames.find(variable.getIdentifier());
+                              if (it != renames.end())
+                                  variable.setIdentifier(it->second);
+                          },
+                           [](AbstractNode &) {} });
+}
+
+/// Creates the oblivious select elseValue +++ (condition *** (thenValue --- elseValue)), elseValue should be a Variable
+/// since it occurs twice
+std::unique_ptr<AbstractExpression> makeMultiplexer(
+    std::unique_ptr<AbstractExpression> condition, std::unique_ptr<AbstractExpression> thenValue,
+    std::unique_ptr<AbstractExpression> elseValue)
+{
+    auto elseValueCopy = elseValue->clone(nullptr);
+    auto difference =
+        std::make_unique<BinaryExpression>(std::move(thenValue), Operator(FHE_SUBTRACTION), std::move(elseValue));
+    auto product =
+        std::make_unique<BinaryExpression>(std::move(condition), Operator(FHE_MULTIPLICATION), std::move(difference));
+    return std::make_unique<BinaryExpression>(std::move(elseValueCopy), Operator(FHE_ADDITION), std::move(product));
+}
+
+SpecialBranchEliminationVisitor::SpecialBranchEliminationVisitor(std::unordered_set<std::string> secretNodes)
+    : secretNodes(std::move(secretNodes))
+{}
+
+void SpecialBranchEliminationVisitor::visitExpression(
+    AbstractExpression &expr, const std::function<void(std::unique_ptr<AbstractExpression> &&)> &replace)
+{
+    auto replacement = rewriteBottomUp(expr, [this](auto &node) { return eliminate(node); });
+    if (replacement)
+        replace(std::move(replacement));
+}
+
+void SpecialBranchEliminationVisitor::visitStatements(Block &block)
+{
+    // temporaries of the enclosing statement (e.g., an If's condition) must not end up in this block
+    auto enclosingPending = std::move(pendingStatements);
+    pendingStatements.clear();
+
+    auto &statements = block.getStatementPointers();
+    for (size_t i = 0; i < statements.size(); ++i)
+    {
+        if (!statements[i])
+            continue;
+
+        statements[i]->accept(*this);
+        if (!pendingStatements.empty())
+        {
+            auto pending = std::move(pendingStatements);
+            pendingStatements.clear();
+            statements.insert(
+                statements.begin() + i, std::make_move_iterator(pending.begin()),
+                std::make_move_iterator(pending.end()));
+            for (size_t j = i; j < i + pending.size(); ++j)
+            {
+                statements[j]->setParent(block);
+            }
+            // skip the temporaries, they contain nothing that still needs to be eliminated
+            i += pending.size();
+        }
+        if (!replacementStatements.empty())
+        {
+            auto replacement = std::move(replacementStatements);
+            replacementStatements.clear();
+            statements.erase(statements.begin() + i);
+            statements.insert(
+                statements.begin() + i, std::make_move_iterator(replacement.begin()),
+                std::make_move_iterator(replacement.end()));
+            for (size_t j = i; j < i + replacement.size(); ++j)
+            {
+                statements[j]->setParent(block);
+            }
+            // the replacement has already been visited
+            i += replacement.size() - 1;
+        }
+    }
+
+    pendingStatements = std::move(enclosingPending);
+}
+
+Datatype SpecialBranchEliminationVisitor::lookupType(const std::string &identifier)
+{
+    for (auto scope = declaredTypes.rbegin(); scope != declaredTypes.rend(); ++scope)
+    {
+        auto it = scope->find(identifier);
+        if (it != scope->end())
+        {
+            return it->second;
+        }
+    }
+    throw runtime_error("Variable " + identifier + " is written in a secret branch but has not been declared.");
+}
+
+Datatype SpecialBranchEliminationVisitor::inferType(const AbstractExpression &expr)
+{
+    // post-order on an explicit stack, since unrolled programs nest expressions arbitrarily deep: an expression whose
+    // type depends on its operands is pushed again (as visited) below them, and then finds their types on top of types
+    struct Frame
+    {
+        const AbstractExpression *expr;
+        size_t operands;
+        bool visited;
+    };
+    std::vector<Frame> stack{ { &expr, 0, false } };
+    std::vector<Type> types;
+    while (!stack.empty())
+    {
+        auto frame = stack.back();
+        stack.pop_back();
+        auto &e = *frame.expr;
+        auto binaryExpression = dynamic_cast<const BinaryExpression *>(&e);
+        auto unaryExpression = dynamic_cast<const UnaryExpression *>(&e);
+
+        if (frame.visited)
+        {
+            // arithmetic (and calls like rotate) evaluate to the widest type of their operands, e.g. int * double is a
+            // double
+            auto type = Type::BOOL;
+            for (auto it = types.end() - static_cast<std::ptrdiff_t>(frame.operands); it != types.end(); ++it)
+            {
+                if (*it != Type::STRING && *it != Type::VOID && *it > type)
+                    type = *it;
+            }
+            types.resize(types.size() - frame.operands);
+            types.push_back(type);
+        }
+        else if (auto variable = dynamic_cast<const Variable *>(&e))
+        {
+            types.push_back(lookupType(variable->getIdentifier()).getType());
+        }
+        else if (dynamic_cast<const LiteralBool *>(&e))
+        {
+            types.push_back(Type::BOOL);
+        }
+        else if (dynamic_cast<const LiteralChar *>(&e))
+        {
+            types.push_back(Type::CHAR);
+        }
+        else if (dynamic_cast<const LiteralInt *>(&e))
+        {
+            types.push_back(Type::INT);
+        }
+        else if (dynamic_cast<const LiteralFloat *>(&e))
+        {
+            types.push_back(Type::FLOAT);
+        }
+        else if (dynamic_cast<const LiteralDouble *>(&e))
+        {
+            types.push_back(Type::DOUBLE);
+        }
+        else if (dynamic_cast<const LiteralString *>(&e))
+        {
+            types.push_back(Type::STRING);
+        }
+        else if (
+            binaryExpression && (binaryExpression->getOperator().isRelationalOperator() ||
+                                 binaryExpression->getOperator() == Operator(LOGICAL_AND) ||
+                                 binaryExpression->getOperator() == Operator(LOGICAL_OR)))
+        {
+            types.push_back(Type::BOOL);
+        }
+        else if (unaryExpression && unaryExpression->getOperator() == Operator(LOGICAL_NOT))
+        {
+            types.push_back(Type::BOOL);
+        }
+        else if (auto indexAccess = dynamic_cast<const IndexAccess *>(&e))
+        {
+            // the type of an array is the type of its elements
+            stack.push_back({ &indexAccess->getTarget(), 0, false });
+        }
+        else if (auto ternaryOperator = dynamic_cast<const TernaryOperator *>(&e))
+        {
+            stack.push_back({ &ternaryOperator->getThenExpr(), 0, false });
+        }
+        else
+        {
+            std::vector<const AbstractExpression *> operands;
+            for (auto &child : e)
+            {
+                if (auto operand = dynamic_cast<const AbstractExpression *>(&child))
+                    operands.push_back(operand);
+            }
+            stack.push_back({ &e, operands.size(), true });
+            for (auto it = operands.rbegin(); it != operands.rend(); ++it)
+            {
+                stack.push_back({ *it, 0, false });
+            }
+        }
+    }
+    return Datatype(types.back(), secretNodes.count(expr.getUniqueNodeId()) > 0);
+}
+
+std::vector<std::unique_ptr<AbstractStatement>> SpecialBranchEliminationVisitor::flatten(If &elem)
+{
+    std::vector<std::unique_ptr<AbstractStatement>> statements;
+    auto suffix = "_" + std::to_string(muxCounter++);
+
+    // evaluate the condition only once and share it between all multiplexers
+    auto conditionIdentifier = "__cond" + suffix;
+    // a comparison lowered by the ComparisonLoweringVisitor is a real that approximates 0 or 1, not a bool
+    auto conditionType = Datatype(inferType(elem.getCondition()).getType(), true);
+    statements.push_back(std::make_unique<VariableDeclaration>(
+        conditionType, std::make_unique<Variable>(conditionIdentifier), elem.getCondition().clone(nullptr)));
+
+    // variables declared outside of the If that are written in the then/else branch, in order of first assignment
+    std::vector<std::string> merged;
+    std::unordered_map<std::string, std::string> thenIdentifiers, elseIdentifiers;
+
+    auto inlineBranch = [&](Block &branch, const std::string &branchName,
+                            std::unordered_map<std::string, std::string> &branchIdentifiers) {
+        std::vector<std::string> written;
+        std::unordered_set<std::string> declared;
+        collectWrittenVariables(branch, written, declared);
+
+        std::unordered_map<std::string, std::string> renames;
+        for (auto &identifier : declared)
+        {
+            renames[identifier] = identifier + "__" + branchName + suffix;
+        }
+        for (auto &identifier : written)
+        {
+            if (declared.count(identifier))
+                continue;
+
+            // the branch works on a copy, so that the other branch still sees the original value
+            auto copyIdentifier = identifier + "__" + branchName + suffix;
+            renames[identifier] = copyIdentifier;
+            branchIdentifiers[identifier] = copyIdentifier;
+            statements.push_back(std::make_unique<VariableDeclaration>(
+                lookupType(identifier), std::make_unique<Variable>(copyIdentifier),
+                std::make_unique<Variable>(identifier)));
+            if (std::find(merged.begin(), merged.end(), identifier) == merged.end())
+            {
+                merged.push_back(identifier);
+            }
+        }
+
+        renameVariables(branch, renames);
+        for (auto &statement : branch.getStatementPointers())
+        {
+            if (statement)
+            {
+                statements.push_back(std::move(statement));
+            }
+        }
+    };
+
+    if (elem.hasThenBranch())
+        inlineBranch(elem.getThenBranch(), "then", thenIdentifiers);
+    if (elem.hasElseBranch())
+        inlineBranch(elem.getElseBranch(), "else", elseIdentifiers);
+
+    // one multiplexer (and thus one multiplication) per variable, no matter how often it was assigned
+    for (auto &identifier : merged)
+    {
+        auto thenIt = thenIdentifiers.find(identifier);
+        auto elseIt = elseIdentifiers.find(identifier);
+        auto thenValue = std::make_unique<Variable>(thenIt != thenIdentifiers.end() ? thenIt->second : identifier);
+        auto elseValue = std::make_unique<Variable>(elseIt != elseIdentifiers.end() ? elseIt->second : identifier);
+        auto multiplexer = makeMultiplexer(
+            std::make_unique<Variable>(conditionIdentifier), std::move(thenValue), std::move(elseValue));
+        statements.push_back(
+            std::make_unique<Assignment>(std::make_unique<Variable>(identifier), std::move(multiplexer)));
+    }
+
+    return statements;
+}
+
+std::unique_ptr<AbstractExpression> SpecialBranchEliminationVisitor::eliminate(AbstractExpression &)
+{
+    return nullptr;
+}
+
+std::unique_ptr<AbstractExpression> SpecialBranchEliminationVisitor::eliminate(TernaryOperator &elem)
+{
+    if (!elem.hasCondition() || !secretNodes.count(elem.getCondition().getUniqueNodeId()))
+        return nullptr;
+
+    if (!elem.hasThenExpr() || !elem.hasElseExpr())
+    {
+        throw runtime_error("TernaryOperator with a secret condition must have both a then and an else value.");
+    }
+
+    // the else value occurs twice in the multiplexer, so an expression is bound to a temporary to evaluate it once
+    std::unique_ptr<AbstractExpression> elseValue;
+    if (dynamic_cast<Variable *>(&elem.getElseExpr()))
+    {
+        elseValue = elem.getElseExpr().clone(nullptr);
+    }
+    else
+    {
+        auto elseIdentifier = "__else_" + std::to_string(muxCounter++);
+        pendingStatements.push_back(std::make_unique<VariableDeclaration>(
+            inferType(elem.getElseExpr()), std::make_unique<Variable>(elseIdentifier),
+            elem.getElseExpr().clone(nullptr)));
+        elseValue = std::make_unique<Variable>(elseIdentifier);
+    }
+    auto multiplexer =
+        makeMultiplexer(elem.getCondition().clone(nullptr), elem.getThenExpr().clone(nullptr), std::move(elseValue));
+    secretNodes.insert(multiplexer->getUniqueNodeId());
+    return multiplexer;
+}
+
+void SpecialBranchEliminationVisitor::visit(Assignment &elem)
+{
+    // the indices of the target are rewritten as well, but the target itself is never replaced
+    if (elem.hasTarget())
+        visitExpression(elem.getTarget(), [](std::unique_ptr<AbstractExpression> &&) {});
+    if (elem.hasValue())
+        visitExpression(elem.getValue(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setValue(std::move(e)); });
+}
+
+void SpecialBranchEliminationVisitor::visit(Block &elem)
+{
+    declaredTypes.emplace_back();
+    visitStatements(elem);
+    declaredTypes.pop_back();
+}
+
+void SpecialBranchEliminationVisitor::visit(For &elem)
+{
+    // variables declared in the initializer must be visible in condition, update and body
+    declaredTypes.emplace_back();
+    if (elem.hasInitializer())
+        visitStatements(elem.getInitializer());
+    if (elem.hasCondition())
+    {
+        visitExpression(
+            elem.getCondition(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setCondition(std::move(e)); });
+        // the condition is evaluated once per iteration, so it has no place for temporaries (and a loop whose
+        // condition depends on a secret cannot be executed obliviously anyway)
+        if (!pendingStatements.empty())
+            throw runtime_error("The condition of a For loop cannot contain a TernaryOperator with a secret condition.");
+    }
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    if (elem.hasUpdate())
+        visitStatements(elem.getUpdate());
+    declaredTypes.pop_back();
+}
+
+void SpecialBranchEliminationVisitor::visit(Function &elem)
+{
+    declaredTypes.emplace_back();
+    for (auto &param : elem.getParameters())
+    {
+        declaredTypes.back().insert_or_assign(param.get().getIdentifier(), param.get().getParameterType());
+    }
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    declaredTypes.pop_back();
+}
+
+void SpecialBranchEliminationVisitor::visit(If &elem)
+{
+    if (elem.hasCondition())
+        visitExpression(
+            elem.getCondition(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setCondition(std::move(e)); });
+
+    // flatten nested secret Ifs first, so that each branch is straight-line code (or plaintext control flow)
+    if (elem.hasThenBranch())
+        elem.getThenBranch().accept(*this);
+    if (elem.hasElseBranch())
+        elem.getElseBranch().accept(*this);
+
+    if (elem.hasCondition() && secretNodes.count(elem.getCondition().getUniqueNodeId()))
+    {
+        replacementStatements = flatten(elem);
+    }
+}
+
+void SpecialBranchEliminationVisitor::visit(Return &elem)
+{
+    if (elem.hasValue())
+        visitExpression(elem.getValue(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setValue(std::move(e)); });
+}
+
+void SpecialBranchEliminationVisitor::visit(VariableDeclaration &elem)
+{
+    if (elem.hasValue())
+        visitExpression(elem.getValue(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setValue(std::move(e)); });
+    if (elem.hasTarget())
+        declaredTypes.back().insert_or_assign(elem.getTarget().getIdentifier(), elem.getDatatype());
+}
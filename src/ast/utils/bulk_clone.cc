@@ -0,0 +1,237 @@
+#include "transpiration/ast/utils/bulk_clone.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// Post-order handler of walk() that clones every node once its children have been cloned, i.e., the clones of the
+/// children of a node are the topmost results, in order, when the node itself is cloned
+class BulkCloner
+{
+private:
+    NodeArena *arena;
+
+    const Substitutions &substitutions;
+
+    /// Clones whose parent has not been cloned yet
+    std::vector<std::unique_ptr<AbstractNode>> results;
+
+    /// Index of the clone of the first child of the node that is being cloned
+    size_t first = 0;
+
+    /// Index of the clone of the next child that is taken
+    size_t next = 0;
+
+    void begin(size_t children)
+    {
+        first = next = results.size() - children;
+    }
+
+    void finish(std::unique_ptr<AbstractNode> clone)
+    {
+        results.resize(first);
+        results.push_back(std::move(clone));
+    }
+
+    template <typename T>
+    std::unique_ptr<T> take()
+    {
+        return std::unique_ptr<T>(static_cast<T *>(results[next++].release()));
+    }
+
+    template <typename T>
+    std::unique_ptr<T> takeIf(bool hasChild)
+    {
+        return hasChild ? take<T>() : nullptr;
+    }
+
+    template <typename T>
+    std::vector<std::unique_ptr<T>> takeAll(size_t children)
+    {
+        std::vector<std::unique_ptr<T>> clones;
+        clones.reserve(children);
+        for (size_t i = 0; i < children; ++i)
+            clones.push_back(take<T>());
+        return clones;
+    }
+
+    /// Takes the clone of a child that must be of class T, which only a substitute might not be
+    template <typename T>
+    std::unique_ptr<T> takeTarget(bool hasChild, const char *parent, const char *target)
+    {
+        if (hasChild && !substitutions.empty() && !dynamic_cast<T *>(results[next].get()))
+            throw std::runtime_error(
+                "Cannot substitute the target of a " + std::string(parent) + " with an expression that is not a " +
+                target + ".");
+        return takeIf<T>(hasChild);
+    }
+
+public:
+    BulkCloner(NodeArena *arena, const Substitutions &substitutions) : arena(arena), substitutions(substitutions)
+    {}
+
+    std::unique_ptr<AbstractNode> takeClone()
+    {
+        return std::move(results.back());
+    }
+
+    void operator()(const Assignment &node)
+    {
+        begin(node.countChildren());
+        auto target = takeTarget<AbstractTarget>(node.hasTarget(), "Assignment", "AbstractTarget");
+        auto value = takeIf<AbstractExpression>(node.hasValue());
+        finish(NodeArena::make<Assignment>(arena, std::move(target), std::move(value)));
+    }
+
+    void operator()(const BinaryExpression &node)
+    {
+        begin(node.countChildren());
+        auto left = takeIf<AbstractExpression>(node.hasLeft());
+        auto right = takeIf<AbstractExpression>(node.hasRight());
+        finish(NodeArena::make<BinaryExpression>(arena, std::move(left), node.getOperator(), std::move(right)));
+    }
+
+    void operator()(const Block &node)
+    {
+        auto children = node.countChildren();
+        begin(children);
+        finish(NodeArena::make<Block>(arena, takeAll<AbstractStatement>(children)));
+    }
+
+    void operator()(const Call &node)
+    {
+        auto children = node.countChildren();
+        begin(children);
+        finish(NodeArena::make<Call>(arena, node.getIdentifier(), takeAll<AbstractExpression>(children)));
+    }
+
+    void operator()(const ExpressionList &node)
+    {
+        auto children = node.countChildren();
+        begin(children);
+        finish(NodeArena::make<ExpressionList>(arena, takeAll<AbstractExpression>(children)));
+    }
+
+    void operator()(const For &node)
+    {
+        begin(node.countChildren());
+        auto initializer = takeIf<Block>(node.hasInitializer());
+        auto condition = takeIf<AbstractExpression>(node.hasCondition());
+        auto update = takeIf<Block>(node.hasUpdate());
+        auto body = takeIf<Block>(node.hasBody());
+        finish(NodeArena::make<For>(
+            arena, std::move(initializer), std::move(condition), std::move(update), std::move(body)));
+    }
+
+    void operator()(const Function &node)
+    {
+        auto children = node.countChildren();
+        begin(children);
+        auto parameters = takeAll<FunctionParameter>(children - (node.hasBody() ? 1 : 0));
+        auto body = takeIf<Block>(node.hasBody());
+        finish(NodeArena::make<Function>(
+            arena, node.getReturnType(), node.getIdentifier(), std::move(parameters), std::move(body)));
+    }
+
+    void operator()(const FunctionParameter &node)
+    {
+        results.push_back(NodeArena::make<FunctionParameter>(arena, node));
+    }
+
+    void operator()(const If &node)
+    {
+        begin(node.countChildren());
+        auto condition = takeIf<AbstractExpression>(node.hasCondition());
+        auto thenBranch = takeIf<Block>(node.hasThenBranch());
+        auto elseBranch = takeIf<Block>(node.hasElseBranch());
+        finish(NodeArena::make<If>(arena, std::move(condition), std::move(thenBranch), std::move(elseBranch)));
+    }
+
+    void operator()(const IndexAccess &node)
+    {
+        begin(node.countChildren());
+        auto target = takeTarget<AbstractTarget>(node.hasTarget(), "IndexAccess", "AbstractTarget");
+        auto index = takeIf<AbstractExpression>(node.hasIndex());
+        finish(NodeArena::make<IndexAccess>(arena, std::move(target), std::move(index)));
+    }
+
+    template <typename T>
+    void operator()(const Literal<T> &node)
+    {
+        results.push_back(NodeArena::make<Literal<T>>(arena, node));
+    }
+
+    void operator()(const OperatorExpression &node)
+    {
+        auto children = node.countChildren();
+        begin(children);
+        finish(NodeArena::make<OperatorExpression>(arena, node.getOperator(), takeAll<AbstractExpression>(children)));
+    }
+
+    void operator()(const Return &node)
+    {
+        begin(node.countChildren());
+        finish(NodeArena::make<Return>(arena, takeIf<AbstractExpression>(node.hasValue())));
+    }
+
+    void operator()(const TernaryOperator &node)
+    {
+        begin(node.countChildren());
+        auto condition = takeIf<AbstractExpression>(node.hasCondition());
+        auto thenExpr = takeIf<AbstractExpression>(node.hasThenExpr());
+        auto elseExpr = takeIf<AbstractExpression>(node.hasElseExpr());
+        finish(NodeArena::make<TernaryOperator>(arena, std::move(condition), std::move(thenExpr), std::move(elseExpr)));
+    }
+
+    void operator()(const UnaryExpression &node)
+    {
+        begin(node.countChildren());
+        auto operand = takeIf<AbstractExpression>(node.hasOperand());
+        finish(NodeArena::make<UnaryExpression>(arena, std::move(operand), node.getOperator()));
+    }
+
+    void operator()(const Variable &node)
+    {
+        if (!substitutions.empty())
+        {
+            auto substitute = substitutions.find(node.getIdentifier());
+            if (substitute != substitutions.end())
+            {
+                // substitutes are typically leaves, e.g., the Variable or LiteralInt of an iteration, which do not
+                // need a walk of their own (nor must a Variable be substituted again)
+                auto &expression = *substitute->second;
+                if (expression.getNodeKind() == NodeKind::Variable)
+                    results.push_back(NodeArena::make<Variable>(
+                        arena, static_cast<const Variable &>(expression).getIdentifier()));
+                else if (expression.countChildren() == 0)
+                    dispatch(expression, *this);
+                else
+                    results.push_back(bulkClone(expression, arena));
+                return;
+            }
+        }
+        results.push_back(NodeArena::make<Variable>(arena, node.getIdentifier()));
+    }
+
+    void operator()(const VariableDeclaration &node)
+    {
+        begin(node.countChildren());
+        auto target = takeTarget<Variable>(node.hasTarget(), "VariableDeclaration", "Variable");
+        auto value = takeIf<AbstractExpression>(node.hasValue());
+        finish(NodeArena::make<VariableDeclaration>(arena, node.getDatatype(), std::move(target), std::move(value)));
+    }
+};
+} // namespace
+
+std::unique_ptr<AbstractNode> bulkClone(const AbstractNode &node, NodeArena *arena, const Substitutions &substitutions)
+{
+    BulkCloner cloner(arena, substitutions);
+    walk(node, NoHandler(), cloner);
+    return cloner.takeClone();
+}
@@ -0,0 +1,216 @@
+#include "transpiration/ast/utils/ciphertext_allocation_visitor.h"
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+SpecialCiphertextAllocationVisitor::SpecialCiphertextAllocationVisitor(std::unordered_set<std::string> cipherVariables)
+    : cipherVariables(std::move(cipherVariables))
+{}
+
+void SpecialCiphertextAllocationVisitor::occurs(const ScopedIdentifier &scopedIdentifier)
+{
+    auto it = intervals.find(scopedIdentifier);
+    if (it == intervals.end())
+        intervals[scopedIdentifier] = { position, position };
+    else
+        it->second.end = position;
+
+    // an occurrence in a loop that the variable is declared outside of might be read again in the next iteration
+    auto depth = declarationDepths.count(scopedIdentifier) ? declarationDepths[scopedIdentifier] : 0;
+    if (depth < openLoops.size())
+        loopCarried.emplace_back(scopedIdentifier, openLoops[depth]);
+
+    bool isTarget = currentTarget && std::equal_to<ScopedIdentifier>{}(*currentTarget, scopedIdentifier);
+    if (!isTarget && !firstReads.count(position))
+        firstReads.emplace(position, scopedIdentifier);
+}
+
+bool SpecialCiphertextAllocationVisitor::isParameter(const ScopedIdentifier &scopedIdentifier) const
+{
+    return std::any_of(parameters.begin(), parameters.end(), [&scopedIdentifier](const ScopedIdentifier &parameter) {
+        return std::equal_to<ScopedIdentifier>{}(parameter, scopedIdentifier);
+    });
+}
+
+void SpecialCiphertextAllocationVisitor::visit(Assignment &elem)
+{
+    auto variable = elem.hasTarget() ? dynamic_cast<Variable *>(&elem.getTarget()) : nullptr;
+    currentTarget = variable ? findIdentifier(*variable) : nullptr;
+    visitChildren(elem);
+    currentTarget = nullptr;
+}
+
+void SpecialCiphertextAllocationVisitor::visit(Block &elem)
+{
+    enterScope(elem);
+    for (auto &statement : elem.getStatementPointers())
+    {
+        if (!statement)
+            continue;
+        ++position;
+        statement->accept(*this);
+    }
+    exitScope();
+}
+
+void SpecialCiphertextAllocationVisitor::visit(For &elem)
+{
+    enterScope(elem);
+
+    // the initializer only runs once, before the loop (and like the update, it is in the scope of the loop)
+    if (elem.hasInitializer())
+        visitChildren(elem.getInitializer());
+
+    openLoops.push_back(loopIntervals.size());
+    loopIntervals.push_back({ position, position });
+    if (elem.hasCondition())
+        elem.getCondition().accept(*this);
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    if (elem.hasUpdate())
+        visitChildren(elem.getUpdate());
+    loopIntervals[openLoops.back()].end = position;
+    openLoops.pop_back();
+
+    exitScope();
+}
+
+void SpecialCiphertextAllocationVisitor::visit(FunctionParameter &elem)
+{
+    getCurrentScope().addIdentifier(elem.getIdentifier());
+    if (cipherVariables.count(elem.getIdentifier()))
+    {
+        auto &scopedIdentifier = getCurrentScope().resolveIdentifier(elem.getIdentifier());
+        parameters.push_back(scopedIdentifier);
+        declarationDepths[scopedIdentifier] = 0;
+        occurs(scopedIdentifier);
+    }
+}
+
+void SpecialCiphertextAllocationVisitor::visit(Variable &elem)
+{
+    if (!cipherVariables.count(elem.getIdentifier()))
+        return;
+    if (auto scopedIdentifier = findIdentifier(elem))
+    {
+        occurrences.emplace_back(&elem, *scopedIdentifier);
+        occurs(*scopedIdentifier);
+    }
+}
+
+void SpecialCiphertextAllocationVisitor::visit(VariableDeclaration &elem)
+{
+    if (!elem.hasTarget())
+        return;
+
+    // the value is visited first, since it cannot refer to the variable it initializes (but to one that it shadows)
+    if (elem.hasValue())
+        elem.getValue().accept(*this);
+
+    auto &target = elem.getTarget();
+    getCurrentScope().addIdentifier(target.getIdentifier());
+    auto &scopedIdentifier = getCurrentScope().resolveIdentifier(target.getIdentifier());
+    declarationDepths[scopedIdentifier] = openLoops.size();
+
+    currentTarget = &scopedIdentifier;
+    target.accept(*this);
+    currentTarget = nullptr;
+}
+
+const std::unordered_map<ScopedIdentifier, LiveInterval> &SpecialCiphertextAllocationVisitor::getIntervals()
+{
+    for (auto &[scopedIdentifier, loop] : loopCarried)
+    {
+        auto &interval = intervals[scopedIdentifier];
+        interval.start = std::min(interval.start, loopIntervals[loop].start);
+        interval.end = std::max(interval.end, loopIntervals[loop].end);
+    }
+    loopCarried.clear();
+    return intervals;
+}
+
+const std::unordered_map<ScopedIdentifier, std::string> &SpecialCiphertextAllocationVisitor::allocate()
+{
+    auto &liveIntervals = getIntervals();
+
+    // parameters first, then by start (and identifier and scope, to make the result deterministic)
+    std::vector<ScopedIdentifier> order;
+    for (auto &[scopedIdentifier, interval] : liveIntervals)
+        order.push_back(scopedIdentifier);
+    auto key = [&](const ScopedIdentifier &scopedIdentifier) {
+        return std::make_tuple(
+            !isParameter(scopedIdentifier), liveIntervals.at(scopedIdentifier).start, scopedIdentifier.getId(),
+            scopedIdentifier.getScopeId());
+    };
+    std::sort(order.begin(), order.end(), [&](const ScopedIdentifier &a, const ScopedIdentifier &b) {
+        return key(a) < key(b);
+    });
+
+    buffers.clear();
+    bufferCount = 0;
+    std::vector<ScopedIdentifier> active;
+    std::vector<std::string> freeBuffers;
+    for (auto &scopedIdentifier : order)
+    {
+        auto &interval = liveIntervals.at(scopedIdentifier);
+
+        // a value whose last use is the statement that defines the new value can share its buffer
+        for (auto it = active.begin(); it != active.end();)
+        {
+            if (!isParameter(scopedIdentifier) && liveIntervals.at(*it).end <= interval.start)
+            {
+                freeBuffers.push_back(buffers[*it]);
+                it = active.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        std::string buffer;
+        auto hint = firstReads.find(interval.start);
+        auto hintBuffer = (hint != firstReads.end() && buffers.count(hint->second))
+                              ? std::find(freeBuffers.begin(), freeBuffers.end(), buffers[hint->second])
+                              : freeBuffers.end();
+        if (isParameter(scopedIdentifier))
+        {
+            buffer = scopedIdentifier.getId();
+            ++bufferCount;
+        }
+        else if (hintBuffer != freeBuffers.end())
+        {
+            buffer = *hintBuffer;
+            freeBuffers.erase(hintBuffer);
+        }
+        else if (!freeBuffers.empty())
+        {
+            buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+        }
+        else
+        {
+            buffer = "__ct_" + std::to_string(bufferCount - parameters.size());
+            ++bufferCount;
+        }
+        buffers[scopedIdentifier] = buffer;
+        active.push_back(scopedIdentifier);
+    }
+    return buffers;
+}
+
+void SpecialCiphertextAllocationVisitor::assignBuffers()
+{
+    for (auto &[variable, scopedIdentifier] : occurrences)
+    {
+        auto buffer = buffers.find(scopedIdentifier);
+        if (buffer != buffers.end())
+            variable->setIdentifier(buffer->second);
+    }
+}
+
+size_t SpecialCiphertextAllocationVisitor::getBufferCount() const
+{
+    return bufferCount;
+}
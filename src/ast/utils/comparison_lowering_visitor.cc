@@ -0,0 +1,229 @@
+#include "transpiration/ast/utils/comparison_lowering_visitor.h"
+
+#include <iterator>
+
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+SpecialComparisonLoweringVisitor::SpecialComparisonLoweringVisitor(
+    std::unordered_set<std::string> secretNodes, ApproximationConfig defaultConfig,
+    std::unordered_map<std::string, ApproximationConfig> callSiteConfigs)
+    : secretNodes(std::move(secretNodes)), defaultConfig(defaultConfig), callSiteConfigs(std::move(callSiteConfigs))
+{}
+
+void SpecialComparisonLoweringVisitor::visitExpression(
+    AbstractExpression &expr, const std::function<void(std::unique_ptr<AbstractExpression> &&)> &replace)
+{
+    realNodes.clear();
+    auto replacement = rewriteBottomUp(expr, [this](auto &node) { return lowerComparison(node); });
+    if (replacement)
+        replace(std::move(replacement));
+}
+
+void SpecialComparisonLoweringVisitor::visitStatements(Block &block)
+{
+    // temporaries of the enclosing statement (e.g., an If's condition) must not end up in this block
+    auto enclosingPending = std::move(pendingStatements);
+    pendingStatements.clear();
+
+    auto &statements = block.getStatementPointers();
+    for (size_t i = 0; i < statements.size(); ++i)
+    {
+        if (!statements[i])
+            continue;
+
+        statements[i]->accept(*this);
+        if (!pendingStatements.empty())
+        {
+            auto pending = std::move(pendingStatements);
+            pendingStatements.clear();
+            statements.insert(
+                statements.begin() + i, std::make_move_iterator(pending.begin()),
+                std::make_move_iterator(pending.end()));
+            for (size_t j = i; j < i + pending.size(); ++j)
+            {
+                statements[j]->setParent(block);
+            }
+            // skip the temporaries, the statement itself has already been visited
+            i += pending.size();
+        }
+    }
+
+    pendingStatements = std::move(enclosingPending);
+}
+
+void SpecialComparisonLoweringVisitor::markReal(const AbstractNode &node)
+{
+    bool real = false;
+    if (auto variable = dynamic_cast<const Variable *>(&node))
+    {
+        for (auto scope = declaredTypes.rbegin(); scope != declaredTypes.rend(); ++scope)
+        {
+            auto it = scope->find(variable->getIdentifier());
+            if (it != scope->end())
+            {
+                real = it->second.getType() == Type::FLOAT || it->second.getType() == Type::DOUBLE;
+                break;
+            }
+        }
+    }
+    else if (dynamic_cast<const LiteralDouble *>(&node) || dynamic_cast<const LiteralFloat *>(&node))
+    {
+        real = true;
+    }
+    else if (auto binaryExpression = dynamic_cast<const BinaryExpression *>(&node);
+             !binaryExpression || !binaryExpression->getOperator().isRelationalOperator())
+    {
+        // the result of a comparison is a bool, even if its operands are reals
+        for (auto &child : node)
+        {
+            if (realNodes.count(&child))
+            {
+                real = true;
+                break;
+            }
+        }
+    }
+
+    // the node may reuse the address of a node that has been replaced in the meantime
+    if (real)
+        realNodes.insert(&node);
+    else
+        realNodes.erase(&node);
+}
+
+std::unique_ptr<AbstractExpression> SpecialComparisonLoweringVisitor::lower(BinaryExpression &elem)
+{
+    auto configIt = callSiteConfigs.find(elem.getUniqueNodeId());
+    auto &config = (configIt != callSiteConfigs.end()) ? configIt->second : defaultConfig;
+    auto approximation = SignApproximation::fromConfig(config);
+
+    auto prefix = "__cmp_" + std::to_string(comparisonCounter++);
+    auto &op = elem.getOperator();
+    bool lessThan = (op == Operator(LESS) || op == Operator(LESS_EQUAL));
+
+    // x = (a - b) / bound, with a and b swapped for < and <=, such that x > 0 iff the comparison holds
+    auto &minuend = lessThan ? elem.getRight() : elem.getLeft();
+    auto &subtrahend = lessThan ? elem.getLeft() : elem.getRight();
+    std::unique_ptr<AbstractExpression> difference = std::make_unique<BinaryExpression>(
+        minuend.clone(nullptr), Operator(FHE_SUBTRACTION), subtrahend.clone(nullptr));
+    if (config.inputBound != 1.0)
+    {
+        auto scale = std::make_unique<LiteralDouble>(1.0 / config.inputBound);
+        difference =
+            std::make_unique<BinaryExpression>(std::move(difference), Operator(FHE_MULTIPLICATION), std::move(scale));
+    }
+    pendingStatements.push_back(std::make_unique<VariableDeclaration>(
+        Datatype(Type::DOUBLE, true), std::make_unique<Variable>(prefix), std::move(difference)));
+
+    auto current = prefix;
+    for (size_t i = 0; i < approximation.getStages().size(); ++i)
+    {
+        auto stagePrefix = prefix + "_" + std::to_string(i);
+        PatersonStockmeyerEvaluator evaluator(pendingStatements, stagePrefix, current);
+        auto value = evaluator.evaluate(approximation.getStages()[i]);
+        pendingStatements.push_back(std::make_unique<VariableDeclaration>(
+            Datatype(Type::DOUBLE, true), std::make_unique<Variable>(stagePrefix), std::move(value)));
+        current = stagePrefix;
+    }
+
+    auto sign = [&current]() { return std::make_unique<Variable>(current); };
+    if (op == Operator(EQUAL) || op == Operator(NOTEQUAL))
+    {
+        auto square = std::make_unique<BinaryExpression>(sign(), Operator(FHE_MULTIPLICATION), sign());
+        if (op == Operator(NOTEQUAL))
+            return square;
+        return std::make_unique<BinaryExpression>(
+            std::make_unique<LiteralDouble>(1.0), Operator(FHE_SUBTRACTION), std::move(square));
+    }
+    return std::make_unique<BinaryExpression>(
+        std::make_unique<LiteralDouble>(0.5), Operator(FHE_ADDITION),
+        std::make_unique<BinaryExpression>(std::make_unique<LiteralDouble>(0.5), Operator(FHE_MULTIPLICATION), sign()));
+}
+
+std::unique_ptr<AbstractExpression> SpecialComparisonLoweringVisitor::lowerComparison(AbstractExpression &expr)
+{
+    markReal(expr);
+    return nullptr;
+}
+
+std::unique_ptr<AbstractExpression> SpecialComparisonLoweringVisitor::lowerComparison(BinaryExpression &elem)
+{
+    markReal(elem);
+    if (!elem.hasLeft() || !elem.hasRight() || !elem.getOperator().isRelationalOperator() ||
+        !(secretNodes.count(elem.getLeft().getUniqueNodeId()) ||
+          secretNodes.count(elem.getRight().getUniqueNodeId())) ||
+        !(realNodes.count(&elem.getLeft()) || realNodes.count(&elem.getRight())))
+        return nullptr;
+
+    auto replacement = lower(elem);
+    secretNodes.insert(replacement->getUniqueNodeId());
+    walk(*replacement, NoHandler(), [this](auto &node) { markReal(node); });
+    return replacement;
+}
+
+void SpecialComparisonLoweringVisitor::visit(Assignment &elem)
+{
+    // comparisons in the indices of the target are lowered as well, but the target itself is never replaced
+    if (elem.hasTarget())
+        visitExpression(elem.getTarget(), [](std::unique_ptr<AbstractExpression> &&) {});
+    if (elem.hasValue())
+        visitExpression(elem.getValue(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setValue(std::move(e)); });
+}
+
+void SpecialComparisonLoweringVisitor::visit(Block &elem)
+{
+    declaredTypes.emplace_back();
+    visitStatements(elem);
+    declaredTypes.pop_back();
+}
+
+void SpecialComparisonLoweringVisitor::visit(For &elem)
+{
+    // variables declared in the initializer must be visible in condition, update and body
+    declaredTypes.emplace_back();
+    if (elem.hasInitializer())
+        visitStatements(elem.getInitializer());
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    if (elem.hasUpdate())
+        visitStatements(elem.getUpdate());
+    declaredTypes.pop_back();
+}
+
+void SpecialComparisonLoweringVisitor::visit(Function &elem)
+{
+    declaredTypes.emplace_back();
+    for (auto &param : elem.getParameters())
+    {
+        declaredTypes.back().insert_or_assign(param.get().getIdentifier(), param.get().getParameterType());
+    }
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    declaredTypes.pop_back();
+}
+
+void SpecialComparisonLoweringVisitor::visit(If &elem)
+{
+    if (elem.hasCondition())
+        visitExpression(
+            elem.getCondition(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setCondition(std::move(e)); });
+    if (elem.hasThenBranch())
+        elem.getThenBranch().accept(*this);
+    if (elem.hasElseBranch())
+        elem.getElseBranch().accept(*this);
+}
+
+void SpecialComparisonLoweringVisitor::visit(Return &elem)
+{
+    if (elem.hasValue())
+        visitExpression(elem.getValue(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setValue(std::move(e)); });
+}
+
+void SpecialComparisonLoweringVisitor::visit(VariableDeclaration &elem)
+{
+    if (elem.hasValue())
+        visitExpression(elem.getValue(), [&](std::unique_ptr<AbstractExpression> &&e) { elem.setValue(std::move(e)); });
+    if (elem.hasTarget())
+        declaredTypes.back().insert_or_assign(elem.getTarget().getIdentifier(), elem.getDatatype());
+}
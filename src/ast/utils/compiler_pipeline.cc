@@ -0,0 +1,447 @@
+#include "transpiration/ast/utils/compiler_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+#include "transpiration/IR/ast/ASTDialect.h"
+#include "transpiration/IR/ast/HoistRotations.h"
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/abc_ast_to_ssa_visitor.h"
+#include "transpiration/ast/utils/binding_resolution_visitor.h"
+#include "transpiration/ast/utils/branch_elimination_visitor.h"
+#include "transpiration/ast/utils/comparison_lowering_visitor.h"
+#include "transpiration/ast/utils/layout_planner.h"
+#include "transpiration/ast/utils/rotation_scheduling_visitor.h"
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+#include "transpiration/ast/utils/static_visitor.h"
+#include "transpiration/ast/utils/statistics.h"
+#include "transpiration/ast/utils/structural_hash.h"
+
+namespace
+{
+/// Runs a phase and appends its report, or adds to the report if the phase ran before (for another Function). The
+/// phase is also timed by the CompilerStatistics if timing is enabled.
+template <typename F>
+void runPhase(CompilationReport &report, const std::string &name, F &&phase)
+{
+    PhaseTimer timer(name);
+    auto start = std::chrono::steady_clock::now();
+    phase();
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    auto it = std::find_if(
+        report.phases.begin(), report.phases.end(), [&name](const PhaseReport &p) { return p.name == name; });
+    if (it == report.phases.end())
+    {
+        report.phases.push_back({ name, duration.count(), CompilerStatistics::peakResidentBytes() });
+    }
+    else
+    {
+        it->milliseconds += duration.count();
+        it->peakResidentBytes = CompilerStatistics::peakResidentBytes();
+    }
+}
+
+/// Runs a visitor on the AST as a phase of the CompilerStatistics
+template <typename V>
+void runVisitor(const std::string &name, AbstractNode &ast, V &visitor)
+{
+    PhaseTimer timer(name);
+    ast.accept(visitor);
+}
+
+/// Times every MLIR pass as a phase of the CompilerStatistics, nested into the phase that runs the pass manager
+class PhaseTimingInstrumentation : public mlir::PassInstrumentation
+{
+public:
+    void runBeforePass(mlir::Pass *pass, mlir::Operation *) override
+    {
+        CompilerStatistics::startPhase(pass->getArgument().str());
+    }
+
+    void runAfterPass(mlir::Pass *, mlir::Operation *) override
+    {
+        CompilerStatistics::stopPhase();
+    }
+
+    void runAfterPassFailed(mlir::Pass *, mlir::Operation *) override
+    {
+        CompilerStatistics::stopPhase();
+    }
+};
+
+size_t countOperations(mlir::ModuleOp module)
+{
+    size_t count = 0;
+    module->walk([&count](mlir::Operation *) { ++count; });
+    // without the module itself
+    return count - 1;
+}
+
+/// Is the program a Block of Functions only, i.e., is it compiled one Function at a time?
+bool isProgramOfFunctions(AbstractNode &ast)
+{
+    auto program = dynamic_cast<Block *>(&ast);
+    if (!program)
+        return false;
+    auto &statements = program->getStatementPointers();
+    return !statements.empty() &&
+           std::all_of(statements.begin(), statements.end(), [](auto &s) { return dynamic_cast<Function *>(s.get()); });
+}
+
+/// Moves every Function of a program into a Block of its own
+/// \return The Blocks, or none (leaving the program as it is) if the program is not a Block of Functions
+std::vector<std::unique_ptr<Block>> splitFunctions(AbstractNode &ast)
+{
+    std::vector<std::unique_ptr<Block>> blocks;
+    if (!isProgramOfFunctions(ast))
+        return blocks;
+
+    auto &statements = static_cast<Block &>(ast).getStatementPointers();
+    for (auto &statement : statements)
+        blocks.push_back(std::make_unique<Block>(std::move(statement)));
+    statements.clear();
+    return blocks;
+}
+
+/// Hash of the secret signatures of the functions that a Function calls, i.e., of their names, whether they return a
+/// secret value and which of their parameters are secret, in the order of their names
+uint64_t calleesHash(
+    const AbstractNode &function, const std::unordered_map<std::string, const Function *> &functions,
+    const std::unordered_set<std::string> &secretFunctions)
+{
+    std::vector<std::string> callees;
+    walk(function, overloaded{ [&](const Call &call) { callees.push_back(call.getIdentifier()); },
+                               [](const AbstractNode &) {} });
+    std::sort(callees.begin(), callees.end());
+    callees.erase(std::unique(callees.begin(), callees.end()), callees.end());
+
+    uint64_t hash = stableHash("callees");
+    for (auto &callee : callees)
+    {
+        hash = combineHashes(hash, stableHash(callee));
+        hash = combineHashes(hash, static_cast<uint64_t>(secretFunctions.count(callee)));
+        auto it = functions.find(callee);
+        if (it == functions.end())
+            continue;
+        for (auto &parameter : it->second->getParameters())
+            hash = combineHashes(hash, static_cast<uint64_t>(parameter.get().getParameterType().getSecretFlag()));
+    }
+    return hash;
+}
+} // namespace
+
+const char *const CompilerPipeline::VERSION = "3";
+
+double CompilationReport::totalMilliseconds() const
+{
+    double total = 0;
+    for (auto &phase : phases)
+        total += phase.milliseconds;
+    return total;
+}
+
+nlohmann::json CompilationReport::toJson() const
+{
+    nlohmann::json phasesJson = nlohmann::json::array();
+    for (auto &phase : phases)
+        phasesJson.push_back({ { "name", phase.name },
+                               { "ms", phase.milliseconds },
+                               { "peak_rss_bytes", phase.peakResidentBytes } });
+
+    return { { "phases", phasesJson },
+             { "total_ms", totalMilliseconds() },
+             { "counts",
+               { { "source_bytes", sourceBytes },
+                 { "tokens", tokens },
+                 { "parsed_nodes", parsedNodes },
+                 { "lowered_nodes", loweredNodes },
+                 { "resolved_identifiers", resolvedIdentifiers },
+                 { "mlir_operations", mlirOperations },
+                 { "optimized_mlir_operations", optimizedMlirOperations },
+                 { "emitted_bytes", emittedBytes } } },
+             { "counters", counters } };
+}
+
+CompilerPipeline::CompilerPipeline(ParameterSpec spec, bool parallel) : spec(std::move(spec)), parallel(parallel)
+{}
+
+void CompilerPipeline::enablePassTimingReport(bool enabled)
+{
+    passTimingReport = enabled;
+}
+
+void CompilerPipeline::setCostTable(CostTable costs)
+{
+    costTable = std::move(costs);
+}
+
+void CompilerPipeline::setFunctionCache(FunctionCache *functionCache)
+{
+    cache = functionCache;
+}
+
+uint64_t CompilerPipeline::optionsHash() const
+{
+    auto hash = stableHash(VERSION);
+    hash = combineHashes(hash, static_cast<uint64_t>(spec.scheme));
+    hash = combineHashes(hash, spec.polyModulusDegree);
+    hash = combineHashes(hash, static_cast<uint64_t>(spec.plainModulusBits));
+    for (auto bits : spec.coeffModulusBits)
+        hash = combineHashes(hash, static_cast<uint64_t>(bits));
+    hash = combineHashes(hash, static_cast<uint64_t>(spec.scaleBits));
+    hash = combineHashes(hash, static_cast<uint64_t>(parallel));
+    // the keys of programs and Functions compiled without a cost table stay the same
+    return costTable ? combineHashes(hash, stableHash(costTable->toJson().dump())) : hash;
+}
+
+void CompilerPipeline::setProgramCache(ProgramCache *cache)
+{
+    programCache = cache;
+}
+
+size_t CompilerPipeline::countNodes(AbstractNode &root)
+{
+    size_t count = 0;
+    walk(root, [&count](const AbstractNode &) { ++count; });
+    return count;
+}
+
+CompiledFunction CompilerPipeline::compileUnit(
+    AbstractNode &ast, const std::unordered_set<std::string> &secretFunctions, bool prologue,
+    mlir::MLIRContext &context, CompilationReport &report) const
+{
+    CompiledFunction compiled;
+
+    // the scopes with the bindings of all Variables, until the first pass that transforms the AST
+    std::unique_ptr<Scope> scopes;
+    runPhase(report, "scoping", [&]() {
+        BindingResolutionVisitor resolution;
+        ast.accept(resolution);
+        compiled.resolvedIdentifiers = resolution.getNumBindings();
+        scopes = resolution.takeRootScope();
+    });
+
+    runPhase(report, "ast-passes", [&]() {
+        SecretTaintVisitor taint;
+        taint.setRootScope(std::move(scopes));
+        taint.setSecretFunctions(secretFunctions);
+        runVisitor("secret-taint", ast, taint);
+        ComparisonLoweringVisitor comparisonLowering(taint.getTaintedNodes());
+        runVisitor("comparison-lowering", ast, comparisonLowering);
+
+        // the lowered comparisons consist of new nodes, whose taint is not known yet
+        SecretTaintVisitor loweredTaint;
+        loweredTaint.setSecretFunctions(secretFunctions);
+        runVisitor("secret-taint", ast, loweredTaint);
+        BranchEliminationVisitor branchElimination(loweredTaint.getTaintedNodes());
+        runVisitor("branch-elimination", ast, branchElimination);
+
+        // and so do the flattened branches
+        SecretTaintVisitor flatTaint;
+        flatTaint.setSecretFunctions(secretFunctions);
+        runVisitor("secret-taint", ast, flatTaint);
+        LayoutPlanningVisitor layoutPlanning(flatTaint.getTaintedNodes(), spec.polyModulusDegree / 2);
+        if (costTable)
+            layoutPlanning.useCostTable(*costTable);
+        const LayoutPlan *plan;
+        {
+            PhaseTimer timer("layout-planning");
+            ast.accept(layoutPlanning);
+            plan = &layoutPlanning.plan();
+            layoutPlanning.insertConversions();
+        }
+        RotationSchedulingVisitor rotationScheduling(flatTaint.getTaintedNodes(), layoutPlanning.getSites(), *plan);
+        runVisitor("rotation-scheduling", ast, rotationScheduling);
+    });
+    compiled.loweredNodes = countNodes(ast);
+
+    // the hoist-rotations pass on the lowered AST decides which rotations the emitter computes together
+    mlir::OwningOpRef<mlir::ModuleOp> module;
+    runPhase(report, "ast-to-mlir", [&]() {
+        AbcAstToSsaVisitor lowering(context);
+        ast.accept(lowering);
+        std::unique_ptr<mlir::Block> block(lowering.getBlockPtr());
+        module = mlir::ModuleOp::create(mlir::UnknownLoc::get(&context));
+        module->getBody()->getOperations().splice(module->getBody()->end(), block->getOperations());
+    });
+    compiled.mlirOperations = countOperations(*module);
+
+    runPhase(report, "mlir-passes", [&]() {
+        mlir::PassManager passManager(&context);
+        if (CompilerStatistics::isTimingEnabled())
+            passManager.addInstrumentation(std::make_unique<PhaseTimingInstrumentation>());
+        if (passTimingReport)
+            passManager.enableTiming();
+        passManager.addPass(createHoistRotationsPass());
+        if (mlir::failed(passManager.run(*module)))
+            throw runtime_error("The MLIR pass pipeline failed.");
+    });
+    compiled.optimizedMlirOperations = countOperations(*module);
+    auto rotationGroups = collectHoistedRotations(*module);
+
+    std::ostringstream code;
+    runPhase(report, "emit", [&]() {
+        SealEmitterVisitor emitter(code, spec, parallel);
+        if (!prologue)
+            emitter.omitPrologue();
+        emitter.setRotationGroups(rotationGroups);
+        ast.accept(emitter);
+    });
+    compiled.code = code.str();
+    return compiled;
+}
+
+CompilationReport CompilerPipeline::compile(std::string source, std::ostream &output) const
+{
+    // the identifiers of the program are interned in a table of its own, which is released with the AST and its Scopes
+    SymbolTable::Context symbols;
+    CompilationReport report;
+    report.sourceBytes = source.size();
+    std::vector<size_t> counters;
+    for (size_t i = 0; i < static_cast<size_t>(Counter::COUNT); ++i)
+        counters.push_back(CompilerStatistics::get(static_cast<Counter>(i)));
+    auto countSinceStart = [&report, &counters]() {
+        for (size_t i = 0; i < static_cast<size_t>(Counter::COUNT); ++i)
+        {
+            auto counter = static_cast<Counter>(i);
+            report.counters[enumToString(counter)] = CompilerStatistics::get(counter) - counters[i];
+        }
+    };
+
+    uint64_t programKey = 0;
+    std::string programSource;
+    if (programCache)
+    {
+        std::optional<CompiledProgram> cached;
+        runPhase(report, "program-cache-lookup", [&]() {
+            auto options = optionsHash();
+            programKey = combineHashes(options, stableHash(source));
+            cached = programCache->find(programKey, source, options);
+        });
+        if (cached)
+        {
+            CompilerStatistics::increment(Counter::PROGRAMS_REUSED);
+            report.emittedBytes = cached->code.size();
+            output << cached->code;
+            countSinceStart();
+            return report;
+        }
+        // tokenizing consumes the source
+        programSource = source;
+    }
+
+    std::deque<token> tokens;
+    runPhase(report, "tokenize", [&]() { tokens = Parser::tokenize(std::move(source)); });
+    report.tokens = tokens.size();
+
+    std::unique_ptr<AbstractNode> ast;
+    runPhase(report, "parse", [&]() { ast = Parser::parse(tokens); });
+    report.parsedNodes = countNodes(*ast);
+
+    // only created once a Function has to be compiled, which loading the dialect is a noticeable part of
+    std::unique_ptr<mlir::MLIRContext> context;
+    auto getContext = [&context]() -> mlir::MLIRContext & {
+        if (!context)
+        {
+            context = std::make_unique<mlir::MLIRContext>();
+            context->getOrLoadDialect<heco::ast::ASTDialect>();
+            // the instrumentation of a multi-threaded pass manager would run concurrently
+            if (CompilerStatistics::isTimingEnabled())
+                context->disableMultithreading();
+        }
+        return *context;
+    };
+
+    std::ostringstream code;
+    auto add = [&report, &code](const CompiledFunction &compiled) {
+        report.resolvedIdentifiers += compiled.resolvedIdentifiers;
+        report.mlirOperations += compiled.mlirOperations;
+        report.optimizedMlirOperations += compiled.optimizedMlirOperations;
+        report.loweredNodes += compiled.loweredNodes;
+        code << compiled.code;
+    };
+
+    // the taint of the whole program, since a Function depends on the secret functions and secret arguments of
+    // Calls in any other Function, including those that follow it
+    std::unordered_set<std::string> secretFunctions;
+    if (isProgramOfFunctions(*ast))
+    {
+        runPhase(report, "program-taint", [&]() {
+            SecretTaintVisitor programTaint;
+            runVisitor("secret-taint", *ast, programTaint);
+            secretFunctions = programTaint.getSecretFunctions();
+        });
+    }
+
+    auto functions = splitFunctions(*ast);
+    if (functions.empty())
+    {
+        // e.g. a Block of statements, which is compiled as a whole
+        add(compileUnit(*ast, {}, true, getContext(), report));
+    }
+    else
+    {
+        SealEmitterVisitor(code, spec, parallel).emitPrologue();
+        // the program around the Functions
+        report.loweredNodes = 1;
+        std::unordered_map<std::string, const Function *> functionsByName;
+        for (auto &block : functions)
+        {
+            auto &function = static_cast<const Function &>(*block->getStatementPointers().front());
+            functionsByName[function.getIdentifier()] = &function;
+        }
+
+        for (auto &block : functions)
+        {
+            auto &function = static_cast<Function &>(*block->getStatementPointers().front());
+            uint64_t key = 0;
+            const CompiledFunction *cached = nullptr;
+            if (cache)
+            {
+                runPhase(report, "cache-lookup", [&]() {
+                    // the structural hash includes the secret parameters that the program taint found
+                    key = combineHashes(optionsHash(), structuralHash(function));
+                    key = combineHashes(key, calleesHash(function, functionsByName, secretFunctions));
+                    cached = cache->find(key);
+                });
+            }
+
+            if (cached)
+            {
+                CompilerStatistics::increment(Counter::FUNCTIONS_REUSED);
+                add(*cached);
+            }
+            else
+            {
+                CompilerStatistics::increment(Counter::FUNCTIONS_COMPILED);
+                auto compiled = compileUnit(*block, secretFunctions, false, getContext(), report);
+                compiled.returnsSecret = secretFunctions.count(function.getIdentifier()) > 0;
+                // without the Block around the Function
+                --compiled.loweredNodes;
+                add(compiled);
+                if (cache)
+                    cache->insert(key, std::move(compiled));
+            }
+        }
+    }
+
+    auto emitted = code.str();
+    report.emittedBytes = emitted.size();
+    output << emitted;
+    if (programCache)
+        programCache->insert(programKey, { std::move(programSource), optionsHash(), std::move(emitted), spec });
+
+    countSinceStart();
+    return report;
+}
@@ -0,0 +1,124 @@
+#include "transpiration/ast/utils/function_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+nlohmann::json CompiledFunction::toJson() const
+{
+    return { { "code", code },
+             { "returns_secret", returnsSecret },
+             { "resolved_identifiers", resolvedIdentifiers },
+             { "mlir_operations", mlirOperations },
+             { "optimized_mlir_operations", optimizedMlirOperations },
+             { "lowered_nodes", loweredNodes } };
+}
+
+CompiledFunction CompiledFunction::fromJson(const nlohmann::json &j)
+{
+    CompiledFunction function;
+    function.code = j.at("code").get<std::string>();
+    function.returnsSecret = j.at("returns_secret").get<bool>();
+    function.resolvedIdentifiers = j.at("resolved_identifiers").get<size_t>();
+    function.mlirOperations = j.at("mlir_operations").get<size_t>();
+    function.optimizedMlirOperations = j.at("optimized_mlir_operations").get<size_t>();
+    function.loweredNodes = j.at("lowered_nodes").get<size_t>();
+    return function;
+}
+
+FunctionCache::FunctionCache(std::string directory) : directory(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (error)
+        throw std::runtime_error("Cannot create the cache directory " + this->directory + ": " + error.message());
+}
+
+std::string FunctionCache::pathOf(uint64_t key) const
+{
+    std::ostringstream path;
+    path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".json";
+    return path.str();
+}
+
+const CompiledFunction *FunctionCache::find(uint64_t key)
+{
+    auto it = functions.find(key);
+    if (it != functions.end())
+    {
+        ++hits;
+        return &it->second;
+    }
+
+    if (!directory.empty())
+    {
+        std::ifstream file(pathOf(key));
+        if (file)
+        {
+            try
+            {
+                nlohmann::json j;
+                file >> j;
+                ++hits;
+                return &functions.emplace(key, CompiledFunction::fromJson(j)).first->second;
+            }
+            catch (nlohmann::json::exception &)
+            {
+                // e.g. written by a different version, it is overwritten once the Function is compiled again
+            }
+        }
+    }
+    ++misses;
+    return nullptr;
+}
+
+void FunctionCache::insert(uint64_t key, CompiledFunction function)
+{
+    if (!directory.empty())
+        writeFileAtomically(pathOf(key), function.toJson().dump());
+    functions.insert_or_assign(key, std::move(function));
+}
+
+size_t FunctionCache::size() const
+{
+    return functions.size();
+}
+
+size_t FunctionCache::getHits() const
+{
+    return hits;
+}
+
+size_t FunctionCache::getMisses() const
+{
+    return misses;
+}
+
+bool writeFileAtomically(const std::string &path, const std::string &contents)
+{
+    // unique among the processes (and threads) that might write the same file at the same time
+    thread_local std::mt19937_64 random(std::random_device{}());
+    auto temporary = path + ".tmp" + std::to_string(random());
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file << contents;
+        file.close();
+        if (!file)
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
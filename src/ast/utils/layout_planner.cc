@@ -0,0 +1,833 @@
+#include "transpiration/ast/utils/layout_planner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+std::string enumToString(const Layout layout)
+{
+    std::unordered_map<Layout, std::string> layoutToString = {
+        { Layout::ROW_MAJOR, "row-major" },
+        { Layout::COLUMN_MAJOR, "column-major" },
+        { Layout::DIAGONAL, "diagonal" },
+        { Layout::REPLICATED, "replicated" }
+    };
+    return layoutToString.find(layout)->second;
+}
+
+/// ceil(log2(n)), i.e., the number of rotate-and-add steps needed to sum up n slots
+size_t ceilLog2(size_t n)
+{
+    size_t log = 0;
+    while ((size_t(1) << log) < n)
+        ++log;
+    return log;
+}
+
+/// Number of rotations needed to create n copies of a ciphertext segment by repeated doubling
+size_t replicationRotations(size_t n)
+{
+    if (n <= 1)
+        return 0;
+    size_t floorLog = 0;
+    while ((size_t(2) << floorLog) <= n)
+        ++floorLog;
+    size_t popcount = 0;
+    for (size_t m = n; m; m >>= 1)
+        popcount += m & 1;
+    return floorLog + popcount - 1;
+}
+
+/// Splits target[index]...[index] into the identifier of the target and the identifiers of the indices
+/// \return false if the expression is not an IndexAccess into a Variable with Variables as indices
+bool decomposeAccess(AbstractExpression &expr, std::string &identifier, std::vector<std::string> &indices)
+{
+    indices.clear();
+    AbstractExpression *target = &expr;
+    while (auto indexAccess = dynamic_cast<IndexAccess *>(target))
+    {
+        auto index = dynamic_cast<Variable *>(&indexAccess->getIndex());
+        if (!index)
+            return false;
+        indices.insert(indices.begin(), index->getIdentifier());
+        target = &indexAccess->getTarget();
+    }
+    auto variable = dynamic_cast<Variable *>(target);
+    if (!variable || indices.empty())
+        return false;
+    identifier = variable->getIdentifier();
+    return true;
+}
+
+/// Does node contain an Assignment to (an element of) the given variable?
+bool writesArray(AbstractNode &node, const std::string &identifier)
+{
+    bool writes = false;
+    walk(node, overloaded{ [&](Assignment &assignment) {
+                              AbstractExpression *target = &assignment.getTarget();
+                              while (auto indexAccess = dynamic_cast<IndexAccess *>(target))
+                              {
+                                  target = &indexAccess->getTarget();
+                              }
+                              auto variable = dynamic_cast<Variable *>(target);
+                              writes = writes || (variable && variable->getIdentifier() == identifier);
+                              return !writes;
+                          },
+                           [&writes](AbstractNode &) { return !writes; } });
+    return writes;
+}
+
+/// Renames all occurrences of the variable in node
+void renameArray(AbstractNode &node, const std::string &from, const std::string &to)
+{
+    walk(node, overloaded{ [&](Variable &variable) {
+                              if (variable.getIdentifier() == from)
+                                  variable.setIdentifier(to);
+                          },
+                           [](AbstractNode &) {} });
+}
+
+/// rotate(identifier, k), i.e., slot i of the result holds slot i + k of the input, or just identifier if k == 0
+std::unique_ptr<AbstractExpression> makeRotation(const std::string &identifier, long k)
+{
+    if (k == 0)
+        return std::make_unique<Variable>(identifier);
+    std::vector<std::unique_ptr<AbstractExpression>> arguments;
+    arguments.push_back(std::make_unique<Variable>(identifier));
+    arguments.push_back(std::make_unique<LiteralInt>(static_cast<int>(k)));
+    return std::make_unique<Call>("rotate", std::move(arguments));
+}
+
+/// 0/1 plaintext vector of the given size with ones exactly at the given slots
+std::unique_ptr<AbstractExpression> makeMask(size_t size, const std::vector<size_t> &ones)
+{
+    std::vector<std::unique_ptr<AbstractExpression>> elements;
+    for (size_t i = 0; i < size; ++i)
+    {
+        elements.push_back(std::make_unique<LiteralInt>(std::find(ones.begin(), ones.end(), i) != ones.end()));
+    }
+    return std::make_unique<ExpressionList>(std::move(elements));
+}
+
+/// Sum of the given expressions
+std::unique_ptr<AbstractExpression> makeSum(std::vector<std::unique_ptr<AbstractExpression>> &&terms)
+{
+    std::unique_ptr<AbstractExpression> sum = nullptr;
+    for (auto &term : terms)
+    {
+        if (sum)
+            sum = std::make_unique<BinaryExpression>(std::move(sum), Operator(FHE_ADDITION), std::move(term));
+        else
+            sum = std::move(term);
+    }
+    return sum;
+}
+
+/// Emits the conversion of one array between two layouts as a sequence of declarations
+class ConversionEmitter
+{
+private:
+    std::vector<std::unique_ptr<AbstractStatement>> &statements;
+    const ArrayInfo &array;
+    std::string prefix;
+    size_t temporaries = 0;
+
+    std::string declare(std::unique_ptr<AbstractExpression> &&value)
+    {
+        auto identifier = prefix + "_" + std::to_string(temporaries++);
+        statements.push_back(std::make_unique<VariableDeclaration>(
+            array.datatype, std::make_unique<Variable>(identifier), std::move(value)));
+        return identifier;
+    }
+
+    /// n copies of the first `stride` slots of source, at offsets 0, stride, 2*stride, ... (doubling, then adding up
+    /// the binary decomposition of n)
+    std::string replicate(const std::string &source, size_t n, size_t stride)
+    {
+        std::vector<std::string> doublings = { source };
+        while ((size_t(2) << (doublings.size() - 1)) <= n)
+        {
+            auto &last = doublings.back();
+            long shift = -static_cast<long>((size_t(1) << (doublings.size() - 1)) * stride);
+            std::vector<std::unique_ptr<AbstractExpression>> terms;
+            terms.push_back(std::make_unique<Variable>(last));
+            terms.push_back(makeRotation(last, shift));
+            doublings.push_back(declare(makeSum(std::move(terms))));
+        }
+
+        std::vector<std::unique_ptr<AbstractExpression>> terms;
+        size_t copies = 0;
+        for (size_t bit = doublings.size(); bit-- > 0;)
+        {
+            if (n & (size_t(1) << bit))
+            {
+                terms.push_back(makeRotation(doublings[bit], -static_cast<long>(copies * stride)));
+                copies += size_t(1) << bit;
+            }
+        }
+        return (terms.size() == 1) ? doublings.back() : declare(makeSum(std::move(terms)));
+    }
+
+    /// Moves the slots in each of the groups by the given amount (one mask and one rotation per group)
+    std::string permute(const std::string &source, const std::vector<std::pair<long, std::vector<size_t>>> &groups)
+    {
+        std::vector<std::unique_ptr<AbstractExpression>> terms;
+        for (auto &[shift, group] : groups)
+        {
+            auto masked = declare(std::make_unique<BinaryExpression>(
+                std::make_unique<Variable>(source), Operator(FHE_MULTIPLICATION), makeMask(size(), group)));
+            terms.push_back(makeRotation(masked, shift));
+        }
+        return declare(makeSum(std::move(terms)));
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return array.rows * array.columns;
+    }
+
+public:
+    ConversionEmitter(std::vector<std::unique_ptr<AbstractStatement>> &statements, const ArrayInfo &array,
+                      std::string prefix)
+        : statements(statements), array(array), prefix(std::move(prefix))
+    {}
+
+    /// \return identifier of the converted array
+    /// \throws runtime_error if the conversion cannot be done in-circuit
+    std::string convert(const std::string &source, Layout from, Layout to)
+    {
+        size_t n = array.rows;
+        size_t m = array.columns;
+        if (from == to)
+            return source;
+
+        if (array.dimensions == 1)
+        {
+            if (from == Layout::ROW_MAJOR && to == Layout::REPLICATED)
+            {
+                return replicate(source, n, m);
+            }
+            else if (from == Layout::REPLICATED && to == Layout::ROW_MAJOR)
+            {
+                std::vector<size_t> ones(m);
+                std::iota(ones.begin(), ones.end(), 0);
+                return declare(std::make_unique<BinaryExpression>(
+                    std::make_unique<Variable>(source), Operator(FHE_MULTIPLICATION), makeMask(size(), ones)));
+            }
+            else if (from == Layout::ROW_MAJOR && to == Layout::COLUMN_MAJOR)
+            {
+                // v[j] from slot j to slot j*n, then n copies within each block of n slots
+                std::vector<std::pair<long, std::vector<size_t>>> groups;
+                for (size_t j = 0; j < m; ++j)
+                    groups.push_back({ static_cast<long>(j) - static_cast<long>(j * n), { j } });
+                return replicate(permute(source, groups), n, 1);
+            }
+            else if (from == Layout::COLUMN_MAJOR && to == Layout::ROW_MAJOR)
+            {
+                std::vector<std::pair<long, std::vector<size_t>>> groups;
+                for (size_t j = 0; j < m; ++j)
+                    groups.push_back({ static_cast<long>(j * n) - static_cast<long>(j), { j * n } });
+                return permute(source, groups);
+            }
+            else if (from != Layout::DIAGONAL && to != Layout::DIAGONAL)
+            {
+                // between replicated and column-major via row-major
+                return convert(convert(source, from, Layout::ROW_MAJOR), Layout::ROW_MAJOR, to);
+            }
+        }
+        else if (n == m && (from == Layout::ROW_MAJOR || from == Layout::COLUMN_MAJOR) &&
+                 (to == Layout::ROW_MAJOR || to == Layout::COLUMN_MAJOR))
+        {
+            // transposing the n x n slot grid moves the d-th diagonal by d*(n-1) slots
+            std::vector<std::pair<long, std::vector<size_t>>> groups;
+            for (long d = -static_cast<long>(n - 1); d < static_cast<long>(n); ++d)
+            {
+                std::vector<size_t> group;
+                for (size_t r = 0; r < n; ++r)
+                {
+                    long c = static_cast<long>(r) + d;
+                    if (c >= 0 && c < static_cast<long>(n))
+                        group.push_back(r * n + c);
+                }
+                groups.push_back({ -d * static_cast<long>(n - 1), group });
+            }
+            return permute(source, groups);
+        }
+
+        throw runtime_error(
+            "Cannot convert " + array.identifier + " from " + enumToString(from) + " to " + enumToString(to) +
+            " layout.");
+    }
+};
+
+LayoutCost LayoutCost::infeasible()
+{
+    return { std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max() };
+}
+
+bool LayoutCost::isInfeasible() const
+{
+    return rotations == std::numeric_limits<size_t>::max();
+}
+
+size_t LayoutCost::total() const
+{
+    return isInfeasible() ? std::numeric_limits<size_t>::max() : rotations + multiplications;
+}
+
+double LayoutCost::weighted(double rotationLatency, double multiplicationLatency) const
+{
+    if (isInfeasible())
+        return std::numeric_limits<double>::infinity();
+    return static_cast<double>(rotations) * rotationLatency +
+           static_cast<double>(multiplications) * multiplicationLatency;
+}
+
+LayoutCost LayoutCost::operator+(const LayoutCost &other) const
+{
+    if (isInfeasible() || other.isInfeasible())
+        return infeasible();
+    return { rotations + other.rotations, multiplications + other.multiplications };
+}
+
+std::vector<Layout> ArrayInfo::candidates() const
+{
+    // arrays computed in the circuit come out of the kernels in row-major layout
+    if (!isInput)
+        return { Layout::ROW_MAJOR };
+    if (dimensions == 1)
+        return { Layout::ROW_MAJOR, Layout::COLUMN_MAJOR, Layout::REPLICATED };
+    return { Layout::ROW_MAJOR, Layout::COLUMN_MAJOR, Layout::DIAGONAL };
+}
+
+SpecialLayoutPlanningVisitor::SpecialLayoutPlanningVisitor(
+    std::unordered_set<std::string> secretNodes, size_t slots, size_t defaultExtent)
+    : secretNodes(std::move(secretNodes)), slots(slots), defaultExtent(defaultExtent)
+{}
+
+size_t SpecialLayoutPlanningVisitor::extentOf(const std::string &loopVariable)
+{
+    for (auto it = loops.rbegin(); it != loops.rend(); ++it)
+    {
+        if (it->variable == loopVariable)
+            return it->extent;
+    }
+    return defaultExtent;
+}
+
+ArrayInfo &SpecialLayoutPlanningVisitor::registerArray(
+    const std::string &identifier, size_t dimensions, size_t rows, size_t columns)
+{
+    auto &array = arrays[identifier];
+    array.identifier = identifier;
+    array.dimensions = std::max(array.dimensions, dimensions);
+    array.rows = std::max(array.rows, rows);
+    array.columns = std::max(array.columns, columns);
+    array.isInput = parameters.count(identifier) > 0;
+    auto type = declaredTypes.find(identifier);
+    if (type != declaredTypes.end())
+        array.datatype = Datatype(type->second.getType(), true);
+    return array;
+}
+
+void SpecialLayoutPlanningVisitor::addSite(LayoutSite site, const std::vector<std::string> &loopVariables)
+{
+    site.block = currentBlock;
+    site.statement = currentStatement;
+    for (auto &loop : loops)
+    {
+        if (std::find(loopVariables.begin(), loopVariables.end(), loop.variable) != loopVariables.end())
+        {
+            site.block = loop.block;
+            site.statement = loop.statement;
+            break;
+        }
+    }
+    sites.push_back(site);
+}
+
+bool SpecialLayoutPlanningVisitor::isCheaper(const LayoutCost &a, const LayoutCost &b) const
+{
+    return a.weighted(rotationLatency, multiplicationLatency) < b.weighted(rotationLatency, multiplicationLatency);
+}
+
+void SpecialLayoutPlanningVisitor::useCostTable(const CostTable &costs)
+{
+    // the kernels and conversions multiply by plaintext diagonals and masks
+    auto degree = costs.getPolyModulusDegree();
+    auto primes = costs.getCoeffModulusCount();
+    rotationLatency = costs.latency("rotate", degree, primes);
+    multiplicationLatency = costs.latency("multiply_plain", degree, primes);
+}
+
+LayoutCost SpecialLayoutPlanningVisitor::siteCost(
+    const LayoutSite &site, const std::map<std::string, Layout> &layouts, std::vector<Layout> *operandLayouts)
+{
+    LayoutCost best = LayoutCost::infeasible();
+    auto consider = [&](const std::vector<Layout> &targets, LayoutCost kernel) {
+        auto cost = kernel;
+        for (size_t i = 0; i < site.operands.size(); ++i)
+        {
+            auto &array = arrays.at(site.operands[i]);
+            cost = cost + conversionCost(layouts.at(site.operands[i]), targets[i], array);
+        }
+        if (isCheaper(cost, best))
+        {
+            best = cost;
+            if (operandLayouts)
+                *operandLayouts = targets;
+        }
+    };
+
+    if (site.kind == LayoutSite::MATRIX_VECTOR)
+    {
+        auto &vector = arrays.at(site.operands[1]);
+        for (auto matrixLayout : { Layout::ROW_MAJOR, Layout::COLUMN_MAJOR, Layout::DIAGONAL })
+        {
+            // the row-major layout of M is the column-major layout of M^T, the diagonals of M are of no use for M^T
+            auto effectiveLayout = matrixLayout;
+            if (site.transposed && matrixLayout == Layout::ROW_MAJOR)
+                effectiveLayout = Layout::COLUMN_MAJOR;
+            else if (site.transposed && matrixLayout == Layout::COLUMN_MAJOR)
+                effectiveLayout = Layout::ROW_MAJOR;
+            else if (site.transposed)
+                continue;
+
+            for (auto vectorLayout : { Layout::ROW_MAJOR, Layout::COLUMN_MAJOR, Layout::REPLICATED })
+            {
+                auto kernel = matrixVectorCost(effectiveLayout, vectorLayout, vector.rows, vector.columns);
+                if (!kernel.isInfeasible())
+                    consider({ matrixLayout, vectorLayout }, kernel);
+            }
+        }
+    }
+    else
+    {
+        for (auto layout : { Layout::ROW_MAJOR, Layout::COLUMN_MAJOR, Layout::REPLICATED })
+        {
+            consider({ layout, layout }, { 0, site.multiplication ? size_t(1) : size_t(0) });
+        }
+    }
+    return best;
+}
+
+void SpecialLayoutPlanningVisitor::planSite(BinaryExpression &elem)
+{
+    if (!elem.hasLeft() || !elem.hasRight())
+        return;
+
+    auto &op = elem.getOperator();
+    bool multiplication = (op == Operator(MULTIPLICATION) || op == Operator(FHE_MULTIPLICATION));
+    bool arithmetic = multiplication || op == Operator(ADDITION) || op == Operator(FHE_ADDITION) ||
+                      op == Operator(SUBTRACTION) || op == Operator(FHE_SUBTRACTION);
+    if (!arithmetic)
+        return;
+
+    std::string left, right;
+    std::vector<std::string> leftIndices, rightIndices;
+    if (!decomposeAccess(elem.getLeft(), left, leftIndices) || !arrays.count(left) ||
+        !decomposeAccess(elem.getRight(), right, rightIndices) || !arrays.count(right) || left == right)
+        return;
+
+    LayoutSite site;
+    site.expression = &elem;
+    site.multiplication = multiplication;
+    if (multiplication && leftIndices.size() + rightIndices.size() == 3)
+    {
+        // M[p][q] * v[r] (in either order)
+        auto &matrix = (leftIndices.size() == 2) ? left : right;
+        auto &vector = (leftIndices.size() == 2) ? right : left;
+        auto &matrixIndices = (leftIndices.size() == 2) ? leftIndices : rightIndices;
+        auto &vectorIndex = (leftIndices.size() == 2) ? rightIndices[0] : leftIndices[0];
+        if (matrixIndices[0] == matrixIndices[1] ||
+            (vectorIndex != matrixIndices[0] && vectorIndex != matrixIndices[1]))
+            return;
+
+        site.kind = LayoutSite::MATRIX_VECTOR;
+        site.operands = { matrix, vector };
+        site.transposed = (vectorIndex == matrixIndices[0]);
+        auto &outputIndex = site.transposed ? matrixIndices[1] : matrixIndices[0];
+
+        // the vector is replicated (or expanded) once per output element
+        auto &vectorInfo = registerArray(vector, 1, extentOf(outputIndex), extentOf(vectorIndex));
+        if (site.transposed)
+            registerArray(matrix, 2, vectorInfo.columns, vectorInfo.rows);
+        else
+            registerArray(matrix, 2, vectorInfo.rows, vectorInfo.columns);
+        addSite(site, matrixIndices);
+    }
+    else if (leftIndices.size() == 1 && rightIndices.size() == 1 && leftIndices[0] == rightIndices[0])
+    {
+        // x[i] op y[i]
+        site.kind = LayoutSite::ELEMENTWISE;
+        site.operands = { left, right };
+        addSite(site, leftIndices);
+    }
+}
+
+void SpecialLayoutPlanningVisitor::visit(AbstractExpression &elem)
+{
+    // the operands of a BinaryExpression come first, such that the arrays they access are registered
+    walk(
+        elem, overloaded{ [this](IndexAccess &indexAccess) { registerAccess(indexAccess); }, [](AbstractNode &) {} },
+        overloaded{
+            [this](BinaryExpression &binaryExpression) { planSite(binaryExpression); }, [](AbstractNode &) {} });
+}
+
+void SpecialLayoutPlanningVisitor::visit(Block &elem)
+{
+    auto enclosingBlock = currentBlock;
+    auto enclosingStatement = currentStatement;
+    currentBlock = &elem;
+    for (auto &statement : elem.getStatementPointers())
+    {
+        if (!statement)
+            continue;
+        currentStatement = statement.get();
+        statement->accept(*this);
+    }
+    currentBlock = enclosingBlock;
+    currentStatement = enclosingStatement;
+}
+
+void SpecialLayoutPlanningVisitor::visit(For &elem)
+{
+    // recognize for (int i = start; i < end; ...) and for (int i = start; i <= end; ...) with literal bounds
+    LoopFrame frame = { "", defaultExtent, currentBlock, currentStatement };
+    int start = 0;
+    if (elem.hasInitializer() && elem.getInitializer().getStatementPointers().size() == 1)
+    {
+        auto &initializer = elem.getInitializer().getStatementPointers()[0];
+        if (auto declaration = dynamic_cast<VariableDeclaration *>(initializer.get()))
+        {
+            if (declaration->hasTarget())
+                frame.variable = declaration->getTarget().getIdentifier();
+            if (declaration->hasValue())
+            {
+                if (auto literal = dynamic_cast<LiteralInt *>(&declaration->getValue()))
+                    start = literal->getValue();
+            }
+        }
+    }
+    if (elem.hasCondition())
+    {
+        auto condition = dynamic_cast<BinaryExpression *>(&elem.getCondition());
+        if (condition && condition->hasLeft() && condition->hasRight())
+        {
+            auto variable = dynamic_cast<Variable *>(&condition->getLeft());
+            auto bound = dynamic_cast<LiteralInt *>(&condition->getRight());
+            auto &op = condition->getOperator();
+            if (variable && bound && variable->getIdentifier() == frame.variable &&
+                (op == Operator(LESS) || op == Operator(LESS_EQUAL)))
+            {
+                int end = bound->getValue() + ((op == Operator(LESS_EQUAL)) ? 1 : 0);
+                frame.extent = static_cast<size_t>(std::max(end - start, 1));
+            }
+        }
+    }
+
+    loops.push_back(frame);
+    visitChildren(elem);
+    loops.pop_back();
+}
+
+void SpecialLayoutPlanningVisitor::visit(FunctionParameter &elem)
+{
+    parameters.insert(elem.getIdentifier());
+    declaredTypes.insert_or_assign(elem.getIdentifier(), elem.getParameterType());
+}
+
+void SpecialLayoutPlanningVisitor::registerAccess(IndexAccess &elem)
+{
+    // the target chain of x[i][j] is handled with the outermost IndexAccess
+    auto parent = dynamic_cast<IndexAccess *>(elem.getParentPtr());
+    if (parent && parent->hasTarget() && &parent->getTarget() == &elem)
+        return;
+
+    std::vector<AbstractExpression *> indices;
+    AbstractExpression *target = &elem;
+    while (auto indexAccess = dynamic_cast<IndexAccess *>(target))
+    {
+        indices.insert(indices.begin(), &indexAccess->getIndex());
+        target = &indexAccess->getTarget();
+    }
+
+    auto variable = dynamic_cast<Variable *>(target);
+    if (variable && indices.size() <= 2)
+    {
+        auto type = declaredTypes.find(variable->getIdentifier());
+        bool secret = secretNodes.count(variable->getUniqueNodeId()) || secretNodes.count(elem.getUniqueNodeId()) ||
+                      (type != declaredTypes.end() && type->second.getSecretFlag());
+        if (secret)
+        {
+            std::vector<size_t> extents;
+            for (auto index : indices)
+            {
+                if (auto indexVariable = dynamic_cast<Variable *>(index))
+                    extents.push_back(extentOf(indexVariable->getIdentifier()));
+                else if (auto literal = dynamic_cast<LiteralInt *>(index))
+                    extents.push_back(static_cast<size_t>(std::max(literal->getValue() + 1, 1)));
+                else
+                    extents.push_back(defaultExtent);
+            }
+            if (extents.size() == 1)
+                registerArray(variable->getIdentifier(), 1, 1, extents[0]);
+            else
+                registerArray(variable->getIdentifier(), 2, extents[0], extents[1]);
+        }
+    }
+}
+
+void SpecialLayoutPlanningVisitor::visit(VariableDeclaration &elem)
+{
+    visitChildren(elem);
+    if (!elem.hasTarget())
+        return;
+
+    auto identifier = elem.getTarget().getIdentifier();
+    declaredTypes.insert_or_assign(identifier, elem.getDatatype());
+
+    // the size of arrays initialized with a (nested) ExpressionList is known
+    auto list = elem.hasValue() ? dynamic_cast<ExpressionList *>(&elem.getValue()) : nullptr;
+    if (list && elem.getDatatype().getSecretFlag())
+    {
+        auto &elements = list->getExpressionPtrs();
+        auto firstRow = elements.empty() ? nullptr : dynamic_cast<ExpressionList *>(elements[0].get());
+        if (firstRow)
+            registerArray(identifier, 2, elements.size(), firstRow->getExpressionPtrs().size());
+        else
+            registerArray(identifier, 1, 1, elements.size());
+    }
+}
+
+size_t SpecialLayoutPlanningVisitor::babyStepCount(size_t m)
+{
+    size_t babySteps = 1;
+    while (babySteps * babySteps < m)
+        ++babySteps;
+    return babySteps;
+}
+
+LayoutCost SpecialLayoutPlanningVisitor::matrixVectorCost(Layout matrix, Layout vector, size_t n, size_t m)
+{
+    if (matrix == Layout::DIAGONAL && vector == Layout::REPLICATED)
+    {
+        // Halevi-Shoup with baby-step giant-step: y = sum_g rot(sum_b diag[g*b1 + b] * rot(v, b), g*b1)
+        size_t babySteps = babyStepCount(m);
+        size_t giantSteps = (m + babySteps - 1) / babySteps;
+        return { (babySteps - 1) + (giantSteps - 1), m };
+    }
+    else if (matrix == Layout::ROW_MAJOR && vector == Layout::REPLICATED)
+    {
+        // one product, rotate-and-sum within each row, then mask and gather the n row sums into slots 0 ... n-1
+        return { ceilLog2(m) + (n - 1), 1 + n };
+    }
+    else if (matrix == Layout::COLUMN_MAJOR && vector == Layout::COLUMN_MAJOR)
+    {
+        // one product, then rotate-and-sum the m columns, y[i] ends up in slot i
+        return { ceilLog2(m), 1 };
+    }
+    return LayoutCost::infeasible();
+}
+
+LayoutCost SpecialLayoutPlanningVisitor::conversionCost(Layout from, Layout to, const ArrayInfo &array)
+{
+    if (from == to)
+        return { 0, 0 };
+
+    size_t n = array.rows;
+    size_t m = array.columns;
+    if (array.dimensions == 1)
+    {
+        if (from == Layout::DIAGONAL || to == Layout::DIAGONAL)
+            return LayoutCost::infeasible();
+        if (from == Layout::ROW_MAJOR && to == Layout::REPLICATED)
+            return { replicationRotations(n), 0 };
+        if (from == Layout::REPLICATED && to == Layout::ROW_MAJOR)
+            return { 0, 1 };
+        if (from == Layout::ROW_MAJOR && to == Layout::COLUMN_MAJOR)
+            return { (m - 1) + replicationRotations(n), m };
+        if (from == Layout::COLUMN_MAJOR && to == Layout::ROW_MAJOR)
+            return { m - 1, m };
+        return conversionCost(from, Layout::ROW_MAJOR, array) + conversionCost(Layout::ROW_MAJOR, to, array);
+    }
+
+    // the diagonal layout is only produced by the client, transposing in-circuit is only done for square matrices
+    if (from == Layout::DIAGONAL || to == Layout::DIAGONAL || from == Layout::REPLICATED || to == Layout::REPLICATED ||
+        n != m)
+        return LayoutCost::infeasible();
+    return { 2 * n - 2, 2 * n - 1 };
+}
+
+const std::map<std::string, ArrayInfo> &SpecialLayoutPlanningVisitor::getArrays() const
+{
+    return arrays;
+}
+
+const std::vector<LayoutSite> &SpecialLayoutPlanningVisitor::getSites() const
+{
+    return sites;
+}
+
+const LayoutPlan &SpecialLayoutPlanningVisitor::plan()
+{
+    std::vector<std::string> identifiers;
+    std::vector<std::vector<Layout>> candidates;
+    for (auto &[identifier, array] : arrays)
+    {
+        size_t size = (array.dimensions == 2) ? array.rows * array.columns : array.columns;
+        if (size > slots)
+        {
+            throw runtime_error(
+                "Secret array " + identifier + " with " + std::to_string(size) + " elements does not fit into " +
+                std::to_string(slots) + " slots.");
+        }
+        // replicated and column-major vectors need one copy per output element
+        auto arrayCandidates = array.candidates();
+        if (array.rows * array.columns > slots)
+            arrayCandidates = { Layout::ROW_MAJOR };
+        identifiers.push_back(identifier);
+        candidates.push_back(arrayCandidates);
+    }
+
+    auto totalCost = [&](const std::map<std::string, Layout> &layouts) {
+        LayoutCost cost;
+        for (auto &site : sites)
+            cost = cost + siteCost(site, layouts);
+        return cost;
+    };
+
+    std::map<std::string, Layout> best;
+    for (size_t i = 0; i < identifiers.size(); ++i)
+        best[identifiers[i]] = candidates[i][0];
+    LayoutCost bestCost = totalCost(best);
+
+    if (identifiers.size() <= 8)
+    {
+        // exhaustive search, counting through all combinations of candidates
+        std::vector<size_t> choice(identifiers.size(), 0);
+        while (true)
+        {
+            size_t i = 0;
+            while (i < choice.size() && ++choice[i] == candidates[i].size())
+                choice[i++] = 0;
+            if (i == choice.size())
+                break;
+
+            std::map<std::string, Layout> layouts;
+            for (size_t j = 0; j < identifiers.size(); ++j)
+                layouts[identifiers[j]] = candidates[j][choice[j]];
+            auto cost = totalCost(layouts);
+            if (isCheaper(cost, bestCost))
+            {
+                best = layouts;
+                bestCost = cost;
+            }
+        }
+    }
+    else
+    {
+        // coordinate descent: change the layout of one array at a time, as long as this improves the total cost
+        bool improved = true;
+        while (improved)
+        {
+            improved = false;
+            for (size_t i = 0; i < identifiers.size(); ++i)
+            {
+                for (auto layout : candidates[i])
+                {
+                    auto layouts = best;
+                    layouts[identifiers[i]] = layout;
+                    auto cost = totalCost(layouts);
+                    if (isCheaper(cost, bestCost))
+                    {
+                        best = layouts;
+                        bestCost = cost;
+                        improved = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (bestCost.isInfeasible())
+        throw runtime_error("No feasible packing of the secret arrays exists.");
+
+    plan_ = std::make_unique<LayoutPlan>();
+    plan_->layouts = best;
+    plan_->cost = bestCost;
+    for (size_t s = 0; s < sites.size(); ++s)
+    {
+        std::vector<Layout> operandLayouts;
+        siteCost(sites[s], best, &operandLayouts);
+        for (size_t i = 0; i < sites[s].operands.size(); ++i)
+        {
+            auto &identifier = sites[s].operands[i];
+            if (best[identifier] != operandLayouts[i])
+            {
+                plan_->conversions.push_back(
+                    { identifier, best[identifier], operandLayouts[i], s,
+                      conversionCost(best[identifier], operandLayouts[i], arrays.at(identifier)) });
+            }
+        }
+        plan_->siteLayouts.push_back(operandLayouts);
+    }
+    return *plan_;
+}
+
+void SpecialLayoutPlanningVisitor::insertConversions()
+{
+    if (!plan_)
+        plan();
+
+    // sites in the same loop nest share the converted copies
+    std::map<std::tuple<AbstractStatement *, std::string, Layout>, std::string> converted;
+    for (size_t c = 0; c < plan_->conversions.size(); ++c)
+    {
+        auto &conversion = plan_->conversions[c];
+        auto &site = sites[conversion.site];
+        if (!site.block || !site.statement)
+            throw runtime_error("Cannot insert a layout conversion for " + conversion.identifier + " outside a block.");
+        if (writesArray(*site.statement, conversion.identifier))
+        {
+            throw runtime_error(
+                "Cannot convert the layout of " + conversion.identifier +
+                " since it is written in the same loop nest.");
+        }
+
+        auto key = std::make_tuple(site.statement, conversion.identifier, conversion.to);
+        auto it = converted.find(key);
+        if (it == converted.end())
+        {
+            auto layoutName = enumToString(conversion.to);
+            std::replace(layoutName.begin(), layoutName.end(), '-', '_');
+            auto prefix = conversion.identifier + "__" + layoutName + "_" + std::to_string(c);
+
+            std::vector<std::unique_ptr<AbstractStatement>> statements;
+            ConversionEmitter emitter(statements, arrays.at(conversion.identifier), prefix);
+            auto identifier = emitter.convert(conversion.identifier, conversion.from, conversion.to);
+
+            auto &blockStatements = site.block->getStatementPointers();
+            auto position = std::find_if(blockStatements.begin(), blockStatements.end(), [&](auto &statement) {
+                return statement.get() == site.statement;
+            });
+            if (position == blockStatements.end())
+                throw runtime_error("Statement of a layout site is no longer part of its block.");
+            auto index = std::distance(blockStatements.begin(), position);
+            blockStatements.insert(
+                position, std::make_move_iterator(statements.begin()), std::make_move_iterator(statements.end()));
+            for (size_t j = index; j < index + statements.size(); ++j)
+            {
+                blockStatements[j]->setParent(*site.block);
+            }
+            it = converted.emplace(key, identifier).first;
+        }
+
+        if (site.expression)
+            renameArray(*site.expression, conversion.identifier, it->second);
+    }
+}
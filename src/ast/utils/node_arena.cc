@@ -0,0 +1,101 @@
+#include "transpiration/ast/utils/node_arena.h"
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+/// Alignment of the nodes within a chunk
+constexpr size_t NODE_ALIGNMENT = alignof(std::max_align_t);
+
+/// The arena of every chunk of every arena, by the address of the chunk. Constructed on first use and never destroyed,
+/// since nodes might still be deleted by destructors of static objects.
+std::unordered_map<std::uintptr_t, NodeArena *> &chunkArenas()
+{
+    static auto *arenas = new std::unordered_map<std::uintptr_t, NodeArena *>();
+    return *arenas;
+}
+
+/// Chunks of destroyed arenas, which the next arenas reuse, since mapping and touching new memory for every arena
+/// costs more than allocating its nodes on the heap, whose freed memory is reused as well
+std::vector<void *> &freeChunks()
+{
+    static auto *chunks = new std::vector<void *>();
+    return *chunks;
+}
+
+/// Free chunks beyond this are returned to the heap
+constexpr size_t MAX_FREE_CHUNKS = 1024;
+} // namespace
+
+NodeArena::~NodeArena()
+{
+    for (auto chunk : chunks)
+    {
+        chunkArenas().erase(reinterpret_cast<std::uintptr_t>(chunk));
+        if (freeChunks().size() < MAX_FREE_CHUNKS)
+            freeChunks().push_back(chunk);
+        else
+            ::operator delete(chunk, std::align_val_t(CHUNK_SIZE));
+    }
+}
+
+void *NodeArena::allocate(size_t size)
+{
+    if (size > CHUNK_SIZE)
+        throw std::invalid_argument("Cannot allocate a node of " + std::to_string(size) + " bytes in a NodeArena.");
+
+    size = (size + NODE_ALIGNMENT - 1) / NODE_ALIGNMENT * NODE_ALIGNMENT;
+    if (static_cast<size_t>(end - next) < size)
+    {
+        void *chunk;
+        if (freeChunks().empty())
+        {
+            chunk = ::operator new(CHUNK_SIZE, std::align_val_t(CHUNK_SIZE));
+        }
+        else
+        {
+            chunk = freeChunks().back();
+            freeChunks().pop_back();
+        }
+        chunks.push_back(chunk);
+        chunkArenas().emplace(reinterpret_cast<std::uintptr_t>(chunk), this);
+        next = static_cast<char *>(chunk);
+        end = next + CHUNK_SIZE;
+    }
+
+    auto pointer = next;
+    next += size;
+    liveBytes += size;
+    return pointer;
+}
+
+void NodeArena::deallocate(size_t size)
+{
+    liveBytes -= (size + NODE_ALIGNMENT - 1) / NODE_ALIGNMENT * NODE_ALIGNMENT;
+}
+
+NodeArena *NodeArena::find(const void *pointer)
+{
+    auto &arenas = chunkArenas();
+    // the common case, i.e., deleting nodes while there is no arena, does not need to look anything up
+    if (arenas.empty())
+        return nullptr;
+
+    auto chunk = reinterpret_cast<std::uintptr_t>(pointer) & ~static_cast<std::uintptr_t>(CHUNK_SIZE - 1);
+    auto it = arenas.find(chunk);
+    return it == arenas.end() ? nullptr : it->second;
+}
+
+size_t NodeArena::getLiveBytes() const
+{
+    return liveBytes;
+}
+
+size_t NodeArena::getReservedBytes() const
+{
+    return chunks.size() * CHUNK_SIZE;
+}
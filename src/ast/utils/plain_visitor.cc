@@ -24,118 +24,115 @@
 
 void PlainVisitor::visit(BinaryExpression &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(Block &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(Call &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(ExpressionList &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(For &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(Function &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(FunctionParameter &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(If &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(IndexAccess &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(LiteralBool &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(LiteralChar &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(LiteralInt &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(LiteralFloat &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(LiteralDouble &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(LiteralString &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(OperatorExpression &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(Return &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(TernaryOperator &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(UnaryExpression &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(Assignment &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(VariableDeclaration &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visit(Variable &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void PlainVisitor::visitChildren(AbstractNode &elem)
 {
-    for (auto &c : elem)
-    {
-        c.accept(*this);
-    }
+    traversal.visitChildren(elem, *this);
 }
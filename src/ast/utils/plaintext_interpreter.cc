@@ -0,0 +1,828 @@
+#include "transpiration/ast/utils/plaintext_interpreter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "transpiration/ast/assignment.h"
+#include "transpiration/ast/binary_expression.h"
+#include "transpiration/ast/block.h"
+#include "transpiration/ast/call.h"
+#include "transpiration/ast/expression_list.h"
+#include "transpiration/ast/for.h"
+#include "transpiration/ast/function.h"
+#include "transpiration/ast/function_parameter.h"
+#include "transpiration/ast/if.h"
+#include "transpiration/ast/index_access.h"
+#include "transpiration/ast/literal.h"
+#include "transpiration/ast/operator_expression.h"
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/return.h"
+#include "transpiration/ast/ternary_operator.h"
+#include "transpiration/ast/unary_expression.h"
+#include "transpiration/ast/variable.h"
+#include "transpiration/ast/variable_declaration.h"
+
+namespace
+{
+typedef SpecialPlaintextInterpreter::Opcode Opcode;
+
+bool isIntegerType(const Datatype &datatype)
+{
+    auto type = datatype.getType();
+    return type == Type::BOOL || type == Type::CHAR || type == Type::INT;
+}
+
+/// Operator of the profile entries of an instruction, or an empty string for instructions that are not operations
+std::string operationName(Opcode opcode)
+{
+    switch (opcode)
+    {
+    case Opcode::ROTATE:
+        return "rotate";
+    case Opcode::ADD:
+        return "+";
+    case Opcode::SUBTRACT:
+        return "-";
+    case Opcode::MULTIPLY:
+        return "*";
+    case Opcode::DIVIDE:
+    case Opcode::DIVIDE_INTEGER:
+        return "/";
+    case Opcode::MODULO:
+        return "%";
+    case Opcode::LOGICAL_AND:
+        return "&&";
+    case Opcode::LOGICAL_OR:
+        return "||";
+    case Opcode::LESS:
+        return "<";
+    case Opcode::LESS_EQUAL:
+        return "<=";
+    case Opcode::GREATER:
+        return ">";
+    case Opcode::GREATER_EQUAL:
+        return ">=";
+    case Opcode::EQUAL:
+        return "==";
+    case Opcode::NOT_EQUAL:
+        return "!=";
+    case Opcode::BITWISE_AND:
+        return "&";
+    case Opcode::BITWISE_XOR:
+        return "^";
+    case Opcode::BITWISE_OR:
+        return "|";
+    case Opcode::LOGICAL_NOT:
+        return "!";
+    case Opcode::BITWISE_NOT:
+        return "~";
+    default:
+        return "";
+    }
+}
+
+/// Replaces left by `left f right`, element-wise for arrays
+template <typename F>
+void apply(PlainValue &left, const PlainValue &right, F f)
+{
+    if (!left.isArray && !right.isArray)
+    {
+        left.scalar = f(left.scalar, right.scalar);
+        return;
+    }
+
+    auto size = std::max(left.isArray ? left.elements.size() : 0, right.isArray ? right.elements.size() : 0);
+    if (!left.isArray)
+    {
+        left.elements.assign(size, left.scalar);
+        left.isArray = true;
+    }
+    left.elements.resize(size, 0);
+    for (size_t i = 0; i < size; ++i)
+        left.elements[i] = f(left.elements[i], right.at(i));
+}
+
+/// Replaces value by `f value`, element-wise for arrays
+template <typename F>
+void apply(PlainValue &value, F f)
+{
+    if (!value.isArray)
+        value.scalar = f(value.scalar);
+    else
+        for (auto &element : value.elements)
+            element = f(element);
+}
+
+int64_t integer(double value)
+{
+    return static_cast<int64_t>(value);
+}
+
+/// 2^53, beyond which a double does not represent every integer, i.e., integer arithmetic on doubles is not exact
+const double maxExactInteger = 9007199254740992.0;
+
+/// Throws if an integer value is too large to be exact, e.g. the result of an integer addition that overflowed 2^53
+void checkExact(const PlainValue &value)
+{
+    auto check = [](double x) {
+        if (std::abs(x) >= maxExactInteger)
+            throw runtime_error(
+                "Integer " + std::to_string(x) + " is out of the range that can be interpreted exactly (|x| < 2^53).");
+    };
+    if (!value.isArray)
+        check(value.scalar);
+    else
+        std::for_each(value.elements.begin(), value.elements.end(), check);
+}
+
+/// The value as an index into an array
+size_t index(const PlainValue &value)
+{
+    auto i = value.isArray ? value.at(0) : value.scalar;
+    if (i < 0)
+        throw runtime_error("Index " + std::to_string(integer(i)) + " is out of range.");
+    return static_cast<size_t>(i);
+}
+} // namespace
+
+SpecialPlaintextInterpreter::SpecialPlaintextInterpreter(size_t slotCount) : slotCount(slotCount)
+{}
+
+size_t SpecialPlaintextInterpreter::emit(Opcode opcode, int operand, OpSpecialization specialization)
+{
+    program->code.push_back({ opcode, operand, specialization });
+    return program->code.size() - 1;
+}
+
+void SpecialPlaintextInterpreter::emitConstant(PlainValue value, bool integer)
+{
+    program->constants.push_back(std::move(value));
+    emit(Opcode::CONSTANT, static_cast<int>(program->constants.size() - 1));
+    integerResult = integer;
+    secretResult = false;
+}
+
+size_t SpecialPlaintextInterpreter::declare(const std::string &identifier, const Datatype &datatype)
+{
+    getCurrentScope().addIdentifier(identifier);
+    auto slot = program->variableCount++;
+    slots.insert_or_assign(getCurrentScope().resolveIdentifier(identifier), std::move(slot));
+    program->integerVariables.push_back(isIntegerType(datatype));
+    program->secretVariables.push_back(datatype.getSecretFlag());
+    return slot;
+}
+
+size_t SpecialPlaintextInterpreter::resolve(const std::string &identifier)
+{
+    if (!getCurrentScope().identifierExists(identifier))
+        throw runtime_error("Variable " + identifier + " is used before it is declared.");
+    return slots.get(getCurrentScope().resolveIdentifier(identifier));
+}
+
+void SpecialPlaintextInterpreter::emitOperator(const Operator &op, bool integer, OpSpecialization specialization)
+{
+    // the FHE operators (+++, ---, ***) compute the same values as their plain counterparts
+    auto name = op.toString();
+    if (name.size() == 3 && name[0] == name[1] && name[1] == name[2])
+        name = name.substr(0, 1);
+
+    static const std::unordered_map<std::string, Opcode> opcodes = {
+        { "+", Opcode::ADD },           { "-", Opcode::SUBTRACT },       { "*", Opcode::MULTIPLY },
+        { "/", Opcode::DIVIDE },        { "%", Opcode::MODULO },         { "&&", Opcode::LOGICAL_AND },
+        { "||", Opcode::LOGICAL_OR },   { "<", Opcode::LESS },           { "<=", Opcode::LESS_EQUAL },
+        { ">", Opcode::GREATER },       { ">=", Opcode::GREATER_EQUAL }, { "==", Opcode::EQUAL },
+        { "!=", Opcode::NOT_EQUAL },    { "&", Opcode::BITWISE_AND },    { "^", Opcode::BITWISE_XOR },
+        { "|", Opcode::BITWISE_OR },    { "!", Opcode::LOGICAL_NOT },    { "~", Opcode::BITWISE_NOT }
+    };
+    auto it = opcodes.find(name);
+    if (it == opcodes.end())
+        throw runtime_error("Operator " + op.toString() + " cannot be interpreted.");
+
+    auto opcode = it->second;
+    if (opcode == Opcode::DIVIDE && integer)
+        opcode = Opcode::DIVIDE_INTEGER;
+    bool exact = integer && (opcode == Opcode::ADD || opcode == Opcode::SUBTRACT || opcode == Opcode::MULTIPLY);
+    emit(opcode, exact ? 1 : 0, specialization);
+
+    // comparisons and logical operators evaluate to bool
+    integerResult = integer || !(opcode == Opcode::ADD || opcode == Opcode::SUBTRACT ||
+                                 opcode == Opcode::MULTIPLY || opcode == Opcode::DIVIDE);
+}
+
+void SpecialPlaintextInterpreter::emitStore(size_t slot)
+{
+    if (program->integerVariables[slot] && !integerResult)
+        emit(Opcode::TRUNCATE);
+    emit(Opcode::STORE, static_cast<int>(slot));
+    if (secretResult)
+        program->secretVariables[slot] = true;
+}
+
+void SpecialPlaintextInterpreter::compile(AbstractExpression &expression)
+{
+    auto base = steps.size();
+    steps.push_back({ &expression, nullptr });
+    while (steps.size() > base)
+    {
+        auto step = std::move(steps.back());
+        steps.pop_back();
+        if (step.expression)
+            step.expression->accept(*this);
+        else
+            step.continuation();
+    }
+}
+
+void SpecialPlaintextInterpreter::compileThen(AbstractExpression &expression, std::function<void()> continuation)
+{
+    steps.push_back({ nullptr, std::move(continuation) });
+    steps.push_back({ &expression, nullptr });
+}
+
+void SpecialPlaintextInterpreter::compileList(
+    std::vector<std::reference_wrapper<AbstractExpression>> expressions, size_t next, bool integer, bool secret)
+{
+    if (next == expressions.size())
+    {
+        emit(Opcode::LIST, static_cast<int>(expressions.size()));
+        integerResult = integer;
+        secretResult = secret;
+        return;
+    }
+    auto &expression = expressions[next].get();
+    compileThen(expression, [this, expressions = std::move(expressions), next, integer, secret]() {
+        compileList(expressions, next + 1, integer && integerResult, secret || secretResult);
+    });
+}
+
+void SpecialPlaintextInterpreter::compileFold(
+    OperatorExpression &elem, std::vector<std::reference_wrapper<AbstractExpression>> operands, size_t next,
+    bool secret)
+{
+    if (next == operands.size())
+        return;
+
+    // fold the operands from the left, e.g. (a + b + c) becomes ((a + b) + c)
+    auto integer = integerResult;
+    auto secretLeft = secretResult;
+    auto &operand = operands[next].get();
+    compileThen(operand, [this, &elem, operands = std::move(operands), next, secret, integer, secretLeft]() {
+        auto specialization = (secretLeft && secretResult)   ? OpSpecialization::CIPHER_CIPHER
+                              : (secretLeft || secretResult) ? OpSpecialization::CIPHER_PLAIN
+                                                             : OpSpecialization::PLAIN_PLAIN;
+        auto secretFolded = secret || secretResult;
+        emitOperator(elem.getOperator(), integer && integerResult, specialization);
+        secretResult = secretFolded;
+        compileFold(elem, operands, next + 1, secretFolded);
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(Assignment &elem)
+{
+    if (auto variable = dynamic_cast<Variable *>(&elem.getTarget()))
+    {
+        auto slot = resolve(variable->getIdentifier());
+        compile(elem.getValue());
+        emitStore(slot);
+    }
+    else if (auto indexAccess = dynamic_cast<IndexAccess *>(&elem.getTarget()))
+    {
+        auto array = dynamic_cast<Variable *>(&indexAccess->getTarget());
+        if (!array)
+            throw runtime_error("Only elements of variables can be assigned to: " + elem.toString(false));
+        auto slot = resolve(array->getIdentifier());
+        compile(indexAccess->getIndex());
+        compile(elem.getValue());
+        if (program->integerVariables[slot] && !integerResult)
+            emit(Opcode::TRUNCATE);
+        emit(Opcode::STORE_INDEX, static_cast<int>(slot));
+        if (secretResult)
+            program->secretVariables[slot] = true;
+    }
+    else
+    {
+        throw runtime_error("Unsupported target of assignment: " + elem.toString(false));
+    }
+}
+
+void SpecialPlaintextInterpreter::visit(BinaryExpression &elem)
+{
+    static const OpSpecialization specializations[] = { OpSpecialization::PLAIN_PLAIN, OpSpecialization::CIPHER_PLAIN,
+                                                         OpSpecialization::CIPHER_CIPHER };
+
+    // like in C++, the right operand of && and || is only evaluated if the left one does not decide the result, i.e.,
+    // a && b is a ? (1 && b) : 0 and a || b is a ? 1 : (0 || b)
+    auto &op = elem.getOperator();
+    bool conjunction = (op == Operator(LOGICAL_AND));
+    if (conjunction || op == Operator(LOGICAL_OR))
+    {
+        compileThen(elem.getLeft(), [this, &elem, conjunction]() {
+            auto leftSecret = secretResult;
+            auto skipTrue = emit(Opcode::JUMP_IF_FALSE);
+            // the right operand follows the constant that decides the result where it is not needed
+            auto evaluateRight = [this, &elem, leftSecret](double left, std::function<void()> continuation) {
+                emitConstant(PlainValue(left), true);
+                compileThen(elem.getRight(), [this, &elem, leftSecret, continuation]() {
+                    emitOperator(
+                        elem.getOperator(), true, specializations[(leftSecret ? 1 : 0) + (secretResult ? 1 : 0)]);
+                    continuation();
+                });
+            };
+            auto evaluateFalse = [this, leftSecret, skipTrue, conjunction, evaluateRight](bool secret) {
+                auto skipFalse = emit(Opcode::JUMP);
+                program->code[skipTrue].operand = static_cast<int>(program->code.size());
+                auto finish = [this, leftSecret, secret, skipFalse]() {
+                    program->code[skipFalse].operand = static_cast<int>(program->code.size());
+                    integerResult = true;
+                    secretResult = leftSecret || secret || secretResult;
+                };
+                if (conjunction)
+                {
+                    emitConstant(PlainValue(0), true);
+                    finish();
+                }
+                else
+                {
+                    evaluateRight(0, finish);
+                }
+            };
+            if (conjunction)
+            {
+                evaluateRight(1, [this, evaluateFalse]() { evaluateFalse(secretResult); });
+            }
+            else
+            {
+                emitConstant(PlainValue(1), true);
+                evaluateFalse(secretResult);
+            }
+        });
+        return;
+    }
+
+    compileThen(elem.getLeft(), [this, &elem]() {
+        auto integer = integerResult;
+        auto secretOperands = secretResult ? 1 : 0;
+        compileThen(elem.getRight(), [this, &elem, integer, secretOperands]() {
+            auto secretCount = secretOperands + (secretResult ? 1 : 0);
+            emitOperator(elem.getOperator(), integer && integerResult, specializations[secretCount]);
+            secretResult = secretCount > 0;
+        });
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(Block &elem)
+{
+    enterScope(elem);
+    for (auto &statement : elem.getStatementPointers())
+    {
+        if (statement)
+            statement->accept(*this);
+    }
+    exitScope();
+}
+
+void SpecialPlaintextInterpreter::visit(Call &elem)
+{
+    auto arguments = elem.getArguments();
+    if (elem.getIdentifier() != "rotate" || arguments.size() != 2)
+        throw runtime_error("Only rotate(x, offset) can be called: " + elem.toString(false));
+
+    compileThen(arguments[0].get(), [this, &offset = arguments[1].get()]() {
+        auto integer = integerResult;
+        auto secret = secretResult;
+        compileThen(offset, [this, integer, secret]() {
+            emit(Opcode::ROTATE, static_cast<int>(slotCount),
+                 secret ? OpSpecialization::CIPHER_PLAIN : OpSpecialization::PLAIN_PLAIN);
+            integerResult = integer;
+            secretResult = secret;
+        });
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(ExpressionList &elem)
+{
+    compileList(elem.getExpressions(), 0, true, false);
+}
+
+void SpecialPlaintextInterpreter::visit(For &elem)
+{
+    enterScope(elem);
+
+    // the initializer and the update are in the scope of the loop, like in ScopedVisitor::visitChildren
+    if (elem.hasInitializer())
+        visitChildren(elem.getInitializer());
+
+    auto condition = program->code.size();
+    size_t exit = 0;
+    if (elem.hasCondition())
+    {
+        compile(elem.getCondition());
+        exit = emit(Opcode::JUMP_IF_FALSE);
+    }
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    if (elem.hasUpdate())
+        visitChildren(elem.getUpdate());
+    emit(Opcode::JUMP, static_cast<int>(condition));
+    if (elem.hasCondition())
+        program->code[exit].operand = static_cast<int>(program->code.size());
+
+    exitScope();
+}
+
+void SpecialPlaintextInterpreter::visit(Function &elem)
+{
+    program = &programs[elem.getIdentifier()];
+    *program = Program();
+
+    enterScope(elem);
+    for (auto &parameter : elem.getParameters())
+        parameter.get().accept(*this);
+    if (elem.hasBody())
+        elem.getBody().accept(*this);
+    emit(Opcode::RETURN, 0);
+    exitScope();
+
+    program = nullptr;
+}
+
+void SpecialPlaintextInterpreter::visit(FunctionParameter &elem)
+{
+    program->parameters.push_back(declare(elem.getIdentifier(), elem.getParameterType()));
+}
+
+void SpecialPlaintextInterpreter::visit(If &elem)
+{
+    enterScope(elem);
+
+    compile(elem.getCondition());
+    auto skipThen = emit(Opcode::JUMP_IF_FALSE);
+    if (elem.hasThenBranch())
+        elem.getThenBranch().accept(*this);
+    if (elem.hasElseBranch())
+    {
+        auto skipElse = emit(Opcode::JUMP);
+        program->code[skipThen].operand = static_cast<int>(program->code.size());
+        elem.getElseBranch().accept(*this);
+        program->code[skipElse].operand = static_cast<int>(program->code.size());
+    }
+    else
+    {
+        program->code[skipThen].operand = static_cast<int>(program->code.size());
+    }
+
+    exitScope();
+}
+
+void SpecialPlaintextInterpreter::visit(IndexAccess &elem)
+{
+    auto array = dynamic_cast<Variable *>(&elem.getTarget());
+    if (!array)
+        throw runtime_error("Only elements of variables can be accessed: " + elem.toString(false));
+    auto slot = resolve(array->getIdentifier());
+    compileThen(elem.getIndex(), [this, slot]() {
+        emit(Opcode::LOAD_INDEX, static_cast<int>(slot));
+        integerResult = program->integerVariables[slot];
+        secretResult = program->secretVariables[slot];
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(LiteralBool &elem)
+{
+    emitConstant(PlainValue(elem.getValue() ? 1 : 0), true);
+}
+
+void SpecialPlaintextInterpreter::visit(LiteralChar &elem)
+{
+    emitConstant(PlainValue(static_cast<double>(elem.getValue())), true);
+}
+
+void SpecialPlaintextInterpreter::visit(LiteralInt &elem)
+{
+    emitConstant(PlainValue(static_cast<double>(elem.getValue())), true);
+}
+
+void SpecialPlaintextInterpreter::visit(LiteralFloat &elem)
+{
+    emitConstant(PlainValue(static_cast<double>(elem.getValue())), false);
+}
+
+void SpecialPlaintextInterpreter::visit(LiteralDouble &elem)
+{
+    emitConstant(PlainValue(elem.getValue()), false);
+}
+
+void SpecialPlaintextInterpreter::visit(LiteralString &elem)
+{
+    throw runtime_error("Strings cannot be interpreted: " + elem.toString(false));
+}
+
+void SpecialPlaintextInterpreter::visit(OperatorExpression &elem)
+{
+    auto operands = elem.getOperands();
+    if (operands.empty())
+        throw runtime_error("Operator expression without operands: " + elem.toString(false));
+
+    compileThen(operands[0].get(), [this, &elem, operands]() {
+        if (elem.getOperator().isUnary())
+        {
+            emitOperator(elem.getOperator(), integerResult,
+                         secretResult ? OpSpecialization::CIPHER_PLAIN : OpSpecialization::PLAIN_PLAIN);
+            return;
+        }
+        compileFold(elem, operands, 1, secretResult);
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(Return &elem)
+{
+    if (elem.hasValue())
+        compile(elem.getValue());
+    emit(Opcode::RETURN, elem.hasValue() ? 1 : 0);
+}
+
+void SpecialPlaintextInterpreter::visit(TernaryOperator &elem)
+{
+    compileThen(elem.getCondition(), [this, &elem]() {
+        auto skipThen = emit(Opcode::JUMP_IF_FALSE);
+        compileThen(elem.getThenExpr(), [this, &elem, skipThen]() {
+            auto integer = integerResult;
+            auto secret = secretResult;
+            auto skipElse = emit(Opcode::JUMP);
+            program->code[skipThen].operand = static_cast<int>(program->code.size());
+            compileThen(elem.getElseExpr(), [this, integer, secret, skipElse]() {
+                program->code[skipElse].operand = static_cast<int>(program->code.size());
+                integerResult = integer && integerResult;
+                secretResult = secret || secretResult;
+            });
+        });
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(UnaryExpression &elem)
+{
+    compileThen(elem.getOperand(), [this, &elem]() {
+        emitOperator(elem.getOperator(), integerResult,
+                     secretResult ? OpSpecialization::CIPHER_PLAIN : OpSpecialization::PLAIN_PLAIN);
+    });
+}
+
+void SpecialPlaintextInterpreter::visit(Variable &elem)
+{
+    auto slot = resolve(elem.getIdentifier());
+    emit(Opcode::LOAD, static_cast<int>(slot));
+    integerResult = program->integerVariables[slot];
+    secretResult = program->secretVariables[slot];
+}
+
+void SpecialPlaintextInterpreter::visit(VariableDeclaration &elem)
+{
+    // the value is compiled first, since it cannot refer to the variable it initializes
+    if (elem.hasValue())
+        compile(elem.getValue());
+    else
+        emitConstant(PlainValue(0), true);
+    auto slot = declare(elem.getTarget().getIdentifier(), elem.getDatatype());
+    emitStore(slot);
+}
+
+PlainValue SpecialPlaintextInterpreter::run(const std::string &function, std::vector<PlainValue> arguments)
+{
+    auto it = programs.find(function);
+    if (it == programs.end())
+        throw runtime_error("Function " + function + " has not been compiled.");
+    auto &p = it->second;
+    if (arguments.size() != p.parameters.size())
+        throw runtime_error(
+            "Function " + function + " expects " + std::to_string(p.parameters.size()) + " arguments, but got " +
+            std::to_string(arguments.size()) + ".");
+
+    std::vector<PlainValue> variables(p.variableCount);
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        auto slot = p.parameters[i];
+        variables[slot] = std::move(arguments[i]);
+        if (p.integerVariables[slot])
+        {
+            apply(variables[slot], [](double x) { return std::trunc(x); });
+            checkExact(variables[slot]);
+        }
+    }
+    return execute(p, variables);
+}
+
+PlainValue SpecialPlaintextInterpreter::execute(Program &p, std::vector<PlainValue> &variables)
+{
+    p.executions.assign(p.code.size(), 0);
+    std::vector<PlainValue> stack;
+    stack.reserve(16);
+
+    for (size_t pc = 0; pc < p.code.size();)
+    {
+        auto &instruction = p.code[pc];
+        ++p.executions[pc];
+        ++pc;
+        switch (instruction.opcode)
+        {
+        case Opcode::CONSTANT:
+            stack.push_back(p.constants[instruction.operand]);
+            break;
+        case Opcode::LOAD:
+            stack.push_back(variables[instruction.operand]);
+            break;
+        case Opcode::STORE:
+            variables[instruction.operand] = std::move(stack.back());
+            stack.pop_back();
+            break;
+        case Opcode::LOAD_INDEX: {
+            auto &array = variables[instruction.operand];
+            auto i = index(stack.back());
+            if (array.isArray && i >= array.elements.size() && i >= slotCount)
+                throw runtime_error("Index " + std::to_string(i) + " is out of range.");
+            stack.back() = PlainValue(array.at(i));
+            break;
+        }
+        case Opcode::STORE_INDEX: {
+            auto &array = variables[instruction.operand];
+            auto i = index(stack[stack.size() - 2]);
+            if (!array.isArray)
+                array = PlainValue(std::vector<double>(1, array.scalar));
+            if (i >= array.elements.size())
+                array.elements.resize(i + 1, 0);
+            array.elements[i] = stack.back().at(0);
+            stack.resize(stack.size() - 2);
+            break;
+        }
+        case Opcode::LIST: {
+            std::vector<double> elements;
+            auto first = stack.end() - instruction.operand;
+            for (auto it = first; it != stack.end(); ++it)
+            {
+                if (it->isArray)
+                    elements.insert(elements.end(), it->elements.begin(), it->elements.end());
+                else
+                    elements.push_back(it->scalar);
+            }
+            stack.erase(first, stack.end());
+            stack.emplace_back(std::move(elements));
+            break;
+        }
+        case Opcode::TRUNCATE:
+            apply(stack.back(), [](double x) { return std::trunc(x); });
+            checkExact(stack.back());
+            break;
+        case Opcode::ROTATE: {
+            auto offset = integer(stack.back().at(0));
+            stack.pop_back();
+            auto &value = stack.back();
+            if (!value.isArray)
+                break;
+            auto n = instruction.operand > 0 ? static_cast<size_t>(instruction.operand) : value.elements.size();
+            if (n == 0)
+                break;
+            if (value.elements.size() > n)
+                throw runtime_error("Cannot rotate an array that has more elements than there are slots.");
+            std::vector<double> rotated(n);
+            auto shift = static_cast<size_t>(((offset % static_cast<int64_t>(n)) + n) % n);
+            for (size_t i = 0; i < n; ++i)
+                rotated[i] = value.at((i + shift) % n);
+            value.elements = std::move(rotated);
+            break;
+        }
+        case Opcode::JUMP:
+            pc = instruction.operand;
+            break;
+        case Opcode::JUMP_IF_FALSE:
+            if (!stack.back().isTrue())
+                pc = instruction.operand;
+            stack.pop_back();
+            break;
+        case Opcode::RETURN:
+            return instruction.operand ? std::move(stack.back()) : PlainValue();
+        case Opcode::ADD:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x + y; });
+            stack.pop_back();
+            if (instruction.operand)
+                checkExact(stack.back());
+            break;
+        case Opcode::SUBTRACT:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x - y; });
+            stack.pop_back();
+            if (instruction.operand)
+                checkExact(stack.back());
+            break;
+        case Opcode::MULTIPLY:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x * y; });
+            stack.pop_back();
+            if (instruction.operand)
+                checkExact(stack.back());
+            break;
+        case Opcode::DIVIDE:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x / y; });
+            stack.pop_back();
+            break;
+        case Opcode::DIVIDE_INTEGER:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) {
+                if (integer(y) == 0)
+                    throw runtime_error("Division by zero.");
+                return static_cast<double>(integer(x) / integer(y));
+            });
+            stack.pop_back();
+            break;
+        case Opcode::MODULO:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) {
+                if (integer(y) == 0)
+                    throw runtime_error("Division by zero.");
+                return static_cast<double>(integer(x) % integer(y));
+            });
+            stack.pop_back();
+            break;
+        case Opcode::LOGICAL_AND:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x != 0 && y != 0 ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::LOGICAL_OR:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x != 0 || y != 0 ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::LESS:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x < y ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::LESS_EQUAL:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x <= y ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::GREATER:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x > y ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::GREATER_EQUAL:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x >= y ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::EQUAL:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x == y ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::NOT_EQUAL:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) { return x != y ? 1. : 0.; });
+            stack.pop_back();
+            break;
+        case Opcode::BITWISE_AND:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) {
+                return static_cast<double>(integer(x) & integer(y));
+            });
+            stack.pop_back();
+            break;
+        case Opcode::BITWISE_XOR:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) {
+                return static_cast<double>(integer(x) ^ integer(y));
+            });
+            stack.pop_back();
+            break;
+        case Opcode::BITWISE_OR:
+            apply(stack[stack.size() - 2], stack.back(), [](double x, double y) {
+                return static_cast<double>(integer(x) | integer(y));
+            });
+            stack.pop_back();
+            break;
+        case Opcode::LOGICAL_NOT:
+            apply(stack.back(), [](double x) { return x == 0 ? 1. : 0.; });
+            break;
+        case Opcode::BITWISE_NOT:
+            apply(stack.back(), [](double x) { return static_cast<double>(~integer(x)); });
+            break;
+        }
+    }
+    return PlainValue();
+}
+
+const std::vector<SpecialPlaintextInterpreter::Instruction> &SpecialPlaintextInterpreter::getCode(
+    const std::string &function) const
+{
+    auto it = programs.find(function);
+    if (it == programs.end())
+        throw runtime_error("Function " + function + " has not been compiled.");
+    return it->second.code;
+}
+
+std::map<std::pair<std::string, OpSpecialization>, size_t> SpecialPlaintextInterpreter::getProfile(
+    const std::string &function) const
+{
+    auto it = programs.find(function);
+    if (it == programs.end())
+        throw runtime_error("Function " + function + " has not been compiled.");
+    auto &p = it->second;
+
+    std::map<std::pair<std::string, OpSpecialization>, size_t> profile;
+    for (size_t pc = 0; pc < p.executions.size(); ++pc)
+    {
+        auto name = operationName(p.code[pc].opcode);
+        if (!name.empty() && p.executions[pc] > 0)
+            profile[{ name, p.code[pc].specialization }] += p.executions[pc];
+    }
+    return profile;
+}
@@ -0,0 +1,336 @@
+#include "transpiration/ast/utils/polynomial_approximation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+#include "transpiration/ast/binary_expression.h"
+#include "transpiration/ast/literal.h"
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/variable.h"
+#include "transpiration/ast/variable_declaration.h"
+
+/// Depth of x^n when computed as x^(n/2) * x^(n - n/2)
+size_t powerDepth(size_t n)
+{
+    size_t depth = 0;
+    while ((size_t(1) << depth) < n)
+        ++depth;
+    return depth;
+}
+
+/// Marks x^n and all powers needed to compute it as used
+void usePower(size_t n, std::set<size_t> &powers)
+{
+    if (n <= 1 || powers.count(n))
+        return;
+    powers.insert(n);
+    usePower(n / 2, powers);
+    usePower(n - n / 2, powers);
+}
+
+/// Mirrors PatersonStockmeyerEvaluator::evaluateRecursive without emitting any nodes
+/// \return depth of the evaluation of p
+size_t simulateEvaluation(const Polynomial &p, size_t babySteps, std::set<size_t> &powers, size_t &products)
+{
+    if (p.degree() < babySteps)
+    {
+        size_t depth = 0;
+        for (size_t i = 1; i < p.getCoefficients().size(); ++i)
+        {
+            if (p.getCoefficients()[i] != 0)
+            {
+                usePower(i, powers);
+                depth = std::max(depth, powerDepth(i));
+            }
+        }
+        return depth;
+    }
+
+    size_t giantStep = babySteps;
+    while (giantStep * 2 <= p.degree())
+        giantStep *= 2;
+    auto [quotient, remainder] = p.divideByPower(giantStep);
+    usePower(giantStep, powers);
+
+    auto quotientDepth = simulateEvaluation(quotient, babySteps, powers, products);
+    auto remainderDepth = simulateEvaluation(remainder, babySteps, powers, products);
+    if (quotient.degree() == 0)
+    {
+        // scalar multiplication
+        return std::max(powerDepth(giantStep), remainderDepth);
+    }
+    ++products;
+    return std::max(std::max(quotientDepth, powerDepth(giantStep)) + 1, remainderDepth);
+}
+
+Polynomial::Polynomial(std::vector<double> coefficients) : coefficients(std::move(coefficients))
+{
+    while (!this->coefficients.empty() && this->coefficients.back() == 0)
+        this->coefficients.pop_back();
+}
+
+size_t Polynomial::degree() const
+{
+    return coefficients.empty() ? 0 : coefficients.size() - 1;
+}
+
+bool Polynomial::isZero() const
+{
+    return coefficients.empty();
+}
+
+const std::vector<double> &Polynomial::getCoefficients() const
+{
+    return coefficients;
+}
+
+double Polynomial::operator()(double x) const
+{
+    double result = 0;
+    for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it)
+        result = result * x + *it;
+    return result;
+}
+
+std::pair<Polynomial, Polynomial> Polynomial::divideByPower(size_t k) const
+{
+    if (coefficients.size() <= k)
+        return { Polynomial({}), *this };
+    std::vector<double> remainder(coefficients.begin(), coefficients.begin() + k);
+    std::vector<double> quotient(coefficients.begin() + k, coefficients.end());
+    return { Polynomial(quotient), Polynomial(remainder) };
+}
+
+size_t Polynomial::depth() const
+{
+    std::set<size_t> powers;
+    size_t products = 0;
+    return simulateEvaluation(*this, PatersonStockmeyerEvaluator::chooseBabySteps(degree()), powers, products);
+}
+
+size_t Polynomial::countNonScalarMultiplications() const
+{
+    std::set<size_t> powers;
+    size_t products = 0;
+    simulateEvaluation(*this, PatersonStockmeyerEvaluator::chooseBabySteps(degree()), powers, products);
+    return powers.size() + products;
+}
+
+Polynomial Polynomial::signF(unsigned n)
+{
+    if (n < 1 || n > 4)
+        throw runtime_error("Polynomial::signF is only available for 1 <= n <= 4.");
+
+    // expand sum_{i=0}^{n} 1/4^i * binom(2i, i) * x * (1 - x^2)^i
+    std::vector<double> coefficients(2 * n + 2, 0.0);
+    for (unsigned i = 0; i <= n; ++i)
+    {
+        double factor = std::pow(0.25, i);
+        for (unsigned j = 1; j <= i; ++j)
+            factor *= double(i + j) / j; // binom(2i, i) = prod_{j=1}^{i} (i + j) / j
+        double binomial = 1; // binom(i, j)
+        for (unsigned j = 0; j <= i; ++j)
+        {
+            coefficients[2 * j + 1] += factor * binomial * ((j % 2) ? -1 : 1);
+            binomial = binomial * (i - j) / (j + 1);
+        }
+    }
+    return Polynomial(coefficients);
+}
+
+Polynomial Polynomial::signG(unsigned n)
+{
+    switch (n)
+    {
+    case 1:
+        return Polynomial({ 0, 2126 / 1024.0, 0, -1359 / 1024.0 });
+    case 2:
+        return Polynomial({ 0, 3334 / 1024.0, 0, -6108 / 1024.0, 0, 3796 / 1024.0 });
+    case 3:
+        return Polynomial({ 0, 4589 / 1024.0, 0, -16577 / 1024.0, 0, 25614 / 1024.0, 0, -12860 / 1024.0 });
+    case 4:
+        return Polynomial(
+            { 0, 5850 / 1024.0, 0, -34974 / 1024.0, 0, 97015 / 1024.0, 0, -113492 / 1024.0, 0, 46623 / 1024.0 });
+    default:
+        throw runtime_error("Polynomial::signG is only available for 1 <= n <= 4.");
+    }
+}
+
+SignApproximation::SignApproximation(std::vector<Polynomial> stages) : stages(std::move(stages))
+{}
+
+SignApproximation SignApproximation::fromConfig(const ApproximationConfig &config)
+{
+    if (config.inputGap <= 0 || config.inputGap >= 1)
+        throw runtime_error("ApproximationConfig::inputGap must be in (0, 1).");
+    if (config.degree > 4)
+        throw runtime_error("ApproximationConfig::degree must be in [0, 4].");
+
+    const unsigned maxIterations = 64;
+    double maxError = std::pow(2.0, -double(config.precisionBits));
+
+    // sign approximations are odd, so the positive half of [-1, -gap] u [gap, 1] suffices
+    std::vector<double> grid;
+    const int gridPoints = 512;
+    for (int i = 0; i <= gridPoints; ++i)
+    {
+        grid.push_back(config.inputGap * std::pow(1.0 / config.inputGap, double(i) / gridPoints));
+        grid.push_back(config.inputGap + (1 - config.inputGap) * i / gridPoints);
+    }
+
+    std::unique_ptr<SignApproximation> best = nullptr;
+    size_t bestDepth = std::numeric_limits<size_t>::max();
+    size_t bestMultiplications = std::numeric_limits<size_t>::max();
+    for (unsigned n = 1; n <= 4; ++n)
+    {
+        if (config.degree != 0 && config.degree != n)
+            continue;
+
+        auto f = Polynomial::signF(n);
+        auto g = Polynomial::signG(n);
+        auto values = grid;
+        for (unsigned gIterations = 0; gIterations < maxIterations; ++gIterations)
+        {
+            auto current = values;
+            for (unsigned fIterations = 0; fIterations < maxIterations; ++fIterations)
+            {
+                size_t depth = gIterations * g.depth() + fIterations * f.depth();
+                size_t multiplications = gIterations * g.countNonScalarMultiplications() +
+                                         fIterations * f.countNonScalarMultiplications();
+                if (depth > bestDepth || (depth == bestDepth && multiplications >= bestMultiplications))
+                    break;
+
+                bool precise = std::all_of(current.begin(), current.end(), [&](double v) {
+                    return std::abs(1 - v) <= maxError;
+                });
+                if (precise)
+                {
+                    std::vector<Polynomial> stages(gIterations, g);
+                    stages.insert(stages.end(), fIterations, f);
+                    best = std::make_unique<SignApproximation>(stages);
+                    bestDepth = depth;
+                    bestMultiplications = multiplications;
+                    break;
+                }
+                for (auto &v : current)
+                    v = f(v);
+            }
+            for (auto &v : values)
+                v = g(v);
+        }
+    }
+
+    if (!best)
+        throw runtime_error("No sign approximation reaches the requested precision.");
+    return *best;
+}
+
+const std::vector<Polynomial> &SignApproximation::getStages() const
+{
+    return stages;
+}
+
+size_t SignApproximation::depth() const
+{
+    size_t depth = 0;
+    for (auto &stage : stages)
+        depth += stage.depth();
+    return depth;
+}
+
+size_t SignApproximation::countNonScalarMultiplications() const
+{
+    size_t count = 0;
+    for (auto &stage : stages)
+        count += stage.countNonScalarMultiplications();
+    return count;
+}
+
+double SignApproximation::operator()(double x) const
+{
+    for (auto &stage : stages)
+        x = stage(x);
+    return x;
+}
+
+PatersonStockmeyerEvaluator::PatersonStockmeyerEvaluator(
+    std::vector<std::unique_ptr<AbstractStatement>> &statements, std::string prefix, std::string input)
+    : statements(statements), prefix(std::move(prefix)), input(std::move(input))
+{}
+
+size_t PatersonStockmeyerEvaluator::chooseBabySteps(size_t degree)
+{
+    // k ~ sqrt((degree + 1) / 2) balances the k baby steps against the (degree + 1) / k giant step products
+    size_t k = 1;
+    while (2 * k * k < degree + 1)
+        k *= 2;
+    return k;
+}
+
+std::string PatersonStockmeyerEvaluator::power(size_t k)
+{
+    if (k == 1)
+        return input;
+
+    auto it = powers.find(k);
+    if (it != powers.end())
+        return it->second;
+
+    auto left = power(k / 2);
+    auto right = power(k - k / 2);
+    auto identifier = prefix + "_pow" + std::to_string(k);
+    statements.push_back(std::make_unique<VariableDeclaration>(
+        Datatype(Type::DOUBLE, true), std::make_unique<Variable>(identifier),
+        std::make_unique<BinaryExpression>(
+            std::make_unique<Variable>(left), Operator(FHE_MULTIPLICATION), std::make_unique<Variable>(right))));
+    powers[k] = identifier;
+    return identifier;
+}
+
+std::unique_ptr<AbstractExpression> PatersonStockmeyerEvaluator::evaluateRecursive(const Polynomial &p)
+{
+    if (p.degree() < babySteps)
+    {
+        // linear combination of the baby-step powers, i.e., only scalar multiplications
+        auto &coefficients = p.getCoefficients();
+        std::unique_ptr<AbstractExpression> result = nullptr;
+        if (!coefficients.empty() && coefficients[0] != 0)
+            result = std::make_unique<LiteralDouble>(coefficients[0]);
+        for (size_t i = 1; i < coefficients.size(); ++i)
+        {
+            if (coefficients[i] == 0)
+                continue;
+            std::unique_ptr<AbstractExpression> term = std::make_unique<Variable>(power(i));
+            if (coefficients[i] != 1)
+            {
+                term = std::make_unique<BinaryExpression>(
+                    std::make_unique<LiteralDouble>(coefficients[i]), Operator(FHE_MULTIPLICATION), std::move(term));
+            }
+            if (result)
+                result = std::make_unique<BinaryExpression>(std::move(result), Operator(FHE_ADDITION), std::move(term));
+            else
+                result = std::move(term);
+        }
+        return result ? std::move(result) : std::make_unique<LiteralDouble>(0.0);
+    }
+
+    // p = quotient * x^giantStep + remainder, with the largest giantStep = babySteps * 2^j <= deg(p)
+    size_t giantStep = babySteps;
+    while (giantStep * 2 <= p.degree())
+        giantStep *= 2;
+    auto [quotient, remainder] = p.divideByPower(giantStep);
+
+    auto product = std::make_unique<BinaryExpression>(
+        evaluateRecursive(quotient), Operator(FHE_MULTIPLICATION), std::make_unique<Variable>(power(giantStep)));
+    if (remainder.isZero())
+        return product;
+    return std::make_unique<BinaryExpression>(std::move(product), Operator(FHE_ADDITION), evaluateRecursive(remainder));
+}
+
+std::unique_ptr<AbstractExpression> PatersonStockmeyerEvaluator::evaluate(const Polynomial &p)
+{
+    babySteps = chooseBabySteps(p.degree());
+    return evaluateRecursive(p);
+}
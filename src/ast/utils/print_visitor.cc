@@ -1,4 +1,8 @@
 #include "transpiration/ast/utils/print_visitor.h"
+
+#include <algorithm>
+#include <cstddef>
+
 #include "transpiration/ast/abstract_expression.h"
 #include "transpiration/ast/abstract_node.h"
 #include "transpiration/ast/literal.h"
@@ -25,13 +29,28 @@ void SpecialPrintVisitor::visit(AbstractNode &elem)
     // Output current node at required indentation
     os << "NODE VISITED: " << getIndentation() << curNodeString;
 
-    // increment indentation level and visit children, decrement afterwards
-    ++indentation_level;
+    // the children are indented by one more level and visited once this returns, by the outermost visit()
+    auto first = pending.size();
     for (AbstractNode &c : elem)
     {
-        c.accept(*this);
+        pending.emplace_back(&c, indentation_level + 1);
+    }
+    std::reverse(pending.begin() + static_cast<std::ptrdiff_t>(first), pending.end());
+    if (visiting)
+        return;
+
+    // explicit stack instead of recursion, since the AST might be arbitrarily deep
+    visiting = true;
+    int level = indentation_level;
+    while (!pending.empty())
+    {
+        auto [node, nodeLevel] = pending.back();
+        pending.pop_back();
+        indentation_level = nodeLevel;
+        node->accept(*this);
     }
-    --indentation_level;
+    indentation_level = level;
+    visiting = false;
 }
 
 void SpecialPrintVisitor::visit(LiteralBool &elem)
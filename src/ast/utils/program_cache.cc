@@ -0,0 +1,213 @@
+#include "transpiration/ast/utils/program_cache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "transpiration/ast/utils/function_cache.h"
+#include "transpiration/ast/utils/structural_hash.h"
+
+namespace
+{
+/// Suffix of the files of the programs, which tells them apart from other files, e.g. of a FunctionCache
+const std::string SUFFIX = ".program";
+
+nlohmann::json specToJson(const ParameterSpec &spec)
+{
+    return { { "scheme", spec.scheme == ParameterSpec::Scheme::CKKS ? "ckks" : "bfv" },
+             { "poly_modulus_degree", spec.polyModulusDegree },
+             { "plain_modulus_bits", spec.plainModulusBits },
+             { "coeff_modulus_bits", spec.coeffModulusBits },
+             { "scale_bits", spec.scaleBits } };
+}
+
+/// Reads exactly count bytes of the file
+/// \return false if the file ends before
+bool readBytes(std::ifstream &file, size_t count, std::string &bytes)
+{
+    bytes.resize(count);
+    file.read(bytes.data(), static_cast<std::streamsize>(count));
+    return static_cast<size_t>(file.gcount()) == count;
+}
+
+ParameterSpec specFromJson(const nlohmann::json &j)
+{
+    ParameterSpec spec;
+    auto ckks = j.at("scheme").get<std::string>() == "ckks";
+    spec.scheme = ckks ? ParameterSpec::Scheme::CKKS : ParameterSpec::Scheme::BFV;
+    spec.polyModulusDegree = j.at("poly_modulus_degree").get<size_t>();
+    spec.plainModulusBits = j.at("plain_modulus_bits").get<int>();
+    spec.coeffModulusBits = j.at("coeff_modulus_bits").get<std::vector<int>>();
+    spec.scaleBits = j.at("scale_bits").get<int>();
+    return spec;
+}
+} // namespace
+
+ProgramCache::ProgramCache(std::string directory, size_t maxBytes) : directory(std::move(directory)), maxBytes(maxBytes)
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (error)
+        throw std::runtime_error("Cannot create the cache directory " + this->directory + ": " + error.message());
+    scan();
+}
+
+std::string ProgramCache::pathOf(uint64_t key) const
+{
+    std::ostringstream path;
+    path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << SUFFIX;
+    return path.str();
+}
+
+void ProgramCache::scan()
+{
+    entries.clear();
+    bytes = 0;
+    // other processes might delete files while they are listed
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        auto name = it->path().filename().string();
+        if (name.size() != 16 + SUFFIX.size() || name.compare(16, SUFFIX.size(), SUFFIX) != 0)
+            continue;
+
+        std::error_code fileError;
+        auto size = it->file_size(fileError);
+        auto lastUse = it->last_write_time(fileError);
+        if (fileError)
+            continue;
+        entries[std::stoull(name.substr(0, 16), nullptr, 16)] = { size, lastUse };
+        bytes += size;
+    }
+}
+
+void ProgramCache::evict()
+{
+    std::vector<std::pair<std::filesystem::file_time_type, uint64_t>> byLastUse;
+    for (auto &[key, entry] : entries)
+        byLastUse.emplace_back(entry.lastUse, key);
+    std::sort(byLastUse.begin(), byLastUse.end());
+
+    for (auto &[lastUse, key] : byLastUse)
+    {
+        if (bytes <= maxBytes)
+            break;
+        std::error_code error;
+        std::filesystem::remove(pathOf(key), error);
+        bytes -= entries[key].bytes;
+        entries.erase(key);
+        ++evictions;
+    }
+}
+
+std::optional<CompiledProgram> ProgramCache::find(uint64_t key, const std::string &source, uint64_t options)
+{
+    auto path = pathOf(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        // e.g. evicted by another process
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            bytes -= it->second.bytes;
+            entries.erase(it);
+        }
+    }
+    else
+    {
+        try
+        {
+            // only the header is parsed, and the source is only read if its length and hash match
+            std::string line;
+            std::getline(file, line);
+            auto header = nlohmann::json::parse(line);
+            CompiledProgram program;
+            bool matches = header.at("options").get<uint64_t>() == options &&
+                           header.at("source_bytes").get<size_t>() == source.size() &&
+                           header.at("source_hash").get<uint64_t>() == stableHash(source) &&
+                           readBytes(file, source.size(), program.source) && program.source == source &&
+                           readBytes(file, header.at("code_bytes").get<size_t>(), program.code);
+            if (matches)
+            {
+                program.options = options;
+                program.spec = specFromJson(header.at("spec"));
+
+                std::error_code error;
+                auto now = std::filesystem::file_time_type::clock::now();
+                std::filesystem::last_write_time(path, now, error);
+                auto size = std::filesystem::file_size(path, error);
+                if (!error)
+                {
+                    auto it = entries.find(key);
+                    bytes = bytes - (it == entries.end() ? 0 : it->second.bytes) + size;
+                    entries[key] = { size, now };
+                }
+                ++hits;
+                return program;
+            }
+        }
+        catch (nlohmann::json::exception &)
+        {
+            // e.g. written by a different version, it is overwritten once the program is compiled again
+        }
+    }
+    ++misses;
+    return std::nullopt;
+}
+
+void ProgramCache::insert(uint64_t key, const CompiledProgram &program)
+{
+    nlohmann::json header = { { "options", program.options },
+                              { "source_bytes", program.source.size() },
+                              { "source_hash", stableHash(program.source) },
+                              { "code_bytes", program.code.size() },
+                              { "spec", specToJson(program.spec) } };
+    auto contents = header.dump() + "\n" + program.source + program.code;
+    auto path = pathOf(key);
+    if (!writeFileAtomically(path, contents))
+        return;
+
+    // the same time on disk (for other processes and scan()) and in memory
+    std::error_code error;
+    auto now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(path, now, error);
+    auto it = entries.find(key);
+    if (it != entries.end())
+        bytes -= it->second.bytes;
+    entries[key] = { contents.size(), now };
+    bytes += contents.size();
+    if (bytes > maxBytes)
+    {
+        // the files of other processes count as well
+        scan();
+        evict();
+    }
+}
+
+size_t ProgramCache::getHits() const
+{
+    return hits;
+}
+
+size_t ProgramCache::getMisses() const
+{
+    return misses;
+}
+
+size_t ProgramCache::getEvictions() const
+{
+    return evictions;
+}
+
+size_t ProgramCache::getBytes() const
+{
+    return bytes;
+}
@@ -1,5 +1,12 @@
 #include "transpiration/ast/utils/program_print_visitor.h"
 
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "transpiration/ast/utils/static_visitor.h"
+
 std::string SpecialProgramPrintVisitor::getIndentation() const
 {
     // Indent with two spaces per level
@@ -9,16 +16,90 @@ std::string SpecialProgramPrintVisitor::getIndentation() const
 SpecialProgramPrintVisitor::SpecialProgramPrintVisitor(std::ostream &os) : os(os)
 {}
 
-void SpecialProgramPrintVisitor::visit(BinaryExpression &elem)
+void SpecialProgramPrintVisitor::visit(AbstractExpression &elem)
 {
-    os << "(";
-    if (elem.hasLeft())
-        elem.getLeft().accept(*this);
-    os << " " << elem.getOperator().toString() << " ";
-    if (elem.hasRight())
-        elem.getRight().accept(*this);
-    os << ")";
+    // the parts that remain to be printed, the next one on top: a subexpression, or text if the expression is nullptr
+    std::vector<std::pair<AbstractExpression *, std::string>> parts{ { &elem, "" } };
+    while (!parts.empty())
+    {
+        auto [expression, text] = std::move(parts.back());
+        parts.pop_back();
+        if (!expression)
+        {
+            os << text;
+            continue;
+        }
+
+        std::vector<std::pair<AbstractExpression *, std::string>> expansion;
+        auto separated = [&expansion](const std::vector<std::unique_ptr<AbstractExpression>> &expressions) {
+            for (size_t i = 0; i < expressions.size(); ++i)
+            {
+                if (i > 0)
+                    expansion.emplace_back(nullptr, ", ");
+                expansion.emplace_back(expressions[i].get(), expressions[i] ? "" : "-");
+            }
+        };
+        dispatch(*expression, [&](auto &node) {
+            using Node = std::remove_reference_t<decltype(node)>;
+            if constexpr (std::is_same_v<Node, BinaryExpression>)
+            {
+                expansion = { { nullptr, "(" },
+                              { node.hasLeft() ? &node.getLeft() : nullptr, "" },
+                              { nullptr, " " + node.getOperator().toString() + " " },
+                              { node.hasRight() ? &node.getRight() : nullptr, "" },
+                              { nullptr, ")" } };
+            }
+            else if constexpr (std::is_same_v<Node, Call>)
+            {
+                expansion.emplace_back(nullptr, node.getIdentifier() + "(");
+                for (auto &argument : node.getArguments())
+                {
+                    if (expansion.size() > 1)
+                        expansion.emplace_back(nullptr, ", ");
+                    expansion.emplace_back(&argument.get(), "");
+                }
+                expansion.emplace_back(nullptr, ")");
+            }
+            else if constexpr (std::is_same_v<Node, ExpressionList>)
+            {
+                expansion.emplace_back(nullptr, "{");
+                separated(node.getExpressionPtrs());
+                expansion.emplace_back(nullptr, "}");
+            }
+            else if constexpr (std::is_same_v<Node, IndexAccess>)
+            {
+                expansion = { { &node.getTarget(), "" }, { nullptr, "[" }, { &node.getIndex(), "" }, { nullptr, "]" } };
+            }
+            else if constexpr (std::is_same_v<Node, OperatorExpression>)
+            {
+                expansion.emplace_back(nullptr, node.getOperator().toString() + "(");
+                for (auto &operand : node.getOperands())
+                {
+                    if (expansion.size() > 1)
+                        expansion.emplace_back(nullptr, ", ");
+                    expansion.emplace_back(&operand.get(), "");
+                }
+                expansion.emplace_back(nullptr, ")");
+            }
+            else if constexpr (std::is_same_v<Node, TernaryOperator>)
+            {
+                expansion = { { &node.getCondition(), "" }, { nullptr, " ? " }, { &node.getThenExpr(), "" },
+                              { nullptr, " : " },           { &node.getElseExpr(), "" } };
+            }
+            else if constexpr (std::is_same_v<Node, UnaryExpression>)
+            {
+                expansion = { { nullptr, node.getOperator().toString() }, { &node.getOperand(), "" } };
+            }
+            else
+            {
+                // Variables and Literals
+                visit(node);
+            }
+        });
+        std::move(expansion.rbegin(), expansion.rend(), std::back_inserter(parts));
+    }
 }
+
 void SpecialProgramPrintVisitor::visit(Block &elem)
 {
     os << getIndentation() << "{\n";
@@ -30,50 +111,6 @@ void SpecialProgramPrintVisitor::visit(Block &elem)
     --indentation_level;
     os << getIndentation() << "}\n";
 }
-void SpecialProgramPrintVisitor::visit(Call &elem)
-{
-    os << elem.getIdentifier() << "(";
-    auto args = elem.getArguments();
-    if (!args.empty())
-    {
-        args[0].get().accept(*this);
-        for (size_t i = 1; i < args.size(); ++i)
-        {
-            os << ", ";
-            args[i].get().accept(*this);
-        }
-    }
-    os << ")";
-}
-void SpecialProgramPrintVisitor::visit(ExpressionList &elem)
-{
-    os << "{";
-    auto &vec = elem.getExpressionPtrs();
-    if (!vec.empty())
-    {
-        if (vec[0])
-        {
-            vec[0]->accept(*this);
-        }
-        else
-        {
-            os << "-";
-        }
-        for (size_t i = 1; i < vec.size(); ++i)
-        {
-            os << ", ";
-            if (vec[i])
-            {
-                vec[i]->accept(*this);
-            }
-            else
-            {
-                os << "-";
-            }
-        }
-    }
-    os << "}";
-}
 void SpecialProgramPrintVisitor::visit(For &elem)
 {
     os << getIndentation() << "for({";
@@ -161,13 +198,6 @@ void SpecialProgramPrintVisitor::visit(If &elem)
         elem.getElseBranch().accept(*this);
     }
 }
-void SpecialProgramPrintVisitor::visit(IndexAccess &elem)
-{
-    elem.getTarget().accept(*this);
-    os << "[";
-    elem.getIndex().accept(*this);
-    os << "]";
-}
 void SpecialProgramPrintVisitor::visit(LiteralBool &elem)
 {
     if (elem.getValue())
@@ -195,21 +225,6 @@ void SpecialProgramPrintVisitor::visit(LiteralString &elem)
 {
     os << elem.getValue();
 }
-void SpecialProgramPrintVisitor::visit(OperatorExpression &elem)
-{
-    os << elem.getOperator().toString() << "(";
-    auto operands = elem.getOperands();
-    if (!operands.empty())
-    {
-        operands[0].get().accept(*this);
-        for (size_t i = 1; i < operands.size(); ++i)
-        {
-            os << ", ";
-            operands[i].get().accept(*this);
-        }
-    }
-    os << ")";
-}
 void SpecialProgramPrintVisitor::visit(Return &elem)
 {
     os << getIndentation() << "return";
@@ -220,19 +235,6 @@ void SpecialProgramPrintVisitor::visit(Return &elem)
     }
     os << ";\n";
 }
-void SpecialProgramPrintVisitor::visit(TernaryOperator &elem)
-{
-    elem.getCondition().accept(*this);
-    os << " ? ";
-    elem.getThenExpr().accept(*this);
-    os << " : ";
-    elem.getElseExpr().accept(*this);
-}
-void SpecialProgramPrintVisitor::visit(UnaryExpression &elem)
-{
-    os << elem.getOperator().toString();
-    elem.getOperand().accept(*this);
-}
 void SpecialProgramPrintVisitor::visit(Assignment &elem)
 {
     os << getIndentation();
@@ -0,0 +1,400 @@
+#include "transpiration/ast/utils/rotation_scheduling_visitor.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// Matches `for (int i = 0; i < n; i = i + 1)` (or `i <= n - 1`) with a literal n
+/// \return false if the loop does not have this form
+bool matchCountingLoop(For &loop, std::string &variable, size_t &extent)
+{
+    if (!loop.hasInitializer() || !loop.hasCondition() || !loop.hasUpdate() || !loop.hasBody())
+        return false;
+
+    auto &initializer = loop.getInitializer().getStatementPointers();
+    auto declaration = (initializer.size() == 1) ? dynamic_cast<VariableDeclaration *>(initializer[0].get()) : nullptr;
+    if (!declaration || !declaration->hasTarget() || !declaration->hasValue())
+        return false;
+    auto start = dynamic_cast<LiteralInt *>(&declaration->getValue());
+    if (!start || start->getValue() != 0)
+        return false;
+    variable = declaration->getTarget().getIdentifier();
+
+    auto condition = dynamic_cast<BinaryExpression *>(&loop.getCondition());
+    if (!condition || !condition->hasLeft() || !condition->hasRight())
+        return false;
+    auto conditionVariable = dynamic_cast<Variable *>(&condition->getLeft());
+    auto bound = dynamic_cast<LiteralInt *>(&condition->getRight());
+    if (!conditionVariable || conditionVariable->getIdentifier() != variable || !bound)
+        return false;
+    if (condition->getOperator() == Operator(LESS))
+        extent = static_cast<size_t>(std::max(bound->getValue(), 0));
+    else if (condition->getOperator() == Operator(LESS_EQUAL))
+        extent = static_cast<size_t>(std::max(bound->getValue() + 1, 0));
+    else
+        return false;
+
+    auto &update = loop.getUpdate().getStatementPointers();
+    auto assignment = (update.size() == 1) ? dynamic_cast<Assignment *>(update[0].get()) : nullptr;
+    if (!assignment || !assignment->hasTarget() || !assignment->hasValue())
+        return false;
+    auto target = dynamic_cast<Variable *>(&assignment->getTarget());
+    auto increment = dynamic_cast<BinaryExpression *>(&assignment->getValue());
+    if (!target || target->getIdentifier() != variable || !increment || !increment->hasLeft() || !increment->hasRight())
+        return false;
+    auto incremented = dynamic_cast<Variable *>(&increment->getLeft());
+    auto step = dynamic_cast<LiteralInt *>(&increment->getRight());
+    return increment->getOperator() == Operator(ADDITION) && incremented && incremented->getIdentifier() == variable &&
+           step && step->getValue() == 1;
+}
+
+/// The only statement of the loop's body, or nullptr if the body does not consist of exactly one statement
+AbstractStatement *singleStatement(For &loop)
+{
+    auto &statements = loop.getBody().getStatementPointers();
+    return (statements.size() == 1) ? statements[0].get() : nullptr;
+}
+
+bool isAddition(const Operator &op)
+{
+    return op == Operator(ADDITION) || op == Operator(FHE_ADDITION);
+}
+
+/// Identifier of the array accessed as identifier[index]...[index], or an empty string if expr is no such access
+std::string accessedArray(AbstractExpression &expr, const std::vector<std::string> &indices)
+{
+    AbstractExpression *target = &expr;
+    for (auto index = indices.rbegin(); index != indices.rend(); ++index)
+    {
+        auto indexAccess = dynamic_cast<IndexAccess *>(target);
+        if (!indexAccess || !indexAccess->hasIndex() || !indexAccess->hasTarget())
+            return "";
+        auto indexVariable = dynamic_cast<Variable *>(&indexAccess->getIndex());
+        if (!indexVariable || indexVariable->getIdentifier() != *index)
+            return "";
+        target = &indexAccess->getTarget();
+    }
+    auto variable = dynamic_cast<Variable *>(target);
+    return variable ? variable->getIdentifier() : "";
+}
+
+/// Clones expr with every x[index] replaced by x, such that it computes all slots at once
+/// \return nullptr if expr contains anything but accesses x[index] and (elementwise) +, - and *
+std::unique_ptr<AbstractExpression> vectorize(
+    AbstractExpression &expr, const std::string &index, std::vector<std::string> &arrays)
+{
+    // in post-order, since unrolled summands nest arbitrarily deep: when a BinaryExpression is combined, its vectorized
+    // operands (nullptr if they cannot be vectorized) are on top of vectorized
+    std::vector<std::unique_ptr<AbstractExpression>> vectorized;
+    auto descend = [&](AbstractExpression &operand) {
+        auto array = accessedArray(operand, { index });
+        if (!array.empty())
+        {
+            arrays.push_back(array);
+            vectorized.push_back(std::make_unique<Variable>(array));
+            return false;
+        }
+
+        auto binaryExpression = dynamic_cast<BinaryExpression *>(&operand);
+        if (!binaryExpression || !binaryExpression->hasLeft() || !binaryExpression->hasRight())
+        {
+            vectorized.push_back(nullptr);
+            return false;
+        }
+        auto &op = binaryExpression->getOperator();
+        bool elementwise = isAddition(op) || op == Operator(SUBTRACTION) || op == Operator(FHE_SUBTRACTION) ||
+                           op == Operator(MULTIPLICATION) || op == Operator(FHE_MULTIPLICATION);
+        if (!elementwise)
+            vectorized.push_back(nullptr);
+        return elementwise;
+    };
+    auto combine = [&vectorized](BinaryExpression &binaryExpression) {
+        // slots beyond the loop's extent must not pick up anything but the arrays' values, hence no literals (or other
+        // scalars) as operands
+        auto right = std::move(vectorized.back());
+        vectorized.pop_back();
+        auto left = std::move(vectorized.back());
+        vectorized.pop_back();
+        if (left && right)
+            vectorized.push_back(
+                std::make_unique<BinaryExpression>(std::move(left), binaryExpression.getOperator(), std::move(right)));
+        else
+            vectorized.push_back(nullptr);
+    };
+    walk(expr, overloaded{ descend, [](AbstractNode &) { return false; } },
+         overloaded{ combine, [](AbstractNode &) {} });
+    return std::move(vectorized.back());
+}
+
+/// rotate(identifier, k), or just identifier if k == 0
+std::unique_ptr<AbstractExpression> rotation(const std::string &identifier, size_t k)
+{
+    if (k == 0)
+        return std::make_unique<Variable>(identifier);
+    std::vector<std::unique_ptr<AbstractExpression>> arguments;
+    arguments.push_back(std::make_unique<Variable>(identifier));
+    arguments.push_back(std::make_unique<LiteralInt>(static_cast<int>(k)));
+    return std::make_unique<Call>("rotate", std::move(arguments));
+}
+
+/// Adds term to sum (which may be nullptr)
+void accumulate(std::unique_ptr<AbstractExpression> &sum, std::unique_ptr<AbstractExpression> &&term)
+{
+    if (sum)
+        sum = std::make_unique<BinaryExpression>(std::move(sum), Operator(FHE_ADDITION), std::move(term));
+    else
+        sum = std::move(term);
+}
+} // namespace
+
+SpecialRotationSchedulingVisitor::SpecialRotationSchedulingVisitor(std::unordered_set<std::string> secretNodes)
+    : secretNodes(std::move(secretNodes))
+{}
+
+SpecialRotationSchedulingVisitor::SpecialRotationSchedulingVisitor(
+    std::unordered_set<std::string> secretNodes, const std::vector<LayoutSite> &sites, const LayoutPlan &plan)
+    : secretNodes(std::move(secretNodes))
+{
+    for (size_t i = 0; i < sites.size() && i < plan.siteLayouts.size(); ++i)
+    {
+        auto &site = sites[i];
+        auto &layouts = plan.siteLayouts[i];
+        if (site.kind == LayoutSite::MATRIX_VECTOR && !site.transposed && site.expression &&
+            layouts == std::vector<Layout>{ Layout::DIAGONAL, Layout::REPLICATED })
+        {
+            diagonalProducts.insert(site.expression);
+        }
+    }
+}
+
+Datatype SpecialRotationSchedulingVisitor::temporaryType(const std::string &identifier)
+{
+    auto type = declaredTypes.find(identifier);
+    return Datatype((type != declaredTypes.end()) ? type->second.getType() : Type::INT, true);
+}
+
+std::vector<std::unique_ptr<AbstractStatement>> SpecialRotationSchedulingVisitor::lowerReduction(For &loop)
+{
+    std::vector<std::unique_ptr<AbstractStatement>> statements;
+
+    // for (int i = 0; i < n; i = i + 1) { s = s + e; } (or s = e + s)
+    std::string index;
+    size_t extent;
+    if (!matchCountingLoop(loop, index, extent) || extent < 2)
+        return statements;
+    auto assignment = dynamic_cast<Assignment *>(singleStatement(loop));
+    if (!assignment || !assignment->hasTarget() || !assignment->hasValue())
+        return statements;
+    auto sum = dynamic_cast<Variable *>(&assignment->getTarget());
+    auto value = dynamic_cast<BinaryExpression *>(&assignment->getValue());
+    if (!sum || !value || !value->hasLeft() || !value->hasRight() || !isAddition(value->getOperator()))
+        return statements;
+
+    auto left = dynamic_cast<Variable *>(&value->getLeft());
+    auto right = dynamic_cast<Variable *>(&value->getRight());
+    AbstractExpression *summand = nullptr;
+    if (left && left->getIdentifier() == sum->getIdentifier())
+        summand = &value->getRight();
+    else if (right && right->getIdentifier() == sum->getIdentifier())
+        summand = &value->getLeft();
+    if (!summand || !secretNodes.count(summand->getUniqueNodeId()))
+        return statements;
+
+    std::vector<std::string> arrays;
+    auto vectorized = vectorize(*summand, index, arrays);
+    if (!vectorized)
+        return statements;
+
+    // the tree sums the slots 0 ... 2^ceil(log2(n)) - 1, so the slots n ... are cleared unless they are known to be zero
+    bool powerOfTwo = (extent & (extent - 1)) == 0;
+    bool zeroBeyondExtent = std::all_of(arrays.begin(), arrays.end(), [&](const std::string &array) {
+        auto length = listLengths.find(array);
+        return length != listLengths.end() && length->second <= extent;
+    });
+    if (!powerOfTwo && !zeroBeyondExtent)
+    {
+        std::vector<std::unique_ptr<AbstractExpression>> ones;
+        for (size_t i = 0; i < extent; ++i)
+            ones.push_back(std::make_unique<LiteralInt>(1));
+        vectorized = std::make_unique<BinaryExpression>(
+            std::move(vectorized), Operator(FHE_MULTIPLICATION), std::make_unique<ExpressionList>(std::move(ones)));
+    }
+
+    auto prefix = "__rot_" + std::to_string(loopCounter++);
+    auto type = temporaryType(arrays[0]);
+    std::string current;
+    if (auto variable = dynamic_cast<Variable *>(vectorized.get()))
+    {
+        current = variable->getIdentifier();
+    }
+    else
+    {
+        current = prefix;
+        statements.push_back(
+            std::make_unique<VariableDeclaration>(type, std::make_unique<Variable>(current), std::move(vectorized)));
+    }
+
+    // after the step with offset k, slot 0 holds the sum of the slots 0 ... 2k - 1
+    for (size_t offset = 1; offset < extent; offset *= 2)
+    {
+        auto next = prefix + "_" + std::to_string(offset);
+        auto step = std::make_unique<BinaryExpression>(
+            std::make_unique<Variable>(current), Operator(FHE_ADDITION), rotation(current, offset));
+        statements.push_back(
+            std::make_unique<VariableDeclaration>(type, std::make_unique<Variable>(next), std::move(step)));
+        current = next;
+    }
+
+    auto total = std::make_unique<IndexAccess>(std::make_unique<Variable>(current), std::make_unique<LiteralInt>(0));
+    statements.push_back(std::make_unique<Assignment>(
+        std::make_unique<Variable>(sum->getIdentifier()),
+        std::make_unique<BinaryExpression>(
+            std::make_unique<Variable>(sum->getIdentifier()), value->getOperator(), std::move(total))));
+    return statements;
+}
+
+std::vector<std::unique_ptr<AbstractStatement>> SpecialRotationSchedulingVisitor::lowerMatrixVector(For &loop)
+{
+    std::vector<std::unique_ptr<AbstractStatement>> statements;
+    if (diagonalProducts.empty())
+        return statements;
+
+    // for (int i = 0; i < n; i = i + 1) { for (int j = 0; j < m; j = j + 1) { y[i] = y[i] + M[i][j] * v[j]; } }
+    std::string row, column;
+    size_t rows, columns;
+    if (!matchCountingLoop(loop, row, rows))
+        return statements;
+    auto inner = dynamic_cast<For *>(singleStatement(loop));
+    if (!inner || !matchCountingLoop(*inner, column, columns) || columns == 0)
+        return statements;
+    auto assignment = dynamic_cast<Assignment *>(singleStatement(*inner));
+    if (!assignment || !assignment->hasTarget() || !assignment->hasValue())
+        return statements;
+    auto output = accessedArray(assignment->getTarget(), { row });
+    auto value = dynamic_cast<BinaryExpression *>(&assignment->getValue());
+    if (output.empty() || !value || !value->hasLeft() || !value->hasRight() || !isAddition(value->getOperator()))
+        return statements;
+
+    BinaryExpression *product = nullptr;
+    if (accessedArray(value->getLeft(), { row }) == output)
+        product = dynamic_cast<BinaryExpression *>(&value->getRight());
+    else if (accessedArray(value->getRight(), { row }) == output)
+        product = dynamic_cast<BinaryExpression *>(&value->getLeft());
+    if (!product || !diagonalProducts.count(product))
+        return statements;
+
+    auto matrix = accessedArray(product->getLeft(), { row, column });
+    auto vector = accessedArray(product->getRight(), { column });
+    if (matrix.empty() || vector.empty())
+    {
+        matrix = accessedArray(product->getRight(), { row, column });
+        vector = accessedArray(product->getLeft(), { column });
+    }
+    if (matrix.empty() || vector.empty())
+        return statements;
+
+    auto prefix = "__bsgs_" + std::to_string(loopCounter++);
+    auto type = temporaryType(vector);
+    size_t babySteps = SpecialLayoutPlanningVisitor::babyStepCount(columns);
+    size_t giantSteps = (columns + babySteps - 1) / babySteps;
+
+    // baby steps: rotations of v, shared by all giant steps
+    std::vector<std::string> rotatedVector = { vector };
+    for (size_t b = 1; b < babySteps; ++b)
+    {
+        auto identifier = prefix + "_v" + std::to_string(b);
+        statements.push_back(
+            std::make_unique<VariableDeclaration>(type, std::make_unique<Variable>(identifier), rotation(vector, b)));
+        rotatedVector.push_back(identifier);
+    }
+
+    // giant steps: sum_b diag[g*b + j] * rot(v, j), rotated by g*b (the diagonals are pre-rotated by -g*b)
+    std::unique_ptr<AbstractExpression> result = nullptr;
+    for (size_t g = 0; g < giantSteps; ++g)
+    {
+        std::unique_ptr<AbstractExpression> giantStep = nullptr;
+        for (size_t b = 0; b < babySteps && g * babySteps + b < columns; ++b)
+        {
+            auto diagonal = std::make_unique<IndexAccess>(
+                std::make_unique<Variable>(matrix), std::make_unique<LiteralInt>(static_cast<int>(g * babySteps + b)));
+            accumulate(
+                giantStep, std::make_unique<BinaryExpression>(
+                               std::move(diagonal), Operator(FHE_MULTIPLICATION),
+                               std::make_unique<Variable>(rotatedVector[b])));
+        }
+        auto identifier = prefix + "_g" + std::to_string(g);
+        statements.push_back(
+            std::make_unique<VariableDeclaration>(type, std::make_unique<Variable>(identifier), std::move(giantStep)));
+        accumulate(result, rotation(identifier, g * babySteps));
+    }
+    statements.push_back(
+        std::make_unique<VariableDeclaration>(type, std::make_unique<Variable>(prefix), std::move(result)));
+
+    statements.push_back(std::make_unique<Assignment>(
+        std::make_unique<Variable>(output),
+        std::make_unique<BinaryExpression>(
+            std::make_unique<Variable>(output), value->getOperator(), std::make_unique<Variable>(prefix))));
+    return statements;
+}
+
+void SpecialRotationSchedulingVisitor::visitStatements(Block &block)
+{
+    auto &statements = block.getStatementPointers();
+    for (size_t i = 0; i < statements.size(); ++i)
+    {
+        if (!statements[i])
+            continue;
+
+        std::vector<std::unique_ptr<AbstractStatement>> replacement;
+        if (auto loop = dynamic_cast<For *>(statements[i].get()))
+        {
+            replacement = lowerMatrixVector(*loop);
+            if (replacement.empty())
+                replacement = lowerReduction(*loop);
+        }
+
+        if (replacement.empty())
+        {
+            statements[i]->accept(*this);
+            continue;
+        }
+
+        statements.erase(statements.begin() + i);
+        statements.insert(
+            statements.begin() + i, std::make_move_iterator(replacement.begin()),
+            std::make_move_iterator(replacement.end()));
+        for (size_t j = i; j < i + replacement.size(); ++j)
+        {
+            statements[j]->setParent(block);
+        }
+        // the replacement only consists of declarations and an assignment, there is nothing left to rewrite
+        i += replacement.size() - 1;
+    }
+}
+
+void SpecialRotationSchedulingVisitor::visit(Block &elem)
+{
+    visitStatements(elem);
+}
+
+void SpecialRotationSchedulingVisitor::visit(FunctionParameter &elem)
+{
+    declaredTypes.insert_or_assign(elem.getIdentifier(), elem.getParameterType());
+}
+
+void SpecialRotationSchedulingVisitor::visit(VariableDeclaration &elem)
+{
+    visitChildren(elem);
+    if (elem.hasTarget())
+    {
+        declaredTypes.insert_or_assign(elem.getTarget().getIdentifier(), elem.getDatatype());
+        if (auto list = elem.hasValue() ? dynamic_cast<ExpressionList *>(&elem.getValue()) : nullptr)
+            listLengths.insert_or_assign(elem.getTarget().getIdentifier(), list->getExpressionPtrs().size());
+        else
+            listLengths.erase(elem.getTarget().getIdentifier());
+    }
+}
@@ -1,25 +1,46 @@
 #include "transpiration/ast/utils/scope.h"
 
 #include <iostream>
+#include <unordered_map>
 #include <utility>
 
-const ScopedIdentifier &Scope::resolveIdentifier(const std::string &id) const
+#include "transpiration/ast/utils/statistics.h"
+
+namespace
+{
+/// The table of the innermost SymbolTable::Context of this thread, if any
+thread_local std::shared_ptr<SymbolTable> contextSymbols;
+} // namespace
+
+const ScopedIdentifier *Scope::findIdentifier(const std::string &id) const
+{
+    CompilerStatistics::increment(Counter::IDENTIFIERS_RESOLVED);
+    return lookupSymbol(symbols->intern(id));
+}
+
+const ScopedIdentifier *Scope::lookupSymbol(uint32_t symbol) const
 {
     // go through scopes, starting from the current scope and then walking up (parent nodes), by looking for the given
-    // identifier
+    // symbol
     const Scope *curScope = this;
     while (curScope != nullptr)
     {
-        auto it = std::find_if(curScope->identifiers.begin(), curScope->identifiers.end(), [&id](const auto &p) {
-            return p->getId() == id;
-        });
+        auto it = curScope->identifiers.find(symbol);
         if (it != curScope->identifiers.end())
         {
-            return **it;
+            return it->second.get();
         }
         curScope = curScope->parent;
     }
+    return nullptr;
+}
 
+const ScopedIdentifier &Scope::resolveIdentifier(const std::string &id) const
+{
+    if (auto scopedIdentifier = findIdentifier(id))
+    {
+        return *scopedIdentifier;
+    }
     throw std::runtime_error("Identifier (" + id + ") cannot be resolved!");
 }
 
@@ -45,7 +66,9 @@ void Scope::addIdentifier(const std::string &id)
         // std::cout << "Adding " << id << " to scope " << this->getScopeName() << "( scope: " << this << ", node: " <<
         // astNode
         //           << ")" << std::endl;
-        identifiers.emplace(std::make_unique<ScopedIdentifier>(*this, id));
+        auto scopedIdentifier = std::make_unique<ScopedIdentifier>(*this, id);
+        auto symbol = scopedIdentifier->getSymbol();
+        identifiers.emplace(symbol, std::move(scopedIdentifier));
     } // else {
     // std::cout << "Adding " << id << " is ignored since already exits in scope " << this->getScopeName() << std::endl;
     // }
@@ -71,7 +94,8 @@ void Scope::addIdentifier(std::unique_ptr<ScopedIdentifier> &&scopedIdentifier)
         }
 
         // std::cout << "Adding " << scopedIdentifier->getId() << " to scope " << this->getScopeName() << std::endl;
-        identifiers.insert(std::move(scopedIdentifier));
+        auto symbol = scopedIdentifier->getSymbol();
+        identifiers.emplace(symbol, std::move(scopedIdentifier));
     } //  else {
     //  std::cout << "Adding " << scopedIdentifier->getId() << " is ignored since already exits in scope "
     //            << this->getScopeName() << std::endl;
@@ -101,25 +125,18 @@ AbstractNode *Scope::getNodePtr() const
 Scope *Scope::createNestedScope(Scope &parentScope, AbstractNode &scopeOpener)
 {
     // if a scope already exists, return it
-    for (auto &s : parentScope.nestedScopes)
+    auto it = parentScope.nestedScopesByCreator.find(&scopeOpener);
+    if (it != parentScope.nestedScopesByCreator.end())
     {
-        if (s->astNode == &scopeOpener)
-        {
-            // std::cout << "Not creating a scope for " << scopeOpener.getUniqueNodeId() << "(" << &scopeOpener << ") in
-            // scope "
-            //           << parentScope.getScopeName() << " (" << &parentScope << ") since one already exists." <<
-            //           std::endl;
-            return s.get();
-        }
+        return it->second;
     }
 
     // Alternatively, do create a new scope
     auto scope = std::make_unique<Scope>(scopeOpener);
     Scope *scopePtr = scope.get();
     scope->setParent(&parentScope);
-    scope->astNode = &scopeOpener;
-    // std::cout << "Creating a new scope " << scope->getScopeName() << " ( " << &scope << ") in "
-    //           << parentScope.getScopeName() << " (" << &parentScope << ")" << std::endl;
+    scope->symbols = parentScope.symbols;
+    parentScope.nestedScopesByCreator.emplace(&scopeOpener, scopePtr);
     parentScope.nestedScopes.push_back(std::move(scope));
     return scopePtr;
 }
@@ -129,8 +146,13 @@ void Scope::setParent(Scope *parentScope)
     Scope::parent = parentScope;
 }
 
-Scope::Scope(AbstractNode &abstractNode) : astNode(&abstractNode)
-{}
+std::atomic<uint64_t> Scope::scopeCounter{ 0 };
+
+Scope::Scope(AbstractNode &abstractNode)
+    : id(++scopeCounter), astNode(&abstractNode), symbols(SymbolTable::current())
+{
+    CompilerStatistics::increment(Counter::SCOPES_CREATED);
+}
 
 // Scope::Scope(const Scope &other) : astNode(other.astNode), parent(other.parent) {
 //
@@ -149,53 +171,44 @@ Scope::Scope(AbstractNode &abstractNode) : astNode(&abstractNode)
 
 bool Scope::identifierExists(const std::string &id) const
 {
-    const Scope *curScope = this;
-    while (curScope != nullptr)
-    {
-        auto it = std::find_if(curScope->identifiers.begin(), curScope->identifiers.end(), [&id](const auto &p) {
-            return p->getId() == id;
-        });
-        if (it != curScope->identifiers.end())
-        {
-            return true;
-        }
-        curScope = curScope->parent;
-    }
-    return false;
+    return lookupSymbol(symbols->intern(id)) != nullptr;
 }
 
 bool Scope::identifierIsLocal(const std::string &id) const
 {
-    // go through all identifiers that are declared in this scope and check whether the identifier matches the given one
-    return std::any_of(identifiers.begin(), identifiers.end(), [id](const auto &scopedIdentifier) {
-        return scopedIdentifier->getId() == id;
-    });
+    // only look at the identifiers that are declared in this scope
+    return identifiers.count(symbols->intern(id)) > 0;
 }
-std::string Scope::getScopeName() const
+
+const std::string &Scope::getScopeName() const
 {
-    if (astNode)
-        return astNode->getUniqueNodeId();
-    else
-        return "ScopeForNullptr";
+    // rendered on the first call only, later calls do not touch the node, which might be gone by then
+    if (name.empty())
+        name = astNode ? astNode->getUniqueNodeId() : "ScopeForNullptr";
+    return name;
+}
+
+SymbolTable &Scope::getSymbolTable() const
+{
+    return *symbols;
+}
+
+uint64_t Scope::getId() const
+{
+    return id;
 }
 
 Scope &Scope::getNestedScopeByCreator(AbstractNode &node)
 {
-    for (auto &scope : nestedScopes)
-    {
-        if (*scope->astNode == node)
-            return *scope;
-    }
-    throw std::runtime_error("Requested nested scope (created by " + node.getUniqueNodeId() + ") not found!");
+    // removes const from result of const counterpart, see https://stackoverflow.com/a/856839/3017719
+    return const_cast<Scope &>(const_cast<const Scope *>(this)->getNestedScopeByCreator(node));
 }
 
 const Scope &Scope::getNestedScopeByCreator(AbstractNode &node) const
 {
-    for (auto &scope : nestedScopes)
-    {
-        if (*scope->astNode == node)
-            return *scope;
-    }
+    auto it = nestedScopesByCreator.find(&node);
+    if (it != nestedScopesByCreator.end())
+        return *it->second;
     throw std::runtime_error("Requested nested scope (created by " + node.getUniqueNodeId() + ") not found!");
 }
 
@@ -211,13 +224,54 @@ const Scope &ScopedIdentifier::getScope() const
 
 const std::string &ScopedIdentifier::getId() const
 {
-    return id;
+    static const std::string empty;
+    return symbols ? symbols->name(symbol) : empty;
 }
 
-std::string &ScopedIdentifier::getId()
+uint64_t ScopedIdentifier::getScopeId() const
 {
-    return id;
+    return scopeId;
 }
 
-ScopedIdentifier::ScopedIdentifier(Scope &scope, std::string id) : scope(&scope), id(std::move(id))
+uint32_t ScopedIdentifier::getSymbol() const
+{
+    return symbol;
+}
+
+ScopedIdentifier::ScopedIdentifier(Scope &scope, std::string id)
+    : scope(&scope), symbols(&scope.getSymbolTable()), scopeId(scope.getId()),
+      symbol(scope.getSymbolTable().intern(id))
 {}
+
+uint32_t SymbolTable::intern(const std::string &id)
+{
+    auto it = symbols.find(id);
+    if (it != symbols.end())
+        return it->second;
+
+    auto symbol = static_cast<uint32_t>(names.size());
+    names.push_back(id);
+    symbols.emplace(id, symbol);
+    return symbol;
+}
+
+const std::string &SymbolTable::name(uint32_t symbol) const
+{
+    return names.at(symbol);
+}
+
+std::shared_ptr<SymbolTable> SymbolTable::current()
+{
+    static auto processSymbols = std::make_shared<SymbolTable>();
+    return contextSymbols ? contextSymbols : processSymbols;
+}
+
+SymbolTable::Context::Context() : previous(std::move(contextSymbols))
+{
+    contextSymbols = std::make_shared<SymbolTable>();
+}
+
+SymbolTable::Context::~Context()
+{
+    contextSymbols = std::move(previous);
+}
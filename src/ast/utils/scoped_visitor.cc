@@ -23,7 +23,7 @@
 
 void ScopedVisitor::visit(BinaryExpression &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(Block &elem)
@@ -35,12 +35,12 @@ void ScopedVisitor::visit(Block &elem)
 
 void ScopedVisitor::visit(Call &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(ExpressionList &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(For &elem)
@@ -60,7 +60,7 @@ void ScopedVisitor::visit(Function &elem)
 void ScopedVisitor::visit(FunctionParameter &elem)
 {
     getCurrentScope().addIdentifier(elem.getIdentifier());
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(If &elem)
@@ -72,73 +72,73 @@ void ScopedVisitor::visit(If &elem)
 
 void ScopedVisitor::visit(IndexAccess &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(LiteralBool &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(LiteralChar &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(LiteralInt &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(LiteralFloat &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(LiteralDouble &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(LiteralString &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(OperatorExpression &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(Return &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(TernaryOperator &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(UnaryExpression &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(Assignment &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(VariableDeclaration &elem)
 {
     getCurrentScope().addIdentifier(elem.getTarget().getIdentifier());
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visit(Variable &elem)
 {
-    visitChildren(elem);
+    traversal.deferChildren(elem, *this);
 }
 
 void ScopedVisitor::visitChildren(AbstractNode &elem)
@@ -161,10 +161,7 @@ void ScopedVisitor::visitChildren(AbstractNode &elem)
     }
     else
     {
-        for (auto &c : elem)
-        {
-            c.accept(*this);
-        }
+        traversal.visitChildren(elem, *this);
     }
 }
 
@@ -214,6 +211,27 @@ void ScopedVisitor::setRootScope(std::unique_ptr<Scope> &&scope)
     rootScope = std::move(scope);
 }
 
+const ScopedIdentifier *ScopedVisitor::findIdentifier(const Variable &variable) const
+{
+    if (rootScope)
+    {
+        if (auto binding = variable.getBinding(rootScope->getId()))
+        {
+            return binding;
+        }
+    }
+    return getCurrentScope().findIdentifier(variable.getIdentifier());
+}
+
+const ScopedIdentifier &ScopedVisitor::resolveIdentifier(const Variable &variable) const
+{
+    if (auto scopedIdentifier = findIdentifier(variable))
+    {
+        return *scopedIdentifier;
+    }
+    return getCurrentScope().resolveIdentifier(variable.getIdentifier());
+}
+
 void ScopedVisitor::overrideCurrentScope(Scope *scope)
 {
     currentScope = scope;
@@ -232,6 +250,11 @@ void ScopedVisitor::enterScope(AbstractNode &node)
     {
         // Root scope exists but no current one: set current scope to rootScope
         currentScope = rootScope.get();
+        // entering the node of the root scope again (e.g., with the root scope of another visitor) must not nest it
+        if (rootScope->getNodePtr() == &node)
+        {
+            return;
+        }
     }
     // create nested scope with current scope as parent
     currentScope = Scope::createNestedScope(getCurrentScope(), node);
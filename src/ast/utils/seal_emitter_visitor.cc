@@ -0,0 +1,1092 @@
+#include "transpiration/ast/utils/seal_emitter_visitor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/ciphertext_allocation_visitor.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// Collects the information about a function that is needed before its body can be translated
+/// \param node The node to scan (including its descendants)
+/// \param secret Identifiers of the variables declared secret
+/// \param indexed Identifiers of the variables that are accessed as x[i]
+/// \param lists Identifiers of the variables initialized with a list of values
+/// \param returns The Return statements
+void scanFunction(
+    AbstractNode &node, std::unordered_set<std::string> &secret, std::unordered_set<std::string> &indexed,
+    std::unordered_set<std::string> &lists, std::vector<Return *> &returns)
+{
+    auto scan = overloaded{
+        [&](VariableDeclaration &declaration) {
+            if (declaration.hasTarget() && declaration.getDatatype().getSecretFlag())
+                secret.insert(declaration.getTarget().getIdentifier());
+            if (declaration.hasTarget() && declaration.hasValue() &&
+                dynamic_cast<ExpressionList *>(&declaration.getValue()))
+                lists.insert(declaration.getTarget().getIdentifier());
+        },
+        [&secret](FunctionParameter &parameter) {
+            if (parameter.getParameterType().getSecretFlag())
+                secret.insert(parameter.getIdentifier());
+        },
+        [&indexed](IndexAccess &indexAccess) {
+            if (auto variable = indexAccess.hasTarget() ? dynamic_cast<Variable *>(&indexAccess.getTarget()) : nullptr)
+                indexed.insert(variable->getIdentifier());
+        },
+        [&returns](Return &returnStatement) { returns.push_back(&returnStatement); },
+        [](AbstractNode &) {}
+    };
+    walk(node, scan);
+}
+
+bool isVariable(AbstractExpression &expr, const std::string &identifier)
+{
+    auto variable = dynamic_cast<Variable *>(&expr);
+    return variable && variable->getIdentifier() == identifier;
+}
+
+/// Does the node (or any of its descendants) read the variable?
+bool readsVariable(AbstractNode &node, const std::string &identifier)
+{
+    bool reads = false;
+    walk(node, overloaded{ [&](Variable &variable) {
+                              reads = reads || variable.getIdentifier() == identifier;
+                              return !reads;
+                          },
+                           [&reads](AbstractNode &) { return !reads; } });
+    return reads;
+}
+
+/// rotate(x, k) with a Variable x and a literal integer k
+bool isLiteralRotation(Call &call)
+{
+    auto arguments = call.getArguments();
+    return call.getIdentifier() == "rotate" && arguments.size() == 2 &&
+           dynamic_cast<Variable *>(&arguments[0].get()) && dynamic_cast<LiteralInt *>(&arguments[1].get());
+}
+
+/// All literal rotations in the node (and its descendants)
+void collectRotations(AbstractNode &node, std::vector<Call *> &calls)
+{
+    walk(node, overloaded{ [&calls](Call &call) {
+                              if (isLiteralRotation(call))
+                                  calls.push_back(&call);
+                          },
+                           [](AbstractNode &) {} });
+}
+
+/// Identifiers of the ciphertext variables that occur in the node (and its descendants), without duplicates
+void collectCipherVariables(
+    AbstractNode &node, const std::unordered_set<std::string> &cipherVariables, std::vector<std::string> &variables)
+{
+    walk(node, overloaded{ [&](Variable &variable) {
+                              if (cipherVariables.count(variable.getIdentifier()) &&
+                                  std::find(variables.begin(), variables.end(), variable.getIdentifier()) ==
+                                      variables.end())
+                                  variables.push_back(variable.getIdentifier());
+                          },
+                           [](AbstractNode &) {} });
+}
+
+/// The HoistedRotator call that rotates the variable by all offsets
+std::string multiRotation(const std::string &variable, const std::vector<int> &offsets)
+{
+    std::string result = "runtime.rotator.rotate(" + variable + ", { ";
+    for (size_t i = 0; i < offsets.size(); ++i)
+        result += (i == 0 ? "" : ", ") + std::to_string(offsets[i]);
+    return result + " }, runtime.pool)";
+}
+
+/// A depend clause of an OpenMP task, or an empty string if there are no variables
+std::string dependClause(const std::string &type, const std::vector<std::string> &variables)
+{
+    if (variables.empty())
+        return "";
+    std::string result = " depend(" + type + ": ";
+    for (size_t i = 0; i < variables.size(); ++i)
+        result += (i == 0 ? "" : ", ") + variables[i];
+    return result + ")";
+}
+
+/// The C++ operator that computes op on plain values
+std::string cppOperator(const Operator &op)
+{
+    if (op == Operator(FHE_ADDITION))
+        return "+";
+    if (op == Operator(FHE_SUBTRACTION))
+        return "-";
+    if (op == Operator(FHE_MULTIPLICATION))
+        return "*";
+    return op.toString();
+}
+
+std::string quote(const std::string &value, char quotationMark)
+{
+    std::string result(1, quotationMark);
+    for (auto c : value)
+    {
+        if (c == '\\' || c == quotationMark)
+            result += '\\';
+        if (c == '\n')
+            result += "\\n";
+        else
+            result += c;
+    }
+    return result + quotationMark;
+}
+} // namespace
+
+SpecialSealEmitterVisitor::SpecialSealEmitterVisitor(
+    std::ostream &os, ParameterSpec spec, bool parallel, bool mockRuntime)
+    : os(os), spec(std::move(spec)), parallel(parallel), mockRuntime(mockRuntime)
+{}
+
+std::string SpecialSealEmitterVisitor::getIndentation() const
+{
+    return std::string(4 * indentationLevel, ' ');
+}
+
+std::string SpecialSealEmitterVisitor::slotType() const
+{
+    return (spec.scheme == ParameterSpec::Scheme::CKKS) ? "double" : "int64_t";
+}
+
+std::string SpecialSealEmitterVisitor::plainType(const Datatype &datatype, bool array) const
+{
+    static const std::unordered_map<Type, std::string> scalarTypes = {
+        { Type::BOOL, "bool" },     { Type::CHAR, "char" },          { Type::INT, "int64_t" }, { Type::FLOAT, "float" },
+        { Type::DOUBLE, "double" }, { Type::STRING, "std::string" }, { Type::VOID, "void" }
+    };
+    if (!array)
+        return scalarTypes.at(datatype.getType());
+
+    // arrays are encoded into plaintexts, which only takes integers (BFV) or doubles (CKKS)
+    if (datatype.getType() == Type::FLOAT || datatype.getType() == Type::DOUBLE)
+        return "std::vector<double>";
+    if (datatype.getType() == Type::STRING)
+        return "std::vector<std::string>";
+    return "std::vector<int64_t>";
+}
+
+bool SpecialSealEmitterVisitor::isCipher(AbstractExpression &expr)
+{
+    auto cached = cipherExpressions.find(&expr);
+    if (cached != cipherExpressions.end())
+        return cached->second;
+
+    // bottom-up, skipping the subexpressions that are known already
+    walk(
+        expr, [this](AbstractNode &node) { return !cipherExpressions.count(&node); },
+        [this](auto &node) {
+            bool cipher = false;
+            if constexpr (std::is_same_v<std::remove_reference_t<decltype(node)>, Variable>)
+                cipher = cipherVariables.count(node.getIdentifier()) > 0;
+            else
+                forEachChild(node, [&](AbstractNode &child) { cipher = cipher || cipherExpressions.at(&child); });
+            cipherExpressions.emplace(&node, cipher);
+        });
+    return cipherExpressions.at(&expr);
+}
+
+std::string SpecialSealEmitterVisitor::plainExpression(AbstractExpression &expr)
+{
+    // every subexpression of a plain expression is plain
+    if (isCipher(expr))
+        throw runtime_error("Cannot use the secret expression " + expr.toString(false) + " as a plain value.");
+
+    // the parts that remain to be written, the next one on top: a subexpression or text (if expression is nullptr),
+    // since unrolled programs nest expressions too deep to translate them recursively
+    struct Part
+    {
+        AbstractExpression *expression;
+        std::string text;
+    };
+    std::vector<Part> parts{ { &expr, "" } };
+    std::string result;
+    while (!parts.empty())
+    {
+        auto part = std::move(parts.back());
+        parts.pop_back();
+        if (!part.expression)
+        {
+            result += part.text;
+            continue;
+        }
+
+        auto &e = *part.expression;
+        std::vector<Part> expansion;
+        if (auto literal = dynamic_cast<LiteralBool *>(&e))
+        {
+            result += literal->getValue() ? "true" : "false";
+        }
+        else if (auto literal = dynamic_cast<LiteralChar *>(&e))
+        {
+            result += quote(std::string(1, literal->getValue()), '\'');
+        }
+        else if (auto literal = dynamic_cast<LiteralInt *>(&e))
+        {
+            result += std::to_string(literal->getValue());
+        }
+        else if (auto literal = dynamic_cast<LiteralString *>(&e))
+        {
+            result += quote(literal->getValue(), '"');
+        }
+        else if (dynamic_cast<LiteralFloat *>(&e) || dynamic_cast<LiteralDouble *>(&e))
+        {
+            std::ostringstream ss;
+            ss.precision(17);
+            if (auto literal = dynamic_cast<LiteralFloat *>(&e))
+                ss << literal->getValue();
+            else
+                ss << dynamic_cast<LiteralDouble &>(e).getValue();
+            auto value = ss.str();
+            bool integral = value.find_first_of(".en") == std::string::npos;
+            result += integral ? value + ".0" : value;
+        }
+        else if (auto variable = dynamic_cast<Variable *>(&e))
+        {
+            result += variable->getIdentifier();
+        }
+        else if (auto binaryExpression = dynamic_cast<BinaryExpression *>(&e))
+        {
+            expansion = { { nullptr, "(" },
+                          { &binaryExpression->getLeft(), "" },
+                          { nullptr, " " + cppOperator(binaryExpression->getOperator()) + " " },
+                          { &binaryExpression->getRight(), "" },
+                          { nullptr, ")" } };
+        }
+        else if (auto unaryExpression = dynamic_cast<UnaryExpression *>(&e))
+        {
+            expansion = { { nullptr, unaryExpression->getOperator().toString() },
+                          { &unaryExpression->getOperand(), "" } };
+        }
+        else if (auto indexAccess = dynamic_cast<IndexAccess *>(&e))
+        {
+            expansion = { { &indexAccess->getTarget(), "" },
+                          { nullptr, "[" },
+                          { &indexAccess->getIndex(), "" },
+                          { nullptr, "]" } };
+        }
+        else if (auto ternary = dynamic_cast<TernaryOperator *>(&e))
+        {
+            expansion = { { nullptr, "(" },
+                          { &ternary->getCondition(), "" },
+                          { nullptr, " ? " },
+                          { &ternary->getThenExpr(), "" },
+                          { nullptr, " : " },
+                          { &ternary->getElseExpr(), "" },
+                          { nullptr, ")" } };
+        }
+        else if (auto call = dynamic_cast<Call *>(&e))
+        {
+            expansion.push_back({ nullptr, call->getIdentifier() + "(" });
+            auto arguments = call->getArguments();
+            for (size_t i = 0; i < arguments.size(); ++i)
+            {
+                if (i > 0)
+                    expansion.push_back({ nullptr, ", " });
+                expansion.push_back({ &arguments[i].get(), "" });
+            }
+            expansion.push_back({ nullptr, ")" });
+        }
+        else if (auto list = dynamic_cast<ExpressionList *>(&e))
+        {
+            expansion.push_back({ nullptr, "{ " });
+            auto &expressions = list->getExpressionPtrs();
+            for (size_t i = 0; i < expressions.size(); ++i)
+            {
+                if (!expressions[i])
+                    throw runtime_error("Cannot translate a list with missing values.");
+                if (i > 0)
+                    expansion.push_back({ nullptr, ", " });
+                expansion.push_back({ expressions[i].get(), "" });
+            }
+            expansion.push_back({ nullptr, " }" });
+        }
+        else
+        {
+            throw runtime_error("Cannot translate the expression " + e.toString(false) + " to C++.");
+        }
+        std::move(expansion.rbegin(), expansion.rend(), std::back_inserter(parts));
+    }
+    return result;
+}
+
+std::string SpecialSealEmitterVisitor::encodable(AbstractExpression &expr)
+{
+    if (auto variable = dynamic_cast<Variable *>(&expr))
+    {
+        if (plainArrays.count(variable->getIdentifier()))
+            return variable->getIdentifier();
+    }
+    if (dynamic_cast<ExpressionList *>(&expr))
+        return "std::vector<" + slotType() + ">" + plainExpression(expr);
+    return "static_cast<" + slotType() + ">(" + plainExpression(expr) + ")";
+}
+
+std::string SpecialSealEmitterVisitor::acquireTemporary()
+{
+    temporaryCount = std::max(temporaryCount, temporaryDepth + 1);
+    return "__t_" + std::to_string(temporaryDepth++);
+}
+
+std::string SpecialSealEmitterVisitor::hoistedRotation(Call &call)
+{
+    auto [groupIndex, offsetIndex] = hoistedRotations.at(call.getUniqueNodeId());
+    auto &group = rotationGroups[groupIndex];
+    if (!group.declared)
+    {
+        code << getIndentation() << "auto " << group.identifier << " = " << multiRotation(group.variable, group.offsets)
+             << ";\n";
+        group.declared = true;
+    }
+    return group.identifier + "[" + std::to_string(offsetIndex) + "]";
+}
+
+std::string SpecialSealEmitterVisitor::directOperand(AbstractExpression &expr)
+{
+    if (auto variable = dynamic_cast<Variable *>(&expr))
+        return variable->getIdentifier();
+    auto call = dynamic_cast<Call *>(&expr);
+    if (call && hoistedRotations.count(call->getUniqueNodeId()))
+        return hoistedRotation(*call);
+
+    // slot 0 of a ciphertext is the ciphertext itself
+    auto indexAccess = dynamic_cast<IndexAccess *>(&expr);
+    auto index = indexAccess ? dynamic_cast<LiteralInt *>(&indexAccess->getIndex()) : nullptr;
+    if (index && index->getValue() == 0 && dynamic_cast<Variable *>(&indexAccess->getTarget()))
+        return dynamic_cast<Variable &>(indexAccess->getTarget()).getIdentifier();
+    return "";
+}
+
+std::string SpecialSealEmitterVisitor::cipherOperand(AbstractExpression &expr)
+{
+    auto operand = directOperand(expr);
+    if (!operand.empty())
+        return operand;
+
+    auto temporary = acquireTemporary();
+    emitCipherInto(expr, temporary);
+    return temporary;
+}
+
+void SpecialSealEmitterVisitor::emitBinaryInplace(
+    const Operator &op, AbstractExpression &operand, const std::string &destination, std::vector<EmitStep> &steps)
+{
+    bool ckks = (spec.scheme == ParameterSpec::Scheme::CKKS);
+    bool multiplication = (op == Operator(MULTIPLICATION) || op == Operator(FHE_MULTIPLICATION));
+    std::string name = "add";
+    if (multiplication)
+        name = "multiply";
+    else if (op == Operator(SUBTRACTION) || op == Operator(FHE_SUBTRACTION))
+        name = "sub";
+
+    if (!isCipher(operand))
+    {
+        code << getIndentation() << "runtime.evaluator." << name << "_plain_inplace(" << destination
+             << ", runtime.encode(" << encodable(operand) << ", " << destination << ")"
+             << (multiplication ? ", runtime.pool" : "") << ");\n";
+        if (multiplication && ckks)
+            code << getIndentation() << "runtime.evaluator.rescale_to_next_inplace(" << destination
+                 << ", runtime.pool);\n";
+        return;
+    }
+
+    // a nested operand is computed into a scratch ciphertext first
+    auto depth = temporaryDepth;
+    AbstractExpression *nested = nullptr;
+    std::string operandVariable;
+    if (!multiplication || !isVariable(operand, destination))
+    {
+        operandVariable = directOperand(operand);
+        if (operandVariable.empty())
+        {
+            nested = &operand;
+            operandVariable = acquireTemporary();
+        }
+    }
+
+    std::ostringstream statements;
+    if (operandVariable.empty())
+    {
+        statements << getIndentation() << "runtime.evaluator.square_inplace(" << destination << ", runtime.pool);\n";
+    }
+    else
+    {
+        if (ckks)
+            statements << getIndentation() << "runtime.align(" << destination << ", " << operandVariable << ");\n";
+        statements << getIndentation() << "runtime.evaluator." << name << "_inplace(" << destination << ", "
+                   << operandVariable << (multiplication ? ", runtime.pool" : "") << ");\n";
+    }
+    if (multiplication)
+    {
+        statements << getIndentation() << "runtime.evaluator.relinearize_inplace(" << destination
+                   << ", runtime.relinKeys, runtime.pool);\n";
+        if (ckks)
+            statements << getIndentation() << "runtime.evaluator.rescale_to_next_inplace(" << destination
+                       << ", runtime.pool);\n";
+    }
+
+    if (!nested)
+    {
+        code << statements.str();
+        return;
+    }
+    // the statements follow the operand and release its scratch ciphertext
+    steps.push_back(EmitStep::write(statements.str(), depth));
+    steps.push_back(EmitStep::compute(*nested, operandVariable));
+}
+
+void SpecialSealEmitterVisitor::emitRotation(
+    AbstractExpression &source, AbstractExpression &offset, const std::string &destination,
+    std::vector<EmitStep> &steps)
+{
+    auto literal = dynamic_cast<LiteralInt *>(&offset);
+    if (literal && literal->getValue() == 0)
+    {
+        steps.push_back(EmitStep::compute(source, destination));
+        return;
+    }
+
+    auto offsetExpression = literal ? plainExpression(offset) : "static_cast<int>(" + plainExpression(offset) + ")";
+    auto variable = dynamic_cast<Variable *>(&source);
+    if (variable && variable->getIdentifier() != destination)
+    {
+        code << getIndentation() << "runtime.rotate(" << variable->getIdentifier() << ", " << offsetExpression << ", "
+             << destination << ");\n";
+    }
+    else
+    {
+        // rotate the source once it has been computed into the destination
+        steps.push_back(EmitStep::write(
+            getIndentation() + "runtime.rotateInplace(" + destination + ", " + offsetExpression + ");\n",
+            temporaryDepth));
+        steps.push_back(EmitStep::compute(source, destination));
+    }
+}
+
+void SpecialSealEmitterVisitor::emitCipherInto(AbstractExpression &expr, const std::string &destination)
+{
+    std::vector<EmitStep> steps{ EmitStep::compute(expr, destination) };
+    while (!steps.empty())
+    {
+        auto step = std::move(steps.back());
+        steps.pop_back();
+        switch (step.kind)
+        {
+        case EmitStep::COMPUTE:
+            computeInto(*step.expression, step.destination, steps);
+            break;
+        case EmitStep::APPLY:
+            emitBinaryInplace(*step.op, *step.expression, step.destination, steps);
+            break;
+        case EmitStep::TEXT:
+            code << step.text;
+            temporaryDepth = step.depth;
+            break;
+        }
+    }
+}
+
+void SpecialSealEmitterVisitor::computeInto(
+    AbstractExpression &expr, const std::string &destination, std::vector<EmitStep> &steps)
+{
+    if (!isCipher(expr))
+    {
+        code << getIndentation() << destination << " = runtime.encrypt(" << encodable(expr) << ");\n";
+    }
+    else if (auto variable = dynamic_cast<Variable *>(&expr))
+    {
+        if (variable->getIdentifier() != destination)
+            code << getIndentation() << destination << " = " << variable->getIdentifier() << ";\n";
+    }
+    else if (auto call = dynamic_cast<Call *>(&expr))
+    {
+        auto arguments = call->getArguments();
+        if (hoistedRotations.count(call->getUniqueNodeId()))
+        {
+            auto rotation = hoistedRotation(*call);
+            code << getIndentation() << destination << " = " << rotation << ";\n";
+        }
+        else if (call->getIdentifier() == "rotate" && arguments.size() == 2)
+        {
+            emitRotation(arguments[0].get(), arguments[1].get(), destination, steps);
+        }
+        else
+        {
+            throw runtime_error("Cannot call " + call->getIdentifier() + " on secret arguments.");
+        }
+    }
+    else if (auto indexAccess = dynamic_cast<IndexAccess *>(&expr))
+    {
+        // slot k of a ciphertext, which the lowering passes only read as a scalar, i.e., from slot 0
+        emitRotation(indexAccess->getTarget(), indexAccess->getIndex(), destination, steps);
+    }
+    else if (auto unaryExpression = dynamic_cast<UnaryExpression *>(&expr))
+    {
+        if (!(unaryExpression->getOperator() == Operator(LOGICAL_NOT)))
+            throw runtime_error("Cannot apply " + unaryExpression->getOperator().toString() + " to a secret value.");
+
+        // !x = 1 - x for secret booleans in {0, 1}
+        steps.push_back(EmitStep::write(
+            getIndentation() + "runtime.evaluator.negate_inplace(" + destination + ");\n" + getIndentation() +
+                "runtime.evaluator.add_plain_inplace(" + destination + ", runtime.encode(static_cast<" + slotType() +
+                ">(1), " + destination + "));\n",
+            temporaryDepth));
+        steps.push_back(EmitStep::compute(unaryExpression->getOperand(), destination));
+    }
+    else if (auto binaryExpression = dynamic_cast<BinaryExpression *>(&expr))
+    {
+        auto &op = binaryExpression->getOperator();
+        bool subtraction = (op == Operator(SUBTRACTION) || op == Operator(FHE_SUBTRACTION));
+        bool supported = subtraction || op == Operator(ADDITION) || op == Operator(FHE_ADDITION) ||
+                         op == Operator(MULTIPLICATION) || op == Operator(FHE_MULTIPLICATION);
+        if (!supported)
+        {
+            throw runtime_error(
+                "The secret expression " + expr.toString(false) + " must be lowered before emitting SEAL code.");
+        }
+
+        auto *left = &binaryExpression->getLeft();
+        auto *right = &binaryExpression->getRight();
+        if (!isCipher(*left) && subtraction)
+        {
+            // c - x = -x + c
+            steps.push_back(EmitStep::write(
+                getIndentation() + "runtime.evaluator.negate_inplace(" + destination + ");\n" + getIndentation() +
+                    "runtime.evaluator.add_plain_inplace(" + destination + ", runtime.encode(" + encodable(*left) +
+                    ", " + destination + "));\n",
+                temporaryDepth));
+            steps.push_back(EmitStep::compute(*right, destination));
+            return;
+        }
+        bool swap = !isCipher(*left) ||
+                    (!subtraction && isVariable(*right, destination) && !isVariable(*left, destination));
+        if (swap)
+            std::swap(left, right);
+
+        // computing the left operand into the destination would overwrite a value the right operand still needs
+        // (scratch ciphertexts are never read by the function's expressions)
+        if (variableIdentifiers.count(destination) && readsVariable(*right, destination) &&
+            !isVariable(*left, destination))
+        {
+            auto depth = temporaryDepth;
+            auto temporary = acquireTemporary();
+            steps.push_back(
+                EmitStep::write(getIndentation() + "std::swap(" + destination + ", " + temporary + ");\n", depth));
+            steps.push_back(EmitStep::compute(expr, temporary));
+            return;
+        }
+
+        // the right operand is applied once the left one has been computed into the destination
+        steps.push_back(EmitStep::apply(op, *right, destination));
+        steps.push_back(EmitStep::compute(*left, destination));
+    }
+    else
+    {
+        throw runtime_error("Cannot translate the secret expression " + expr.toString(false) + " to SEAL code.");
+    }
+}
+
+size_t SpecialSealEmitterVisitor::findRotationGroups(Block &block, size_t first)
+{
+    auto &statements = block.getStatementPointers();
+
+    // the entry in rotationGroups of every planned group that occurs in the straight-line code
+    std::unordered_map<size_t, size_t> groupIndices;
+
+    size_t end = first;
+    for (; end < statements.size(); ++end)
+    {
+        auto statement = statements[end].get();
+        if (!statement)
+            continue;
+        if (!dynamic_cast<Assignment *>(statement) && !dynamic_cast<VariableDeclaration *>(statement) &&
+            !dynamic_cast<Return *>(statement))
+            break;
+
+        std::vector<Call *> calls;
+        collectRotations(*statement, calls);
+        for (auto call : calls)
+        {
+            auto plannedGroup = plannedRotations.find(call->getUniqueNodeId());
+            auto variable = dynamic_cast<Variable &>(call->getArguments()[0].get()).getIdentifier();
+            if (plannedGroup == plannedRotations.end() || !cipherVariables.count(variable))
+                continue;
+            auto offset = dynamic_cast<LiteralInt &>(call->getArguments()[1].get()).getValue();
+
+            if (!groupIndices.count(plannedGroup->second))
+            {
+                groupIndices[plannedGroup->second] = rotationGroups.size();
+                auto groupIdentifier = variable + "__rotations_" + std::to_string(groupCounter++);
+                rotationGroups.push_back({ variable, {}, groupIdentifier });
+            }
+            auto groupIndex = groupIndices[plannedGroup->second];
+            auto &offsets = rotationGroups[groupIndex].offsets;
+            auto offsetIndex = std::find(offsets.begin(), offsets.end(), offset) - offsets.begin();
+            if (offsetIndex == static_cast<long>(offsets.size()))
+                offsets.push_back(offset);
+            hoistedRotations[call->getUniqueNodeId()] = { groupIndex, offsetIndex };
+            rotationGroups[groupIndex].lastStatement = statement;
+        }
+    }
+    return end;
+}
+
+void SpecialSealEmitterVisitor::emitStatements(Block &block)
+{
+    auto &statements = block.getStatementPointers();
+    size_t straightLineEnd = 0;
+    for (size_t i = 0; i < statements.size(); ++i)
+    {
+        if (i >= straightLineEnd)
+            straightLineEnd = std::max(findRotationGroups(block, i), i + 1);
+        if (!statements[i])
+            continue;
+
+        if (parallel && isCipherStatement(statements[i].get()))
+        {
+            auto end = i + 1;
+            while (end < statements.size() && isCipherStatement(statements[end].get()))
+                ++end;
+            if (end - i > 1 && emitTaskGraph(block, i, end))
+            {
+                i = end - 1;
+                continue;
+            }
+        }
+        statements[i]->accept(*this);
+
+        for (auto &group : rotationGroups)
+        {
+            if (group.declared && group.lastStatement == statements[i].get())
+                code << getIndentation() << group.identifier << ".clear();\n";
+        }
+    }
+}
+
+bool SpecialSealEmitterVisitor::isCipherStatement(AbstractStatement *statement)
+{
+    if (auto assignment = dynamic_cast<Assignment *>(statement))
+    {
+        auto variable = dynamic_cast<Variable *>(&assignment->getTarget());
+        return variable && cipherVariables.count(variable->getIdentifier());
+    }
+    auto declaration = dynamic_cast<VariableDeclaration *>(statement);
+    return declaration && declaration->hasValue() && cipherVariables.count(declaration->getTarget().getIdentifier());
+}
+
+bool SpecialSealEmitterVisitor::emitTaskGraph(Block &block, size_t first, size_t end)
+{
+    struct Task
+    {
+        AbstractStatement *statement;
+        size_t group;
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+    };
+
+    // one task per statement, preceded by one task per group of rotations that is first used by the statement
+    auto &statements = block.getStatementPointers();
+    std::vector<Task> tasks;
+    std::vector<size_t> groups;
+    for (size_t i = first; i < end; ++i)
+    {
+        auto statement = statements[i].get();
+        Task task = { statement, 0, {}, {} };
+        std::vector<Call *> calls;
+        collectRotations(*statement, calls);
+        for (auto call : calls)
+        {
+            auto hoisted = hoistedRotations.find(call->getUniqueNodeId());
+            if (hoisted == hoistedRotations.end())
+                continue;
+            auto groupIndex = hoisted->second.first;
+            auto &group = rotationGroups[groupIndex];
+            if (std::find(task.reads.begin(), task.reads.end(), group.identifier) == task.reads.end())
+                task.reads.push_back(group.identifier);
+            if (!group.declared && std::find(groups.begin(), groups.end(), groupIndex) == groups.end())
+            {
+                groups.push_back(groupIndex);
+                tasks.push_back({ nullptr, groupIndex, { group.variable }, { group.identifier } });
+            }
+        }
+
+        auto assignment = dynamic_cast<Assignment *>(statement);
+        auto &value = assignment ? assignment->getValue() : dynamic_cast<VariableDeclaration *>(statement)->getValue();
+        auto &target = assignment ? dynamic_cast<Variable &>(assignment->getTarget())
+                                  : dynamic_cast<VariableDeclaration *>(statement)->getTarget();
+        collectCipherVariables(value, cipherVariables, task.reads);
+        task.writes.push_back(target.getIdentifier());
+
+        // aligning the levels of CKKS ciphertexts modifies the operands as well
+        if (spec.scheme == ParameterSpec::Scheme::CKKS)
+        {
+            for (auto &read : task.reads)
+            {
+                if (std::find(task.writes.begin(), task.writes.end(), read) == task.writes.end())
+                    task.writes.push_back(read);
+            }
+        }
+        tasks.push_back(task);
+    }
+
+    // the longest path through the dependency DAG (read after write, write after read and write after write)
+    std::unordered_map<std::string, size_t> lastWriter;
+    std::unordered_map<std::string, std::vector<size_t>> readers;
+    std::vector<size_t> depths(tasks.size(), 1);
+    size_t longestPath = 0;
+    for (size_t t = 0; t < tasks.size(); ++t)
+    {
+        auto dependOn = [&](size_t predecessor) { depths[t] = std::max(depths[t], depths[predecessor] + 1); };
+        for (auto &read : tasks[t].reads)
+        {
+            if (lastWriter.count(read))
+                dependOn(lastWriter[read]);
+        }
+        for (auto &write : tasks[t].writes)
+        {
+            if (lastWriter.count(write))
+                dependOn(lastWriter[write]);
+            for (auto reader : readers[write])
+                dependOn(reader);
+        }
+        for (auto &read : tasks[t].reads)
+            readers[read].push_back(t);
+        for (auto &write : tasks[t].writes)
+        {
+            lastWriter[write] = t;
+            readers[write].clear();
+        }
+        longestPath = std::max(longestPath, depths[t]);
+    }
+    if (longestPath == tasks.size())
+        return false;
+
+    for (auto groupIndex : groups)
+    {
+        code << getIndentation() << "std::vector<seal::Ciphertext> " << rotationGroups[groupIndex].identifier << ";\n";
+        rotationGroups[groupIndex].declared = true;
+    }
+    code << getIndentation() << "#pragma omp parallel num_threads(runtime.threads) if (runtime.threads > 1)\n";
+    code << getIndentation() << "#pragma omp single\n";
+    code << getIndentation() << "{\n";
+    ++indentationLevel;
+    for (auto &task : tasks)
+    {
+        std::vector<std::string> inputs;
+        for (auto &read : task.reads)
+        {
+            if (std::find(task.writes.begin(), task.writes.end(), read) == task.writes.end())
+                inputs.push_back(read);
+        }
+        code << getIndentation() << "#pragma omp task" << dependClause("in", inputs)
+             << dependClause("inout", task.writes) << "\n";
+        code << getIndentation() << "{\n";
+        ++indentationLevel;
+        if (!task.statement)
+        {
+            auto &group = rotationGroups[task.group];
+            code << getIndentation() << group.identifier << " = " << multiRotation(group.variable, group.offsets)
+                 << ";\n";
+        }
+        else
+        {
+            // the scratch ciphertexts are private to the task
+            auto outer = code.str();
+            auto outerDepth = temporaryDepth;
+            auto outerCount = temporaryCount;
+            code.str("");
+            temporaryDepth = 0;
+            temporaryCount = 0;
+            task.statement->accept(*this);
+            auto body = code.str();
+            code.str(outer);
+            code.seekp(0, std::ios_base::end);
+            for (size_t i = 0; i < temporaryCount; ++i)
+                code << getIndentation() << "seal::Ciphertext __t_" << i << " = runtime.allocate();\n";
+            code << body;
+            temporaryDepth = outerDepth;
+            temporaryCount = outerCount;
+        }
+        --indentationLevel;
+        code << getIndentation() << "}\n";
+    }
+    --indentationLevel;
+    code << getIndentation() << "}\n";
+
+    for (auto &group : rotationGroups)
+    {
+        auto last = std::find_if(statements.begin() + first, statements.begin() + end, [&](auto &statement) {
+            return statement.get() == group.lastStatement;
+        });
+        if (group.declared && last != statements.begin() + end)
+            code << getIndentation() << group.identifier << ".clear();\n";
+    }
+    return true;
+}
+
+void SpecialSealEmitterVisitor::visit(Assignment &elem)
+{
+    auto &target = elem.getTarget();
+    if (auto variable = dynamic_cast<Variable *>(&target); variable && cipherVariables.count(variable->getIdentifier()))
+    {
+        emitCipherInto(elem.getValue(), variable->getIdentifier());
+    }
+    else if (isCipher(target))
+    {
+        throw runtime_error(
+            "Cannot assign to a single slot in " + target.toString(false) + ", it must be lowered to a mask first.");
+    }
+    else
+    {
+        code << getIndentation() << plainExpression(target) << " = " << plainExpression(elem.getValue()) << ";\n";
+    }
+}
+
+void SpecialSealEmitterVisitor::visit(Block &elem)
+{
+    // a block of Functions is a translation unit
+    auto &statements = elem.getStatementPointers();
+    if (std::any_of(statements.begin(), statements.end(), [](auto &s) { return dynamic_cast<Function *>(s.get()); }))
+    {
+        emitStatements(elem);
+        return;
+    }
+
+    code << getIndentation() << "{\n";
+    ++indentationLevel;
+    emitStatements(elem);
+    --indentationLevel;
+    code << getIndentation() << "}\n";
+}
+
+void SpecialSealEmitterVisitor::visit(For &elem)
+{
+    if (elem.hasCondition() && isCipher(elem.getCondition()))
+        throw runtime_error("Loops with a secret condition cannot be translated.");
+
+    // for (init; cond; update) { body } becomes { init; for (; cond;) { body update } }
+    code << getIndentation() << "{\n";
+    ++indentationLevel;
+    if (elem.hasInitializer())
+        emitStatements(elem.getInitializer());
+    auto condition = elem.hasCondition() ? plainExpression(elem.getCondition()) : "";
+    code << getIndentation() << "for (; " << condition << ";)\n";
+    code << getIndentation() << "{\n";
+    ++indentationLevel;
+    if (elem.hasBody())
+        emitStatements(elem.getBody());
+    if (elem.hasUpdate())
+        emitStatements(elem.getUpdate());
+    --indentationLevel;
+    code << getIndentation() << "}\n";
+    --indentationLevel;
+    code << getIndentation() << "}\n";
+}
+
+void SpecialSealEmitterVisitor::emitPrologue()
+{
+    if (prologueEmitted)
+        return;
+
+    os << "#include <cstdint>\n"
+       << "#include <string>\n"
+       << "#include <utility>\n"
+       << "#include <vector>\n\n";
+    if (mockRuntime)
+    {
+        // the simulated types stand in for SEAL's, so that the code below is the same for both
+        os << "#include \"transpiration/runtime/mock/mock_runtime.h\"\n\n"
+           << "namespace seal = mock;\n"
+           << "typedef MockRuntime SealRuntime;\n";
+    }
+    else
+    {
+        os << "#include \"seal/seal.h\"\n"
+           << "#include \"transpiration/runtime/seal/seal_runtime.h\"\n";
+    }
+    prologueEmitted = true;
+}
+
+void SpecialSealEmitterVisitor::omitPrologue()
+{
+    prologueEmitted = true;
+}
+
+void SpecialSealEmitterVisitor::setRotationGroups(const std::vector<std::vector<std::string>> &groups)
+{
+    plannedRotations.clear();
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        for (auto &call : groups[i])
+            plannedRotations[call] = i;
+    }
+}
+
+void SpecialSealEmitterVisitor::visit(Function &elem)
+{
+    emitPrologue();
+
+    auto identifier = elem.getIdentifier();
+    bool ckks = (spec.scheme == ParameterSpec::Scheme::CKKS);
+    auto degree = std::to_string(spec.polyModulusDegree);
+    os << "\nseal::EncryptionParameters " << identifier << "_parameters()\n{\n";
+    os << "    seal::EncryptionParameters parameters(seal::scheme_type::" << (ckks ? "ckks" : "bfv") << ");\n";
+    os << "    parameters.set_poly_modulus_degree(" << degree << ");\n";
+    if (ckks)
+    {
+        os << "    parameters.set_coeff_modulus(seal::CoeffModulus::Create(" << degree << ", { ";
+        for (size_t i = 0; i < spec.coeffModulusBits.size(); ++i)
+            os << (i == 0 ? "" : ", ") << spec.coeffModulusBits[i];
+        os << " }));\n";
+    }
+    else
+    {
+        os << "    parameters.set_coeff_modulus(seal::CoeffModulus::BFVDefault(" << degree << "));\n";
+        os << "    parameters.set_plain_modulus(seal::PlainModulus::Batching(" << degree << ", "
+           << spec.plainModulusBits << "));\n";
+    }
+    os << "    return parameters;\n}\n";
+    if (ckks)
+        os << "\nconst double " << identifier << "_scale = static_cast<double>(1ULL << " << spec.scaleBits << ");\n";
+
+    std::unordered_set<std::string> indexed;
+    std::unordered_set<std::string> lists;
+    std::vector<Return *> returns;
+    cipherVariables.clear();
+    cipherExpressions.clear();
+    rotationGroups.clear();
+    hoistedRotations.clear();
+    scanFunction(elem, cipherVariables, indexed, lists, returns);
+    plainArrays.clear();
+    for (auto &variable : indexed)
+    {
+        if (!cipherVariables.count(variable))
+            plainArrays.insert(variable);
+    }
+    for (auto &variable : lists)
+    {
+        if (!cipherVariables.count(variable))
+            plainArrays.insert(variable);
+    }
+
+    cipherResult = elem.getReturnType().getSecretFlag();
+    bool arrayResult = false;
+    for (auto returnStatement : returns)
+    {
+        if (!returnStatement->hasValue())
+            continue;
+        cipherResult = cipherResult || isCipher(returnStatement->getValue());
+        auto variable = dynamic_cast<Variable *>(&returnStatement->getValue());
+        arrayResult = arrayResult || (variable && plainArrays.count(variable->getIdentifier()));
+    }
+
+    os << "\n" << (cipherResult ? "seal::Ciphertext" : plainType(elem.getReturnType(), arrayResult)) << " "
+       << identifier << "(SealRuntime &runtime";
+    size_t cipherParameters = 0;
+    for (auto &parameter : elem.getParameters())
+    {
+        auto parameterIdentifier = parameter.get().getIdentifier();
+        os << ", ";
+        if (cipherVariables.count(parameterIdentifier))
+        {
+            os << "seal::Ciphertext";
+            ++cipherParameters;
+        }
+        else
+        {
+            os << plainType(parameter.get().getParameterType(), plainArrays.count(parameterIdentifier) > 0);
+        }
+        os << " " << parameterIdentifier;
+    }
+    os << ")\n{\n";
+
+    // from here on, the ciphertext variables are their buffers
+    CiphertextAllocationVisitor allocation(cipherVariables);
+    elem.accept(allocation);
+    auto &buffers = allocation.allocate();
+    allocation.assignBuffers();
+    cipherVariables.clear();
+    cipherExpressions.clear();
+    for (auto &[variable, buffer] : buffers)
+        cipherVariables.insert(buffer);
+    variableIdentifiers.clear();
+    walk(elem, overloaded{ [this](Variable &variable) { variableIdentifiers.insert(variable.getIdentifier()); },
+                           [](AbstractNode &) {} });
+
+    code.str("");
+    temporaryDepth = 0;
+    temporaryCount = 0;
+    indentationLevel = 1;
+    if (elem.hasBody())
+        emitStatements(elem.getBody());
+    indentationLevel = 0;
+
+    for (size_t i = 0; i < allocation.getBufferCount() - cipherParameters; ++i)
+        os << "    seal::Ciphertext __ct_" << i << " = runtime.allocate();\n";
+    for (size_t i = 0; i < temporaryCount; ++i)
+        os << "    seal::Ciphertext __t_" << i << " = runtime.allocate();\n";
+    os << code.str() << "}\n";
+}
+
+void SpecialSealEmitterVisitor::visit(If &elem)
+{
+    if (isCipher(elem.getCondition()))
+    {
+        throw runtime_error(
+            "The secret condition " + elem.getCondition().toString(false) +
+            " must be eliminated (see BranchEliminationVisitor) before emitting SEAL code.");
+    }
+    code << getIndentation() << "if (" << plainExpression(elem.getCondition()) << ")\n";
+    if (elem.hasThenBranch())
+        elem.getThenBranch().accept(*this);
+    if (elem.hasElseBranch())
+    {
+        code << getIndentation() << "else\n";
+        elem.getElseBranch().accept(*this);
+    }
+}
+
+void SpecialSealEmitterVisitor::visit(Return &elem)
+{
+    if (!elem.hasValue())
+    {
+        code << getIndentation() << "return;\n";
+    }
+    else if (!cipherResult)
+    {
+        code << getIndentation() << "return " << plainExpression(elem.getValue()) << ";\n";
+    }
+    else if (!isCipher(elem.getValue()))
+    {
+        code << getIndentation() << "return runtime.encrypt(" << encodable(elem.getValue()) << ");\n";
+    }
+    else
+    {
+        auto result = cipherOperand(elem.getValue());
+        code << getIndentation() << "return " << result << ";\n";
+    }
+}
+
+void SpecialSealEmitterVisitor::visit(VariableDeclaration &elem)
+{
+    auto identifier = elem.getTarget().getIdentifier();
+    if (!cipherVariables.count(identifier))
+    {
+        code << getIndentation() << plainType(elem.getDatatype(), plainArrays.count(identifier) > 0) << " "
+             << identifier;
+        if (elem.hasValue())
+            code << " = " << plainExpression(elem.getValue());
+        code << ";\n";
+    }
+    else if (elem.hasValue())
+    {
+        // the buffer is declared at the top of the function and might have held other variables before
+        emitCipherInto(elem.getValue(), identifier);
+    }
+}
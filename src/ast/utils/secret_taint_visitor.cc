@@ -0,0 +1,384 @@
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+
+#include <type_traits>
+#include <vector>
+
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+std::string enumToString(const OpSpecialization specialization)
+{
+    std::unordered_map<OpSpecialization, std::string> specializationToString = {
+        { OpSpecialization::PLAIN_PLAIN, "plain-plain" },
+        { OpSpecialization::CIPHER_PLAIN, "cipher-plain" },
+        { OpSpecialization::CIPHER_CIPHER, "cipher-cipher" }
+    };
+    return specializationToString.find(specialization)->second;
+}
+
+/// Returns the FHE variant of a native arithmetic operator, or the operator itself if there is none
+Operator toFheOperator(const Operator &op)
+{
+    if (op == Operator(ADDITION))
+        return Operator(FHE_ADDITION);
+    else if (op == Operator(SUBTRACTION))
+        return Operator(FHE_SUBTRACTION);
+    else if (op == Operator(MULTIPLICATION))
+        return Operator(FHE_MULTIPLICATION);
+    return op;
+}
+
+/// Returns the native variant of an FHE arithmetic operator, or the operator itself if it is not an FHE operator
+Operator toNativeOperator(const Operator &op)
+{
+    if (op == Operator(FHE_ADDITION))
+        return Operator(ADDITION);
+    else if (op == Operator(FHE_SUBTRACTION))
+        return Operator(SUBTRACTION);
+    else if (op == Operator(FHE_MULTIPLICATION))
+        return Operator(MULTIPLICATION);
+    return op;
+}
+
+void SpecialSecretTaintVisitor::taintVariable(const ScopedIdentifier &scopedIdentifier)
+{
+    taintedVariables.insert_or_assign(scopedIdentifier, true);
+    if (declarations.has(scopedIdentifier))
+    {
+        auto &datatype = declarations.get(scopedIdentifier)->getDatatype();
+        if (!datatype.getSecretFlag())
+        {
+            datatype = Datatype(datatype.getType(), true);
+        }
+    }
+}
+
+bool SpecialSecretTaintVisitor::setTainted(AbstractNode &node, bool tainted)
+{
+    if (tainted)
+    {
+        taintedNodes.insert(node.getUniqueNodeId());
+    }
+    return tainted;
+}
+
+bool SpecialSecretTaintVisitor::analyseOnFork(const std::function<void()> &analysis)
+{
+    auto outer = std::move(taintedVariables);
+    taintedVariables = outer.fork();
+    analysis();
+
+    bool newlyTainted = false;
+    for (auto &si : taintedVariables.changedEntries())
+    {
+        if (taintedVariables.get(si) && !(outer.has(si) && outer.get(si)))
+            newlyTainted = true;
+    }
+    outer.merge(taintedVariables, [](bool before, bool after) { return before || after; });
+    taintedVariables = std::move(outer);
+    return newlyTainted;
+}
+
+OpSpecialization SpecialSecretTaintVisitor::specialize(Operator &op, size_t numSecretOperands)
+{
+    if (numSecretOperands == 0)
+    {
+        op = toNativeOperator(op);
+        return OpSpecialization::PLAIN_PLAIN;
+    }
+    op = toFheOperator(op);
+    return (numSecretOperands == 1) ? OpSpecialization::CIPHER_PLAIN : OpSpecialization::CIPHER_CIPHER;
+}
+
+void SpecialSecretTaintVisitor::taint(AbstractExpression &elem)
+{
+    // Generic expressions (literals, ExpressionList, IndexAccess, TernaryOperator, UnaryExpression)
+    // are secret iff any of their children is secret
+    bool tainted = false;
+    for (auto &child : elem)
+    {
+        tainted = tainted || isSecretTainted(child);
+    }
+    setTainted(elem, tainted);
+}
+
+void SpecialSecretTaintVisitor::taint(BinaryExpression &elem)
+{
+    size_t numSecretOperands = static_cast<size_t>(isSecretTainted(elem.getLeft())) +
+                               static_cast<size_t>(isSecretTainted(elem.getRight()));
+    specializations[elem.getUniqueNodeId()] = specialize(elem.getOperator(), numSecretOperands);
+    setTainted(elem, numSecretOperands > 0);
+}
+
+void SpecialSecretTaintVisitor::taint(Call &elem)
+{
+    bool tainted = secretFunctions.count(elem.getIdentifier()) > 0;
+    auto function = functions.find(elem.getIdentifier());
+    auto arguments = elem.getArguments();
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        if (!isSecretTainted(arguments[i].get()))
+            continue;
+        tainted = true;
+
+        // the parameter receives a ciphertext, so the called Function has to treat it as secret
+        if (function == functions.end())
+            continue;
+        auto parameters = function->second->getParameters();
+        if (i >= parameters.size())
+            throw runtime_error("Too many arguments in call to " + elem.getIdentifier() + ".");
+        auto &datatype = parameters[i].get().getParameterType();
+        if (!datatype.getSecretFlag())
+        {
+            datatype = Datatype(datatype.getType(), true);
+            ++numSecretArguments;
+        }
+    }
+    setTainted(elem, tainted);
+}
+
+void SpecialSecretTaintVisitor::taint(OperatorExpression &elem)
+{
+    size_t numSecretOperands = 0;
+    for (auto &operand : elem.getOperands())
+    {
+        if (isSecretTainted(operand.get()))
+            ++numSecretOperands;
+    }
+    specializations[elem.getUniqueNodeId()] = specialize(elem.getOperator(), numSecretOperands);
+    setTainted(elem, numSecretOperands > 0);
+}
+
+void SpecialSecretTaintVisitor::taint(Variable &elem)
+{
+    if (auto si = findIdentifier(elem))
+    {
+        setTainted(elem, taintedVariables.has(*si) && taintedVariables.get(*si));
+    }
+}
+
+void SpecialSecretTaintVisitor::visit(AbstractExpression &elem)
+{
+    walk(elem, NoHandler(), [this](auto &node) {
+        if constexpr (std::is_base_of_v<AbstractExpression, std::remove_reference_t<decltype(node)>>)
+            taint(node);
+    });
+}
+
+void SpecialSecretTaintVisitor::visit(Assignment &elem)
+{
+    visitChildren(elem);
+
+    // Writing to a secret index of an array makes the whole array secret, as does writing a secret value
+    bool secret = secretControlDepth > 0 || (elem.hasValue() && isSecretTainted(elem.getValue()));
+    AbstractExpression *target = &elem.getTarget();
+    while (auto indexAccess = dynamic_cast<IndexAccess *>(target))
+    {
+        secret = secret || isSecretTainted(indexAccess->getIndex());
+        target = &indexAccess->getTarget();
+    }
+
+    if (auto variable = dynamic_cast<Variable *>(target))
+    {
+        auto scopedIdentifier = secret ? findIdentifier(*variable) : nullptr;
+        if (scopedIdentifier)
+        {
+            taintVariable(*scopedIdentifier);
+        }
+    }
+    else
+    {
+        throw runtime_error("Assignment target must be a Variable or an IndexAccess into a Variable.");
+    }
+}
+
+void SpecialSecretTaintVisitor::visit(Block &elem)
+{
+    std::vector<Function *> programFunctions;
+    for (auto &statement : elem.getStatementPointers())
+    {
+        if (auto function = dynamic_cast<Function *>(statement.get()))
+            programFunctions.push_back(function);
+    }
+    for (auto function : programFunctions)
+        functions[function->getIdentifier()] = function;
+
+    // a Call may precede the Function it calls, so the Functions of a program are analysed until a Call to a secret
+    // function and a secret argument of a Call have been seen by the Functions that depend on them
+    size_t numSecretBefore;
+    do
+    {
+        numSecretBefore = secretFunctions.size() + numSecretArguments;
+        enterScope(elem);
+        visitChildren(elem);
+        exitScope();
+    } while (!programFunctions.empty() && secretFunctions.size() + numSecretArguments != numSecretBefore);
+}
+
+void SpecialSecretTaintVisitor::visit(For &elem)
+{
+    enterScope(elem);
+
+    // variables declared in the initializer must be visible in condition, update and body, so no new scope
+    if (elem.hasInitializer())
+    {
+        visitChildren(elem.getInitializer());
+    }
+
+    // taint only ever grows, so iterating until no further variable becomes secret terminates
+    bool newlyTainted;
+    do
+    {
+        newlyTainted = analyseOnFork([&]() {
+            bool secretCondition = false;
+            if (elem.hasCondition())
+            {
+                elem.getCondition().accept(*this);
+                secretCondition = isSecretTainted(elem.getCondition());
+            }
+
+            if (secretCondition)
+                ++secretControlDepth;
+            if (elem.hasBody())
+                elem.getBody().accept(*this);
+            if (elem.hasUpdate())
+                visitChildren(elem.getUpdate());
+            if (secretCondition)
+                --secretControlDepth;
+        });
+    } while (newlyTainted);
+
+    exitScope();
+}
+
+void SpecialSecretTaintVisitor::visit(Function &elem)
+{
+    auto enclosingFunction = currentFunction;
+    currentFunction = elem.getIdentifier();
+
+    // (mutually) recursive calls might only learn that this function returns a secret value after a first pass
+    bool newlyTainted;
+    size_t numSecretFunctionsBefore;
+    do
+    {
+        numSecretFunctionsBefore = secretFunctions.size();
+        newlyTainted = analyseOnFork([&]() {
+            enterScope(elem);
+            visitChildren(elem);
+            exitScope();
+        });
+    } while (newlyTainted || secretFunctions.size() != numSecretFunctionsBefore);
+
+    currentFunction = enclosingFunction;
+}
+
+void SpecialSecretTaintVisitor::visit(FunctionParameter &elem)
+{
+    getCurrentScope().addIdentifier(elem.getIdentifier());
+    auto &si = getCurrentScope().resolveIdentifier(elem.getIdentifier());
+    if (elem.getParameterType().getSecretFlag())
+    {
+        taintVariable(si);
+    }
+    else if (!taintedVariables.has(si))
+    {
+        taintedVariables.insert_or_assign(si, false);
+    }
+}
+
+void SpecialSecretTaintVisitor::visit(If &elem)
+{
+    enterScope(elem);
+
+    bool secretCondition = false;
+    if (elem.hasCondition())
+    {
+        elem.getCondition().accept(*this);
+        secretCondition = isSecretTainted(elem.getCondition());
+    }
+
+    // implicit flow: everything written in either branch depends on the secret condition
+    if (secretCondition)
+        ++secretControlDepth;
+    if (elem.hasThenBranch())
+        elem.getThenBranch().accept(*this);
+    if (elem.hasElseBranch())
+        elem.getElseBranch().accept(*this);
+    if (secretCondition)
+        --secretControlDepth;
+
+    exitScope();
+}
+
+void SpecialSecretTaintVisitor::visit(Return &elem)
+{
+    visitChildren(elem);
+    bool secret = secretControlDepth > 0 || (elem.hasValue() && isSecretTainted(elem.getValue()));
+    if (setTainted(elem, secret) && !currentFunction.empty())
+    {
+        secretFunctions.insert(currentFunction);
+    }
+}
+
+void SpecialSecretTaintVisitor::visit(VariableDeclaration &elem)
+{
+    if (!elem.hasTarget())
+    {
+        throw runtime_error("Variable declaration must have a target.");
+    }
+
+    getCurrentScope().addIdentifier(elem.getTarget().getIdentifier());
+    auto &si = resolveIdentifier(elem.getTarget());
+    declarations.insert_or_assign(si, &elem);
+
+    if (elem.hasValue())
+    {
+        elem.getValue().accept(*this);
+    }
+
+    bool secret = elem.getDatatype().getSecretFlag() || secretControlDepth > 0 ||
+                  (elem.hasValue() && isSecretTainted(elem.getValue()));
+    if (secret)
+    {
+        taintVariable(si);
+    }
+    else if (!taintedVariables.has(si))
+    {
+        taintedVariables.insert_or_assign(si, false);
+    }
+}
+
+bool SpecialSecretTaintVisitor::isSecretTainted(const AbstractNode &node) const
+{
+    return taintedNodes.count(node.getUniqueNodeId()) > 0;
+}
+
+OpSpecialization SpecialSecretTaintVisitor::getSpecialization(const AbstractNode &node) const
+{
+    auto it = specializations.find(node.getUniqueNodeId());
+    if (it == specializations.end())
+    {
+        throw runtime_error("No specialization recorded for " + node.getUniqueNodeId() + ".");
+    }
+    return it->second;
+}
+
+const std::unordered_map<std::string, OpSpecialization> &SpecialSecretTaintVisitor::getSpecializations() const
+{
+    return specializations;
+}
+
+const std::unordered_set<std::string> &SpecialSecretTaintVisitor::getTaintedNodes() const
+{
+    return taintedNodes;
+}
+
+void SpecialSecretTaintVisitor::setSecretFunctions(std::unordered_set<std::string> functions)
+{
+    secretFunctions = std::move(functions);
+}
+
+const std::unordered_set<std::string> &SpecialSecretTaintVisitor::getSecretFunctions() const
+{
+    return secretFunctions;
+}
@@ -0,0 +1,194 @@
+#include "transpiration/ast/utils/statistics.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include <sys/resource.h>
+
+std::string enumToString(const Counter counter)
+{
+    switch (counter)
+    {
+    case Counter::TOKENS:
+        return "tokens";
+    case Counter::NODES_ALLOCATED:
+        return "nodes_allocated";
+    case Counter::SCOPES_CREATED:
+        return "scopes_created";
+    case Counter::IDENTIFIERS_RESOLVED:
+        return "identifiers_resolved";
+    case Counter::MLIR_OPERATIONS_CREATED:
+        return "mlir_operations_created";
+    case Counter::FUNCTIONS_COMPILED:
+        return "functions_compiled";
+    case Counter::FUNCTIONS_REUSED:
+        return "functions_reused";
+    case Counter::PROGRAMS_REUSED:
+        return "programs_reused";
+    default:
+        return "unknown";
+    }
+}
+
+bool CompilerStatistics::timingEnabled = false;
+
+size_t CompilerStatistics::counters[static_cast<size_t>(Counter::COUNT)] = {};
+
+size_t CompilerStatistics::liveNodeBytes = 0;
+
+size_t CompilerStatistics::peakNodeBytes = 0;
+
+std::vector<CompilerStatistics::Phase> CompilerStatistics::phases = { { "", 0, {} } };
+
+std::vector<CompilerStatistics::Run> CompilerStatistics::running;
+
+void CompilerStatistics::enableTiming(bool enabled)
+{
+    timingEnabled = enabled;
+}
+
+bool CompilerStatistics::isTimingEnabled()
+{
+    return timingEnabled;
+}
+
+size_t CompilerStatistics::get(Counter counter)
+{
+    return counters[static_cast<size_t>(counter)];
+}
+
+size_t CompilerStatistics::getLiveNodeBytes()
+{
+    return liveNodeBytes;
+}
+
+size_t CompilerStatistics::getPeakNodeBytes()
+{
+    return peakNodeBytes;
+}
+
+void CompilerStatistics::startPhase(const std::string &name)
+{
+    if (!timingEnabled)
+        return;
+
+    auto parent = running.empty() ? 0 : running.back().phase;
+    if (parent != 0 && phases[parent].name == name)
+    {
+        running.push_back({ parent, std::chrono::steady_clock::now(), true });
+        return;
+    }
+
+    auto &siblings = phases[parent].children;
+    auto it = std::find_if(siblings.begin(), siblings.end(), [&name](size_t i) { return phases[i].name == name; });
+    size_t index;
+    if (it != siblings.end())
+    {
+        index = *it;
+    }
+    else
+    {
+        index = phases.size();
+        phases.push_back({ name, parent, {} });
+        phases[parent].children.push_back(index);
+    }
+    running.push_back({ index, std::chrono::steady_clock::now(), false });
+}
+
+void CompilerStatistics::stopPhase()
+{
+    if (running.empty())
+        return;
+
+    auto run = running.back();
+    running.pop_back();
+    if (run.reentrant)
+        return;
+
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - run.start;
+    auto &phase = phases[run.phase];
+    ++phase.calls;
+    phase.milliseconds += duration.count();
+    phase.peakResidentBytes = peakResidentBytes();
+}
+
+size_t CompilerStatistics::peakResidentBytes()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+void CompilerStatistics::reset()
+{
+    std::fill(std::begin(counters), std::end(counters), 0);
+    peakNodeBytes = liveNodeBytes;
+    phases = { { "", 0, {} } };
+    running.clear();
+}
+
+nlohmann::json CompilerStatistics::phaseToJson(size_t index)
+{
+    auto &phase = phases[index];
+    nlohmann::json children = nlohmann::json::array();
+    for (auto child : phase.children)
+        children.push_back(phaseToJson(child));
+    return { { "name", phase.name },
+             { "calls", phase.calls },
+             { "ms", phase.milliseconds },
+             { "peak_rss_bytes", phase.peakResidentBytes },
+             { "phases", children } };
+}
+
+nlohmann::json CompilerStatistics::toJson()
+{
+    nlohmann::json countersJson;
+    for (size_t i = 0; i < static_cast<size_t>(Counter::COUNT); ++i)
+        countersJson[enumToString(static_cast<Counter>(i))] = counters[i];
+    countersJson["live_node_bytes"] = liveNodeBytes;
+    countersJson["peak_node_bytes"] = peakNodeBytes;
+
+    return { { "counters", countersJson }, { "phases", phaseToJson(0)["phases"] } };
+}
+
+void CompilerStatistics::printPhase(std::ostream &os, size_t index, size_t depth)
+{
+    auto &phase = phases[index];
+    os << std::setw(12) << std::fixed << std::setprecision(3) << phase.milliseconds << " ms  "
+       << std::string(2 * depth, ' ') << phase.name;
+    if (phase.calls > 1)
+        os << " (" << phase.calls << " calls)";
+    os << "\n";
+    for (auto child : phase.children)
+        printPhase(os, child, depth + 1);
+}
+
+void CompilerStatistics::print(std::ostream &os)
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+    for (auto child : phases[0].children)
+        printPhase(os, child, 0);
+    for (size_t i = 0; i < static_cast<size_t>(Counter::COUNT); ++i)
+        os << enumToString(static_cast<Counter>(i)) << ": " << counters[i] << "\n";
+    os << "peak_node_bytes: " << peakNodeBytes << "\n";
+    os << "peak_rss_bytes: " << peakResidentBytes() << "\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+PhaseTimer::PhaseTimer(const std::string &name) : timed(CompilerStatistics::isTimingEnabled())
+{
+    if (timed)
+        CompilerStatistics::startPhase(name);
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    if (timed)
+        CompilerStatistics::stopPhase();
+}
@@ -0,0 +1,200 @@
+#include "transpiration/ast/utils/structural_hash.h"
+
+#include <cstring>
+#include <initializer_list>
+
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// Pre-order handler of walk() that mixes every node into the hash, the post-order handler closes the node, such that
+/// the hash also determines which node the children belong to
+class StructuralHasher
+{
+private:
+    uint64_t hash = 0;
+
+    /// Mixes the bits of a value (splitmix64), since most values are small integers
+    void add(uint64_t value)
+    {
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        hash = combineHashes(hash, value ^ (value >> 31));
+    }
+
+    void add(const std::string &s)
+    {
+        add(stableHash(s));
+    }
+
+    void add(const Datatype &datatype)
+    {
+        add(static_cast<uint64_t>(datatype.getType()) << 1 | static_cast<uint64_t>(datatype.getSecretFlag()));
+    }
+
+    void add(const Operator &op)
+    {
+        add(op.toString());
+    }
+
+    /// Which of the optional children of a node with several of them are present, e.g. the update of a For
+    void addPresence(std::initializer_list<bool> children)
+    {
+        uint64_t mask = 0;
+        for (auto present : children)
+            mask = mask << 1 | static_cast<uint64_t>(present);
+        add(mask);
+    }
+
+    void addValue(bool value)
+    {
+        add(static_cast<uint64_t>(value));
+    }
+
+    void addValue(char value)
+    {
+        add(static_cast<uint64_t>(static_cast<unsigned char>(value)));
+    }
+
+    void addValue(int value)
+    {
+        add(static_cast<uint64_t>(static_cast<int64_t>(value)));
+    }
+
+    void addValue(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    }
+
+    void addValue(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    }
+
+    void addValue(const std::string &value)
+    {
+        add(value);
+    }
+
+    void addAttributes(const AbstractNode &)
+    {}
+
+    void addAttributes(const Assignment &node)
+    {
+        addPresence({ node.hasTarget(), node.hasValue() });
+    }
+
+    void addAttributes(const BinaryExpression &node)
+    {
+        add(node.getOperator());
+        addPresence({ node.hasLeft(), node.hasRight() });
+    }
+
+    void addAttributes(const Call &node)
+    {
+        add(node.getIdentifier());
+    }
+
+    void addAttributes(const For &node)
+    {
+        addPresence({ node.hasInitializer(), node.hasCondition(), node.hasUpdate(), node.hasBody() });
+    }
+
+    void addAttributes(const Function &node)
+    {
+        add(node.getReturnType());
+        add(node.getIdentifier());
+    }
+
+    void addAttributes(const FunctionParameter &node)
+    {
+        add(node.getParameterType());
+        add(node.getIdentifier());
+    }
+
+    void addAttributes(const If &node)
+    {
+        addPresence({ node.hasCondition(), node.hasThenBranch(), node.hasElseBranch() });
+    }
+
+    void addAttributes(const IndexAccess &node)
+    {
+        addPresence({ node.hasTarget(), node.hasIndex() });
+    }
+
+    template <typename T>
+    void addAttributes(const Literal<T> &node)
+    {
+        addValue(node.getValue());
+    }
+
+    void addAttributes(const OperatorExpression &node)
+    {
+        add(node.getOperator());
+    }
+
+    void addAttributes(const TernaryOperator &node)
+    {
+        addPresence({ node.hasCondition(), node.hasThenExpr(), node.hasElseExpr() });
+    }
+
+    void addAttributes(const UnaryExpression &node)
+    {
+        add(node.getOperator());
+    }
+
+    void addAttributes(const Variable &node)
+    {
+        add(node.getIdentifier());
+    }
+
+    void addAttributes(const VariableDeclaration &node)
+    {
+        add(node.getDatatype());
+        addPresence({ node.hasTarget(), node.hasValue() });
+    }
+
+public:
+    uint64_t getHash() const
+    {
+        return hash;
+    }
+
+    template <typename N>
+    void operator()(const N &node)
+    {
+        add(static_cast<uint64_t>(node.getNodeKind()));
+        addAttributes(node);
+    }
+
+    /// Marks the end of the children of a node
+    void close()
+    {
+        // one more than the last NodeKind
+        add(static_cast<uint64_t>(NodeKind::VariableDeclaration) + 1);
+    }
+};
+} // namespace
+
+uint64_t structuralHash(const AbstractNode &node)
+{
+    StructuralHasher hasher;
+    walk(node, hasher, [&hasher](const AbstractNode &) { hasher.close(); });
+    return hasher.getHash();
+}
+
+uint64_t stableHash(const std::string &s)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto c : s)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,53 @@
+#include "transpiration/ast/utils/traversal_stack.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "transpiration/ast/utils/static_visitor.h"
+
+void TraversalStack::pushChildren(AbstractNode &node)
+{
+    auto first = nodes.size();
+    dispatch(node, [this](auto &concrete) {
+        forEachChild(concrete, [this](AbstractNode &child) { nodes.push_back(&child); });
+    });
+    std::reverse(nodes.begin() + static_cast<std::ptrdiff_t>(first), nodes.end());
+}
+
+void TraversalStack::visitChildren(AbstractNode &node, IVisitor &visitor)
+{
+    // the nodes below belong to the visitChildren() calls this one is nested into
+    auto bottom = nodes.size();
+    pushChildren(node);
+    try
+    {
+        while (nodes.size() > bottom)
+        {
+            auto next = nodes.back();
+            nodes.pop_back();
+            dispatched = next;
+            next->accept(visitor);
+            dispatched = nullptr;
+        }
+    }
+    catch (...)
+    {
+        // the visitor might be used again after the error was handled
+        nodes.resize(bottom);
+        dispatched = nullptr;
+        throw;
+    }
+}
+
+void TraversalStack::deferChildren(AbstractNode &node, IVisitor &visitor)
+{
+    if (&node == dispatched)
+    {
+        dispatched = nullptr;
+        pushChildren(node);
+    }
+    else
+    {
+        visitChildren(node, visitor);
+    }
+}
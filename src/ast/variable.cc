@@ -12,17 +12,22 @@ Variable::Variable(std::string variableIdentifier) : identifier(std::move(variab
 Variable::Variable(const Variable &other) : identifier(other.identifier)
 {}
 
-Variable::Variable(Variable &&other) noexcept : identifier(std::move(other.identifier))
+Variable::Variable(Variable &&other) noexcept
+    : identifier(std::move(other.identifier)), binding(other.binding), bindingRootScopeId(other.bindingRootScopeId)
 {}
 
 Variable &Variable::operator=(const Variable &other)
 {
     identifier = other.identifier;
+    binding = nullptr;
+    bindingRootScopeId = 0;
     return *this;
 }
 Variable &Variable::operator=(Variable &&other) noexcept
 {
     identifier = std::move(other.identifier);
+    binding = other.binding;
+    bindingRootScopeId = other.bindingRootScopeId;
     return *this;
 }
 
@@ -36,6 +41,24 @@ std::string Variable::getIdentifier() const
     return identifier;
 }
 
+void Variable::setIdentifier(std::string newIdentifier)
+{
+    identifier = std::move(newIdentifier);
+    binding = nullptr;
+    bindingRootScopeId = 0;
+}
+
+void Variable::setBinding(const ScopedIdentifier &scopedIdentifier, uint64_t rootScopeId)
+{
+    binding = &scopedIdentifier;
+    bindingRootScopeId = rootScopeId;
+}
+
+const ScopedIdentifier *Variable::getBinding(uint64_t rootScopeId) const
+{
+    return (binding && bindingRootScopeId == rootScopeId) ? binding : nullptr;
+}
+
 ///////////////////////////////////////////////
 ////////// AbstractNode Interface /////////////
 ///////////////////////////////////////////////
@@ -100,4 +123,9 @@ std::string Variable::toString(bool printChildren) const
 std::string Variable::getNodeType() const
 {
     return "Variable";
-}
\ No newline at end of file
+}
+
+NodeKind Variable::getNodeKind() const
+{
+    return NodeKind::Variable;
+}
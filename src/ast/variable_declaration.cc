@@ -6,27 +6,39 @@
 #include "transpiration/ast/parser/parser.h"
 #include "transpiration/ast/utils/ivisitor.h"
 
-VariableDeclaration::~VariableDeclaration() = default;
+VariableDeclaration::~VariableDeclaration()
+{
+    destroyChild(target);
+    destroyChild(value);
+}
 
 VariableDeclaration::VariableDeclaration(
     Datatype datatype, std::unique_ptr<Variable> target, std::unique_ptr<AbstractExpression> value)
     : datatype(datatype), target(std::move(target)), value(std::move(value))
-{}
+{
+    adoptChild(this->target);
+    adoptChild(this->value);
+}
 
 VariableDeclaration::VariableDeclaration(const VariableDeclaration &other)
-    : datatype(other.datatype), target(other.target ? other.target->clone(this) : nullptr),
-      value(other.value ? other.value->clone(this) : nullptr)
-{}
+    : datatype(other.datatype)
+{
+    cloneChild(target, other.target);
+    cloneChild(value, other.value);
+}
 
 VariableDeclaration::VariableDeclaration(VariableDeclaration &&other) noexcept
     : datatype(std::move(other.datatype)), target(std::move(other.target)), value(std::move(other.value))
-{}
+{
+    adoptChild(target);
+    adoptChild(value);
+}
 
 VariableDeclaration &VariableDeclaration::operator=(const VariableDeclaration &other)
 {
     datatype = other.datatype;
-    target = other.target ? other.target->clone(this) : nullptr;
-    value = other.value ? other.value->clone(this) : nullptr;
+    cloneChild(target, other.target);
+    cloneChild(value, other.value);
     return *this;
 }
 
@@ -35,6 +47,8 @@ VariableDeclaration &VariableDeclaration::operator=(VariableDeclaration &&other)
     datatype = other.datatype;
     target = std::move(other.target);
     value = std::move(other.value);
+    adoptChild(target);
+    adoptChild(value);
     return *this;
 }
 
@@ -124,11 +138,13 @@ std::unique_ptr<AbstractExpression> VariableDeclaration::takeValue()
 void VariableDeclaration::setTarget(std::unique_ptr<Variable> newTarget)
 {
     target = std::move(newTarget);
+    adoptChild(target);
 }
 
 void VariableDeclaration::setValue(std::unique_ptr<AbstractExpression> newValue)
 {
     value = std::move(newValue);
+    adoptChild(value);
 }
 
 ///////////////////////////////////////////////
@@ -205,4 +221,9 @@ std::string VariableDeclaration::toString(bool printChildren) const
 std::string VariableDeclaration::getNodeType() const
 {
     return "VariableDeclaration";
-}
\ No newline at end of file
+}
+
+NodeKind VariableDeclaration::getNodeKind() const
+{
+    return NodeKind::VariableDeclaration;
+}
@@ -0,0 +1,124 @@
+#include "transpiration/runtime/cost_table.h"
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+CostTable::CostTable(
+    std::string scheme, size_t polyModulusDegree, size_t coeffModulusCount, std::map<std::string, double> latencies)
+    : scheme(std::move(scheme)), polyModulusDegree(polyModulusDegree), coeffModulusCount(coeffModulusCount),
+      latencies(std::move(latencies))
+{}
+
+CostTable CostTable::defaults(const std::string &scheme)
+{
+    if (scheme == "ckks")
+    {
+        return CostTable(
+            "ckks", 8192, 3,
+            { { "add", 20 },
+              { "add_plain", 15 },
+              { "multiply", 75 },
+              { "multiply_plain", 50 },
+              { "square", 55 },
+              { "negate", 15 },
+              { "relinearize", 650 },
+              { "rescale", 160 },
+              { "mod_switch", 35 },
+              { "rotate", 650 },
+              { "encode", 250 },
+              { "encrypt", 1800 } });
+    }
+    return CostTable(
+        "bfv", 8192, 4,
+        { { "add", 25 },
+          { "add_plain", 25 },
+          { "multiply", 2600 },
+          { "multiply_plain", 300 },
+          { "square", 1900 },
+          { "negate", 20 },
+          { "relinearize", 750 },
+          { "rescale", 0 },
+          { "mod_switch", 60 },
+          { "rotate", 750 },
+          { "encode", 120 },
+          { "encrypt", 2200 } });
+}
+
+CostTable CostTable::fromJson(const nlohmann::json &j)
+{
+    try
+    {
+        return CostTable(
+            j.at("scheme").get<std::string>(), j.at("poly_modulus_degree").get<size_t>(),
+            j.at("coeff_modulus_count").get<size_t>(), j.at("latencies_us").get<std::map<std::string, double>>());
+    }
+    catch (nlohmann::json::exception &e)
+    {
+        throw std::invalid_argument(std::string("Invalid cost table: ") + e.what());
+    }
+}
+
+CostTable CostTable::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::invalid_argument("Cannot read cost table " + path + ".");
+    nlohmann::json j;
+    try
+    {
+        file >> j;
+    }
+    catch (nlohmann::json::exception &e)
+    {
+        throw std::invalid_argument("Cannot parse cost table " + path + ": " + e.what());
+    }
+    return fromJson(j);
+}
+
+nlohmann::json CostTable::toJson() const
+{
+    return { { "scheme", scheme },
+             { "poly_modulus_degree", polyModulusDegree },
+             { "coeff_modulus_count", coeffModulusCount },
+             { "latencies_us", latencies } };
+}
+
+void CostTable::save(const std::string &path) const
+{
+    std::ofstream file(path);
+    file << toJson().dump(2) << std::endl;
+}
+
+double CostTable::latency(const std::string &operation, size_t degree, size_t primes) const
+{
+    auto it = latencies.find(operation);
+    if (it == latencies.end())
+        return 0;
+
+    auto ringFactor = (static_cast<double>(degree) * std::log2(static_cast<double>(degree))) /
+                      (static_cast<double>(polyModulusDegree) * std::log2(static_cast<double>(polyModulusDegree)));
+    auto primeFactor = static_cast<double>(primes) / static_cast<double>(coeffModulusCount);
+    return it->second * ringFactor * primeFactor;
+}
+
+const std::string &CostTable::getScheme() const
+{
+    return scheme;
+}
+
+size_t CostTable::getPolyModulusDegree() const
+{
+    return polyModulusDegree;
+}
+
+size_t CostTable::getCoeffModulusCount() const
+{
+    return coeffModulusCount;
+}
+
+const std::map<std::string, double> &CostTable::getLatencies() const
+{
+    return latencies;
+}
@@ -0,0 +1,259 @@
+#include "transpiration/runtime/mock/mock_runtime.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+MockRotator::MockRotator(const mock::Context &context, mock::Evaluator &evaluator)
+    : evaluator(evaluator), rowSize(static_cast<int>(context.polyModulusDegree / 2))
+{}
+
+bool MockRotator::hasKey(int offset) const
+{
+    auto magnitude = static_cast<unsigned int>(std::abs(offset));
+    return magnitude != 0 && (magnitude & (magnitude - 1)) == 0;
+}
+
+int MockRotator::normalize(int offset) const
+{
+    offset %= rowSize;
+    if (offset < -rowSize / 2)
+        offset += rowSize;
+    else if (offset >= rowSize / 2)
+        offset -= rowSize;
+    return offset;
+}
+
+std::vector<int> MockRotator::nonAdjacentForm(int offset)
+{
+    std::vector<int> terms;
+    long n = offset;
+    long power = 1;
+    while (n != 0)
+    {
+        if (n % 2 != 0)
+        {
+            // pick +1 or -1 such that the remaining value is divisible by 4
+            long digit = 2 - (((n % 4) + 4) % 4);
+            terms.push_back(static_cast<int>(digit * power));
+            n -= digit;
+        }
+        n /= 2;
+        power *= 2;
+    }
+    return { terms.rbegin(), terms.rend() };
+}
+
+std::vector<mock::Ciphertext> MockRotator::rotate(
+    const mock::Ciphertext &ciphertext, const std::vector<int> &offsets, mock::MemoryPoolHandle pool)
+{
+    // partial rotations by the sum of a prefix of the NAF terms, shared by all offsets with that prefix
+    std::map<int, mock::Ciphertext> partial;
+    partial[0] = ciphertext;
+
+    std::vector<mock::Ciphertext> result;
+    for (auto offset : offsets)
+    {
+        offset = normalize(offset);
+        auto it = partial.find(offset);
+        if (it == partial.end() && hasKey(offset))
+        {
+            it = partial.emplace(offset, ciphertext).first;
+            evaluator.rotate_inplace(it->second, offset, pool);
+        }
+        else if (it == partial.end())
+        {
+            int prefix = 0;
+            for (auto term : nonAdjacentForm(offset))
+            {
+                auto next = partial.find(prefix + term);
+                if (next == partial.end())
+                {
+                    next = partial.emplace(prefix + term, partial.at(prefix)).first;
+                    evaluator.rotate_inplace(next->second, term, pool);
+                }
+                prefix += term;
+            }
+            it = partial.find(offset);
+        }
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+MockRuntime::MockRuntime(const mock::EncryptionParameters &parameters, CostTable costs, double scale)
+    : costs(std::move(costs)), context(parameters), evaluator(context, this->costs, statistics),
+      rotator(context, evaluator), scale(scale)
+{}
+
+template <typename T>
+std::vector<double> MockRuntime::pad(const std::vector<T> &values) const
+{
+    if (values.size() > slotCount())
+        throw std::invalid_argument("Cannot encode more values than there are slots.");
+    std::vector<double> slots(slotCount(), 0);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (isCkks())
+        {
+            slots[i] = static_cast<double>(values[i]);
+            continue;
+        }
+
+        // like SEAL's BatchEncoder, which expects the centered representatives modulo the plain modulus
+        auto value = static_cast<int64_t>(values[i]);
+        if (std::abs(value) > static_cast<int64_t>(context.plainModulus / 2))
+            throw std::invalid_argument("Value " + std::to_string(value) + " is out of range of the plain modulus.");
+        slots[i] = static_cast<double>(value);
+    }
+    return slots;
+}
+
+bool MockRuntime::isCkks() const
+{
+    return context.scheme == mock::scheme_type::ckks;
+}
+
+size_t MockRuntime::slotCount() const
+{
+    return context.slotCount;
+}
+
+mock::Ciphertext MockRuntime::allocate() const
+{
+    return mock::Ciphertext();
+}
+
+mock::Plaintext MockRuntime::encode(double value, const mock::Ciphertext &like)
+{
+    return encode(std::vector<double>(slotCount(), value), like);
+}
+
+mock::Plaintext MockRuntime::encode(int64_t value, const mock::Ciphertext &like)
+{
+    return encode(std::vector<int64_t>(slotCount(), value), like);
+}
+
+mock::Plaintext MockRuntime::encode(const std::vector<double> &values, const mock::Ciphertext &like)
+{
+    mock::Plaintext plaintext{ pad(values), isCkks() ? like.scale : 1, like.level };
+    evaluator.recordEncoding(plaintext);
+    return plaintext;
+}
+
+mock::Plaintext MockRuntime::encode(const std::vector<int64_t> &values, const mock::Ciphertext &like)
+{
+    mock::Plaintext plaintext{ pad(values), isCkks() ? like.scale : 1, like.level };
+    evaluator.recordEncoding(plaintext);
+    return plaintext;
+}
+
+mock::Ciphertext MockRuntime::encrypt(double value)
+{
+    return encrypt(std::vector<double>(slotCount(), value));
+}
+
+mock::Ciphertext MockRuntime::encrypt(int64_t value)
+{
+    return encrypt(std::vector<int64_t>(slotCount(), value));
+}
+
+mock::Ciphertext MockRuntime::encrypt(const std::vector<double> &values)
+{
+    mock::Ciphertext ciphertext;
+    ciphertext.slots = pad(values);
+    ciphertext.level = context.topLevel();
+    ciphertext.scale = isCkks() ? scale : 1;
+    ciphertext.noiseBudget = context.freshNoiseBudget;
+    evaluator.recordEncoding({ {}, ciphertext.scale, ciphertext.level });
+    evaluator.recordEncryption(ciphertext);
+    return ciphertext;
+}
+
+mock::Ciphertext MockRuntime::encrypt(const std::vector<int64_t> &values)
+{
+    return encrypt(pad(values));
+}
+
+void MockRuntime::rotate(const mock::Ciphertext &ciphertext, int offset, mock::Ciphertext &destination)
+{
+    offset = rotator.normalize(offset);
+    if (offset == 0)
+        destination = ciphertext;
+    else if (!rotator.hasKey(offset))
+        destination = std::move(rotator.rotate(ciphertext, { offset }, pool)[0]);
+    else
+    {
+        destination = ciphertext;
+        evaluator.rotate_inplace(destination, offset, pool);
+    }
+}
+
+void MockRuntime::rotateInplace(mock::Ciphertext &ciphertext, int offset)
+{
+    offset = rotator.normalize(offset);
+    if (offset == 0)
+        return;
+    else if (!rotator.hasKey(offset))
+        ciphertext = std::move(rotator.rotate(ciphertext, { offset }, pool)[0]);
+    else
+        evaluator.rotate_inplace(ciphertext, offset, pool);
+}
+
+void MockRuntime::align(mock::Ciphertext &x, mock::Ciphertext &y)
+{
+    if (!isCkks())
+        return;
+
+    if (x.level > y.level)
+        evaluator.mod_switch_to_inplace(x, y.level, pool);
+    else if (y.level > x.level)
+        evaluator.mod_switch_to_inplace(y, x.level, pool);
+
+    // after rescaling by different primes, the scales only differ by a factor close to 1
+    x.scale = y.scale;
+}
+
+std::vector<double> MockRuntime::decrypt(const mock::Ciphertext &ciphertext) const
+{
+    if (ciphertext.slots.empty())
+        throw std::invalid_argument("The ciphertext has not been initialized.");
+    if (noiseBudget(ciphertext) <= 0)
+        throw std::runtime_error("The ciphertext has run out of noise budget and cannot be decrypted.");
+    return ciphertext.slots;
+}
+
+double MockRuntime::noiseBudget(const mock::Ciphertext &ciphertext) const
+{
+    return evaluator.budget(ciphertext);
+}
+
+double MockRuntime::getLatency() const
+{
+    return statistics.latency;
+}
+
+const std::map<std::string, size_t> &MockRuntime::getOperationCounts() const
+{
+    return statistics.operations;
+}
+
+bool MockRuntime::isNoiseBudgetExhausted() const
+{
+    return statistics.noiseBudgetExhausted;
+}
+
+const std::string &MockRuntime::getExhaustingOperation() const
+{
+    return statistics.exhaustedBy;
+}
+
+void MockRuntime::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(statistics.mutex);
+    statistics.latency = 0;
+    statistics.operations.clear();
+    statistics.noiseBudgetExhausted = false;
+    statistics.exhaustedBy.clear();
+}
@@ -0,0 +1,382 @@
+#include "transpiration/runtime/mock/mock_seal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+uint64_t multiplyModulo(uint64_t a, uint64_t b, uint64_t modulus)
+{
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % modulus);
+}
+
+uint64_t powerModulo(uint64_t base, uint64_t exponent, uint64_t modulus)
+{
+    uint64_t result = 1;
+    base %= modulus;
+    while (exponent > 0)
+    {
+        if (exponent & 1)
+            result = multiplyModulo(result, base, modulus);
+        base = multiplyModulo(base, base, modulus);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+/// Miller-Rabin with bases that are deterministic for all 64 bit integers
+bool isPrime(uint64_t n)
+{
+    if (n < 2)
+        return false;
+    for (uint64_t p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 })
+    {
+        if (n % p == 0)
+            return n == p;
+    }
+
+    auto d = n - 1;
+    int s = 0;
+    while (d % 2 == 0)
+    {
+        d /= 2;
+        ++s;
+    }
+    for (uint64_t a : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 })
+    {
+        auto x = powerModulo(a, d, n);
+        if (x == 1 || x == n - 1)
+            continue;
+        bool composite = true;
+        for (int i = 1; i < s && composite; ++i)
+        {
+            x = multiplyModulo(x, x, n);
+            composite = (x != n - 1);
+        }
+        if (composite)
+            return false;
+    }
+    return true;
+}
+
+/// Largest primes p = 1 mod 2N with the given bit size that are not in `exclude`
+uint64_t nttFriendlyPrime(size_t polyModulusDegree, int bitSize, const std::vector<mock::Modulus> &exclude)
+{
+    if (bitSize < 2 || bitSize > 61)
+        throw std::invalid_argument("Invalid bit size " + std::to_string(bitSize) + " of a prime.");
+    uint64_t factor = 2 * polyModulusDegree;
+    uint64_t upper = (uint64_t(1) << bitSize) - 1;
+    uint64_t lower = uint64_t(1) << (bitSize - 1);
+    for (auto candidate = upper - (upper - 1) % factor; candidate > lower && candidate > factor; candidate -= factor)
+    {
+        auto used = std::any_of(exclude.begin(), exclude.end(), [&](const mock::Modulus &m) {
+            return m.value() == candidate;
+        });
+        if (!used && isPrime(candidate))
+            return candidate;
+    }
+    throw std::invalid_argument(
+        "No " + std::to_string(bitSize) + " bit prime for a ring dimension of " + std::to_string(polyModulusDegree) +
+        ".");
+}
+
+/// Budget of the sum of two values with the given budgets, i.e., their noises are added
+double addNoise(double budget, double otherBudget)
+{
+    return -std::log2(std::exp2(-budget) + std::exp2(-otherBudget));
+}
+} // namespace
+
+namespace mock
+{
+int Modulus::bit_count() const
+{
+    int bits = 0;
+    for (auto v = value_; v > 0; v >>= 1)
+        ++bits;
+    return bits;
+}
+
+std::vector<Modulus> CoeffModulus::Create(size_t polyModulusDegree, const std::vector<int> &bitSizes)
+{
+    std::vector<Modulus> primes;
+    for (auto bitSize : bitSizes)
+        primes.emplace_back(nttFriendlyPrime(polyModulusDegree, bitSize, primes));
+    return primes;
+}
+
+std::vector<Modulus> CoeffModulus::BFVDefault(size_t polyModulusDegree)
+{
+    static const std::map<size_t, std::vector<int>> bitSizes = {
+        { 1024, { 27 } },
+        { 2048, { 54 } },
+        { 4096, { 36, 36, 37 } },
+        { 8192, { 43, 43, 44, 44, 44 } },
+        { 16384, { 48, 48, 48, 49, 49, 49, 49, 49, 49 } },
+        { 32768, { 55, 55, 55, 55, 55, 55, 56, 56, 56, 56, 56, 56, 56, 56, 56, 56 } }
+    };
+    auto it = bitSizes.find(polyModulusDegree);
+    if (it == bitSizes.end())
+        throw std::invalid_argument("No default coefficient modulus for " + std::to_string(polyModulusDegree) + ".");
+    return Create(polyModulusDegree, it->second);
+}
+
+Modulus PlainModulus::Batching(size_t polyModulusDegree, int bitSize)
+{
+    return Modulus(nttFriendlyPrime(polyModulusDegree, bitSize, {}));
+}
+
+Context::Context(const EncryptionParameters &parameters)
+    : scheme(parameters.scheme()), polyModulusDegree(parameters.poly_modulus_degree()),
+      primes(parameters.coeff_modulus()), plainModulus(parameters.plain_modulus().value())
+{
+    if (polyModulusDegree == 0 || primes.empty())
+        throw std::invalid_argument("The encryption parameters are incomplete.");
+    if (scheme == scheme_type::bfv && plainModulus == 0)
+        throw std::invalid_argument("BFV requires a plain modulus.");
+
+    // like SEAL, the last prime is the special prime for key switching if there is more than one
+    if (primes.size() > 1)
+        primes.pop_back();
+
+    slotCount = (scheme == scheme_type::bfv) ? polyModulusDegree : polyModulusDegree / 2;
+    freshNoiseBudget = 0;
+    if (scheme == scheme_type::bfv)
+    {
+        freshNoiseBudget = modulusBits(topLevel()) - std::log2(static_cast<double>(plainModulus)) -
+                           std::log2(static_cast<double>(polyModulusDegree)) / 2 - 1;
+    }
+}
+
+size_t Context::topLevel() const
+{
+    return primes.size() - 1;
+}
+
+double Context::modulusBits(size_t level) const
+{
+    double bits = 0;
+    for (size_t i = 0; i <= level && i < primes.size(); ++i)
+        bits += std::log2(static_cast<double>(primes[i].value()));
+    return bits;
+}
+
+Evaluator::Evaluator(const Context &context, const CostTable &costs, Statistics &statistics)
+    : context(context), costs(costs), statistics(statistics)
+{}
+
+void Evaluator::record(const std::string &operation, const Ciphertext &result)
+{
+    auto exhausted = budget(result) <= 0;
+    std::lock_guard<std::mutex> lock(statistics.mutex);
+    statistics.latency += costs.latency(operation, context.polyModulusDegree, result.level + 1);
+    ++statistics.operations[operation];
+    if (exhausted && !statistics.noiseBudgetExhausted)
+    {
+        statistics.noiseBudgetExhausted = true;
+        statistics.exhaustedBy = operation;
+    }
+}
+
+double Evaluator::reduce(double value) const
+{
+    if (context.scheme != scheme_type::bfv)
+        return value;
+    auto t = static_cast<int64_t>(context.plainModulus);
+    auto r = static_cast<int64_t>(std::llround(value)) % t;
+    if (r > t / 2)
+        r -= t;
+    else if (r < -((t - 1) / 2))
+        r += t;
+    return static_cast<double>(r);
+}
+
+void Evaluator::checkCompatible(const Ciphertext &x, size_t level, double scale, bool multiplication) const
+{
+    if (x.slots.empty())
+        throw std::invalid_argument("The ciphertext has not been initialized.");
+    if (x.level != level)
+    {
+        throw std::invalid_argument(
+            "The operands are at different levels (" + std::to_string(x.level) + " and " + std::to_string(level) +
+            ").");
+    }
+    if (context.scheme == scheme_type::ckks && !multiplication &&
+        std::abs(x.scale - scale) > 1e-6 * std::max(x.scale, scale))
+    {
+        throw std::invalid_argument("The operands have different scales.");
+    }
+}
+
+void Evaluator::multiplySlots(Ciphertext &x, const std::vector<double> &y) const
+{
+    if (context.scheme == scheme_type::ckks)
+    {
+        for (size_t i = 0; i < x.slots.size(); ++i)
+            x.slots[i] *= (i < y.size() ? y[i] : 0);
+        return;
+    }
+
+    auto t = static_cast<__int128>(context.plainModulus);
+    for (size_t i = 0; i < x.slots.size(); ++i)
+    {
+        auto product = static_cast<__int128>(std::llround(x.slots[i])) * std::llround(i < y.size() ? y[i] : 0) % t;
+        x.slots[i] = reduce(static_cast<double>(static_cast<int64_t>(product)));
+    }
+}
+
+double Evaluator::budget(const Ciphertext &ciphertext) const
+{
+    if (context.scheme == scheme_type::bfv)
+        return ciphertext.noiseBudget;
+
+    double largest = 1;
+    for (auto slot : ciphertext.slots)
+        largest = std::max(largest, std::abs(slot));
+    return context.modulusBits(ciphertext.level) - std::log2(ciphertext.scale) - std::log2(largest);
+}
+
+void Evaluator::add_inplace(Ciphertext &x, const Ciphertext &y)
+{
+    checkCompatible(x, y.level, y.scale, false);
+    for (size_t i = 0; i < x.slots.size(); ++i)
+        x.slots[i] = reduce(x.slots[i] + y.slots[i]);
+    x.size = std::max(x.size, y.size);
+    x.noiseBudget = addNoise(x.noiseBudget, y.noiseBudget);
+    record("add", x);
+}
+
+void Evaluator::sub_inplace(Ciphertext &x, const Ciphertext &y)
+{
+    checkCompatible(x, y.level, y.scale, false);
+    for (size_t i = 0; i < x.slots.size(); ++i)
+        x.slots[i] = reduce(x.slots[i] - y.slots[i]);
+    x.size = std::max(x.size, y.size);
+    x.noiseBudget = addNoise(x.noiseBudget, y.noiseBudget);
+    record("add", x);
+}
+
+void Evaluator::multiply_inplace(Ciphertext &x, const Ciphertext &y, MemoryPoolHandle)
+{
+    checkCompatible(x, y.level, y.scale, true);
+    multiplySlots(x, y.slots);
+    x.size = x.size + y.size - 1;
+    x.scale *= y.scale;
+    x.noiseBudget = std::min(x.noiseBudget, y.noiseBudget) - std::log2(static_cast<double>(context.plainModulus)) -
+                    std::log2(static_cast<double>(context.polyModulusDegree));
+    record("multiply", x);
+}
+
+void Evaluator::square_inplace(Ciphertext &x, MemoryPoolHandle)
+{
+    checkCompatible(x, x.level, x.scale, true);
+    auto slots = x.slots;
+    multiplySlots(x, slots);
+    x.size = 2 * x.size - 1;
+    x.scale *= x.scale;
+    x.noiseBudget -= std::log2(static_cast<double>(context.plainModulus)) +
+                     std::log2(static_cast<double>(context.polyModulusDegree));
+    record("square", x);
+}
+
+void Evaluator::add_plain_inplace(Ciphertext &x, const Plaintext &y)
+{
+    if (context.scheme == scheme_type::ckks)
+        checkCompatible(x, y.level, y.scale, false);
+    for (size_t i = 0; i < x.slots.size(); ++i)
+        x.slots[i] = reduce(x.slots[i] + (i < y.slots.size() ? y.slots[i] : 0));
+    record("add_plain", x);
+}
+
+void Evaluator::sub_plain_inplace(Ciphertext &x, const Plaintext &y)
+{
+    if (context.scheme == scheme_type::ckks)
+        checkCompatible(x, y.level, y.scale, false);
+    for (size_t i = 0; i < x.slots.size(); ++i)
+        x.slots[i] = reduce(x.slots[i] - (i < y.slots.size() ? y.slots[i] : 0));
+    record("add_plain", x);
+}
+
+void Evaluator::multiply_plain_inplace(Ciphertext &x, const Plaintext &y, MemoryPoolHandle)
+{
+    if (context.scheme == scheme_type::ckks)
+        checkCompatible(x, y.level, y.scale, true);
+    multiplySlots(x, y.slots);
+    x.scale *= y.scale;
+    x.noiseBudget -= std::log2(static_cast<double>(context.plainModulus)) +
+                     std::log2(static_cast<double>(context.polyModulusDegree)) / 2;
+    record("multiply_plain", x);
+}
+
+void Evaluator::negate_inplace(Ciphertext &x)
+{
+    for (auto &slot : x.slots)
+        slot = reduce(-slot);
+    record("negate", x);
+}
+
+void Evaluator::relinearize_inplace(Ciphertext &x, const RelinKeys &, MemoryPoolHandle)
+{
+    if (x.size <= 2)
+        return;
+    x.size = 2;
+    x.noiseBudget = addNoise(x.noiseBudget, context.freshNoiseBudget);
+    record("relinearize", x);
+}
+
+void Evaluator::rescale_to_next_inplace(Ciphertext &x, MemoryPoolHandle)
+{
+    if (context.scheme != scheme_type::ckks)
+        throw std::invalid_argument("Rescaling is only supported for CKKS.");
+    if (x.level == 0)
+        throw std::invalid_argument("End of modulus switching chain reached.");
+    x.scale /= static_cast<double>(context.primes[x.level].value());
+    --x.level;
+    record("rescale", x);
+}
+
+void Evaluator::mod_switch_to_inplace(Ciphertext &x, size_t level, MemoryPoolHandle)
+{
+    if (level > x.level)
+        throw std::invalid_argument("Cannot switch to a higher level.");
+    while (x.level > level)
+    {
+        --x.level;
+        record("mod_switch", x);
+    }
+}
+
+void Evaluator::rotate_inplace(Ciphertext &x, int steps, MemoryPoolHandle)
+{
+    if (x.size != 2)
+        throw std::invalid_argument("Only ciphertexts of size 2 can be rotated.");
+
+    // BFV rotates both rows of N / 2 slots, CKKS the whole vector of N / 2 slots
+    auto rowSize = static_cast<int64_t>(context.polyModulusDegree / 2);
+    auto shift = ((steps % rowSize) + rowSize) % rowSize;
+    std::vector<double> rotated(x.slots.size());
+    for (size_t row = 0; row < x.slots.size(); row += rowSize)
+    {
+        for (int64_t i = 0; i < rowSize; ++i)
+            rotated[row + i] = x.slots[row + (i + shift) % rowSize];
+    }
+    x.slots = std::move(rotated);
+    x.noiseBudget = addNoise(x.noiseBudget, context.freshNoiseBudget);
+    record("rotate", x);
+}
+
+void Evaluator::recordEncoding(const Plaintext &plaintext)
+{
+    std::lock_guard<std::mutex> lock(statistics.mutex);
+    statistics.latency += costs.latency("encode", context.polyModulusDegree, plaintext.level + 1);
+    ++statistics.operations["encode"];
+}
+
+void Evaluator::recordEncryption(const Ciphertext &ciphertext)
+{
+    std::lock_guard<std::mutex> lock(statistics.mutex);
+    statistics.latency += costs.latency("encrypt", context.polyModulusDegree, ciphertext.level + 1);
+    ++statistics.operations["encrypt"];
+}
+} // namespace mock
@@ -0,0 +1,124 @@
+#include "transpiration/runtime/seal/hoisted_rotations.h"
+
+#include <set>
+#include <stdexcept>
+
+HoistedRotator::HoistedRotator(
+    const seal::SEALContext &context, seal::Evaluator &evaluator, const seal::GaloisKeys &galoisKeys)
+    : context(context), evaluator(evaluator), galoisKeys(galoisKeys)
+{
+    auto &parms = context.key_context_data()->parms();
+    rowSize = static_cast<int>(parms.poly_modulus_degree() / 2);
+    ckks = (parms.scheme() == seal::scheme_type::ckks);
+}
+
+bool HoistedRotator::hasKey(int offset) const
+{
+    auto galoisTool = context.key_context_data()->galois_tool();
+    return galoisKeys.has_key(galoisTool->get_elt_from_step(offset));
+}
+
+void HoistedRotator::rotate(
+    const seal::Ciphertext &ciphertext, int offset, seal::Ciphertext &destination, seal::MemoryPoolHandle pool)
+{
+    if (ckks)
+        evaluator.rotate_vector(ciphertext, offset, galoisKeys, destination, std::move(pool));
+    else
+        evaluator.rotate_rows(ciphertext, offset, galoisKeys, destination, std::move(pool));
+}
+
+int HoistedRotator::normalize(int offset) const
+{
+    offset %= rowSize;
+    if (offset < -rowSize / 2)
+        offset += rowSize;
+    else if (offset >= rowSize / 2)
+        offset -= rowSize;
+    return offset;
+}
+
+std::vector<int> HoistedRotator::nonAdjacentForm(int offset)
+{
+    std::vector<int> terms;
+    long n = offset;
+    long power = 1;
+    while (n != 0)
+    {
+        if (n % 2 != 0)
+        {
+            // pick +1 or -1 such that the remaining value is divisible by 4
+            long digit = 2 - (((n % 4) + 4) % 4);
+            terms.push_back(static_cast<int>(digit * power));
+            n -= digit;
+        }
+        n /= 2;
+        power *= 2;
+    }
+    return { terms.rbegin(), terms.rend() };
+}
+
+std::vector<seal::Ciphertext> HoistedRotator::rotate(
+    const seal::Ciphertext &ciphertext, const std::vector<int> &offsets, seal::MemoryPoolHandle pool)
+{
+    // partial rotations by the sum of a prefix of the NAF terms, shared by all offsets with that prefix
+    std::map<int, seal::Ciphertext> partial;
+    partial[0] = ciphertext;
+
+    std::vector<seal::Ciphertext> result;
+    for (auto offset : offsets)
+    {
+        offset = normalize(offset);
+        auto it = partial.find(offset);
+        if (it == partial.end() && hasKey(offset))
+        {
+            it = partial.emplace(offset, seal::Ciphertext(pool)).first;
+            rotate(ciphertext, offset, it->second, pool);
+        }
+        else if (it == partial.end())
+        {
+            int prefix = 0;
+            for (auto term : nonAdjacentForm(offset))
+            {
+                auto next = partial.find(prefix + term);
+                if (next == partial.end())
+                {
+                    if (!hasKey(term))
+                    {
+                        throw std::invalid_argument(
+                            "No Galois key for rotating by " + std::to_string(offset) + " or by " +
+                            std::to_string(term) + ".");
+                    }
+                    next = partial.emplace(prefix + term, seal::Ciphertext(pool)).first;
+                    rotate(partial.at(prefix), term, next->second, pool);
+                }
+                prefix += term;
+            }
+            it = partial.find(offset);
+        }
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+size_t HoistedRotator::countKeySwitches(const std::vector<int> &offsets) const
+{
+    std::set<int> computed = { 0 };
+    for (auto offset : offsets)
+    {
+        offset = normalize(offset);
+        if (computed.count(offset))
+            continue;
+        if (hasKey(offset))
+        {
+            computed.insert(offset);
+            continue;
+        }
+        int prefix = 0;
+        for (auto term : nonAdjacentForm(offset))
+        {
+            prefix += term;
+            computed.insert(prefix);
+        }
+    }
+    return computed.size() - 1;
+}
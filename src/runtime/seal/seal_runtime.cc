@@ -0,0 +1,149 @@
+#include "transpiration/runtime/seal/seal_runtime.h"
+
+#include <stdexcept>
+
+SealRuntime::SealRuntime(
+    const seal::SEALContext &context, const seal::PublicKey &publicKey, const seal::RelinKeys &relinKeys,
+    const seal::GaloisKeys &galoisKeys, double scale, seal::MemoryPoolHandle pool)
+    : context(context), evaluator(context), encryptor(context, publicKey), relinKeys(relinKeys),
+      galoisKeys(galoisKeys), rotator(context, evaluator, galoisKeys), pool(std::move(pool)), scale(scale)
+{
+    if (isCkks())
+        ckksEncoder = std::make_unique<seal::CKKSEncoder>(context);
+    else
+        batchEncoder = std::make_unique<seal::BatchEncoder>(context);
+}
+
+template <typename T>
+std::vector<T> SealRuntime::pad(std::vector<T> values) const
+{
+    if (values.size() > slotCount())
+        throw std::invalid_argument("Cannot encode more values than there are slots.");
+    values.resize(slotCount(), T(0));
+    return values;
+}
+
+bool SealRuntime::isCkks() const
+{
+    return context.first_context_data()->parms().scheme() == seal::scheme_type::ckks;
+}
+
+size_t SealRuntime::slotCount() const
+{
+    return isCkks() ? ckksEncoder->slot_count() : batchEncoder->slot_count();
+}
+
+seal::Ciphertext SealRuntime::allocate() const
+{
+    seal::Ciphertext ciphertext(context, pool);
+    ciphertext.reserve(3);
+    return ciphertext;
+}
+
+seal::Plaintext SealRuntime::encode(double value, const seal::Ciphertext &like)
+{
+    if (!isCkks())
+        return encode(static_cast<int64_t>(value), like);
+    seal::Plaintext plaintext(pool);
+    ckksEncoder->encode(value, like.parms_id(), like.scale(), plaintext, pool);
+    return plaintext;
+}
+
+seal::Plaintext SealRuntime::encode(int64_t value, const seal::Ciphertext &like)
+{
+    if (isCkks())
+        return encode(static_cast<double>(value), like);
+    return encode(std::vector<int64_t>(slotCount(), value), like);
+}
+
+seal::Plaintext SealRuntime::encode(const std::vector<double> &values, const seal::Ciphertext &like)
+{
+    if (!isCkks())
+        return encode(std::vector<int64_t>(values.begin(), values.end()), like);
+    seal::Plaintext plaintext(pool);
+    ckksEncoder->encode(pad(values), like.parms_id(), like.scale(), plaintext, pool);
+    return plaintext;
+}
+
+seal::Plaintext SealRuntime::encode(const std::vector<int64_t> &values, const seal::Ciphertext &like)
+{
+    if (isCkks())
+        return encode(std::vector<double>(values.begin(), values.end()), like);
+    seal::Plaintext plaintext(pool);
+    batchEncoder->encode(pad(values), plaintext);
+    return plaintext;
+}
+
+seal::Ciphertext SealRuntime::encrypt(double value)
+{
+    return encrypt(std::vector<double>(slotCount(), value));
+}
+
+seal::Ciphertext SealRuntime::encrypt(int64_t value)
+{
+    return encrypt(std::vector<int64_t>(slotCount(), value));
+}
+
+seal::Ciphertext SealRuntime::encrypt(const std::vector<double> &values)
+{
+    if (!isCkks())
+        return encrypt(std::vector<int64_t>(values.begin(), values.end()));
+    seal::Plaintext plaintext(pool);
+    ckksEncoder->encode(pad(values), scale, plaintext, pool);
+    auto ciphertext = allocate();
+    encryptor.encrypt(plaintext, ciphertext, pool);
+    return ciphertext;
+}
+
+seal::Ciphertext SealRuntime::encrypt(const std::vector<int64_t> &values)
+{
+    if (isCkks())
+        return encrypt(std::vector<double>(values.begin(), values.end()));
+    seal::Plaintext plaintext(pool);
+    batchEncoder->encode(pad(values), plaintext);
+    auto ciphertext = allocate();
+    encryptor.encrypt(plaintext, ciphertext, pool);
+    return ciphertext;
+}
+
+void SealRuntime::rotate(const seal::Ciphertext &ciphertext, int offset, seal::Ciphertext &destination)
+{
+    offset = rotator.normalize(offset);
+    if (offset == 0)
+        destination = ciphertext;
+    else if (!rotator.hasKey(offset))
+        destination = std::move(rotator.rotate(ciphertext, { offset }, pool)[0]);
+    else if (isCkks())
+        evaluator.rotate_vector(ciphertext, offset, galoisKeys, destination, pool);
+    else
+        evaluator.rotate_rows(ciphertext, offset, galoisKeys, destination, pool);
+}
+
+void SealRuntime::rotateInplace(seal::Ciphertext &ciphertext, int offset)
+{
+    offset = rotator.normalize(offset);
+    if (offset == 0)
+        return;
+    else if (!rotator.hasKey(offset))
+        ciphertext = std::move(rotator.rotate(ciphertext, { offset }, pool)[0]);
+    else if (isCkks())
+        evaluator.rotate_vector_inplace(ciphertext, offset, galoisKeys, pool);
+    else
+        evaluator.rotate_rows_inplace(ciphertext, offset, galoisKeys, pool);
+}
+
+void SealRuntime::align(seal::Ciphertext &x, seal::Ciphertext &y)
+{
+    if (!isCkks())
+        return;
+
+    auto xLevel = context.get_context_data(x.parms_id())->chain_index();
+    auto yLevel = context.get_context_data(y.parms_id())->chain_index();
+    if (xLevel > yLevel)
+        evaluator.mod_switch_to_inplace(x, y.parms_id(), pool);
+    else if (yLevel > xLevel)
+        evaluator.mod_switch_to_inplace(y, x.parms_id(), pool);
+
+    // after rescaling by different primes, the scales only differ by a factor close to 1
+    x.scale() = y.scale();
+}
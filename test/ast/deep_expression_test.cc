@@ -0,0 +1,114 @@
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/compiler_pipeline.h"
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/plaintext_interpreter.h"
+#include "transpiration/ast/utils/static_visitor.h"
+#include "transpiration/ast/utils/structural_hash.h"
+#include "transpiration/ast/utils/visitor.h"
+
+namespace
+{
+/// Depth of the chains, well beyond what recursing on a default 8 MiB stack survives
+const size_t depth = 1000000;
+
+/// Counts the Variables of an AST with the default traversal of the PlainVisitor, i.e., the TraversalStack
+class SpecialVariableCountingVisitor : public PlainVisitor
+{
+public:
+    size_t count = 0;
+
+    void visit(Variable &)
+    {
+        ++count;
+    }
+};
+
+typedef Visitor<SpecialVariableCountingVisitor, PlainVisitor> VariableCountingVisitor;
+
+/// y = x + x + ... + x with n + 1 terms, i.e., a left-deep chain of n BinaryExpressions, or with every term but the
+/// first in parentheses nested n deep if parenthesized (n + 3 Variables either way), as in deep_expression_benchmark
+std::string program(size_t n, bool parenthesized)
+{
+    std::ostringstream source;
+    source << "public int chain(secret int x) {\n";
+    source << "  secret int y = x";
+    for (size_t i = 0; i < n; ++i)
+        source << (parenthesized ? " + (x" : " + x");
+    if (parenthesized)
+        source << std::string(n, ')');
+    source << ";\n  return y;\n}\n";
+    return source.str();
+}
+
+size_t occurrences(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size()))
+        ++count;
+    return count;
+}
+
+/// Parameter: whether the chain is parenthesized, i.e., right-deep instead of left-deep
+class DeepExpressionTest : public ::testing::TestWithParam<bool>
+{
+protected:
+    std::string source = program(depth, GetParam());
+};
+} // namespace
+
+TEST_P(DeepExpressionTest, parseAndTraverse)
+{
+    auto ast = Parser::parse(source);
+
+    size_t walked = 0;
+    walk(*ast, overloaded{ [&walked](Variable &) { ++walked; }, [](AbstractNode &) {} });
+    EXPECT_EQ(walked, depth + 3);
+
+    VariableCountingVisitor counter;
+    ast->accept(counter);
+    EXPECT_EQ(counter.count, depth + 3);
+}
+
+TEST_P(DeepExpressionTest, cloneAndPrint)
+{
+    auto ast = Parser::parse(source);
+    auto clone = ast->clone(nullptr);
+    EXPECT_EQ(CompilerPipeline::countNodes(*clone), CompilerPipeline::countNodes(*ast));
+    EXPECT_EQ(structuralHash(*clone), structuralHash(*ast));
+
+    auto printed = clone->toString(true);
+    EXPECT_EQ(occurrences(printed, "Variable (x)"), depth + 1);
+    // destroying both ASTs has to be iterative too
+    clone.reset();
+    ast.reset();
+}
+
+TEST_P(DeepExpressionTest, interpret)
+{
+    auto ast = Parser::parse(source);
+    PlaintextInterpreter interpreter;
+    ast->accept(interpreter);
+    EXPECT_EQ(interpreter.run("chain", { PlainValue(1.0) }).scalar, static_cast<double>(depth + 1));
+}
+
+TEST_P(DeepExpressionTest, compile)
+{
+    CompilerPipeline pipeline;
+    std::ostringstream output;
+    auto report = pipeline.compile(source, output);
+
+    auto code = output.str();
+    EXPECT_EQ(report.emittedBytes, code.size());
+    EXPECT_NE(code.find("seal::Ciphertext chain(SealRuntime &runtime, seal::Ciphertext x)"), std::string::npos);
+    // one homomorphic addition per BinaryExpression
+    EXPECT_EQ(occurrences(code, "runtime.evaluator.add_inplace("), depth);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    LeftAndRightDeep, DeepExpressionTest, ::testing::Bool(),
+    [](const ::testing::TestParamInfo<bool> &info) { return info.param ? "parenthesized" : "chain"; });
@@ -0,0 +1,178 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/branch_elimination_visitor.h"
+#include "transpiration/ast/utils/plaintext_interpreter.h"
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// Taints the program and eliminates its secret branches, as CompilerPipeline::compileUnit does
+void eliminateBranches(AbstractNode &ast)
+{
+    SecretTaintVisitor taint;
+    ast.accept(taint);
+    BranchEliminationVisitor branchElimination(taint.getTaintedNodes());
+    ast.accept(branchElimination);
+}
+
+/// Number of Ifs left in the program, whose conditions are all plaintext after eliminateBranches
+size_t countIfs(AbstractNode &ast)
+{
+    size_t count = 0;
+    walk(ast, overloaded{ [&count](If &) { ++count; }, [](AbstractNode &) {} });
+    return count;
+}
+
+std::vector<double> run(AbstractNode &ast, const std::string &function, double argument)
+{
+    PlaintextInterpreter interpreter;
+    ast.accept(interpreter);
+    auto result = interpreter.run(function, { PlainValue(argument) });
+    return result.isArray ? result.elements : std::vector<double>{ result.scalar };
+}
+
+/// Interprets the Function of the program before and after eliminating its branches (the oracle), which must give the
+/// same results for all arguments and leave remainingIfs (plaintext) Ifs
+void expectSameResults(const std::string &source, const std::string &function, size_t remainingIfs = 0)
+{
+    auto original = Parser::parse(source);
+    auto flattened = Parser::parse(source);
+    eliminateBranches(*flattened);
+    EXPECT_EQ(countIfs(*flattened), remainingIfs);
+
+    for (double argument : { -3, -1, 0, 1, 2, 3, 5 })
+    {
+        SCOPED_TRACE(function + "(" + std::to_string(argument) + ")");
+        EXPECT_EQ(run(*flattened, function, argument), run(*original, function, argument));
+    }
+}
+} // namespace
+
+TEST(BranchEliminationVisitorTest, writeInThenBranchOnly)
+{
+    expectSameResults(
+        "public int thenOnly(secret int x) {\n"
+        "  int y = 7;\n"
+        "  if (x < 1) {\n"
+        "    y = x * 3;\n"
+        "    y = y + 1;\n"
+        "  }\n"
+        "  return y;\n"
+        "}\n",
+        "thenOnly");
+}
+
+TEST(BranchEliminationVisitorTest, writeInElseBranchOnly)
+{
+    expectSameResults(
+        "public int elseOnly(secret int x) {\n"
+        "  int y = 7;\n"
+        "  int z = 2;\n"
+        "  if (x < 1) {\n"
+        "  } else {\n"
+        "    y = x - z;\n"
+        "  }\n"
+        "  return y + z;\n"
+        "}\n",
+        "elseOnly");
+}
+
+TEST(BranchEliminationVisitorTest, writeToIndexAccess)
+{
+    expectSameResults(
+        "public int indexed(secret int x) {\n"
+        "  int v[] = {1, 2, 3, 4};\n"
+        "  if (x > 0) {\n"
+        "    v[1] = x;\n"
+        "    v[3] = v[1] + v[2];\n"
+        "  } else {\n"
+        "    v[0] = 0 - x;\n"
+        "  }\n"
+        "  return v;\n"
+        "}\n",
+        "indexed");
+}
+
+TEST(BranchEliminationVisitorTest, nestedSecretIfs)
+{
+    expectSameResults(
+        "public int nested(secret int x) {\n"
+        "  int y = 0;\n"
+        "  int z = 1;\n"
+        "  if (x > 0) {\n"
+        "    if (x > 2) {\n"
+        "      y = 3;\n"
+        "    } else {\n"
+        "      y = 2;\n"
+        "      z = x;\n"
+        "    }\n"
+        "  } else {\n"
+        "    if (x < 0 - 2) {\n"
+        "      z = 0 - x;\n"
+        "    }\n"
+        "    y = y - 1;\n"
+        "  }\n"
+        "  return y * 10 + z;\n"
+        "}\n",
+        "nested");
+}
+
+TEST(BranchEliminationVisitorTest, plaintextIfIsKept)
+{
+    expectSameResults(
+        "public int mixed(secret int x) {\n"
+        "  int y = 0;\n"
+        "  for (int i = 0; i < 3; i = i + 1) {\n"
+        "    if (i > 1) {\n"
+        "      y = y + x;\n"
+        "    }\n"
+        "  }\n"
+        "  if (x > 0) {\n"
+        "    y = y * 2;\n"
+        "  }\n"
+        "  return y;\n"
+        "}\n",
+        "mixed", 1);
+}
+
+TEST(BranchEliminationVisitorTest, variablesDeclaredInBranches)
+{
+    // t is declared in both branches and shadows nothing, s shadows the outer s in the then branch only
+    expectSameResults(
+        "public int declared(secret int x) {\n"
+        "  int y = 1;\n"
+        "  int s = 4;\n"
+        "  if (x > 1) {\n"
+        "    int t = x * 2;\n"
+        "    int s = t + 1;\n"
+        "    y = t + s;\n"
+        "  } else {\n"
+        "    int t = x - 5;\n"
+        "    y = t * t;\n"
+        "    s = s + 1;\n"
+        "  }\n"
+        "  return y * 100 + s;\n"
+        "}\n",
+        "declared");
+}
+
+TEST(BranchEliminationVisitorTest, returnInSecretBranchIsRejected)
+{
+    auto ast = Parser::parse(
+        "public int early(secret int x) {\n"
+        "  int y = 0;\n"
+        "  if (x > 0) {\n"
+        "    y = 1;\n"
+        "  } else {\n"
+        "    return x;\n"
+        "  }\n"
+        "  return y;\n"
+        "}\n");
+    EXPECT_THROW(eliminateBranches(*ast), runtime_error);
+}
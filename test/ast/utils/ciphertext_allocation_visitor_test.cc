@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/ast.h"
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/ciphertext_allocation_visitor.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// The first Function of a program
+Function &firstFunction(AbstractNode &program)
+{
+    Function *found = nullptr;
+    walk(program, overloaded{ [&found](Function &function) {
+                                 if (!found)
+                                     found = &function;
+                             },
+                              [](AbstractNode &) {} });
+    return *found;
+}
+
+/// The declarations of the variable with the given identifier, in the order their live intervals start
+std::vector<ScopedIdentifier> declarations(CiphertextAllocationVisitor &allocation, const std::string &identifier)
+{
+    std::vector<ScopedIdentifier> found;
+    for (auto &[scopedIdentifier, interval] : allocation.getIntervals())
+    {
+        if (scopedIdentifier.getId() == identifier)
+            found.push_back(scopedIdentifier);
+    }
+    std::sort(found.begin(), found.end(), [&allocation](const ScopedIdentifier &a, const ScopedIdentifier &b) {
+        return allocation.getIntervals().at(a).start < allocation.getIntervals().at(b).start;
+    });
+    return found;
+}
+
+/// Variables whose live intervals overlap (beyond a single statement that reads one and defines the other) must not
+/// share a buffer
+void expectNoSharedBuffersWhileLive(CiphertextAllocationVisitor &allocation)
+{
+    auto &intervals = allocation.getIntervals();
+    auto &buffers = allocation.allocate();
+    for (auto &[a, aInterval] : intervals)
+    {
+        for (auto &[b, bInterval] : intervals)
+        {
+            if (std::equal_to<ScopedIdentifier>{}(a, b) || buffers.at(a) != buffers.at(b))
+                continue;
+            EXPECT_TRUE(aInterval.end <= bInterval.start || bInterval.end <= aInterval.start)
+                << a.getId() << " and " << b.getId() << " share " << buffers.at(a);
+        }
+    }
+}
+} // namespace
+
+TEST(CiphertextAllocationVisitorTest, shadowingVariableGetsBufferOfItsOwn)
+{
+    auto program = Parser::parse(
+        "public int shadow(secret int x) {\n"
+        "  secret int y = x + 1;\n"
+        "  for (int i = 0; i < 2; i = i + 1) {\n"
+        "    secret int y = x * 3;\n"
+        "    x = x + y;\n"
+        "  }\n"
+        "  return x * y;\n"
+        "}\n");
+    auto &function = firstFunction(*program);
+    CiphertextAllocationVisitor allocation(std::unordered_set<std::string>{ "x", "y" });
+    function.accept(allocation);
+    auto &buffers = allocation.allocate();
+
+    auto y = declarations(allocation, "y");
+    ASSERT_EQ(y.size(), 2);
+    EXPECT_NE(buffers.at(y[0]), buffers.at(y[1]));
+    EXPECT_EQ(allocation.getBufferCount(), 3);
+    expectNoSharedBuffersWhileLive(allocation);
+
+    // the result reads the outer y, which is renamed to its buffer and not to the one of the inner y
+    allocation.assignBuffers();
+    auto &result = dynamic_cast<Return &>(function.getBody().getStatements().back().get());
+    auto &product = dynamic_cast<BinaryExpression &>(result.getValue());
+    EXPECT_EQ(dynamic_cast<Variable &>(product.getRight()).getIdentifier(), buffers.at(y[0]));
+}
+
+TEST(CiphertextAllocationVisitorTest, loopCarriedValuesLiveThroughLoop)
+{
+    // c is only read in the first statement of the loop and s is written in every iteration, but the next iteration
+    // reads both of them again, so t and u can take over neither of their buffers
+    auto program = Parser::parse(
+        "public int loop(secret int x) {\n"
+        "  secret int c = x * 2;\n"
+        "  secret int s = x;\n"
+        "  for (int i = 0; i < 4; i = i + 1) {\n"
+        "    secret int t = c * x;\n"
+        "    secret int u = t + s;\n"
+        "    s = u * u;\n"
+        "  }\n"
+        "  return s;\n"
+        "}\n");
+    auto &function = firstFunction(*program);
+    CiphertextAllocationVisitor allocation(std::unordered_set<std::string>{ "x", "c", "s", "t", "u" });
+    function.accept(allocation);
+    auto &buffers = allocation.allocate();
+
+    auto c = declarations(allocation, "c")[0];
+    auto s = declarations(allocation, "s")[0];
+    auto t = declarations(allocation, "t")[0];
+    auto u = declarations(allocation, "u")[0];
+    auto &intervals = allocation.getIntervals();
+    EXPECT_GE(intervals.at(c).end, intervals.at(u).end);
+    EXPECT_GE(intervals.at(s).end, intervals.at(u).end);
+    for (auto &value : { t, u })
+    {
+        EXPECT_NE(buffers.at(value), buffers.at(c));
+        EXPECT_NE(buffers.at(value), buffers.at(s));
+    }
+    // u is computed from t, which dies there
+    EXPECT_EQ(buffers.at(u), buffers.at(t));
+    expectNoSharedBuffersWhileLive(allocation);
+}
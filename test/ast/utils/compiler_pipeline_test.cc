@@ -0,0 +1,71 @@
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/utils/compiler_pipeline.h"
+
+namespace
+{
+const char *source =
+    "public int sum(secret int x) {\n"
+    "  secret int v[] = {1, 2, 3, 4};\n"
+    "  int w[] = v * x;\n"
+    "  int s = 0;\n"
+    "  for (int i = 0; i < 4; i = i + 1) {\n"
+    "    s = s + w[i] * v[i];\n"
+    "  }\n"
+    "  return s;\n"
+    "}\n";
+
+/// A directory of its own for every test, removed afterwards
+class CompilerPipelineTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+
+    void SetUp() override
+    {
+        auto test = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        directory = std::filesystem::temp_directory_path() / (std::string("transpiration_pipeline_test_") + test);
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+std::string compile(const CompilerPipeline &pipeline)
+{
+    std::ostringstream code;
+    pipeline.compile(source, code);
+    return code.str();
+}
+} // namespace
+
+TEST_F(CompilerPipelineTest, costTableIsPartOfTheProgramKey)
+{
+    ProgramCache cache(directory.string());
+    CompilerPipeline pipeline;
+    pipeline.setProgramCache(&cache);
+    auto code = compile(pipeline);
+    EXPECT_EQ(compile(pipeline), code);
+    EXPECT_EQ(cache.getHits(), 1);
+
+    // the layouts might be chosen differently with other latencies, so the program is compiled again
+    CompilerPipeline weighted;
+    weighted.setProgramCache(&cache);
+    weighted.setCostTable(CostTable::defaults());
+    EXPECT_EQ(compile(weighted), code);
+    EXPECT_EQ(cache.getHits(), 1);
+    compile(weighted);
+    EXPECT_EQ(cache.getHits(), 2);
+
+    CompilerPipeline other;
+    other.setProgramCache(&cache);
+    other.setCostTable(CostTable("bfv", 8192, 4, { { "rotate", 1000.0 }, { "multiply_plain", 1.0 } }));
+    compile(other);
+    EXPECT_EQ(cache.getHits(), 2);
+}
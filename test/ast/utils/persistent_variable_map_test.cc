@@ -0,0 +1,96 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/block.h"
+#include "transpiration/ast/utils/persistent_variable_map.h"
+
+namespace
+{
+class PersistentVariableMapTest : public ::testing::Test
+{
+protected:
+    Block block;
+    Scope scope{ block };
+    std::vector<ScopedIdentifier> variables;
+
+    void SetUp() override
+    {
+        for (size_t i = 0; i < 100; ++i)
+            variables.emplace_back(scope, "v" + std::to_string(i));
+    }
+
+    /// A map of all variables (all of them false), whose entries are all marked as changed
+    PersistentVariableMap<bool> written()
+    {
+        PersistentVariableMap<bool> map;
+        for (auto &variable : variables)
+            map.insert_or_assign(variable, false);
+        return map;
+    }
+};
+
+bool join(bool a, bool b)
+{
+    return a || b;
+}
+} // namespace
+
+TEST_F(PersistentVariableMapTest, mergeIntoOriginOnlyTakesChangesOfFork)
+{
+    auto map = written();
+    auto fork = map.fork();
+    fork.insert_or_assign(variables[3], true);
+    Block inner;
+    Scope innerScope(inner);
+    ScopedIdentifier declared(innerScope, "d");
+    fork.insert_or_assign(declared, true);
+
+    map.merge(fork, join);
+    EXPECT_TRUE(map.get(variables[3]));
+    EXPECT_TRUE(map.get(declared));
+    EXPECT_FALSE(map.get(variables[4]));
+    EXPECT_EQ(map.size(), variables.size() + 1);
+}
+
+TEST_F(PersistentVariableMapTest, mergeOfSiblingsJoinsChangesOfBoth)
+{
+    auto map = written();
+    map.resetChangeFlags();
+    auto thenBranch = map.fork(), elseBranch = map.fork();
+    thenBranch.insert_or_assign(variables[1], true);
+    elseBranch.insert_or_assign(variables[2], true);
+
+    thenBranch.merge(elseBranch, join);
+    EXPECT_TRUE(thenBranch.get(variables[1]));
+    EXPECT_TRUE(thenBranch.get(variables[2]));
+    EXPECT_FALSE(thenBranch.get(variables[3]));
+    EXPECT_FALSE(map.get(variables[1]));
+    EXPECT_EQ(thenBranch.changedEntries().size(), 2);
+}
+
+TEST_F(PersistentVariableMapTest, mergeIntoChangedOriginJoinsChangesOfBoth)
+{
+    auto map = written();
+    map.resetChangeFlags();
+    auto fork = map.fork();
+    map.insert_or_assign(variables[5], true);
+    fork.insert_or_assign(variables[6], true);
+
+    map.merge(fork, join);
+    EXPECT_TRUE(map.get(variables[5]));
+    EXPECT_TRUE(map.get(variables[6]));
+}
+
+TEST_F(PersistentVariableMapTest, nestedForksMergeUpToOrigin)
+{
+    auto map = written();
+    auto outer = map.fork();
+    auto inner = outer.fork();
+    inner.insert_or_assign(variables[7], true);
+    outer.merge(inner, join);
+    EXPECT_EQ(outer.changedEntries().count(variables[7]), 1);
+
+    map.merge(outer, join);
+    EXPECT_TRUE(map.get(variables[7]));
+}
@@ -0,0 +1,185 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/parser/errors.h"
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/branch_elimination_visitor.h"
+#include "transpiration/ast/utils/comparison_lowering_visitor.h"
+#include "transpiration/ast/utils/layout_planner.h"
+#include "transpiration/ast/utils/plaintext_interpreter.h"
+#include "transpiration/ast/utils/rotation_scheduling_visitor.h"
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+
+namespace
+{
+/// Number of slots of the ciphertexts, which the layout planner and rotations work with
+const size_t slots = 16;
+
+/// Runs the AST passes of the CompilerPipeline (see CompilerPipeline::compileUnit) on the program
+void lower(AbstractNode &ast)
+{
+    SecretTaintVisitor taint;
+    ast.accept(taint);
+    ComparisonLoweringVisitor comparisonLowering(taint.getTaintedNodes());
+    ast.accept(comparisonLowering);
+
+    SecretTaintVisitor loweredTaint;
+    ast.accept(loweredTaint);
+    BranchEliminationVisitor branchElimination(loweredTaint.getTaintedNodes());
+    ast.accept(branchElimination);
+
+    SecretTaintVisitor flatTaint;
+    ast.accept(flatTaint);
+    LayoutPlanningVisitor layoutPlanning(flatTaint.getTaintedNodes(), slots);
+    ast.accept(layoutPlanning);
+    auto &plan = layoutPlanning.plan();
+    layoutPlanning.insertConversions();
+    RotationSchedulingVisitor rotationScheduling(flatTaint.getTaintedNodes(), layoutPlanning.getSites(), plan);
+    ast.accept(rotationScheduling);
+}
+
+std::vector<double> run(AbstractNode &ast, const std::string &function, double argument)
+{
+    PlaintextInterpreter interpreter(slots);
+    ast.accept(interpreter);
+    auto result = interpreter.run(function, { PlainValue(argument) });
+    return result.isArray ? result.elements : std::vector<double>{ result.scalar };
+}
+
+/// Interprets the Function of the program before and after lowering it, which must not change its results (up to
+/// tolerance, e.g. for comparisons of reals that are approximated by polynomials)
+void expectSameResults(
+    const std::string &source, const std::string &function, const std::vector<double> &arguments,
+    double tolerance = 0)
+{
+    auto original = Parser::parse(source);
+    auto lowered = Parser::parse(source);
+    lower(*lowered);
+
+    for (auto argument : arguments)
+    {
+        SCOPED_TRACE(function + "(" + std::to_string(argument) + ")");
+        auto expected = run(*original, function, argument);
+        auto actual = run(*lowered, function, argument);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            EXPECT_NEAR(actual[i], expected[i], tolerance) << "slot " << i;
+    }
+}
+
+const std::vector<double> integers = { -3, -1, 0, 1, 2, 3, 5 };
+} // namespace
+
+TEST(PlaintextInterpreterTest, secretIfOnIntegersIsFlattenedExactly)
+{
+    expectSameResults(
+        "public int branches(secret int x) {\n"
+        "  int y = x * 2;\n"
+        "  int z = 1;\n"
+        "  if (x < 3) {\n"
+        "    y = y + 1;\n"
+        "    z = y * 3;\n"
+        "  } else {\n"
+        "    int t = x - 1;\n"
+        "    y = t * t;\n"
+        "  }\n"
+        "  return y + z;\n"
+        "}\n",
+        "branches", integers);
+}
+
+TEST(PlaintextInterpreterTest, secretIfInLoopIsFlattenedExactly)
+{
+    expectSameResults(
+        "public int loop(secret int x) {\n"
+        "  int sum = 0;\n"
+        "  for (int i = 0; i < 4; i = i + 1) {\n"
+        "    if (x > i) {\n"
+        "      sum = sum + i;\n"
+        "    } else {\n"
+        "      sum = sum - x;\n"
+        "    }\n"
+        "  }\n"
+        "  return sum;\n"
+        "}\n",
+        "loop", integers);
+}
+
+TEST(PlaintextInterpreterTest, logicalOperatorsOnSecretsKeepTheirResults)
+{
+    expectSameResults(
+        "public int logic(secret int x) {\n"
+        "  bool b = (x < 1 && x > 0 - 3) || !(x == 0);\n"
+        "  bool c = (x > 0 || x < 0 - 1) && (x != 5 || false);\n"
+        "  int r = 0;\n"
+        "  if (b && c) {\n"
+        "    r = x;\n"
+        "  }\n"
+        "  return r + b + 2 * c;\n"
+        "}\n",
+        "logic", integers);
+}
+
+TEST(PlaintextInterpreterTest, loweredComparisonsOfRealsApproximateTheirResults)
+{
+    // the polynomial approximation of sign is accurate for differences in [-1, 1] (see ApproximationConfig) that are
+    // not too close to 0, i.e., for x in [1, 3] but not too close to 2
+    expectSameResults(
+        "public double clamp(secret double x) {\n"
+        "  double y = x;\n"
+        "  if (x > 2.0) {\n"
+        "    y = 2.0;\n"
+        "  }\n"
+        "  return y;\n"
+        "}\n",
+        "clamp", { 1, 1.5, 1.98, 2.02, 2.5, 3 }, 0.01);
+}
+
+TEST(PlaintextInterpreterTest, scheduledReductionsKeepTheirResults)
+{
+    // the second loop sums fewer slots than v has, which the rotation tree masks
+    expectSameResults(
+        "public int reduction(secret int x) {\n"
+        "  secret int v[] = {1, 2, 3, 4, 5, 6, 7, 8};\n"
+        "  int w[] = v * x;\n"
+        "  int sum = 0;\n"
+        "  for (int i = 0; i < 8; i = i + 1) {\n"
+        "    sum = sum + w[i] * v[i];\n"
+        "  }\n"
+        "  int partial = 0;\n"
+        "  for (int i = 0; i < 6; i = i + 1) {\n"
+        "    partial = partial + (v[i] - w[i]);\n"
+        "  }\n"
+        "  return sum * 2 + partial;\n"
+        "}\n",
+        "reduction", integers);
+}
+
+TEST(PlaintextInterpreterTest, rotationsKeepTheirResults)
+{
+    expectSameResults(
+        "public int rotations(secret int x) {\n"
+        "  secret int v[] = {1, 2, 3, 4};\n"
+        "  int w[] = v * x;\n"
+        "  int r[] = rotate(w, 1) + rotate(w, 2) + rotate(w, 3);\n"
+        "  return r;\n"
+        "}\n",
+        "rotations", integers);
+}
+
+TEST(PlaintextInterpreterTest, integersBeyondDoublePrecisionAreRejected)
+{
+    auto ast = Parser::parse(
+        "public int square(int x) {\n"
+        "  return x * x;\n"
+        "}\n");
+    PlaintextInterpreter interpreter;
+    ast->accept(interpreter);
+
+    EXPECT_EQ(interpreter.run("square", { PlainValue(94906265.0) }).scalar, 94906265.0 * 94906265.0);
+    // 94906267^2 = 9007199515875289 > 2^53 has no exact double
+    EXPECT_THROW(interpreter.run("square", { PlainValue(94906267.0) }), runtime_error);
+    EXPECT_THROW(interpreter.run("square", { PlainValue(1e16) }), runtime_error);
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/utils/program_cache.h"
+
+namespace
+{
+/// A directory of its own for every test, removed afterwards
+class ProgramCacheTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory;
+
+    void SetUp() override
+    {
+        auto test = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        directory = std::filesystem::temp_directory_path() / (std::string("transpiration_program_cache_test_") + test);
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+/// A program whose source and code are derived from its key, all with the same size
+CompiledProgram programOf(uint64_t key)
+{
+    CompiledProgram program;
+    program.source = "public int f" + std::to_string(key) + "(secret int x) { return x; }\n";
+    program.options = 42;
+    program.code = std::string(1000, static_cast<char>('a' + key % 26));
+    return program;
+}
+} // namespace
+
+TEST_F(ProgramCacheTest, findsProgramOfSameSourceAndOptionsOnly)
+{
+    ProgramCache cache(directory.string());
+    auto program = programOf(1);
+    program.spec.polyModulusDegree = 16384;
+    cache.insert(1, program);
+
+    auto found = cache.find(1, program.source, program.options);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->code, program.code);
+    EXPECT_EQ(found->spec.polyModulusDegree, 16384);
+
+    // a collision of the keys, either of the same length or not
+    auto other = program.source;
+    other.back() = ' ';
+    EXPECT_FALSE(cache.find(1, other, program.options));
+    EXPECT_FALSE(cache.find(1, program.source + " ", program.options));
+    EXPECT_FALSE(cache.find(1, program.source, program.options + 1));
+    EXPECT_FALSE(cache.find(2, program.source, program.options));
+    EXPECT_EQ(cache.getHits(), 1);
+    EXPECT_EQ(cache.getMisses(), 4);
+
+    // another process sees the program as well
+    ProgramCache reopened(directory.string());
+    EXPECT_TRUE(reopened.find(1, program.source, program.options));
+}
+
+TEST_F(ProgramCacheTest, evictsLeastRecentlyUsedProgram)
+{
+    ProgramCache probe(directory.string());
+    probe.insert(0, programOf(0));
+    auto size = probe.getBytes();
+    std::filesystem::remove_all(directory);
+
+    // room for two programs
+    ProgramCache cache(directory.string(), 2 * size + size / 2);
+    cache.insert(1, programOf(1));
+    cache.insert(2, programOf(2));
+    ASSERT_TRUE(cache.find(1, programOf(1).source, programOf(1).options));
+    cache.insert(3, programOf(3));
+    EXPECT_EQ(cache.getEvictions(), 1);
+    EXPECT_LE(cache.getBytes(), 2 * size + size / 2);
+
+    EXPECT_FALSE(cache.find(2, programOf(2).source, programOf(2).options));
+    EXPECT_TRUE(cache.find(1, programOf(1).source, programOf(1).options));
+    EXPECT_TRUE(cache.find(3, programOf(3).source, programOf(3).options));
+}
+
+TEST_F(ProgramCacheTest, concurrentWritersNeverExposePartialPrograms)
+{
+    // every thread stands for a process with a cache of its own on the shared directory
+    const uint64_t keys = 8;
+    std::atomic<size_t> hits{ 0 };
+    std::atomic<size_t> corrupt{ 0 };
+    std::vector<std::thread> writers;
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        writers.emplace_back([&, thread]() {
+            ProgramCache cache(directory.string());
+            for (int round = 0; round < 50; ++round)
+            {
+                auto key = (thread + round) % keys;
+                auto program = programOf(key);
+                if (auto found = cache.find(key, program.source, program.options))
+                {
+                    ++hits;
+                    if (found->code != program.code || found->source != program.source)
+                        ++corrupt;
+                }
+                cache.insert(key, program);
+            }
+        });
+    }
+    for (auto &writer : writers)
+        writer.join();
+
+    EXPECT_EQ(corrupt, 0);
+    EXPECT_GT(hits, 0);
+    ProgramCache cache(directory.string());
+    for (uint64_t key = 0; key < keys; ++key)
+    {
+        auto found = cache.find(key, programOf(key).source, programOf(key).options);
+        ASSERT_TRUE(found);
+        EXPECT_EQ(found->code, programOf(key).code);
+    }
+}
@@ -0,0 +1,52 @@
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/block.h"
+#include "transpiration/ast/utils/scope.h"
+
+TEST(ScopeTest, contextReplacesSymbolTableOfItsThreadOnly)
+{
+    auto processSymbols = SymbolTable::current();
+    {
+        SymbolTable::Context context;
+        auto contextSymbols = SymbolTable::current();
+        EXPECT_NE(contextSymbols, processSymbols);
+
+        std::shared_ptr<SymbolTable> otherThreadSymbols;
+        std::thread([&otherThreadSymbols]() { otherThreadSymbols = SymbolTable::current(); }).join();
+        EXPECT_EQ(otherThreadSymbols, processSymbols);
+
+        {
+            SymbolTable::Context nested;
+            EXPECT_NE(SymbolTable::current(), contextSymbols);
+        }
+        EXPECT_EQ(SymbolTable::current(), contextSymbols);
+    }
+    EXPECT_EQ(SymbolTable::current(), processSymbols);
+}
+
+TEST(ScopeTest, scopesKeepTheirSymbolTableBeyondContext)
+{
+    Block root, inner;
+    std::unique_ptr<Scope> scope;
+    std::weak_ptr<SymbolTable> contextSymbols;
+    {
+        SymbolTable::Context context;
+        contextSymbols = SymbolTable::current();
+        scope = std::make_unique<Scope>(root);
+        scope->addIdentifier("x");
+    }
+    ASSERT_FALSE(contextSymbols.expired());
+
+    // nested scopes intern their identifiers in the table of the root scope
+    auto nested = Scope::createNestedScope(*scope, inner);
+    nested->addIdentifier("y");
+    EXPECT_EQ(&nested->getSymbolTable(), contextSymbols.lock().get());
+    EXPECT_EQ(nested->resolveIdentifier("x").getId(), "x");
+    EXPECT_EQ(nested->resolveIdentifier("y").getId(), "y");
+    EXPECT_FALSE(scope->identifierExists("y"));
+
+    scope.reset();
+    EXPECT_TRUE(contextSymbols.expired());
+}
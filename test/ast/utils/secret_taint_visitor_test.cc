@@ -0,0 +1,144 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "transpiration/ast/ast.h"
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// The Function of a program with the given identifier
+Function &function(AbstractNode &program, const std::string &identifier)
+{
+    Function *found = nullptr;
+    walk(program, overloaded{ [&](Function &function) {
+                                 if (function.getIdentifier() == identifier)
+                                     found = &function;
+                             },
+                              [](AbstractNode &) {} });
+    if (!found)
+        throw std::runtime_error("No function " + identifier + ".");
+    return *found;
+}
+
+/// The first BinaryExpression of a Function, in the order of the source
+BinaryExpression &firstBinaryExpression(Function &function)
+{
+    BinaryExpression *found = nullptr;
+    walk(function, overloaded{ [&](BinaryExpression &binaryExpression) {
+                                  if (!found)
+                                      found = &binaryExpression;
+                              },
+                               [](AbstractNode &) {} });
+    if (!found)
+        throw std::runtime_error("No BinaryExpression in " + function.getIdentifier() + ".");
+    return *found;
+}
+
+/// Replaces the value of the first statement of a Function, a VariableDeclaration or a Return, with a Call (the source
+/// parser has no syntax for calls to user Functions)
+void setCall(Function &function, const std::string &callee, const std::vector<std::string> &arguments)
+{
+    std::vector<std::unique_ptr<AbstractExpression>> args;
+    for (auto &argument : arguments)
+        args.emplace_back(std::make_unique<Variable>(argument));
+    auto call = std::make_unique<Call>(callee, std::move(args));
+
+    auto &statement = function.getBody().getStatements().front().get();
+    if (auto declaration = dynamic_cast<VariableDeclaration *>(&statement))
+        declaration->setValue(std::move(call));
+    else
+        dynamic_cast<Return &>(statement).setValue(std::move(call));
+}
+
+bool isSecretParameter(Function &function, size_t i)
+{
+    return function.getParameters()[i].get().getParameterType().getSecretFlag();
+}
+} // namespace
+
+TEST(SecretTaintVisitorTest, callToSecretFunctionDefinedLaterIsSecret)
+{
+    auto program = Parser::parse(
+        "public int first(int a) {\n"
+        "  int b = 0;\n"
+        "  return b * a;\n"
+        "}\n"
+        "public int later(int c) {\n"
+        "  secret int s = 5;\n"
+        "  return s + c;\n"
+        "}\n");
+    setCall(function(*program, "first"), "later", { "a" });
+    SecretTaintVisitor taint;
+    program->accept(taint);
+
+    EXPECT_EQ(taint.getSecretFunctions().count("later"), 1);
+    EXPECT_EQ(taint.getSecretFunctions().count("first"), 1);
+    auto &product = firstBinaryExpression(function(*program, "first"));
+    EXPECT_TRUE(taint.isSecretTainted(product));
+    EXPECT_EQ(taint.getSpecialization(product), OpSpecialization::CIPHER_PLAIN);
+    EXPECT_EQ(product.getOperator().toString(), Operator(FHE_MULTIPLICATION).toString());
+}
+
+TEST(SecretTaintVisitorTest, secretArgumentMakesParameterOfLaterFunctionSecret)
+{
+    auto program = Parser::parse(
+        "public int caller(secret int x) {\n"
+        "  return 0;\n"
+        "}\n"
+        "public int callee(int p) {\n"
+        "  return p * 2;\n"
+        "}\n");
+    setCall(function(*program, "caller"), "callee", { "x" });
+    SecretTaintVisitor taint;
+    program->accept(taint);
+
+    auto &callee = function(*program, "callee");
+    EXPECT_TRUE(isSecretParameter(callee, 0));
+    EXPECT_EQ(taint.getSpecialization(firstBinaryExpression(callee)), OpSpecialization::CIPHER_PLAIN);
+    EXPECT_EQ(taint.getSecretFunctions().count("callee"), 1);
+}
+
+TEST(SecretTaintVisitorTest, secretArgumentMakesParameterOfEarlierFunctionSecret)
+{
+    auto program = Parser::parse(
+        "public int callee(int p, int q) {\n"
+        "  return p + q;\n"
+        "}\n"
+        "public int caller(int w, secret int x) {\n"
+        "  int y = 0;\n"
+        "  return y;\n"
+        "}\n");
+    setCall(function(*program, "caller"), "callee", { "w", "x" });
+    SecretTaintVisitor taint;
+    program->accept(taint);
+
+    auto &callee = function(*program, "callee");
+    EXPECT_FALSE(isSecretParameter(callee, 0));
+    EXPECT_TRUE(isSecretParameter(callee, 1));
+    EXPECT_EQ(taint.getSpecialization(firstBinaryExpression(callee)), OpSpecialization::CIPHER_PLAIN);
+    EXPECT_EQ(taint.getSecretFunctions().count("caller"), 1);
+}
+
+TEST(SecretTaintVisitorTest, plainCallsStayPlain)
+{
+    auto program = Parser::parse(
+        "public int caller(int x) {\n"
+        "  int y = 0;\n"
+        "  return y + 1;\n"
+        "}\n"
+        "public int callee(int p) {\n"
+        "  return p * 2;\n"
+        "}\n");
+    setCall(function(*program, "caller"), "callee", { "x" });
+    SecretTaintVisitor taint;
+    program->accept(taint);
+
+    EXPECT_TRUE(taint.getSecretFunctions().empty());
+    EXPECT_FALSE(isSecretParameter(function(*program, "callee"), 0));
+    EXPECT_EQ(
+        taint.getSpecialization(firstBinaryExpression(function(*program, "caller"))), OpSpecialization::PLAIN_PLAIN);
+}
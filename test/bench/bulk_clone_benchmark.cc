@@ -0,0 +1,114 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/bulk_clone.h"
+#include "transpiration/ast/utils/static_visitor.h"
+
+namespace
+{
+/// The body of a loop over i, which is cloned for every iteration that is unrolled
+std::unique_ptr<AbstractNode> loopBody()
+{
+    return Parser::parse(
+        "{\n"
+        "  sum = sum + x[i] * y[i] + i;\n"
+        "  secret int t = x[i + 1] - y[i - 1];\n"
+        "  sum = sum + t * t;\n"
+        "  prod = prod * (x[i] + y[i]);\n"
+        "}\n");
+}
+
+/// clone() followed by the pass that renames the induction variable of every clone
+void cloneThenRename(benchmark::State &state)
+{
+    auto body = loopBody();
+    for (auto _ : state)
+    {
+        std::vector<std::unique_ptr<AbstractNode>> iterations;
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            auto clone = body->clone();
+            auto identifier = "i" + std::to_string(i);
+            walk(*clone, overloaded{ [&identifier](Variable &variable) {
+                                        if (variable.getIdentifier() == "i")
+                                            variable.setIdentifier(identifier);
+                                    },
+                                     [](AbstractNode &) {} });
+            iterations.push_back(std::move(clone));
+        }
+        benchmark::DoNotOptimize(iterations);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// bulkClone() on the heap, which renames the induction variable while cloning
+void bulkCloneRenaming(benchmark::State &state)
+{
+    auto body = loopBody();
+    for (auto _ : state)
+    {
+        std::vector<std::unique_ptr<AbstractNode>> iterations;
+        Substitutions substitutions;
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            Variable renamed("i" + std::to_string(i));
+            substitutions["i"] = &renamed;
+            iterations.push_back(bulkClone(*body, nullptr, substitutions));
+        }
+        benchmark::DoNotOptimize(iterations);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// The same into a NodeArena, including deleting the clones and the arena
+void bulkCloneIntoArena(benchmark::State &state)
+{
+    auto body = loopBody();
+    for (auto _ : state)
+    {
+        NodeArena arena;
+        std::vector<std::unique_ptr<AbstractNode>> iterations;
+        Substitutions substitutions;
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            Variable renamed("i" + std::to_string(i));
+            substitutions["i"] = &renamed;
+            iterations.push_back(bulkClone(*body, &arena, substitutions));
+        }
+        benchmark::DoNotOptimize(iterations);
+        iterations.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Substituting the LiteralInt of every iteration, which a pass after clone() would have to replace nodes for
+void bulkCloneSubstituting(benchmark::State &state)
+{
+    auto body = loopBody();
+    for (auto _ : state)
+    {
+        NodeArena arena;
+        std::vector<std::unique_ptr<AbstractNode>> iterations;
+        Substitutions substitutions;
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            LiteralInt iteration(static_cast<int>(i));
+            substitutions["i"] = &iteration;
+            iterations.push_back(bulkClone(*body, &arena, substitutions));
+        }
+        benchmark::DoNotOptimize(iterations);
+        iterations.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(cloneThenRename)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(bulkCloneRenaming)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(bulkCloneIntoArena)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(bulkCloneSubstituting)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "transpiration/ast/utils/compiler_pipeline.h"
+
+namespace
+{
+/// Slots of a ciphertext for the default parameters (N = 8192), larger kernels wrap around, i.e., process several
+/// batches of their input packed into the same ciphertext
+const size_t slots = 4096;
+
+/// Side length of the square (or cube) with about n elements
+size_t root(size_t n, double degree)
+{
+    return std::max<size_t>(2, static_cast<size_t>(std::round(std::pow(static_cast<double>(n), 1 / degree))));
+}
+
+/// sum += x[i] * y[i], unrolled n times
+std::string dotProduct(size_t n)
+{
+    std::ostringstream source;
+    source << "public int dot(secret int x, secret int y) {\n";
+    source << "  secret int sum = 0;\n";
+    for (size_t i = 0; i < n; ++i)
+        source << "  sum = sum + x[" << (i % slots) << "] * y[" << (i % slots) << "];\n";
+    source << "  return sum;\n}\n";
+    return source.str();
+}
+
+/// C = A * B for d x d matrices in row-major order, with d^3 ~ n multiplications
+std::string matrixMultiplication(size_t n)
+{
+    auto d = root(n, 3);
+    std::ostringstream source;
+    source << "public int matmul(secret int a, secret int b) {\n";
+    source << "  secret int trace = 0;\n";
+    for (size_t i = 0; i < d; ++i)
+    {
+        for (size_t j = 0; j < d; ++j)
+        {
+            source << "  secret int c_" << i << "_" << j << " = 0";
+            for (size_t k = 0; k < d; ++k)
+                source << " + a[" << (i * d + k) % slots << "] * b[" << (k * d + j) % slots << "]";
+            source << ";\n";
+        }
+        source << "  trace = trace + c_" << i << "_" << i << ";\n";
+    }
+    source << "  return trace;\n}\n";
+    return source.str();
+}
+
+/// A polynomial of degree n, evaluated with Horner's method
+std::string polynomialEvaluation(size_t n)
+{
+    std::ostringstream source;
+    source << "public int poly(secret int x) {\n";
+    source << "  secret int y = 1;\n";
+    for (size_t i = 0; i < n; ++i)
+        source << "  y = y * x + " << (i % 7 + 1) << ";\n";
+    source << "  return y;\n}\n";
+    return source.str();
+}
+
+/// Roberts cross edge detection on a w x w image with w^2 ~ n pixels, one statement per pixel
+std::string robertsCross(size_t n)
+{
+    auto w = root(n, 2);
+    std::ostringstream source;
+    source << "public int roberts(secret int img) {\n";
+    source << "  secret int edges = 0;\n";
+    for (size_t k = 0; k < w * w; ++k)
+    {
+        auto pixel = [&](size_t offset) { return "img[" + std::to_string((k + offset) % slots) + "]"; };
+        auto gx = "(" + pixel(0) + " - " + pixel(w + 1) + ")";
+        auto gy = "(" + pixel(1) + " - " + pixel(w) + ")";
+        source << "  edges = edges + " << gx << " * " << gx << " + " << gy << " * " << gy << ";\n";
+    }
+    source << "  return edges;\n}\n";
+    return source.str();
+}
+
+/// 3 x 3 box blur of a w x w image with w^2 ~ n pixels, one statement per pixel
+std::string boxBlur(size_t n)
+{
+    auto w = root(n, 2);
+    std::ostringstream source;
+    source << "public int blur(secret int img) {\n";
+    source << "  secret int blurred = 0;\n";
+    for (size_t k = 0; k < w * w; ++k)
+    {
+        source << "  blurred = blurred";
+        for (size_t row = 0; row < 3; ++row)
+        {
+            for (size_t column = 0; column < 3; ++column)
+                source << " + img[" << (k + row * w + column) % slots << "]";
+        }
+        source << ";\n";
+    }
+    source << "  return blurred;\n}\n";
+    return source.str();
+}
+
+const std::vector<std::pair<std::string, std::function<std::string(size_t)>>> kernels = {
+    { "dot_product", dotProduct },
+    { "matrix_multiplication", matrixMultiplication },
+    { "polynomial_evaluation", polynomialEvaluation },
+    { "roberts_cross", robertsCross },
+    { "box_blur", boxBlur },
+};
+
+/// Compiles the kernel unrolled to state.range(0) statements, reporting every phase as a counter
+void compile(benchmark::State &state, const std::function<std::string(size_t)> &kernel)
+{
+    auto source = kernel(static_cast<size_t>(state.range(0)));
+    CompilerPipeline pipeline;
+    std::map<std::string, double> milliseconds;
+    CompilationReport report;
+    for (auto _ : state)
+    {
+        std::ostringstream output;
+        report = pipeline.compile(source, output);
+        for (auto &phase : report.phases)
+            milliseconds[phase.name] += phase.milliseconds;
+    }
+
+    for (auto &[phase, total] : milliseconds)
+        state.counters[phase + "_ms"] = benchmark::Counter(total, benchmark::Counter::kAvgIterations);
+    // the peak of the whole process, i.e., of the largest program compiled so far
+    state.counters["peak_rss_bytes"] = static_cast<double>(report.phases.back().peakResidentBytes);
+    state.counters["tokens"] = static_cast<double>(report.tokens);
+    state.counters["parsed_nodes"] = static_cast<double>(report.parsedNodes);
+    state.counters["lowered_nodes"] = static_cast<double>(report.loweredNodes);
+    state.counters["mlir_operations"] = static_cast<double>(report.mlirOperations);
+    state.counters["emitted_bytes"] = static_cast<double>(report.emittedBytes);
+    for (auto &[counter, value] : report.counters)
+        state.counters[counter] = static_cast<double>(value);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    for (auto &[name, kernel] : kernels)
+    {
+        benchmark::RegisterBenchmark(name.c_str(), compile, kernel)
+            ->RangeMultiplier(10)
+            ->Range(100, 1000000)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
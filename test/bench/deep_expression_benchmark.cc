@@ -0,0 +1,97 @@
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/compiler_pipeline.h"
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+namespace
+{
+/// Counts the Variables of an AST with the default traversal of the PlainVisitor, i.e., the TraversalStack
+class SpecialVariableCountingVisitor : public PlainVisitor
+{
+public:
+    size_t count = 0;
+
+    void visit(Variable &)
+    {
+        ++count;
+    }
+};
+
+typedef Visitor<SpecialVariableCountingVisitor, PlainVisitor> VariableCountingVisitor;
+
+/// y = x + x + ... + x with n + 1 terms, i.e., a left-deep chain of n BinaryExpressions, or with every term but the
+/// first in parentheses nested n deep if parenthesized (n + 3 Variables either way)
+std::string program(size_t n, bool parenthesized)
+{
+    std::ostringstream source;
+    source << "public int chain(secret int x) {\n";
+    source << "  secret int y = x";
+    for (size_t i = 0; i < n; ++i)
+        source << (parenthesized ? " + (x" : " + x");
+    if (parenthesized)
+        source << std::string(n, ')');
+    source << ";\n  return y;\n}\n";
+    return source.str();
+}
+
+void parse(benchmark::State &state)
+{
+    auto source = program(static_cast<size_t>(state.range(0)), state.range(1));
+    for (auto _ : state)
+    {
+        // destroys the AST as well, which has to be iterative too
+        benchmark::DoNotOptimize(Parser::parse(source));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void traverse(benchmark::State &state)
+{
+    auto ast = Parser::parse(program(static_cast<size_t>(state.range(0)), state.range(1)));
+    for (auto _ : state)
+    {
+        VariableCountingVisitor counter;
+        ast->accept(counter);
+        if (counter.count != static_cast<size_t>(state.range(0)) + 3)
+            state.SkipWithError("Visited the wrong number of Variables.");
+        benchmark::DoNotOptimize(counter.count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void toString(benchmark::State &state)
+{
+    auto ast = Parser::parse(program(static_cast<size_t>(state.range(0)), state.range(1)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ast->toString(true));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Runs every pass of the CompilerPipeline on the chain, from parsing to emitting SEAL code
+void compile(benchmark::State &state)
+{
+    auto source = program(static_cast<size_t>(state.range(0)), state.range(1));
+    CompilerPipeline pipeline;
+    for (auto _ : state)
+    {
+        std::ostringstream output;
+        auto report = pipeline.compile(source, output);
+        if (report.emittedBytes == 0)
+            state.SkipWithError("Emitted no code.");
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+// the depths go well beyond what recursing on a default 8 MiB stack survives
+BENCHMARK(parse)->ArgsProduct({ { 1000, 100000, 1000000 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(traverse)->ArgsProduct({ { 1000, 100000, 1000000 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(toString)->ArgsProduct({ { 1000, 100000, 1000000 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(compile)->ArgsProduct({ { 1000, 100000, 1000000 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
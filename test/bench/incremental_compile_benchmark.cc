@@ -0,0 +1,127 @@
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include "transpiration/ast/utils/compiler_pipeline.h"
+
+namespace
+{
+/// A program of n Functions, where the one with index edited adds revision instead of 1 to its result
+std::string program(size_t n, size_t edited, size_t revision)
+{
+    std::ostringstream source;
+    for (size_t f = 0; f < n; ++f)
+    {
+        source << "public int f" << f << "(secret int x, secret int y, int c) {\n";
+        source << "  secret int sum = 0;\n";
+        for (size_t i = 0; i < 16; ++i)
+            source << "  sum = sum + x[" << (f + i) % 64 << "] * y[" << i << "] + c;\n";
+        source << "  secret int d = x - y;\n";
+        source << "  if (c > 3) { sum = sum + d * d; }\n";
+        source << "  return sum + " << (f == edited ? revision : 1) << ";\n}\n";
+    }
+    return source.str();
+}
+
+/// Compiles a program of state.range(0) Functions after editing one of them, without a FunctionCache
+void fullRecompile(benchmark::State &state)
+{
+    auto n = static_cast<size_t>(state.range(0));
+    CompilerPipeline pipeline;
+    size_t revision = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto source = program(n, n / 2, ++revision);
+        std::ostringstream output;
+        state.ResumeTiming();
+        pipeline.compile(source, output);
+    }
+}
+
+/// The same with a FunctionCache in memory, which has all Functions but the edited one
+void incrementalRecompile(benchmark::State &state)
+{
+    auto n = static_cast<size_t>(state.range(0));
+    FunctionCache cache;
+    CompilerPipeline pipeline;
+    pipeline.setFunctionCache(&cache);
+    std::ostringstream warmup;
+    pipeline.compile(program(n, n / 2, 1), warmup);
+
+    size_t revision = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto source = program(n, n / 2, ++revision);
+        std::ostringstream output;
+        state.ResumeTiming();
+        pipeline.compile(source, output);
+    }
+    state.counters["reused_functions"] =
+        benchmark::Counter(static_cast<double>(cache.getHits()), benchmark::Counter::kAvgIterations);
+}
+
+/// The same with a FunctionCache that is loaded from a directory, like every run of transpiration-compile does
+void incrementalRecompileFromDisk(benchmark::State &state)
+{
+    auto n = static_cast<size_t>(state.range(0));
+    auto directory = (std::filesystem::temp_directory_path() / "incremental_compile_benchmark").string();
+    std::filesystem::remove_all(directory);
+    {
+        FunctionCache cache(directory);
+        CompilerPipeline pipeline;
+        pipeline.setFunctionCache(&cache);
+        std::ostringstream warmup;
+        pipeline.compile(program(n, n / 2, 1), warmup);
+    }
+
+    size_t revision = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto source = program(n, n / 2, ++revision);
+        std::ostringstream output;
+        state.ResumeTiming();
+        FunctionCache cache(directory);
+        CompilerPipeline pipeline;
+        pipeline.setFunctionCache(&cache);
+        pipeline.compile(source, output);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+/// Compiles the same program again with a ProgramCache, which finds it without tokenizing or parsing it
+void unchangedRecompileFromProgramCache(benchmark::State &state)
+{
+    auto n = static_cast<size_t>(state.range(0));
+    auto directory = (std::filesystem::temp_directory_path() / "incremental_compile_benchmark_programs").string();
+    std::filesystem::remove_all(directory);
+    auto source = program(n, n / 2, 1);
+    {
+        ProgramCache cache(directory);
+        CompilerPipeline pipeline;
+        pipeline.setProgramCache(&cache);
+        std::ostringstream warmup;
+        pipeline.compile(source, warmup);
+    }
+
+    for (auto _ : state)
+    {
+        std::ostringstream output;
+        ProgramCache cache(directory);
+        CompilerPipeline pipeline;
+        pipeline.setProgramCache(&cache);
+        pipeline.compile(source, output);
+    }
+    std::filesystem::remove_all(directory);
+}
+} // namespace
+
+BENCHMARK(fullRecompile)->Arg(20)->Arg(200)->Unit(benchmark::kMillisecond);
+BENCHMARK(incrementalRecompile)->Arg(20)->Arg(200)->Unit(benchmark::kMillisecond);
+BENCHMARK(incrementalRecompileFromDisk)->Arg(20)->Arg(200)->Unit(benchmark::kMillisecond);
+BENCHMARK(unchangedRecompileFromProgramCache)->Arg(20)->Arg(200)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,253 @@
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "seal/seal.h"
+#include "transpiration/runtime/cost_table.h"
+
+namespace
+{
+/// A parameter set that the compiler can select (see ParameterSpec)
+struct ParameterSet
+{
+    std::string scheme;
+    size_t polyModulusDegree;
+
+    /// Bit sizes of the coefficient modulus primes (CKKS only, BFV uses SEAL's default for the degree)
+    std::vector<int> coeffModulusBits;
+
+    int plainModulusBits = 20;
+    int scaleBits = 40;
+
+    [[nodiscard]] std::string name() const
+    {
+        return scheme + "_" + std::to_string(polyModulusDegree);
+    }
+};
+
+const std::vector<ParameterSet> parameterSets = {
+    { "bfv", 4096, {} },
+    { "bfv", 8192, {} },
+    { "bfv", 16384, {} },
+    { "bfv", 32768, {} },
+    { "ckks", 8192, { 60, 40, 40, 60 } },
+    { "ckks", 16384, { 60, 40, 40, 40, 40, 40, 40, 60 } },
+    { "ckks", 32768, { 60, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 60 } },
+};
+
+/// Keys and operands for one parameter set, which are only created once they are needed
+class Fixture
+{
+public:
+    seal::SEALContext context;
+    seal::KeyGenerator keygen;
+    seal::PublicKey publicKey;
+    seal::RelinKeys relinKeys;
+    seal::GaloisKeys galoisKeys;
+    seal::Encryptor encryptor;
+    seal::Evaluator evaluator;
+    std::unique_ptr<seal::BatchEncoder> batchEncoder;
+    std::unique_ptr<seal::CKKSEncoder> ckksEncoder;
+    double scale;
+
+    /// A fresh ciphertext, a second one, an unrelinearized product and a plaintext
+    seal::Ciphertext x, y, product;
+    seal::Plaintext plaintext;
+
+    /// The values encoded into the plaintext
+    std::vector<int64_t> integers;
+    std::vector<double> reals;
+
+    static seal::EncryptionParameters parametersOf(const ParameterSet &set)
+    {
+        auto ckks = (set.scheme == "ckks");
+        seal::EncryptionParameters parameters(ckks ? seal::scheme_type::ckks : seal::scheme_type::bfv);
+        parameters.set_poly_modulus_degree(set.polyModulusDegree);
+        if (ckks)
+        {
+            parameters.set_coeff_modulus(seal::CoeffModulus::Create(set.polyModulusDegree, set.coeffModulusBits));
+        }
+        else
+        {
+            parameters.set_coeff_modulus(seal::CoeffModulus::BFVDefault(set.polyModulusDegree));
+            parameters.set_plain_modulus(seal::PlainModulus::Batching(set.polyModulusDegree, set.plainModulusBits));
+        }
+        return parameters;
+    }
+
+    static seal::PublicKey createPublicKey(seal::KeyGenerator &keygen)
+    {
+        seal::PublicKey publicKey;
+        keygen.create_public_key(publicKey);
+        return publicKey;
+    }
+
+    explicit Fixture(const ParameterSet &set)
+        : context(parametersOf(set)), keygen(context), publicKey(createPublicKey(keygen)),
+          encryptor(context, publicKey), evaluator(context), scale(static_cast<double>(1ULL << set.scaleBits))
+    {
+        keygen.create_relin_keys(relinKeys);
+        keygen.create_galois_keys(std::vector<int>{ 1 }, galoisKeys);
+
+        if (set.scheme == "ckks")
+        {
+            ckksEncoder = std::make_unique<seal::CKKSEncoder>(context);
+            reals.assign(ckksEncoder->slot_count(), 1.5);
+            ckksEncoder->encode(reals, scale, plaintext);
+        }
+        else
+        {
+            batchEncoder = std::make_unique<seal::BatchEncoder>(context);
+            integers.assign(batchEncoder->slot_count(), 3);
+            batchEncoder->encode(integers, plaintext);
+        }
+        encryptor.encrypt(plaintext, x);
+        encryptor.encrypt(plaintext, y);
+        evaluator.multiply(x, y, product);
+    }
+
+    void rotate(const seal::Ciphertext &ciphertext, seal::Ciphertext &destination)
+    {
+        if (ckksEncoder)
+            evaluator.rotate_vector(ciphertext, 1, galoisKeys, destination);
+        else
+            evaluator.rotate_rows(ciphertext, 1, galoisKeys, destination);
+    }
+
+    void encode(seal::Plaintext &destination)
+    {
+        if (ckksEncoder)
+            ckksEncoder->encode(reals, scale, destination);
+        else
+            batchEncoder->encode(integers, destination);
+    }
+};
+
+Fixture &fixtureOf(const ParameterSet &set)
+{
+    static std::map<std::string, std::unique_ptr<Fixture>> fixtures;
+    auto &fixture = fixtures[set.name()];
+    if (!fixture)
+        fixture = std::make_unique<Fixture>(set);
+    return *fixture;
+}
+
+/// The primitives, named like the operations of a CostTable
+const std::vector<std::pair<std::string, std::function<void(Fixture &, seal::Ciphertext &)>>> operations = {
+    { "add", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.add(f.x, f.y, d); } },
+    { "add_plain", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.add_plain(f.x, f.plaintext, d); } },
+    { "multiply", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.multiply(f.x, f.y, d); } },
+    { "multiply_plain", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.multiply_plain(f.x, f.plaintext, d); } },
+    { "square", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.square(f.x, d); } },
+    { "negate", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.negate(f.x, d); } },
+    { "relinearize", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.relinearize(f.product, f.relinKeys, d); } },
+    { "rescale", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.rescale_to_next(f.product, d); } },
+    { "mod_switch", [](Fixture &f, seal::Ciphertext &d) { f.evaluator.mod_switch_to_next(f.x, d); } },
+    { "rotate", [](Fixture &f, seal::Ciphertext &d) { f.rotate(f.x, d); } },
+    { "encrypt", [](Fixture &f, seal::Ciphertext &d) { f.encryptor.encrypt(f.plaintext, d); } },
+};
+
+/// Collects the mean latency of every benchmark while printing the usual console output
+class CostTableReporter : public benchmark::ConsoleReporter
+{
+public:
+    /// Latency in microseconds, by benchmark name (<parameter set>/<operation>)
+    std::map<std::string, double> latencies;
+
+    void ReportRuns(const std::vector<Run> &runs) override
+    {
+        for (auto &run : runs)
+        {
+            if (run.run_type == Run::RT_Iteration)
+                latencies[run.benchmark_name()] = run.GetAdjustedRealTime();
+        }
+        ConsoleReporter::ReportRuns(runs);
+    }
+};
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // our own flag, which must be removed before benchmark::Initialize complains about it
+    std::string costTableDirectory;
+    std::vector<char *> arguments;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--cost_table_dir=", 17) == 0)
+            costTableDirectory = argv[i] + 17;
+        else
+            arguments.push_back(argv[i]);
+    }
+    auto argumentCount = static_cast<int>(arguments.size());
+
+    for (auto &set : parameterSets)
+    {
+        for (auto &[operation, run] : operations)
+        {
+            if (operation == "rescale" && set.scheme != "ckks")
+                continue;
+            benchmark::RegisterBenchmark(
+                (set.name() + "/" + operation).c_str(),
+                [set, run = run](benchmark::State &state) {
+                    auto &fixture = fixtureOf(set);
+                    seal::Ciphertext destination;
+                    for (auto _ : state)
+                    {
+                        run(fixture, destination);
+                        benchmark::DoNotOptimize(destination);
+                    }
+                })
+                ->Unit(benchmark::kMicrosecond);
+        }
+        benchmark::RegisterBenchmark(
+            (set.name() + "/encode").c_str(),
+            [set](benchmark::State &state) {
+                auto &fixture = fixtureOf(set);
+                seal::Plaintext destination;
+                for (auto _ : state)
+                {
+                    fixture.encode(destination);
+                    benchmark::DoNotOptimize(destination);
+                }
+            })
+            ->Unit(benchmark::kMicrosecond);
+    }
+
+    benchmark::Initialize(&argumentCount, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data()))
+        return 1;
+    CostTableReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (costTableDirectory.empty())
+        return 0;
+
+    // one cost table per parameter set (with at least one benchmark that ran, e.g., with --benchmark_filter)
+    std::filesystem::create_directories(costTableDirectory);
+    for (auto &set : parameterSets)
+    {
+        std::map<std::string, double> latencies;
+        auto prefix = set.name() + "/";
+        for (auto &[name, latency] : reporter.latencies)
+        {
+            if (name.compare(0, prefix.size(), prefix) == 0)
+                latencies[name.substr(prefix.size())] = latency;
+        }
+        if (latencies.empty())
+            continue;
+
+        // the primes of the data level, i.e., without the special prime
+        auto primes = Fixture::parametersOf(set).coeff_modulus().size() - 1;
+        auto path = costTableDirectory + "/" + set.name() + ".json";
+        CostTable(set.scheme, set.polyModulusDegree, primes, latencies).save(path);
+        std::cout << "Wrote " << path << std::endl;
+    }
+    return 0;
+}
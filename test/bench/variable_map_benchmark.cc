@@ -0,0 +1,171 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "transpiration/ast/block.h"
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/persistent_variable_map.h"
+#include "transpiration/ast/utils/secret_taint_visitor.h"
+#include "transpiration/ast/utils/variable_map.h"
+
+namespace
+{
+/// The ScopedIdentifiers of n variables of the same scope, which the benchmarks copy before every lookup, i.e., look up
+/// different objects for the same variables, as a pass does when it resolves the same variable again
+class Variables
+{
+public:
+    Block block;
+    Scope scope;
+    std::vector<ScopedIdentifier> identifiers;
+
+    explicit Variables(size_t n) : scope(block)
+    {
+        for (size_t i = 0; i < n; ++i)
+            identifiers.emplace_back(scope, "v" + std::to_string(i));
+    }
+};
+
+template <typename Map = VariableMap<size_t>>
+Map fill(const Variables &variables)
+{
+    Map map;
+    for (size_t i = 0; i < variables.identifiers.size(); ++i)
+        map.insert_or_assign(variables.identifiers[i], size_t(i));
+    map.resetChangeFlags();
+    return map;
+}
+
+void insertOrAssign(benchmark::State &state)
+{
+    Variables variables(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(fill(variables));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void get(benchmark::State &state)
+{
+    Variables variables(static_cast<size_t>(state.range(0)));
+    auto map = fill(variables);
+    for (auto _ : state)
+    {
+        for (auto &identifier : variables.identifiers)
+            benchmark::DoNotOptimize(map.get(ScopedIdentifier(identifier)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void has(benchmark::State &state)
+{
+    Variables variables(static_cast<size_t>(state.range(0)));
+    auto map = fill(variables);
+    for (auto _ : state)
+    {
+        for (auto &identifier : variables.identifiers)
+            benchmark::DoNotOptimize(map.has(ScopedIdentifier(identifier)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void erase(benchmark::State &state)
+{
+    Variables variables(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto map = fill(variables);
+        state.ResumeTiming();
+        for (auto &identifier : variables.identifiers)
+            map.erase(ScopedIdentifier(identifier));
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Variables changed per branch in copyBranch and forkBranch
+const size_t changesPerBranch = 10;
+
+/// What an analysis over an If does with a VariableMap: copy it for the branch, change a few variables and merge them
+/// back
+void copyBranch(benchmark::State &state)
+{
+    Variables variables(static_cast<size_t>(state.range(0)));
+    auto map = fill(variables);
+    for (auto _ : state)
+    {
+        auto branch = map;
+        for (size_t i = 0; i < changesPerBranch; ++i)
+            branch.insert_or_assign(variables.identifiers[i], size_t(0));
+        for (auto &si : branch.changedEntries())
+            map.insert_or_assign(si, size_t(branch.get(si)));
+        map.resetChangeFlags();
+    }
+}
+
+/// The same with a PersistentVariableMap, i.e., fork() and merge() as the SecretTaintVisitor does (analyseOnFork): its
+/// map is never reset, i.e., all variables written so far are marked as changed, which merge() must not look at
+void forkBranch(benchmark::State &state)
+{
+    Variables variables(static_cast<size_t>(state.range(0)));
+    auto map = fill<PersistentVariableMap<size_t>>(variables);
+    for (auto &identifier : variables.identifiers)
+        map.insert_or_assign(identifier, size_t(1));
+    for (auto _ : state)
+    {
+        auto outer = std::move(map);
+        map = outer.fork();
+        for (size_t i = 0; i < changesPerBranch; ++i)
+            map.insert_or_assign(variables.identifiers[i], size_t(0));
+        outer.merge(map, [](size_t, size_t changed) { return changed; });
+        map = std::move(outer);
+    }
+}
+
+/// A function that declares n variables, in blocks of 100 so that resolving an identifier in its Scope does not
+/// dominate, and assigns each of them once
+std::string program(size_t n)
+{
+    std::ostringstream source;
+    source << "public int variables(secret int x) {\n";
+    source << "  secret int sum = 0;\n";
+    for (size_t block = 0; block * 100 < n; ++block)
+    {
+        source << "  {\n";
+        for (size_t i = block * 100; i < n && i < (block + 1) * 100; ++i)
+        {
+            source << "    int v" << i << " = " << i << ";\n";
+            source << "    v" << i << " = v" << i << " + " << (i % 2 ? "x" : "1") << ";\n";
+            source << "    sum = sum + v" << i << ";\n";
+        }
+        source << "  }\n";
+    }
+    source << "  return sum;\n}\n";
+    return source.str();
+}
+
+/// The SecretTaintVisitor, whose analysis is a VariableMap lookup per Variable
+void secretTaint(benchmark::State &state)
+{
+    auto ast = Parser::parse(program(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        SecretTaintVisitor taint;
+        ast->accept(taint);
+        benchmark::DoNotOptimize(taint.getTaintedNodes());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(insertOrAssign)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(get)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(has)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(erase)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(copyBranch)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(forkBranch)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(secretTaint)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include "transpiration/ast/parser/parser.h"
+#include "transpiration/ast/utils/plain_visitor.h"
+#include "transpiration/ast/utils/static_visitor.h"
+#include "transpiration/ast/utils/visitor.h"
+
+namespace
+{
+/// Counts the Variables of an AST with the virtual accept() and visit() of an IVisitor
+class SpecialVariableCountingVisitor : public PlainVisitor
+{
+public:
+    size_t count = 0;
+
+    void visit(Variable &)
+    {
+        ++count;
+    }
+};
+
+typedef Visitor<SpecialVariableCountingVisitor, PlainVisitor> VariableCountingVisitor;
+
+/// The same with handlers that are resolved at compile time
+class StaticVariableCounter : public StaticVisitor<StaticVariableCounter>
+{
+public:
+    size_t count = 0;
+
+    void visit(Variable &)
+    {
+        ++count;
+    }
+};
+
+/// sum = sum + x[i] * y[i] + i, unrolled n times, i.e., about 14 nodes per statement
+std::string program(size_t n)
+{
+    std::ostringstream source;
+    source << "public int dot(secret int x, secret int y) {\n";
+    source << "  secret int sum = 0;\n";
+    for (size_t i = 0; i < n; ++i)
+        source << "  sum = sum + x[" << i << "] * y[" << i << "] + " << i << ";\n";
+    source << "  return sum;\n}\n";
+    return source.str();
+}
+
+void ivisitor(benchmark::State &state)
+{
+    auto ast = Parser::parse(program(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        VariableCountingVisitor counter;
+        ast->accept(counter);
+        benchmark::DoNotOptimize(counter.count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void staticVisitor(benchmark::State &state)
+{
+    auto ast = Parser::parse(program(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        StaticVariableCounter counter;
+        counter.traverse(*ast);
+        benchmark::DoNotOptimize(counter.count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void walkLambdas(benchmark::State &state)
+{
+    auto ast = Parser::parse(program(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        walk(*ast, overloaded{ [&count](Variable &) { ++count; }, [](AbstractNode &) {} });
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(ivisitor)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(staticVisitor)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(walkLambdas)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
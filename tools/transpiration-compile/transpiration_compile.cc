@@ -0,0 +1,147 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "transpiration/ast/utils/compiler_pipeline.h"
+#include "transpiration/ast/utils/statistics.h"
+
+namespace
+{
+const char *usage =
+    "Usage: transpiration-compile [options] <program>\n"
+    "Compiles a program to a C++ translation unit that calls SEAL.\n"
+    "  -o <file>                  Write the code to <file> instead of stdout\n"
+    "  --scheme=<bfv|ckks>        Scheme of the encryption parameters (default: bfv)\n"
+    "  --poly-modulus-degree=<N>  Ring dimension of the encryption parameters (default: 8192)\n"
+    "  --parallel                 Run independent operations concurrently (OpenMP task graphs)\n"
+    "  --cost-table=<file>        Choose the layouts of secret arrays by the latencies of the operations measured\n"
+    "                             on the target machine, read from <file> (JSON, see test/bench)\n"
+    "  --time-phases              Print the time of every phase and MLIR's pass timing report to stderr\n"
+    "  --stats[=<file>]           Write the counters and phase times as JSON to <file> (default: stderr)\n"
+    "  --function-cache=<dir>     Reuse the Functions compiled by earlier runs from <dir> and add the others\n"
+    "  --program-cache=<dir>      Reuse the program if an earlier run compiled it with the same options, keeping the\n"
+    "                             most recently used programs in <dir> (up to 1 GiB)\n";
+
+bool startsWith(const char *argument, const char *prefix)
+{
+    return std::strncmp(argument, prefix, std::strlen(prefix)) == 0;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ParameterSpec spec;
+    bool parallel = false;
+    bool timePhases = false;
+    bool stats = false;
+    std::string statsPath;
+    std::string costTablePath;
+    std::string functionCachePath;
+    std::string programCachePath;
+    std::string outputPath;
+    std::string programPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (std::strcmp(argv[i], "--scheme=bfv") == 0)
+            spec.scheme = ParameterSpec::Scheme::BFV;
+        else if (std::strcmp(argv[i], "--scheme=ckks") == 0)
+            spec.scheme = ParameterSpec::Scheme::CKKS;
+        else if (startsWith(argv[i], "--poly-modulus-degree="))
+            spec.polyModulusDegree = std::stoul(argv[i] + std::strlen("--poly-modulus-degree="));
+        else if (std::strcmp(argv[i], "--parallel") == 0)
+            parallel = true;
+        else if (startsWith(argv[i], "--cost-table="))
+            costTablePath = argv[i] + std::strlen("--cost-table=");
+        else if (std::strcmp(argv[i], "--time-phases") == 0)
+            timePhases = true;
+        else if (std::strcmp(argv[i], "--stats") == 0)
+            stats = true;
+        else if (startsWith(argv[i], "--stats="))
+        {
+            stats = true;
+            statsPath = argv[i] + std::strlen("--stats=");
+        }
+        else if (startsWith(argv[i], "--function-cache="))
+            functionCachePath = argv[i] + std::strlen("--function-cache=");
+        else if (startsWith(argv[i], "--program-cache="))
+            programCachePath = argv[i] + std::strlen("--program-cache=");
+        else if (argv[i][0] != '-' && programPath.empty())
+            programPath = argv[i];
+        else
+        {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+    if (programPath.empty())
+    {
+        std::cerr << usage;
+        return 2;
+    }
+
+    std::ifstream programFile(programPath);
+    if (!programFile)
+    {
+        std::cerr << "Cannot read " << programPath << std::endl;
+        return 1;
+    }
+    std::stringstream program;
+    program << programFile.rdbuf();
+
+    CompilerStatistics::enableTiming(timePhases || stats);
+    CompilationReport report;
+    std::ostringstream code;
+    try
+    {
+        CompilerPipeline pipeline(spec, parallel);
+        pipeline.enablePassTimingReport(timePhases);
+        if (!costTablePath.empty())
+            pipeline.setCostTable(CostTable::load(costTablePath));
+        std::unique_ptr<FunctionCache> functionCache;
+        if (!functionCachePath.empty())
+        {
+            functionCache = std::make_unique<FunctionCache>(functionCachePath);
+            pipeline.setFunctionCache(functionCache.get());
+        }
+        std::unique_ptr<ProgramCache> programCache;
+        if (!programCachePath.empty())
+        {
+            programCache = std::make_unique<ProgramCache>(programCachePath);
+            pipeline.setProgramCache(programCache.get());
+        }
+        report = pipeline.compile(program.str(), code);
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << programPath << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (outputPath.empty())
+    {
+        std::cout << code.str();
+    }
+    else
+    {
+        std::ofstream outputFile(outputPath);
+        outputFile << code.str();
+    }
+
+    if (timePhases)
+        CompilerStatistics::print(std::cerr);
+    if (stats)
+    {
+        auto json = CompilerStatistics::toJson();
+        json["pipeline"] = report.toJson();
+        if (statsPath.empty())
+            std::cerr << json.dump(2) << std::endl;
+        else
+            std::ofstream(statsPath) << json.dump(2) << std::endl;
+    }
+    return 0;
+}